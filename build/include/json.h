@@ -0,0 +1 @@
+#include <zebra.h>
@@ -0,0 +1,4 @@
+#ifndef EIGRP_TEST_LIB_json_h
+#define EIGRP_TEST_LIB_json_h
+#include "../json.h"
+#endif
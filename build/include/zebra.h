@@ -46,6 +46,7 @@
 #define VRF_CMD_HELP_STR "VRF name\n"
 #define NO_STR "Negate a command or set its defaults\n"
 #define SHOW_STR "Show running system information\n"
+#define JSON_STR "JavaScript Object Notation\n"
 #define CLEAR_STR "Reset functions\n"
 #define DEBUG_STR "Debugging functions\n"
 #define UNDEBUG_STR "Disable debugging functions\n"
@@ -148,7 +149,8 @@ struct zclient;
 typedef int zclient_handler();
 union g_addr { struct in_addr ipv4; struct in6_addr ipv6; };
 struct zclient { void (*zebra_connected)(struct zclient *); void *context; int sock; struct stream *ibuf; int redist[3][ZEBRA_ROUTE_MAX + 1]; int default_information[3]; };
-struct zapi_nexthop { int type; vrf_id_t vrf_id; ifindex_t ifindex; union g_addr gate; };
+enum blackhole_type { BLACKHOLE_UNSPEC = 0, BLACKHOLE_NULL, BLACKHOLE_REJECT, BLACKHOLE_ADMINPROHIB };
+struct zapi_nexthop { int type; vrf_id_t vrf_id; ifindex_t ifindex; union g_addr gate; enum blackhole_type bh_type; };
 struct zapi_route { int type; int safi; int vrf_id; struct prefix prefix; uint8_t distance; uint32_t metric; uint32_t mtu; uint32_t tag; uint32_t message; struct zapi_nexthop nexthops[8]; int nexthop_num; };
 struct zebra_dplane_ctx { int dummy; };
 struct nexthop { int dummy; };
@@ -195,7 +197,9 @@ static inline void vty_time_print(struct vty *vty, int seconds) { (void)vty; (vo
 
 static inline struct route_node *route_node_lookup(struct route_table *t, const struct prefix *p) { (void)t; (void)p; return NULL; }
 static inline struct route_node *route_top(struct route_table *t) { return t ? t->top : NULL; }
+static inline struct route_node *route_table_get_next(struct route_table *t, const struct prefix *p) { (void)p; return route_top(t); }
 static inline struct route_node *route_next(struct route_node *n) { return n ? n->next : NULL; }
+static inline struct route_node *route_next_until(struct route_node *n, const struct route_node *limit) { (void)limit; return n ? n->next : NULL; }
 static inline void route_unlock_node(struct route_node *n) { (void)n; }
 static inline void route_lock_node(struct route_node *n) { (void)n; }
 
@@ -217,9 +221,18 @@ static inline void stream_set_endp(struct stream *s, size_t p) { if (s) s->endp=
 static inline size_t stream_get_getp(const struct stream *s) { return s ? s->getp : 0; }
 static inline void stream_set_getp(struct stream *s, size_t p) { if (s) s->getp=p; }
 static inline unsigned char *STREAM_DATA(struct stream *s) { return s ? s->data : NULL; }
+#define STREAM_SIZE(S) ((S)->size)
 static inline size_t STREAM_WRITEABLE(struct stream *s) { return s && s->size>=s->endp ? s->size - s->endp : 0; }
 
 static inline int vty_out(struct vty *vty, const char *fmt, ...) { (void)vty; (void)fmt; return 0; }
+typedef struct json_object json_object;
+static inline json_object *json_object_new_object(void) { return NULL; }
+static inline json_object *json_object_new_array(void) { return NULL; }
+static inline void json_object_int_add(json_object *obj, const char *key, int64_t i) { (void)obj; (void)key; (void)i; }
+static inline void json_object_string_add(json_object *obj, const char *key, const char *s) { (void)obj; (void)key; (void)s; }
+static inline void json_object_object_add(json_object *obj, const char *key, json_object *val) { (void)obj; (void)key; (void)val; }
+static inline int json_object_array_add(json_object *obj, json_object *val) { (void)obj; (void)val; return 0; }
+static inline int vty_json(struct vty *vty, json_object *json) { (void)vty; (void)json; return 0; }
 static inline int vty_out_newline(struct vty *vty, const char *fmt, ...) { (void)vty; (void)fmt; return 0; }
 
 struct ip { unsigned int ip_hl:4, ip_v:4; uint8_t ip_tos; uint16_t ip_len; uint16_t ip_id; uint16_t ip_off; uint8_t ip_ttl; uint8_t ip_p; uint16_t ip_sum; struct in_addr ip_src; struct in_addr ip_dst; };
@@ -258,6 +271,7 @@ static inline void if_add_hook(int type, int (*fn)(struct interface *)) { (void)
 static inline void if_del_hook(int type, int (*fn)(struct interface *)) { (void)type;(void)fn; }
 static inline void *XCALLOC(int type, size_t size) { (void)type; return calloc(1,size); }
 static inline void *XMALLOC(int type, size_t size) { (void)type; return malloc(size); }
+static inline void *XREALLOC(int type, void *ptr, size_t size) { (void)type; return realloc(ptr, size); }
 static inline void XFREE(int type, void *ptr) { (void)type; free(ptr); }
 static inline char *XSTRDUP(int type, const char *s) { (void)type; return s ? strdup(s) : NULL; }
 
@@ -334,6 +348,19 @@ extern struct running_config_stub { struct lyd_node *dnode; } *running_config;
 #define MTYPE_EIGRP_IPV4_INT_TLV 1017
 #define MTYPE_EIGRP_SEQ_TLV 1018
 #define MTYPE_EIGRP_PACKETIZER_WORK 1019
+#define MTYPE_EIGRP_ROUTE_VEC 1020
+#define MTYPE_EIGRP_SLAB 1021
+#define MTYPE_EIGRP_RECOMPUTE 1022
+#define MTYPE_EIGRP_PREFIX_SET 1023
+#define MTYPE_EIGRP_SNAPSHOT 1024
+#define MTYPE_EIGRP_SNAPSHOT_DATA 1025
+#define MTYPE_EIGRP_FSM_TRACE 1026
+#define MTYPE_EIGRP_ACTIVE 1027
+#define MTYPE_EIGRP_NBR_SET 1028
+#define MTYPE_EIGRP_NBR_SLOTS 1029
+#define MTYPE_EIGRP_SUMMARY 1030
+#define MTYPE_EIGRP_TLV_CACHE 1031
+#define MTYPE_EIGRP_FILTER_CACHE 1032
 #define DISTRIBUTE_V4_IN 0
 #define DISTRIBUTE_V4_OUT 1
 #define ZCAP_NET_RAW 1
@@ -354,6 +381,7 @@ extern struct running_config_stub { struct lyd_node *dnode; } *running_config;
 #define ZEBRA_ROUTE_NOTIFY_OWNER 10
 #define NEXTHOP_TYPE_IPV4_IFINDEX 1
 #define NEXTHOP_TYPE_IFINDEX 2
+#define NEXTHOP_TYPE_BLACKHOLE 6
 #define IPVERSION 4
 #define IPTOS_PREC_INTERNETCONTROL 0xc0
 #define IPV4_NET127(a) (((a) & 0xff000000U) == 0x7f000000U)
@@ -431,9 +459,11 @@ static inline struct prefix *prefix_new(void) { return calloc(1, sizeof(struct p
 static inline struct prefix_ipv4 *prefix_ipv4_new(void) { return calloc(1, sizeof(struct prefix_ipv4)); }
 static inline void prefix_free(void *p) { free(p); }
 static inline void prefix_ipv4_free(void *p) { free(p); }
-static inline void prefix_copy(struct prefix *dst, const struct prefix *src) { if (dst && src) *dst = *src; }
+static inline void prefix_copy(struct prefix *dst, const struct prefix *src) { if (!dst || !src) return; dst->family = src->family; dst->prefixlen = src->prefixlen; if (src->family == AF_INET) dst->u.prefix4 = src->u.prefix4; else dst->u = src->u; }
 static inline void apply_mask(struct prefix *p) { (void)p; }
 static inline int prefix_cmp(const struct prefix *a, const struct prefix *b) { return memcmp(a, b, sizeof(*a)); }
+static inline int prefix_same(const struct prefix *a, const struct prefix *b) { return a->family == b->family && a->prefixlen == b->prefixlen && a->u.prefix4.s_addr == b->u.prefix4.s_addr; }
+static inline int prefix_match(const struct prefix *n, const struct prefix *p) { uint32_t mask; if (n->prefixlen > p->prefixlen) return 0; mask = n->prefixlen ? htonl(0xffffffffU << (32 - n->prefixlen)) : 0; return (n->u.prefix4.s_addr & mask) == (p->u.prefix4.s_addr & mask); }
 static inline int prefix_match_network_statement(const struct prefix *net, const struct prefix *p) { (void)net; (void)p; return 1; }
 static inline int IPV4_ADDR_SAME(const struct in_addr *a, const struct in_addr *b) { return a && b && a->s_addr == b->s_addr; }
 
@@ -0,0 +1,326 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP active timer and stuck-in-active handling.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * A prefix that goes ACTIVE waits for a REPLY from every neighbor it
+ * queried.  A neighbor that never answers would keep it ACTIVE for good,
+ * and with it every diffusing computation that depends on it.  Each
+ * ACTIVE prefix therefore carries an active timer.
+ *
+ * The timers live on one FIFO per instance.  Every prefix runs on the
+ * same interval, half the configured active time, so a prefix whose
+ * deadline is set goes to the tail and the queue stays in deadline
+ * order; one instance timer armed for the head serves the whole queue.
+ *
+ * When a prefix's timer fires, the neighbors it still waits on are sent
+ * an SIA-QUERY.  A neighbor that is alive answers with an SIA-REPLY, even
+ * while its own computation is still running, and is asked again next
+ * round.  A neighbor that answered neither the QUERY nor the SIA-QUERY
+ * by the next round, or that has not replied after EIGRP_SIA_QUERY_MAX
+ * rounds, is stuck in active: only that neighbor is reset, and its
+ * outstanding reply is dropped from every ACTIVE prefix.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_packet.h"
+#include "eigrpd/eigrp_network.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_nbr_set.h"
+#include "eigrpd/eigrp_fsm.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_dual_queue.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_ACTIVE, "EIGRP active timer");
+
+static void eigrp_active_event(struct event *event);
+
+static uint64_t eigrp_active_now(void)
+{
+	struct timeval now;
+
+	monotime(&now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+/* SIA rounds run at half the active time */
+static uint64_t eigrp_active_interval(eigrp_instance_t *eigrp)
+{
+	return (uint64_t)eigrp->active_time * 1000 / 2;
+}
+
+uint64_t eigrp_active_elapsed(eigrp_active_t *active)
+{
+	return eigrp_active_now() - active->start;
+}
+
+static void eigrp_active_link(eigrp_instance_t *eigrp, eigrp_active_t *active)
+{
+	active->next = NULL;
+	active->prev = eigrp->active_tail;
+	if (eigrp->active_tail)
+		eigrp->active_tail->next = active;
+	else
+		eigrp->active_head = active;
+	eigrp->active_tail = active;
+	eigrp->active_count++;
+}
+
+static void eigrp_active_unlink(eigrp_instance_t *eigrp,
+				eigrp_active_t *active)
+{
+	if (active->prev)
+		active->prev->next = active->next;
+	else
+		eigrp->active_head = active->next;
+	if (active->next)
+		active->next->prev = active->prev;
+	else
+		eigrp->active_tail = active->prev;
+	active->prev = active->next = NULL;
+	eigrp->active_count--;
+}
+
+/* Arm the instance timer for the head of the queue. */
+static void eigrp_active_schedule(eigrp_instance_t *eigrp)
+{
+	eigrp_active_t *head = eigrp->active_head;
+	uint64_t now;
+
+	event_cancel(&eigrp->t_active);
+	if (!head || !eigrp->active_time)
+		return;
+
+	now = eigrp_active_now();
+	event_add_timer_msec(eigrpd_event, eigrp_active_event, eigrp,
+			     head->deadline > now ? head->deadline - now : 0,
+			     &eigrp->t_active);
+}
+
+static void eigrp_active_hist(eigrp_instance_t *eigrp, uint64_t msec)
+{
+	static const uint32_t bounds[] = EIGRP_ACTIVE_HIST_BOUNDS;
+	unsigned int i;
+
+	for (i = 0; i < array_size(bounds); i++)
+		if (msec < bounds[i])
+			break;
+	eigrp->active_stats.active_hist[i]++;
+}
+
+/*
+ * The prefix went ACTIVE, or started another diffusing computation while
+ * ACTIVE.  Either way the neighbors get a full round before SIA starts.
+ */
+void eigrp_active_start(eigrp_instance_t *eigrp, eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_active_t *active = pe->active;
+	uint64_t now = eigrp_active_now();
+
+	if (active) {
+		eigrp_active_unlink(eigrp, active);
+		eigrp_nbr_set_fini(&active->sia_wait);
+	} else {
+		active = XCALLOC(MTYPE_EIGRP_ACTIVE, sizeof(*active));
+		active->prefix = pe;
+		active->start = now;
+		pe->active = active;
+		eigrp->active_stats.entered++;
+	}
+
+	active->sia_rounds = 0;
+	active->deadline = now + eigrp_active_interval(eigrp);
+	eigrp_active_link(eigrp, active);
+
+	if (eigrp->active_head == active)
+		eigrp_active_schedule(eigrp);
+}
+
+/* The prefix is PASSIVE again, or going away. */
+void eigrp_active_stop(eigrp_instance_t *eigrp, eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_active_t *active = pe->active;
+	bool head;
+
+	if (!active)
+		return;
+
+	head = (eigrp->active_head == active);
+	eigrp_active_unlink(eigrp, active);
+	eigrp_active_hist(eigrp, eigrp_active_elapsed(active));
+
+	eigrp_nbr_set_fini(&active->sia_wait);
+	XFREE(MTYPE_EIGRP_ACTIVE, active);
+	pe->active = NULL;
+
+	if (head)
+		eigrp_active_schedule(eigrp);
+}
+
+/* The neighbor answered an SIA-QUERY for the prefix; it is not stuck. */
+void eigrp_active_sia_reply(eigrp_instance_t *eigrp,
+			    eigrp_prefix_descriptor_t *pe,
+			    eigrp_neighbor_t *nbr)
+{
+	eigrp->active_stats.sia_replies_rcvd++;
+	if (pe->active)
+		eigrp_nbr_set_del(&pe->active->sia_wait, nbr->slot);
+}
+
+static void eigrp_active_stuck_add(struct list **stuck, eigrp_neighbor_t *nbr)
+{
+	if (!*stuck)
+		*stuck = list_new();
+	if (!listnode_lookup(*stuck, nbr))
+		listnode_add(*stuck, nbr);
+}
+
+/* One expired timer: find who is stuck and ask everyone else again. */
+static void eigrp_active_expire(eigrp_instance_t *eigrp,
+				eigrp_active_t *active, uint64_t now,
+				struct list **stuck)
+{
+	eigrp_prefix_descriptor_t *pe = active->prefix;
+	bool last = active->sia_rounds >= EIGRP_SIA_QUERY_MAX;
+	eigrp_nbr_set_t wait = {};
+	eigrp_neighbor_t *nbr;
+	uint32_t slot;
+
+	EIGRP_TOPOLOGY_RIJ_FOREACH (eigrp, pe, slot, nbr) {
+		/* asked last round and still silent, or out of rounds */
+		if (last || eigrp_nbr_set_test(&active->sia_wait, slot)) {
+			eigrp_active_stuck_add(stuck, nbr);
+			continue;
+		}
+		if (*stuck && listnode_lookup(*stuck, nbr))
+			continue;
+
+		eigrp_siaquery_send(eigrp, nbr, pe);
+		eigrp_nbr_set_add(&wait, slot);
+		eigrp->active_stats.sia_queries_sent++;
+	}
+	eigrp_nbr_set_fini(&active->sia_wait);
+	active->sia_wait = wait;
+
+	active->sia_rounds++;
+	active->deadline = now + eigrp_active_interval(eigrp);
+	eigrp_active_link(eigrp, active);
+}
+
+static void eigrp_active_reset(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+{
+	eigrp->active_stats.stuck++;
+	zlog_warn("Neighbor %s (%s) is down: stuck in active",
+		  eigrp_print_addr(&nbr->src),
+		  ifindex2ifname(nbr->ei->ifp->ifindex, eigrp->vrf_id));
+
+	eigrp_hello_send(nbr->ei, EIGRP_HELLO_GRACEFUL_SHUTDOWN_NBR, &nbr->src);
+	eigrp_nbr_state_set(nbr, EIGRP_NEIGHBOR_DOWN);
+	eigrp_nbr_delete(nbr);
+}
+
+static void eigrp_active_event(struct event *event)
+{
+	eigrp_instance_t *eigrp = EVENT_ARG(event);
+	eigrp_active_t *active;
+	eigrp_neighbor_t *nbr;
+	struct list *stuck = NULL;
+	struct listnode *node;
+	uint64_t now = eigrp_active_now();
+
+	while ((active = eigrp->active_head) && active->deadline <= now) {
+		eigrp_active_unlink(eigrp, active);
+		eigrp_active_expire(eigrp, active, now, &stuck);
+	}
+	eigrp_active_schedule(eigrp);
+
+	/*
+	 * Resetting a neighbor runs DUAL for the prefixes waiting on it,
+	 * which may stop or restart timers; do it off the queue walk.
+	 */
+	if (!stuck)
+		return;
+
+	for (ALL_LIST_ELEMENTS_RO(stuck, node, nbr))
+		eigrp_active_reset(eigrp, nbr);
+	list_delete(&stuck);
+}
+
+/*
+ * A neighbor went down.  It will never reply, so stop waiting on it; a
+ * prefix left with nothing outstanding has heard its last reply, which
+ * is queued behind the neighbor's withdraws.  The neighbor's pending
+ * count bounds the walk.
+ */
+void eigrp_active_neighbor_down(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+{
+	eigrp_active_t *active, *next;
+	eigrp_prefix_descriptor_t *pe;
+
+	for (active = eigrp->active_head; active && nbr->rij_pending;
+	     active = next) {
+		next = active->next;
+		pe = active->prefix;
+
+		if (!eigrp_topology_rij_test(pe, nbr))
+			continue;
+
+		eigrp_topology_rij_remove(pe, nbr);
+		eigrp_nbr_set_del(&active->sia_wait, nbr->slot);
+		if (!eigrp_topology_rij_count(pe))
+			eigrp_dual_queue_enqueue(eigrp, nbr, pe, NULL,
+						 EIGRP_OPC_REPLY);
+	}
+
+	/* replies still owed on prefixes that are not on the queue */
+	if (nbr->rij_pending)
+		eigrp_topology_rij_purge(eigrp, nbr);
+}
+
+/*
+ * Last-reply processing for a prefix whose last outstanding reply went
+ * down with its neighbor.  Anything run since may have settled it.
+ */
+void eigrp_active_replied(eigrp_instance_t *eigrp, eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_fsm_action_message_t msg = {};
+	eigrp_route_descriptor_t *route;
+
+	route = eigrp_route_vec_head(&pe->routes);
+	if (!pe->active || eigrp_topology_rij_count(pe) || !route)
+		return;
+
+	msg.packet_type = EIGRP_OPC_REPLY;
+	msg.eigrp = eigrp;
+	msg.data_type = EIGRP_RECOMPUTE;
+	msg.change = METRIC_SAME;
+	msg.adv_router = route->adv_router;
+	msg.route = route;
+	msg.metrics = route->reported_metric;
+	msg.prefix = pe;
+	eigrp_fsm_event(&msg);
+}
+
+/*
+ * The active time changed.  Give every ACTIVE prefix a fresh round on the
+ * new interval; equal deadlines keep the queue in order.
+ */
+void eigrp_active_time_set(eigrp_instance_t *eigrp, uint16_t seconds)
+{
+	eigrp_active_t *active;
+	uint64_t now = eigrp_active_now();
+
+	eigrp->active_time = seconds;
+	EIGRP_ACTIVE_FOREACH (eigrp, active)
+		active->deadline = now + eigrp_active_interval(eigrp);
+	eigrp_active_schedule(eigrp);
+}
+
+void eigrp_active_fini(eigrp_instance_t *eigrp)
+{
+	while (eigrp->active_head)
+		eigrp_active_stop(eigrp, eigrp->active_head->prefix);
+	event_cancel(&eigrp->t_active);
+}
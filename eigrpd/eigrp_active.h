@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP active timer and stuck-in-active handling.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_ACTIVE_H
+#define _ZEBRA_EIGRP_ACTIVE_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern void eigrp_active_start(eigrp_instance_t *eigrp,
+			       eigrp_prefix_descriptor_t *pe);
+extern void eigrp_active_stop(eigrp_instance_t *eigrp,
+			      eigrp_prefix_descriptor_t *pe);
+extern void eigrp_active_sia_reply(eigrp_instance_t *eigrp,
+				   eigrp_prefix_descriptor_t *pe,
+				   eigrp_neighbor_t *nbr);
+extern void eigrp_active_neighbor_down(eigrp_instance_t *eigrp,
+				       eigrp_neighbor_t *nbr);
+extern void eigrp_active_replied(eigrp_instance_t *eigrp,
+				 eigrp_prefix_descriptor_t *pe);
+extern void eigrp_active_time_set(eigrp_instance_t *eigrp, uint16_t seconds);
+extern void eigrp_active_fini(eigrp_instance_t *eigrp);
+
+/* msec since the prefix went ACTIVE */
+extern uint64_t eigrp_active_elapsed(eigrp_active_t *active);
+
+/* Walk the ACTIVE prefixes, oldest deadline first. */
+#define EIGRP_ACTIVE_FOREACH(eigrp, active)                                    \
+	for ((active) = (eigrp)->active_head; (active);                        \
+	     (active) = (active)->next)
+
+#endif /* _ZEBRA_EIGRP_ACTIVE_H */
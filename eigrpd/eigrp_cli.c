@@ -17,6 +17,9 @@
 #include "eigrpd.h"
 #include "eigrp_zebra.h"
 #include "eigrp_cli.h"
+#include "eigrp_stub.h"
+#include "eigrp_interface.h"
+#include "eigrp_neighbor.h"
 
 #ifndef EIGRP_STANDALONE_BUILD
 /*
@@ -157,7 +160,9 @@ static void eigrp_cli_show_named_af_interfaces(struct vty *vty,
 {
 	eigrp_instance_t *eigrp = eigrp_cli_dnode_instance(dnode);
 	eigrp_interface_t *ei;
-	struct listnode *node;
+	eigrp_summary_t *sum;
+	struct listnode *node, *snode;
+	char buf[PREFIX_STRLEN];
 
 	if (!eigrp)
 		return;
@@ -173,7 +178,9 @@ static void eigrp_cli_show_named_af_interfaces(struct vty *vty,
 		    && ei->params.delay == EIGRP_DELAY_DEFAULT
 		    && ei->params.passive_interface == EIGRP_INTF_ACTIVE
 		    && ei->params.auth_type == EIGRP_AUTH_TYPE_NONE
-		    && ei->params.auth_keychain == NULL)
+		    && ei->params.auth_keychain == NULL
+		    && ei->params.bringup_max == EIGRP_INTF_BRINGUP_MAX_DEFAULT
+		    && (!ei->summaries || !ei->summaries->count))
 			continue;
 
 		vty_out(vty, "  af-interface %s\n", ei->ifp->name);
@@ -194,6 +201,14 @@ static void eigrp_cli_show_named_af_interfaces(struct vty *vty,
 		if (ei->params.auth_keychain)
 			vty_out(vty, "   authentication key-chain %s\n",
 				ei->params.auth_keychain);
+		if (ei->params.bringup_max != EIGRP_INTF_BRINGUP_MAX_DEFAULT)
+			vty_out(vty, "   bring-up max %u\n",
+				ei->params.bringup_max);
+		if (ei->summaries)
+			for (ALL_LIST_ELEMENTS_RO(ei->summaries, snode, sum))
+				vty_out(vty, "   summary-address %s\n",
+					prefix2str(&sum->prefix, buf,
+						   sizeof(buf)));
 
 		if (wrote)
 			vty_out(vty, "  exit-af-interface\n");
@@ -215,6 +230,20 @@ void eigrp_cli_show_header(struct vty *vty, const struct lyd_node *dnode,
 
 void eigrp_cli_show_end_header(struct vty *vty, const struct lyd_node *dnode)
 {
+	eigrp_instance_t *eigrp = eigrp_cli_dnode_instance(dnode);
+
+	/* instance settings the frr-eigrpd model does not carry */
+	if (eigrp && eigrp->dual_flush_delay != EIGRP_DUAL_FLUSH_DELAY_DEFAULT)
+		vty_out(vty, "  timers dual-flush %u\n", eigrp->dual_flush_delay);
+	if (eigrp && eigrp->bringup_max != EIGRP_BRINGUP_MAX_DEFAULT)
+		vty_out(vty, "  bring-up max %u\n", eigrp->bringup_max);
+	if (eigrp && eigrp->stub) {
+		char buf[64];
+
+		vty_out(vty, "  eigrp stub %s\n",
+			eigrp_stub_str(eigrp->stub, buf, sizeof(buf)));
+	}
+
 	eigrp_cli_show_named_af_interfaces(vty, dnode);
 	vty_out(vty, " exit-address-family\n");
 	vty_out(vty, "exit\n");
@@ -329,6 +358,8 @@ void eigrp_cli_show_active_time(struct vty *vty, const struct lyd_node *dnode,
 {
 	const char *timer = yang_dnode_get_string(dnode, NULL);
 
+	if (strcmp(timer, "0") == 0)
+		timer = "disabled";
 	vty_out(vty, "  timers active-time %s\n", timer);
 }
 
@@ -1946,7 +1977,26 @@ DEFUN(eigrp_af_interface_summary_address,
       "Perform address summarization\n"
       "Summary prefix\n")
 {
-	return eigrp_cli_not_configured(vty, "summary-address");
+	char ifname[IFNAMSIZ];
+	char asn[16];
+	char xpath[XPATH_MAXLEN];
+	char instance_xpath[XPATH_MAXLEN];
+	char leaf[64];
+
+	if (!eigrp_cli_af_interface_path(vty, ifname, sizeof(ifname), asn,
+					   sizeof(asn)))
+		return CMD_WARNING;
+
+	snprintf(instance_xpath, sizeof(instance_xpath),
+		 "/frr-interface:lib/interface[name='%s']/frr-eigrpd:eigrp/instance[asn='%s']",
+		 ifname, asn);
+	nb_cli_enqueue_change(vty, instance_xpath, NB_OP_CREATE, NULL);
+	snprintf(leaf, sizeof(leaf), "summarize-addresses[.='%s']",
+		 eigrp_cli_token_last(argc, argv));
+	eigrp_cli_interface_instance_xpath(xpath, sizeof(xpath), ifname, asn,
+					    leaf);
+	nb_cli_enqueue_change(vty, xpath, NB_OP_CREATE, NULL);
+	return nb_cli_apply_changes(vty, NULL);
 }
 
 DEFUN(no_eigrp_af_interface_summary_address,
@@ -1956,7 +2006,21 @@ DEFUN(no_eigrp_af_interface_summary_address,
       "Perform address summarization\n"
       "Summary prefix\n")
 {
-	return eigrp_cli_not_configured(vty, "no summary-address");
+	char ifname[IFNAMSIZ];
+	char asn[16];
+	char xpath[XPATH_MAXLEN];
+	char leaf[64];
+
+	if (!eigrp_cli_af_interface_path(vty, ifname, sizeof(ifname), asn,
+					   sizeof(asn)))
+		return CMD_WARNING;
+
+	snprintf(leaf, sizeof(leaf), "summarize-addresses[.='%s']",
+		 eigrp_cli_token_last(argc, argv));
+	eigrp_cli_interface_instance_xpath(xpath, sizeof(xpath), ifname, asn,
+					    leaf);
+	nb_cli_enqueue_change(vty, xpath, NB_OP_DESTROY, NULL);
+	return nb_cli_apply_changes(vty, NULL);
 }
 
 DEFUN(eigrp_af_interface_split_horizon,
@@ -2036,6 +2100,186 @@ DEFUN(eigrp_summary_metric_stub,
 	return eigrp_cli_not_configured(vty, "summary-metric");
 }
 
+static int eigrp_cli_dual_flush_set(struct vty *vty, uint16_t delay)
+{
+	char asn[16];
+	char vrf_name[VRF_NAMSIZ];
+	eigrp_instance_t *eigrp;
+
+	if (!eigrp_cli_current_as_vrf(vty, asn, sizeof(asn), vrf_name,
+				       sizeof(vrf_name)))
+		return CMD_WARNING;
+
+	eigrp = eigrp_cli_instance_lookup_by_as_vrf(asn, vrf_name);
+	if (!eigrp)
+		return CMD_WARNING;
+
+	eigrp->dual_flush_delay = delay;
+	return CMD_SUCCESS;
+}
+
+DEFUN(eigrp_timers_dual_flush,
+      eigrp_timers_dual_flush_cmd,
+      "timers dual-flush (0-1000)",
+      "Adjust routing timers\n"
+      "Coalesce DUAL updates and queries of a burst\n"
+      "Coalescing delay in milliseconds, 0 for end of task\n")
+{
+	return eigrp_cli_dual_flush_set(
+		vty, strtoul(eigrp_cli_token_last(argc, argv), NULL, 10));
+}
+
+DEFUN(no_eigrp_timers_dual_flush,
+      no_eigrp_timers_dual_flush_cmd,
+      "no timers dual-flush [(0-1000)]",
+      NO_STR
+      "Adjust routing timers\n"
+      "Coalesce DUAL updates and queries of a burst\n"
+      "Coalescing delay in milliseconds, 0 for end of task\n")
+{
+	return eigrp_cli_dual_flush_set(vty, EIGRP_DUAL_FLUSH_DELAY_DEFAULT);
+}
+
+/*
+ * The same command caps initial syncs for the instance, or for one
+ * interface when given in af-interface mode.  max NULL restores the
+ * default.
+ */
+static int eigrp_cli_bringup_set(struct vty *vty, const char *max)
+{
+	char ifname[IFNAMSIZ];
+	char asn[16];
+	char vrf_name[VRF_NAMSIZ];
+	eigrp_instance_t *eigrp;
+	eigrp_interface_t *ei;
+	bool intf;
+
+	intf = eigrp_cli_xpath_get(VTY_CURR_XPATH, "ifname", ifname,
+				   sizeof(ifname))
+	       || eigrp_cli_xpath_get(VTY_CURR_XPATH, "interface", ifname,
+				      sizeof(ifname));
+
+	if (!eigrp_cli_current_as_vrf(vty, asn, sizeof(asn), vrf_name,
+				       sizeof(vrf_name)))
+		return CMD_WARNING;
+
+	eigrp = eigrp_cli_instance_lookup_by_as_vrf(asn, vrf_name);
+	if (!eigrp)
+		return CMD_WARNING;
+
+	if (!intf) {
+		eigrp->bringup_max = max ? strtoul(max, NULL, 10)
+					 : EIGRP_BRINGUP_MAX_DEFAULT;
+	} else {
+		ei = eigrp_intf_lookup_by_name(eigrp, ifname);
+		if (!ei) {
+			vty_out(vty, "%% Interface %s is not running EIGRP\n",
+				ifname);
+			return CMD_WARNING;
+		}
+		ei->params.bringup_max = max ? strtoul(max, NULL, 10)
+					     : EIGRP_INTF_BRINGUP_MAX_DEFAULT;
+	}
+
+	eigrp_nbr_bringup_resume(eigrp);
+	return CMD_SUCCESS;
+}
+
+DEFUN(eigrp_bringup_max,
+      eigrp_bringup_max_cmd,
+      "bring-up max (0-65535)",
+      "Neighbor initial sync admission\n"
+      "Most neighbors in initial sync at once\n"
+      "Neighbor count, 0 for no limit\n")
+{
+	return eigrp_cli_bringup_set(vty, eigrp_cli_token_last(argc, argv));
+}
+
+DEFUN(no_eigrp_bringup_max,
+      no_eigrp_bringup_max_cmd,
+      "no bring-up max [(0-65535)]",
+      NO_STR
+      "Neighbor initial sync admission\n"
+      "Most neighbors in initial sync at once\n"
+      "Neighbor count, 0 for no limit\n")
+{
+	return eigrp_cli_bringup_set(vty, NULL);
+}
+
+static int eigrp_cli_stub_set(struct vty *vty, uint16_t flags)
+{
+	char asn[16];
+	char vrf_name[VRF_NAMSIZ];
+	eigrp_instance_t *eigrp;
+
+	if (!eigrp_cli_current_as_vrf(vty, asn, sizeof(asn), vrf_name,
+				       sizeof(vrf_name)))
+		return CMD_WARNING;
+
+	eigrp = eigrp_cli_instance_lookup_by_as_vrf(asn, vrf_name);
+	if (!eigrp)
+		return CMD_WARNING;
+
+	eigrp_stub_set(eigrp, flags);
+	return CMD_SUCCESS;
+}
+
+DEFUN(eigrp_stub,
+      eigrp_stub_cmd,
+      "eigrp stub [{connected|static|summary|redistributed}]",
+      EIGRP_STR
+      "Set address-family as a stub router\n"
+      "Advertise connected routes\n"
+      "Advertise static routes\n"
+      "Advertise summary routes\n"
+      "Advertise redistributed routes\n")
+{
+	static const struct {
+		const char *name;
+		uint16_t flag;
+	} types[] = {
+		{"connected", EIGRP_STUB_CONNECTED},
+		{"static", EIGRP_STUB_STATIC},
+		{"summary", EIGRP_STUB_SUMMARY},
+		{"redistributed", EIGRP_STUB_REDIST},
+	};
+	uint16_t flags = 0;
+	unsigned int t;
+	int i;
+
+	for (i = 2; i < argc; i++)
+		for (t = 0; t < array_size(types); t++)
+			if (strcmp(eigrp_cli_token_value(argv[i]), types[t].name) == 0)
+				flags |= types[t].flag;
+
+	return eigrp_cli_stub_set(vty, flags ? flags : EIGRP_STUB_DEFAULT);
+}
+
+DEFUN(eigrp_stub_receive_only,
+      eigrp_stub_receive_only_cmd,
+      "eigrp stub receive-only",
+      EIGRP_STR
+      "Set address-family as a stub router\n"
+      "Advertise no routes\n")
+{
+	return eigrp_cli_stub_set(vty, EIGRP_STUB_RECVONLY);
+}
+
+DEFUN(no_eigrp_stub,
+      no_eigrp_stub_cmd,
+      "no eigrp stub [{connected|static|summary|redistributed|receive-only}]",
+      NO_STR
+      EIGRP_STR
+      "Set address-family as a stub router\n"
+      "Advertise connected routes\n"
+      "Advertise static routes\n"
+      "Advertise summary routes\n"
+      "Advertise redistributed routes\n"
+      "Advertise no routes\n")
+{
+	return eigrp_cli_stub_set(vty, 0);
+}
+
 /*
  * CLI installation procedures.
  */
@@ -2087,6 +2331,13 @@ eigrp_cli_init(void)
 	install_element(EIGRP_NODE, &eigrp_passive_interface_cmd);
 	install_element(EIGRP_NODE, &eigrp_timers_active_cmd);
 	install_element(EIGRP_NODE, &no_eigrp_timers_active_cmd);
+	install_element(EIGRP_NODE, &eigrp_timers_dual_flush_cmd);
+	install_element(EIGRP_NODE, &no_eigrp_timers_dual_flush_cmd);
+	install_element(EIGRP_NODE, &eigrp_bringup_max_cmd);
+	install_element(EIGRP_NODE, &no_eigrp_bringup_max_cmd);
+	install_element(EIGRP_NODE, &eigrp_stub_cmd);
+	install_element(EIGRP_NODE, &eigrp_stub_receive_only_cmd);
+	install_element(EIGRP_NODE, &no_eigrp_stub_cmd);
 	install_element(EIGRP_NODE, &eigrp_variance_cmd);
 	install_element(EIGRP_NODE, &no_eigrp_variance_cmd);
 	install_element(EIGRP_NODE, &eigrp_maximum_paths_cmd);
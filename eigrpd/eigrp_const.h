@@ -36,6 +36,25 @@
 #define EIGRP_NEIGHBOR_UP 2
 #define EIGRP_NEIGHBOR_STATE_MAX 3
 
+/* Neighbor slots, see eigrp_nbr_slot_alloc() */
+#define EIGRP_NBR_SLOT_NONE UINT32_MAX /* self neighbor, or released */
+#define EIGRP_NBR_SLOT_INIT 64	       /* initial slot table size */
+
+/* Neighbor bring-up admission (initial INIT/EOT sync) */
+#define EIGRP_BRINGUP_NONE 0	/* not in initial sync */
+#define EIGRP_BRINGUP_QUEUED 1	/* PENDING, waiting for a sync slot */
+#define EIGRP_BRINGUP_ACTIVE 2	/* holds a sync slot */
+
+#define EIGRP_BRINGUP_MAX_DEFAULT 32	  /* concurrent syncs per instance */
+#define EIGRP_INTF_BRINGUP_MAX_DEFAULT 8 /* concurrent syncs per interface */
+
+/* time-to-full-adjacency histogram, upper bounds in seconds */
+#define EIGRP_BRINGUP_HIST_BOUNDS {1, 2, 5, 10, 30, 60}
+#define EIGRP_BRINGUP_HIST_MAX 7 /* bounds plus overflow bucket */
+
+/* Object allocator chunk size, bytes */
+#define EIGRP_SLAB_CHUNK_SIZE 16384
+
 /*Packet requiring ack will be retransmitted again after this time*/
 #define EIGRP_PACKET_RETRANS_TIME 2 /* in seconds */
 #define EIGRP_PACKET_RETRANS_MAX 16 /* number of retrans attempts */
@@ -114,12 +133,16 @@ enum metric_change { METRIC_DECREASE, METRIC_SAME, METRIC_INCREASE };
 #define EIGRP_TOPOLOGY_TYPE_CONNECTED 0	      // Connected network
 #define EIGRP_TOPOLOGY_TYPE_REMOTE 1	      // Remote internal network
 #define EIGRP_TOPOLOGY_TYPE_REMOTE_EXTERNAL 2 // Remote external network
+#define EIGRP_TOPOLOGY_TYPE_SUMMARY 3	      // Local interface summary
 
 /*EIGRP TT entry flags*/
 #define EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG (1 << 0)
 #define EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG (1 << 1)
 #define EIGRP_ROUTE_DESCRIPTOR_INTABLE_FLAG (1 << 2)
 #define EIGRP_ROUTE_DESCRIPTOR_EXTERNAL_FLAG (1 << 3)
+#define EIGRP_ROUTE_DESCRIPTOR_FEASIBLE_FLAGS                                  \
+	(EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG                                 \
+	 | EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG)
 
 /*EIGRP FSM state count, event count*/
 #define EIGRP_FSM_STATE_MAX 5
@@ -138,6 +161,50 @@ enum eigrp_fsm_states {
 #define EIGRP_FSM_NEED_UPDATE 1
 #define EIGRP_FSM_NEED_QUERY 2
 
+/* Dirty prefix queues, queue n holds prefixes with req_action bit (1 << n) */
+#define EIGRP_DIRTY_UPDATE 0 /* EIGRP_FSM_NEED_UPDATE */
+#define EIGRP_DIRTY_QUERY 1  /* EIGRP_FSM_NEED_QUERY */
+#define EIGRP_DIRTY_MAX 2
+
+/* Lanes per eigrp_calculate_metrics_batch() call during bulk recompute */
+#define EIGRP_METRIC_BATCH_SIZE 256
+
+/* Read-only topology snapshots, see eigrp_snapshot.c */
+#define EIGRP_SNAPSHOT_CHUNK 4096 /* prefixes copied per yielding step */
+#define EIGRP_SNAPSHOT_DELAY 1	  /* seconds of quiet before a refresh */
+#define EIGRP_SNAPSHOT_HOLD 60	  /* seconds a reader keeps a copy warm */
+
+/* DUAL event trace ring, see eigrp_fsm.c; a power of two */
+#define EIGRP_FSM_TRACE_SIZE 4096
+
+/* DUAL output coalescing, see eigrp_packetizer.c */
+#define EIGRP_DUAL_FLUSH_DELAY_DEFAULT 0 /* msec, 0 = end of current task */
+#define EIGRP_DUAL_FLUSH_DELAY_MAX 1000
+
+/* DUAL input queue, see eigrp_dual_queue.c */
+#define EIGRP_DUAL_QUEUE_SLICE_USEC 10000 /* one run, then yield */
+
+/* Routing table install queue, see eigrp_rib_queue.c */
+#define EIGRP_RIB_FLUSH_DELAY 10   /* msec a change waits for company */
+#define EIGRP_RIB_QUEUE_BATCH 1024 /* prefixes per flush; a full batch
+				      does not wait for the timer */
+
+/* Active timer and SIA, see eigrp_active.c */
+#define EIGRP_ACTIVE_TIME_DEFAULT 180 /* seconds, 0 = disabled */
+#define EIGRP_SIA_QUERY_MAX 3	      /* SIA-QUERY rounds before giving up */
+
+/* time-in-active histogram, upper bounds in msec */
+#define EIGRP_ACTIVE_HIST_BOUNDS {10, 100, 1000, 10000, 60000, 180000}
+#define EIGRP_ACTIVE_HIST_MAX 7 /* bounds plus overflow bucket */
+
+/* Stub routing (RFC 7868 section 6.8), see eigrp_stub.c */
+#define EIGRP_STUB_CONNECTED 0x0001   /* advertise connected routes */
+#define EIGRP_STUB_STATIC 0x0002      /* advertise redistributed statics */
+#define EIGRP_STUB_SUMMARY 0x0004     /* advertise local summaries */
+#define EIGRP_STUB_RECVONLY 0x0008    /* advertise nothing */
+#define EIGRP_STUB_REDIST 0x0010      /* advertise other redistributed routes */
+#define EIGRP_STUB_DEFAULT (EIGRP_STUB_CONNECTED | EIGRP_STUB_SUMMARY)
+
 /*EIGRP FSM events*/
 enum eigrp_fsm_events {
 	/*
@@ -267,6 +334,9 @@ enum eigrp_fsm_events {
 #define EIGRP_TLV_SW_VERSION_LEN	(8U)
 
 #define EIGRP_TLV_NEXT_MCAST_SEQ	(EIGRP_TLV_GENERAL | 0x0005) /*!< sequence number */
+#define EIGRP_TLV_STUB			(EIGRP_TLV_GENERAL | 0x0006) /*!< stub flags */
+#define EIGRP_TLV_STUB_LEN		(6U)
+
 #define EIGRP_TLV_PEER_TERMINATION	(EIGRP_TLV_GENERAL | 0x0007) /*!< peer termination */
 #define EIGRP_TLV_PEER_TERMINATION_LEN	(9U)
 
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP DUAL input queue.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * The UPDATE, QUERY and REPLY receive paths used to run DUAL for every
+ * TLV before returning to the event loop.  A full-table UPDATE ran
+ * thousands of prefixes through the FSM in one go while hellos and
+ * timers waited behind it, long enough to cost adjacencies.
+ *
+ * Receiving now only decodes.  Each TLV for a known prefix becomes a DUAL
+ * event on an instance FIFO, and the FIFO is run from a southbound work
+ * queue in slices of EIGRP_DUAL_QUEUE_SLICE_USEC; between slices the
+ * event loop gets its turn.  A TLV that finds an event from the same
+ * neighbor with the same opcode already waiting for its prefix replaces
+ * that event's route: DUAL only needs the neighbor's latest word.  The
+ * event then moves to the tail, where the TLV would have gone, so DUAL
+ * still sees each prefix's input in the order it arrived.
+ *
+ * An event holds its prefix and neighbor by pointer, so a prefix that is
+ * deleted or a neighbor that goes down takes its waiting events with it.
+ *
+ * Neighbor down is queued too.  Each prefix the neighbor has a route for
+ * gets an UPDATE without a route, which withdraws it, and each ACTIVE
+ * prefix left with no reply outstanding gets a REPLY without a route,
+ * which runs last-reply processing.  A deleted neighbor is only freed once
+ * the last of its events is gone.  New prefixes and the GR and filter
+ * paths still run DUAL directly; they are not driven by packet volume.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_fsm.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_southbound.h"
+#include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_dual_queue.h"
+
+static uint64_t eigrp_dual_queue_now(void)
+{
+	struct timeval now;
+
+	monotime(&now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+static void eigrp_dual_queue_append(eigrp_instance_t *eigrp,
+				    eigrp_dual_event_t *ev)
+{
+	ev->next = NULL;
+	ev->prev = eigrp->dual_tail;
+	if (eigrp->dual_tail)
+		eigrp->dual_tail->next = ev;
+	else
+		eigrp->dual_head = ev;
+	eigrp->dual_tail = ev;
+}
+
+static void eigrp_dual_queue_remove(eigrp_instance_t *eigrp,
+				    eigrp_dual_event_t *ev)
+{
+	if (ev->prev)
+		ev->prev->next = ev->next;
+	else
+		eigrp->dual_head = ev->next;
+	if (ev->next)
+		ev->next->prev = ev->prev;
+	else
+		eigrp->dual_tail = ev->prev;
+}
+
+static void eigrp_dual_queue_prefix_remove(eigrp_dual_event_t *ev)
+{
+	eigrp_dual_event_t **pp;
+
+	for (pp = &ev->prefix->dual; *pp; pp = &(*pp)->pe_next)
+		if (*pp == ev) {
+			*pp = ev->pe_next;
+			break;
+		}
+}
+
+static void eigrp_dual_queue_unlink(eigrp_instance_t *eigrp,
+				    eigrp_dual_event_t *ev)
+{
+	eigrp_dual_queue_remove(eigrp, ev);
+	eigrp_dual_queue_prefix_remove(ev);
+
+	eigrp->dual_count--;
+	ev->nbr->dual_pending--;
+}
+
+/* Call after unlinking; a deleted neighbor goes with its last event. */
+static void eigrp_dual_event_free(eigrp_dual_event_t *ev)
+{
+	eigrp_neighbor_t *nbr = ev->nbr;
+
+	if (ev->route)
+		eigrp_topology_route_free(ev->route);
+	eigrp_slab_obj_free(ev);
+
+	if (nbr->deleted && !nbr->dual_pending)
+		eigrp_nbr_release(nbr);
+}
+
+/*
+ * Run DUAL for one event, exactly as the receive path used to: the route
+ * the neighbor already has in the topology takes the decoded fields,
+ * otherwise the decoded route is offered to DUAL.
+ */
+static void eigrp_dual_event_run(eigrp_instance_t *eigrp,
+				 eigrp_dual_event_t *ev)
+{
+	eigrp_fsm_action_message_t msg = {};
+	eigrp_route_descriptor_t *received = ev->route;
+	eigrp_route_descriptor_t *route = received;
+	eigrp_route_descriptor_t *topology_route;
+
+	/* left behind by neighbor down */
+	if (!received) {
+		if (ev->opcode == EIGRP_OPC_REPLY)
+			eigrp_active_replied(eigrp, ev->prefix);
+		else
+			eigrp_topology_neighbor_withdraw(eigrp, ev->nbr,
+							 ev->prefix);
+		return;
+	}
+
+	ev->route = NULL;
+	topology_route = eigrp_prefix_descriptor_lookup(&ev->prefix->routes,
+							ev->nbr);
+	if (topology_route) {
+		topology_route->type = received->type;
+		topology_route->nexthop = received->nexthop;
+		topology_route->extdata = received->extdata;
+		route = topology_route;
+	} else {
+		received->adv_router = ev->nbr;
+		received->prefix = ev->prefix;
+	}
+
+	msg.packet_type = ev->opcode;
+	msg.eigrp = eigrp;
+	msg.data_type = (received->type == EIGRP_TLV_IPv4_EXT) ? EIGRP_EXT
+							       : EIGRP_INT;
+	msg.adv_router = ev->nbr;
+	msg.route = route;
+	msg.metrics = received->metric;
+	msg.prefix = ev->prefix;
+	eigrp_fsm_event(&msg);
+
+	if (topology_route)
+		eigrp_topology_route_free(received);
+}
+
+/*
+ * One slice.  Whatever DUAL produced is flushed at the end; the flush
+ * skips the interface the input came in on if it all came in on one.
+ */
+static eigrp_work_queue_result_t eigrp_dual_queue_run(eigrp_work_queue_t *queue,
+						      void *data)
+{
+	eigrp_instance_t *eigrp = eigrp_work_queue_eigrp(queue);
+	eigrp_dual_queue_stats_t *stats = &eigrp->dual_stats;
+	eigrp_interface_t *exception = NULL;
+	eigrp_dual_event_t *ev;
+	uint64_t start, now, latency;
+	uint32_t processed = 0;
+
+	(void)data;
+	start = eigrp_dual_queue_now();
+
+	while ((ev = eigrp->dual_head)) {
+		now = eigrp_dual_queue_now();
+		if (processed && now - start >= EIGRP_DUAL_QUEUE_SLICE_USEC)
+			break;
+
+		eigrp_dual_queue_unlink(eigrp, ev);
+		if (!processed)
+			exception = ev->nbr->ei;
+		else if (exception != ev->nbr->ei)
+			exception = NULL;
+
+		latency = now > ev->queued ? now - ev->queued : 0;
+		stats->latency_usec += latency;
+		if (latency > stats->latency_max_usec)
+			stats->latency_max_usec = latency;
+
+		eigrp_dual_event_run(eigrp, ev);
+		eigrp_dual_event_free(ev);
+		processed++;
+	}
+
+	stats->runs++;
+	stats->processed += processed;
+	stats->last_processed = processed;
+	stats->last_usec = eigrp_dual_queue_now() - start;
+
+	if (processed)
+		eigrp_packetizer_flush(eigrp, exception);
+
+	if (eigrp->dual_head) {
+		stats->yields++;
+		return EIGRP_WORK_QUEUE_REQUEUE;
+	}
+
+	eigrp->dual_scheduled = false;
+	return EIGRP_WORK_QUEUE_SUCCESS;
+}
+
+static void eigrp_dual_queue_delete(eigrp_work_queue_t *queue, void *data)
+{
+	(void)queue;
+	(void)data;
+}
+
+void eigrp_dual_queue_init(eigrp_instance_t *eigrp)
+{
+	eigrp->dual_queue = eigrp_work_queue_new(eigrp, "eigrp DUAL input",
+						 eigrp_dual_queue_run,
+						 eigrp_dual_queue_delete);
+}
+
+void eigrp_dual_queue_fini(eigrp_instance_t *eigrp)
+{
+	eigrp_dual_event_t *ev;
+
+	while ((ev = eigrp->dual_head)) {
+		eigrp_dual_queue_unlink(eigrp, ev);
+		eigrp_dual_event_free(ev);
+	}
+
+	eigrp_work_queue_free(eigrp->dual_queue);
+	eigrp->dual_queue = NULL;
+	eigrp->dual_scheduled = false;
+}
+
+void eigrp_dual_queue_enqueue(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
+			      eigrp_prefix_descriptor_t *pe,
+			      eigrp_route_descriptor_t *route, uint8_t opcode)
+{
+	eigrp_dual_queue_stats_t *stats = &eigrp->dual_stats;
+	eigrp_dual_event_t *ev;
+
+	/* the neighbor's newest waiting event for the prefix */
+	for (ev = pe->dual; ev; ev = ev->pe_next)
+		if (ev->nbr == nbr)
+			break;
+
+	/*
+	 * A merged event runs with the newest route, so it goes behind
+	 * whatever other neighbors said about the prefix in the meantime.
+	 * Neighbor down leaves events without a route, and those are never
+	 * merged either way: the withdraw or the last reply has to run on its
+	 * own.  Folding a later UPDATE into one would hide the down, and
+	 * folding one into a waiting UPDATE would drop the route it carried.
+	 */
+	if (ev && ev->route && route && ev->opcode == opcode) {
+		eigrp_topology_route_free(ev->route);
+		ev->route = route;
+		if (ev != eigrp->dual_tail) {
+			eigrp_dual_queue_remove(eigrp, ev);
+			eigrp_dual_queue_append(eigrp, ev);
+		}
+		if (ev != pe->dual) {
+			eigrp_dual_queue_prefix_remove(ev);
+			ev->pe_next = pe->dual;
+			pe->dual = ev;
+		}
+		stats->coalesced++;
+		return;
+	}
+
+	ev = eigrp_slab_obj_create(&eigrp->dual_slab);
+	ev->prefix = pe;
+	ev->nbr = nbr;
+	ev->route = route;
+	ev->opcode = opcode;
+	ev->queued = eigrp_dual_queue_now();
+
+	eigrp_dual_queue_append(eigrp, ev);
+	ev->pe_next = pe->dual;
+	pe->dual = ev;
+
+	nbr->dual_pending++;
+	stats->queued++;
+	if (++eigrp->dual_count > stats->peak)
+		stats->peak = eigrp->dual_count;
+
+	if (!eigrp->dual_scheduled) {
+		eigrp->dual_scheduled = true;
+		eigrp_work_queue_enqueue(eigrp->dual_queue, eigrp);
+	}
+}
+
+/*
+ * The interface a deleted neighbor was on is going away; its withdraws
+ * cannot wait for the next slice.
+ */
+void eigrp_dual_queue_drain(eigrp_instance_t *eigrp)
+{
+	eigrp_dual_event_t *ev;
+	uint32_t processed = 0;
+
+	while ((ev = eigrp->dual_head)) {
+		eigrp_dual_queue_unlink(eigrp, ev);
+		eigrp_dual_event_run(eigrp, ev);
+		eigrp_dual_event_free(ev);
+		processed++;
+	}
+
+	if (!processed)
+		return;
+
+	eigrp->dual_stats.processed += processed;
+	eigrp_packetizer_flush(eigrp, NULL);
+}
+
+void eigrp_dual_queue_prefix_purge(eigrp_instance_t *eigrp,
+				   eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_dual_event_t *ev;
+
+	while ((ev = pe->dual)) {
+		eigrp_dual_queue_unlink(eigrp, ev);
+		eigrp_dual_event_free(ev);
+		eigrp->dual_stats.dropped++;
+	}
+}
+
+/* The neighbor's routes are being withdrawn; what it said last no longer matters. */
+void eigrp_dual_queue_neighbor_down(eigrp_instance_t *eigrp,
+				    eigrp_neighbor_t *nbr)
+{
+	eigrp_dual_event_t *ev, *next;
+
+	for (ev = eigrp->dual_head; ev && nbr->dual_pending; ev = next) {
+		next = ev->next;
+		if (ev->nbr != nbr)
+			continue;
+
+		eigrp_dual_queue_unlink(eigrp, ev);
+		eigrp_dual_event_free(ev);
+		eigrp->dual_stats.dropped++;
+	}
+}
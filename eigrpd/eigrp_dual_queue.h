@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP DUAL input queue.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_DUAL_QUEUE_H
+#define _ZEBRA_EIGRP_DUAL_QUEUE_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern void eigrp_dual_queue_init(eigrp_instance_t *eigrp);
+extern void eigrp_dual_queue_fini(eigrp_instance_t *eigrp);
+
+/*
+ * hand a decoded TLV for an existing prefix to DUAL; takes the route.
+ * Neighbor down passes no route: an UPDATE withdraws the neighbor's
+ * route, a REPLY stands in for the reply it will never send.
+ */
+extern void eigrp_dual_queue_enqueue(eigrp_instance_t *eigrp,
+				     eigrp_neighbor_t *nbr,
+				     eigrp_prefix_descriptor_t *pe,
+				     eigrp_route_descriptor_t *route,
+				     uint8_t opcode);
+
+/* drop waiting input the prefix or neighbor took with it */
+extern void eigrp_dual_queue_prefix_purge(eigrp_instance_t *eigrp,
+					  eigrp_prefix_descriptor_t *pe);
+extern void eigrp_dual_queue_neighbor_down(eigrp_instance_t *eigrp,
+					   eigrp_neighbor_t *nbr);
+
+/* run everything waiting now, slices or not */
+extern void eigrp_dual_queue_drain(eigrp_instance_t *eigrp);
+
+#endif /* _ZEBRA_EIGRP_DUAL_QUEUE_H */
@@ -17,8 +17,14 @@
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_dump.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_snapshot.h"
+#include "eigrpd/eigrp_fsm.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_stub.h"
 
 #include "command.h"
+#include "json.h"
 
 /* Enable debug option variables -- valid only session. */
 unsigned long term_debug_eigrp = 0;
@@ -173,6 +179,10 @@ void show_ip_eigrp_interface_detail(struct vty *vty, eigrp_instance_t *eigrp,
 		"set");
 	vty_out(vty, "%-2s TLV peers: v1 %u, v2 %u\n", "",
 		ei->tlv1_peer_count, ei->tlv2_peer_count);
+	vty_out(vty, "%-2s Routes: %u, metric recomputes: %" PRIu64
+		" (%" PRIu64 " routes, last %u)\n", "",
+		ei->route_count, ei->recompute_runs, ei->recompute_routes,
+		ei->recompute_last);
 	vty_out(vty, "%-2s %s \n", "", "Use multicast");
 }
 
@@ -208,7 +218,680 @@ void show_ip_eigrp_neighbor_sub(struct vty *vty, eigrp_neighbor_t *nbr,
 		vty_out(vty, ", TLV version: %u", nbr->tlv_version);
 		vty_out(vty, ", Retrans: %lu, Retries: %lu",
 			nbr->retrans_queue->count, 0UL);
-		vty_out(vty, ", %s\n", eigrp_nbr_state_str(nbr));
+		vty_out(vty, ", %s", eigrp_nbr_state_str(nbr));
+		vty_out(vty, ", Slot %u, Replies owed %u", nbr->slot,
+			nbr->rij_pending);
+		if (nbr->bringup == EIGRP_BRINGUP_QUEUED)
+			vty_out(vty, ", waiting for sync slot");
+		else if (nbr->bringup == EIGRP_BRINGUP_ACTIVE)
+			vty_out(vty, ", initial sync");
+		vty_out(vty, "\n");
+		if (nbr->stub) {
+			char buf[64];
+
+			vty_out(vty, "    Stub Peer Advertising (%s) Routes\n",
+				eigrp_stub_str(nbr->stub, buf, sizeof(buf)));
+			vty_out(vty, "    Suppressing queries\n");
+		}
+	}
+}
+
+/*
+ * Print neighbor bring-up admission state and time-to-full-adjacency
+ * histogram for the instance.
+ */
+void eigrp_neighbor_bringup_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	static const uint32_t bounds[] = EIGRP_BRINGUP_HIST_BOUNDS;
+	eigrp_bringup_stats_t *stats = &eigrp->bringup_stats;
+	eigrp_interface_t *ei;
+	struct listnode *node;
+	char label[16];
+	size_t i;
+
+	vty_out(vty, "\nNeighbor bring-up: %u syncing (max %u), %u queued (peak %u)\n",
+		eigrp->bringup_active, eigrp->bringup_max,
+		listcount(eigrp->bringup_queue), stats->queue_peak);
+	vty_out(vty, "  Admitted %" PRIu64 ", deferred %" PRIu64
+		", completed %" PRIu64 ", aborted %" PRIu64 "\n",
+		stats->admitted, stats->deferred, stats->completed,
+		stats->aborted);
+
+	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei)) {
+		if (!ei->bringup_active && !ei->bringup_queued)
+			continue;
+		vty_out(vty, "  %-21s %u syncing (max %u), %u queued\n",
+			EIGRP_INTF_NAME(ei), ei->bringup_active,
+			ei->params.bringup_max, ei->bringup_queued);
+	}
+
+	vty_out(vty, "  Time to full adjacency:\n");
+	for (i = 0; i < EIGRP_BRINGUP_HIST_MAX; i++) {
+		if (i < array_size(bounds))
+			snprintf(label, sizeof(label), "< %us", bounds[i]);
+		else
+			snprintf(label, sizeof(label), ">= %us",
+				 bounds[array_size(bounds) - 1]);
+		vty_out(vty, "    %-8s %" PRIu64 "\n", label,
+			stats->adjacency_hist[i]);
+	}
+}
+
+/*
+ * Print the active timers: each ACTIVE prefix with how long it has been
+ * active and who it is still waiting on, then the SIA counters and the
+ * time-in-active histogram.
+ */
+void eigrp_active_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	static const uint32_t bounds[] = EIGRP_ACTIVE_HIST_BOUNDS;
+	eigrp_active_stats_t *stats = &eigrp->active_stats;
+	eigrp_prefix_descriptor_t *pe;
+	eigrp_active_t *active;
+	eigrp_neighbor_t *nbr;
+	uint64_t elapsed;
+	uint32_t slot;
+	char label[16];
+	size_t i;
+
+	if (eigrp->active_time)
+		vty_out(vty, "Active time %us, SIA-QUERY every %us\n",
+			eigrp->active_time, eigrp->active_time / 2);
+	else
+		vty_out(vty, "Active time disabled\n");
+	vty_out(vty, "  %u prefixes active\n", eigrp->active_count);
+
+	EIGRP_ACTIVE_FOREACH (eigrp, active) {
+		pe = active->prefix;
+		elapsed = eigrp_active_elapsed(active);
+		vty_out(vty, "  %-18s active %" PRIu64 ".%03" PRIu64
+			"s, SIA round %u, %u replies outstanding\n",
+			eigrp_print_prefix(eigrp_topology_prefix_dest(pe)),
+			elapsed / 1000, elapsed % 1000, active->sia_rounds,
+			eigrp_topology_rij_count(pe));
+		EIGRP_TOPOLOGY_RIJ_FOREACH (eigrp, pe, slot, nbr)
+			vty_out(vty, "    waiting on %s (slot %u)%s\n",
+				eigrp_print_addr(&nbr->src), slot,
+				eigrp_nbr_set_test(&active->sia_wait, slot)
+					? ", SIA-QUERY unanswered"
+					: "");
+	}
+
+	vty_out(vty, "  Went active %" PRIu64 ", stuck neighbors reset %" PRIu64
+		"\n", stats->entered, stats->stuck);
+	vty_out(vty, "  SIA-QUERY sent %" PRIu64 ", received %" PRIu64
+		"; SIA-REPLY sent %" PRIu64 ", received %" PRIu64 "\n",
+		stats->sia_queries_sent, stats->sia_queries_rcvd,
+		stats->sia_replies_sent, stats->sia_replies_rcvd);
+
+	vty_out(vty, "  Time in active:\n");
+	for (i = 0; i < EIGRP_ACTIVE_HIST_MAX; i++) {
+		if (i < array_size(bounds))
+			snprintf(label, sizeof(label), "< %ums", bounds[i]);
+		else
+			snprintf(label, sizeof(label), ">= %ums",
+				 bounds[array_size(bounds) - 1]);
+		vty_out(vty, "    %-10s %" PRIu64 "\n", label,
+			stats->active_hist[i]);
+	}
+}
+
+static void eigrp_topology_dirty_dump(struct vty *vty, const char *name,
+				      eigrp_dirty_queue_t *queue)
+{
+	vty_out(vty, "  %s queue: %u prefixes (peak %u), %" PRIu64
+		" queued, %" PRIu64 " duplicates suppressed\n",
+		name, queue->count, queue->peak, queue->queued,
+		queue->suppressed);
+}
+
+/* Input waiting for DUAL and how long it waited */
+static void eigrp_dual_queue_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_dual_queue_stats_t *stats = &eigrp->dual_stats;
+
+	vty_out(vty, "  DUAL input: %u queued, peak %u; %" PRIu64
+		" events, %" PRIu64 " coalesced, %" PRIu64 " dropped\n",
+		eigrp->dual_count, stats->peak, stats->queued,
+		stats->coalesced, stats->dropped);
+	vty_out(vty, "    runs: %" PRIu64 ", %" PRIu64
+		" yielded; last %u events in %u usec\n",
+		stats->runs, stats->yields, stats->last_processed,
+		stats->last_usec);
+	vty_out(vty, "    latency: %" PRIu64 " usec average, %u usec max\n",
+		stats->processed ? stats->latency_usec / stats->processed : 0,
+		stats->latency_max_usec);
+}
+
+/*
+ * Neighbors queried per lost prefix, the cost stub routing and interface
+ * summaries bound
+ */
+static void eigrp_query_scope_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_query_stats_t *stats = &eigrp->query_stats;
+	eigrp_summary_t *sum;
+	struct route_node *rn;
+	uint64_t hundredths = 0;
+	uint32_t components = 0;
+	char buf[64];
+
+	if (stats->prefixes)
+		hundredths = stats->neighbors * 100 / stats->prefixes;
+
+	vty_out(vty, "  Query scope: %" PRIu64 " prefixes, %" PRIu64
+		" neighbors queried, %" PRIu64 ".%02" PRIu64 " per prefix\n",
+		stats->prefixes, stats->neighbors, hundredths / 100,
+		hundredths % 100);
+	vty_out(vty, "    last prefix: %u neighbors; %" PRIu64
+		" stub neighbors not queried\n",
+		stats->last_neighbors, stats->stub_skipped);
+	if (eigrp->stub)
+		vty_out(vty, "    stub router: %s\n",
+			eigrp_stub_str(eigrp->stub, buf, sizeof(buf)));
+	if (!eigrp->summary_count)
+		return;
+
+	for (rn = route_top(eigrp->summaries); rn; rn = route_next(rn))
+		if ((sum = rn->info))
+			components += sum->components;
+	vty_out(vty, "    summaries: %u covering %u components; %" PRIu64
+		" queries answered at the boundary\n",
+		eigrp->summary_count, components,
+		eigrp->summary_boundary_replies);
+}
+
+/* Work merged before it ran, and TLVs packed per packet by opcode */
+static void eigrp_packetizer_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	static const uint8_t opcodes[] = {
+		EIGRP_OPC_UPDATE, EIGRP_OPC_QUERY, EIGRP_OPC_REPLY,
+		EIGRP_OPC_SIAQUERY, EIGRP_OPC_SIAREPLY,
+	};
+	eigrp_packetizer_queue_stats_t *queue = &eigrp->packetizer_queue_stats;
+	eigrp_packetizer_stats_t *stats;
+	uint64_t hundredths, fill;
+	uint32_t i;
+
+	vty_out(vty, "  Packetizer: %" PRIu64 " work items queued, %" PRIu64
+		" chained, %" PRIu64 " coalesced (%" PRIu64
+		" upgraded), %" PRIu64 " dropped\n",
+		queue->enqueued, queue->chained, queue->coalesced,
+		queue->upgraded, queue->dropped);
+	for (i = 0; i < array_size(opcodes); i++) {
+		stats = &eigrp->packetizer_stats[opcodes[i]];
+		hundredths = stats->packets ? stats->tlvs * 100 / stats->packets
+					    : 0;
+		fill = stats->room ? stats->bytes * 100 / stats->room : 0;
+		vty_out(vty, "    %-10s %" PRIu64 " packets, %" PRIu64
+			" TLVs, %" PRIu64 ".%02" PRIu64
+			" per packet, most %u, %" PRIu64 "%% full\n",
+			lookup_msg(eigrp_packet_type_str, opcodes[i], NULL),
+			stats->packets, stats->tlvs, hundredths / 100,
+			hundredths % 100, stats->max_tlvs, fill);
+	}
+}
+
+static void eigrp_tlv_cache_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_tlv_cache_stats_t *stats = &eigrp->tlv_cache_stats;
+
+	vty_out(vty, "  Route TLVs: %" PRIu64 " copied from cache, %" PRIu64
+		" encoded, %" PRIu64 " not cached\n",
+		stats->hits, stats->misses, stats->uncached);
+	vty_out(vty, "    full-table updates: %" PRIu64 ", %" PRIu64
+		" TLVs, %" PRIu64 " usec per update, most %u usec\n",
+		stats->dumps, stats->dump_tlvs,
+		stats->dumps ? stats->dump_usec / stats->dumps : 0,
+		stats->max_dump_usec);
+	vty_out(vty, "    last update: %u TLVs, %u usec\n",
+		stats->last_dump_tlvs, stats->last_dump_usec);
+}
+
+static void eigrp_rib_queue_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_rib_queue_stats_t *stats = &eigrp->rib_stats;
+	uint64_t sent = stats->installs + stats->withdraws;
+
+	vty_out(vty, "  RIB changes: %u queued, peak %u; %" PRIu64
+		" requests, %" PRIu64 " coalesced%s\n",
+		eigrp->rib_count, stats->peak, stats->requests,
+		stats->coalesced, eigrp->t_rib_flush ? ", pending" : "");
+	vty_out(vty, "    sent: %" PRIu64 " installs, %" PRIu64
+		" withdraws in %" PRIu64 " batches, last %u\n",
+		stats->installs, stats->withdraws, stats->flushes,
+		stats->last_batch);
+	vty_out(vty, "    latency: %" PRIu64 " usec average, %u usec max\n",
+		sent ? stats->latency_usec / sent : 0, stats->latency_max_usec);
+}
+
+static void eigrp_filter_cache_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_filter_cache_stats_t *stats = &eigrp->filter_cache_stats;
+
+	vty_out(vty, "  Filter verdicts: %" PRIu64 " cached, %" PRIu64
+		" evaluated, generation %u, %" PRIu64 " flushes\n",
+		stats->hits, stats->misses, eigrp->filter_gen, stats->flushes);
+}
+
+void eigrp_topology_summary_dump(struct vty *vty, eigrp_instance_t *eigrp)
+{
+	eigrp_prefix_descriptor_t *pe;
+	struct route_node *rn;
+	uint32_t prefixes = 0, routes = 0, active = 0;
+
+	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
+		pe = rn->info;
+		if (!pe)
+			continue;
+
+		prefixes++;
+		routes += pe->routes.count;
+		if (pe->state != EIGRP_FSM_STATE_PASSIVE)
+			active++;
+	}
+
+	vty_out(vty, "\nEIGRP Topology Summary for AS(%d)/ID(%s)\n\n",
+		eigrp->AS, eigrp_print_routerid(eigrp->router_id));
+	vty_out(vty, "  %u prefixes, %u routes, %u active\n", prefixes, routes,
+		active);
+	eigrp_topology_dirty_dump(vty, "Update",
+				  &eigrp->dirty[EIGRP_DIRTY_UPDATE]);
+	eigrp_topology_dirty_dump(vty, "Query", &eigrp->dirty[EIGRP_DIRTY_QUERY]);
+	eigrp_dual_queue_dump(vty, eigrp);
+	vty_out(vty, "  DUAL output: %" PRIu64 " flushes for %" PRIu64
+		" requests, delay %u msec%s\n",
+		eigrp->flush_stats.flushes, eigrp->flush_stats.requests,
+		eigrp->dual_flush_delay, eigrp->t_dual_flush ? ", pending" : "");
+	vty_out(vty, "    batches: %" PRIu64 " updates, %" PRIu64
+		" queries; last %u/%u, largest %u/%u\n",
+		eigrp->flush_stats.updates, eigrp->flush_stats.queries,
+		eigrp->flush_stats.last_updates, eigrp->flush_stats.last_queries,
+		eigrp->flush_stats.max_updates, eigrp->flush_stats.max_queries);
+	eigrp_query_scope_dump(vty, eigrp);
+	eigrp_packetizer_dump(vty, eigrp);
+	eigrp_tlv_cache_dump(vty, eigrp);
+	eigrp_filter_cache_dump(vty, eigrp);
+	eigrp_rib_queue_dump(vty, eigrp);
+	vty_out(vty, "  Metric recompute: %" PRIu64 " runs, %" PRIu64
+		" routes, %" PRIu64 " prefixes to DUAL\n",
+		eigrp->recompute.runs, eigrp->recompute.routes,
+		eigrp->recompute.prefixes);
+	vty_out(vty, "    last run: %u routes, %u prefixes to DUAL, %u usec\n",
+		eigrp->recompute.last_routes, eigrp->recompute.last_prefixes,
+		eigrp->recompute.last_usec);
+	vty_out(vty, "  Snapshots: %" PRIu64 " copies (%" PRIu64
+		" in %" PRIu64 " chunks, %" PRIu64 " restarted), %" PRIu64
+		" reused, %s\n",
+		eigrp->snapshot_stats.copies, eigrp->snapshot_stats.background,
+		eigrp->snapshot_stats.chunks, eigrp->snapshot_stats.abandoned,
+		eigrp->snapshot_stats.reused,
+		eigrp_snapshot_current(eigrp, eigrp->snapshot) ? "current"
+							       : "stale");
+	vty_out(vty, "    last copy: %u prefixes, %u routes, %u usec\n",
+		eigrp->snapshot_stats.last_prefixes,
+		eigrp->snapshot_stats.last_routes,
+		eigrp->snapshot_stats.last_usec);
+}
+
+static void eigrp_slab_dump(struct vty *vty, eigrp_slab_t *slab,
+			    json_object *json)
+{
+	json_object *json_slab;
+
+	if (json) {
+		json_slab = json_object_new_object();
+		json_object_int_add(json_slab, "size", slab->size);
+		json_object_int_add(json_slab, "live", slab->live);
+		json_object_int_add(json_slab, "free", slab->free);
+		json_object_int_add(json_slab, "peak", slab->live_peak);
+		json_object_int_add(json_slab, "slabs", slab->chunks);
+		json_object_int_add(json_slab, "released", slab->released);
+		json_object_int_add(json_slab, "bytes", eigrp_slab_bytes(slab));
+		json_object_object_add(json, slab->name, json_slab);
+		return;
+	}
+
+	vty_out(vty, "  %-16s %6u %10u %10u %10u %8u %10zu\n", slab->name,
+		slab->size, slab->live, slab->free, slab->live_peak,
+		slab->chunks, eigrp_slab_bytes(slab));
+}
+
+static json_object *eigrp_packet_queue_json(eigrp_packet_queue_t *queue)
+{
+	json_object *json_queue = json_object_new_object();
+
+	json_object_int_add(json_queue, "packets", queue->count);
+	json_object_int_add(json_queue, "bytes", queue->bytes);
+	json_object_int_add(json_queue, "packetsPeak", queue->count_peak);
+	json_object_int_add(json_queue, "bytesPeak", queue->bytes_peak);
+	return json_queue;
+}
+
+/*
+ * Heap the topology holds outside its slabs: route vectors that spilled
+ * to the heap and reply lists of ACTIVE prefixes.  Needs a table walk, so
+ * only the detail output pays for it.
+ */
+static size_t eigrp_topology_side_bytes(eigrp_instance_t *eigrp)
+{
+	eigrp_prefix_descriptor_t *pe;
+	struct route_node *rn;
+	size_t bytes = 0;
+
+	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
+		pe = rn->info;
+		if (!pe)
+			continue;
+
+		if (pe->routes.size > EIGRP_ROUTE_VEC_INLINE)
+			bytes += pe->routes.size * sizeof(*pe->routes.heap);
+		if (pe->feasible.size > EIGRP_ROUTE_VEC_INLINE)
+			bytes += pe->feasible.size * sizeof(*pe->feasible.heap);
+		bytes += pe->rij.nwords * sizeof(*pe->rij.heap);
+	}
+
+	return bytes;
+}
+
+static void eigrp_memory_intf_dump(struct vty *vty, eigrp_interface_t *ei,
+				   json_object *json)
+{
+	json_object *json_intf;
+
+	if (json) {
+		json_intf = json_object_new_object();
+		json_object_int_add(json_intf, "routes", ei->route_count);
+		json_object_int_add(json_intf, "routesPeak", ei->route_peak);
+		json_object_int_add(json_intf, "neighbors", listcount(ei->nbrs));
+		json_object_object_add(json_intf, "outputQueue",
+				       eigrp_packet_queue_json(ei->obuf));
+		json_object_object_add(json, EIGRP_INTF_NAME(ei), json_intf);
+		return;
+	}
+
+	vty_out(vty, "  %-16s %8u %8u %6lu %10zu %6lu %10zu\n",
+		EIGRP_INTF_NAME(ei), ei->route_count, ei->route_peak,
+		ei->obuf->count, ei->obuf->bytes, ei->obuf->count_peak,
+		ei->obuf->bytes_peak);
+}
+
+static void eigrp_memory_nbr_dump(struct vty *vty, eigrp_neighbor_t *nbr,
+				  json_object *json)
+{
+	json_object *json_nbr;
+
+	if (json) {
+		json_nbr = json_object_new_object();
+		json_object_string_add(json_nbr, "address",
+				       eigrp_print_addr(&nbr->src));
+		json_object_string_add(json_nbr, "interface",
+				       EIGRP_INTF_NAME(nbr->ei));
+		json_object_int_add(json_nbr, "routes", nbr->route_count);
+		json_object_int_add(json_nbr, "routesPeak", nbr->route_peak);
+		json_object_object_add(json_nbr, "retransmitQueue",
+				       eigrp_packet_queue_json(nbr->retrans_queue));
+		json_object_object_add(json_nbr, "multicastQueue",
+				       eigrp_packet_queue_json(nbr->multicast_queue));
+		json_object_array_add(json, json_nbr);
+		return;
+	}
+
+	vty_out(vty, "  %-16s %-12s %8u %8u %6lu %10zu %6lu %10zu\n",
+		eigrp_print_addr(&nbr->src), EIGRP_INTF_NAME(nbr->ei),
+		nbr->route_count, nbr->route_peak,
+		nbr->retrans_queue->count + nbr->multicast_queue->count,
+		nbr->retrans_queue->bytes + nbr->multicast_queue->bytes,
+		nbr->retrans_queue->count_peak, nbr->retrans_queue->bytes_peak);
+}
+
+/*
+ * Where the instance memory goes: object slabs, topology bytes per prefix,
+ * snapshots, queued packetizer work and the packet queues of interfaces
+ * and neighbors, with high-water marks.  detail breaks the queues down per
+ * interface and neighbor.
+ */
+void eigrp_memory_dump(struct vty *vty, eigrp_instance_t *eigrp, bool detail,
+		       json_object *json)
+{
+	json_object *json_eigrp = NULL, *json_obj = NULL, *json_list = NULL;
+	eigrp_interface_t *ei;
+	eigrp_neighbor_t *nbr;
+	struct listnode *node, *node2;
+	unsigned long out_packets = 0, rexmit_packets = 0;
+	size_t out_bytes = 0, rexmit_bytes = 0, rexmit_peak = 0;
+	size_t topology, side = 0, snapshot;
+	uint32_t prefixes, nbrs = 0;
+	char key[8];
+
+	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei)) {
+		out_packets += ei->obuf->count;
+		out_bytes += ei->obuf->bytes;
+		for (ALL_LIST_ELEMENTS_RO(ei->nbrs, node2, nbr)) {
+			nbrs++;
+			rexmit_packets += nbr->retrans_queue->count
+					  + nbr->multicast_queue->count;
+			rexmit_bytes += nbr->retrans_queue->bytes
+					+ nbr->multicast_queue->bytes;
+			if (nbr->retrans_queue->bytes_peak > rexmit_peak)
+				rexmit_peak = nbr->retrans_queue->bytes_peak;
+		}
+	}
+
+	prefixes = eigrp->prefix_slab.live;
+	if (detail)
+		side = eigrp_topology_side_bytes(eigrp);
+	topology = eigrp_slab_bytes(&eigrp->prefix_slab)
+		   + eigrp_slab_bytes(&eigrp->route_slab) + side;
+	snapshot = eigrp_snapshot_bytes(eigrp->snapshot)
+		   + eigrp_snapshot_bytes(eigrp->snapshot_build);
+
+	if (json) {
+		json_eigrp = json_object_new_object();
+		json_object_string_add(json_eigrp, "routerId",
+				       eigrp_print_routerid(eigrp->router_id));
+
+		json_obj = json_object_new_object();
+		eigrp_slab_dump(vty, &eigrp->prefix_slab, json_obj);
+		eigrp_slab_dump(vty, &eigrp->route_slab, json_obj);
+		eigrp_slab_dump(vty, &eigrp->work_slab, json_obj);
+		eigrp_slab_dump(vty, &eigrp->dual_slab, json_obj);
+		eigrp_slab_dump(vty, &eigrp->rib_slab, json_obj);
+		json_object_object_add(json_eigrp, "slabs", json_obj);
+
+		json_obj = json_object_new_object();
+		json_object_int_add(json_obj, "prefixes", prefixes);
+		json_object_int_add(json_obj, "routes", eigrp->route_slab.live);
+		json_object_int_add(json_obj, "bytes", topology);
+		json_object_int_add(json_obj, "bytesPerPrefix",
+				    prefixes ? topology / prefixes : 0);
+		if (detail)
+			json_object_int_add(json_obj, "sideBytes", side);
+		json_object_object_add(json_eigrp, "topology", json_obj);
+
+		json_object_int_add(json_eigrp, "snapshotBytes", snapshot);
+
+		json_obj = json_object_new_object();
+		json_object_int_add(json_obj, "queued", eigrp->work_slab.live);
+		json_object_int_add(json_obj, "queuedPeak",
+				    eigrp->work_slab.live_peak);
+		json_object_object_add(json_eigrp, "packetizerWork", json_obj);
+
+		json_obj = json_object_new_object();
+		json_object_int_add(json_obj, "packets", out_packets);
+		json_object_int_add(json_obj, "bytes", out_bytes);
+		json_object_object_add(json_eigrp, "outputQueues", json_obj);
+
+		json_obj = json_object_new_object();
+		json_object_int_add(json_obj, "packets", rexmit_packets);
+		json_object_int_add(json_obj, "bytes", rexmit_bytes);
+		json_object_int_add(json_obj, "neighborBytesPeak", rexmit_peak);
+		json_object_object_add(json_eigrp, "retransmitQueues", json_obj);
+	} else {
+		vty_out(vty, "\nEIGRP memory for AS(%d)/ID(%s)\n\n", eigrp->AS,
+			eigrp_print_routerid(eigrp->router_id));
+		vty_out(vty, "  %-16s %6s %10s %10s %10s %8s %10s\n", "Object",
+			"Size", "Live", "Free", "Peak", "Slabs", "Bytes");
+		eigrp_slab_dump(vty, &eigrp->prefix_slab, NULL);
+		eigrp_slab_dump(vty, &eigrp->route_slab, NULL);
+		eigrp_slab_dump(vty, &eigrp->work_slab, NULL);
+		eigrp_slab_dump(vty, &eigrp->dual_slab, NULL);
+		eigrp_slab_dump(vty, &eigrp->rib_slab, NULL);
+		vty_out(vty, "  Slabs released: prefix %" PRIu64
+			", route %" PRIu64 ", packetizer work %" PRIu64
+			", DUAL input %" PRIu64 ", RIB change %" PRIu64 "\n",
+			eigrp->prefix_slab.released, eigrp->route_slab.released,
+			eigrp->work_slab.released, eigrp->dual_slab.released,
+			eigrp->rib_slab.released);
+
+		vty_out(vty, "\n  Topology: %u prefixes, %u routes, %zu bytes, %zu bytes/prefix%s\n",
+			prefixes, eigrp->route_slab.live, topology,
+			prefixes ? topology / prefixes : 0,
+			detail ? "" : " (slabs only)");
+		vty_out(vty, "  Snapshots: %zu bytes\n", snapshot);
+		vty_out(vty, "  Packetizer work: %u queued, peak %u\n",
+			eigrp->work_slab.live, eigrp->work_slab.live_peak);
+		vty_out(vty, "  Output queues: %lu packets, %zu bytes\n",
+			out_packets, out_bytes);
+		vty_out(vty, "  Retransmit queues: %lu packets, %zu bytes, %u neighbors, neighbor peak %zu bytes\n",
+			rexmit_packets, rexmit_bytes, nbrs, rexmit_peak);
+	}
+
+	if (detail) {
+		if (json)
+			json_obj = json_object_new_object();
+		else
+			vty_out(vty, "\n  %-16s %8s %8s %6s %10s %6s %10s\n",
+				"Interface", "Routes", "Peak", "OutQ", "Bytes",
+				"PeakQ", "PeakBytes");
+		for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei))
+			eigrp_memory_intf_dump(vty, ei, json_obj);
+		if (json)
+			json_object_object_add(json_eigrp, "interfaces",
+					       json_obj);
+
+		if (json)
+			json_list = json_object_new_array();
+		else
+			vty_out(vty, "\n  %-16s %-12s %8s %8s %6s %10s %6s %10s\n",
+				"Neighbor", "Interface", "Routes", "Peak",
+				"ReXmtQ", "Bytes", "PeakQ", "PeakBytes");
+		for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei))
+			for (ALL_LIST_ELEMENTS_RO(ei->nbrs, node2, nbr))
+				eigrp_memory_nbr_dump(vty, nbr, json_list);
+		if (json)
+			json_object_object_add(json_eigrp, "neighbors",
+					       json_list);
+		else
+			vty_out(vty, "  %-16s %-12s %8u %8u\n", "Connected", "-",
+				eigrp->neighbor_self->route_count,
+				eigrp->neighbor_self->route_peak);
+	}
+
+	if (json) {
+		snprintf(key, sizeof(key), "%u", eigrp->AS);
+		json_object_object_add(json, key, json_eigrp);
+	}
+}
+
+static void eigrp_fsm_trace_entry_dump(struct vty *vty,
+				       eigrp_fsm_trace_entry_t *entry,
+				       uint64_t now, json_object *json)
+{
+	json_object *json_entry;
+	uint64_t age = now > entry->usec ? now - entry->usec : 0;
+	char dest[PREFIX_STRLEN];
+
+	snprintf(dest, sizeof(dest), "%s/%u", inet_ntoa(entry->dest),
+		 entry->prefixlen);
+
+	if (json) {
+		json_entry = json_object_new_object();
+		json_object_int_add(json_entry, "ageUsec", age);
+		json_object_string_add(json_entry, "prefix", dest);
+		json_object_string_add(json_entry, "neighbor",
+				       eigrp_print_addr(&entry->nbr));
+		json_object_string_add(json_entry, "packetType",
+				       eigrp_fsm_packet_type2str(entry->packet_type));
+		json_object_string_add(json_entry, "event",
+				       eigrp_fsm_event2str(entry->event));
+		json_object_string_add(json_entry, "oldState",
+				       eigrp_fsm_state2str(entry->old_state));
+		json_object_string_add(json_entry, "newState",
+				       eigrp_fsm_state2str(entry->new_state));
+		json_object_string_add(json_entry, "change",
+				       eigrp_fsm_change2str(entry->change));
+		json_object_int_add(json_entry, "replies", entry->replies);
+		json_object_array_add(json, json_entry);
+		return;
+	}
+
+	vty_out(vty, "  %6" PRIu64 ".%03u %-18s %-15s %-9s %-11s -> %-11s %4u  %s\n",
+		age / 1000000, (unsigned int)(age % 1000000) / 1000, dest,
+		eigrp_print_addr(&entry->nbr),
+		eigrp_fsm_packet_type2str(entry->packet_type),
+		eigrp_fsm_state2str(entry->old_state),
+		eigrp_fsm_state2str(entry->new_state), entry->replies,
+		eigrp_fsm_event2str(entry->event));
+}
+
+/*
+ * The DUAL event ring, newest first: every event, or those of one prefix,
+ * at most last of them (0 for the whole ring).
+ */
+void eigrp_fsm_trace_dump(struct vty *vty, eigrp_instance_t *eigrp,
+			  const struct prefix_ipv4 *prefix, uint32_t last,
+			  json_object *json)
+{
+	eigrp_fsm_trace_t *trace = eigrp->fsm_trace;
+	eigrp_fsm_trace_entry_t *entry;
+	json_object *json_eigrp = NULL, *json_list = NULL;
+	struct timeval tv;
+	uint64_t now, seq, oldest;
+	uint32_t shown = 0;
+	char key[8];
+
+	if (!trace)
+		return;
+
+	monotime(&tv);
+	now = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+	oldest = trace->head > EIGRP_FSM_TRACE_SIZE
+			 ? trace->head - EIGRP_FSM_TRACE_SIZE
+			 : 0;
+
+	if (json) {
+		json_eigrp = json_object_new_object();
+		json_object_int_add(json_eigrp, "recorded", trace->head);
+		json_list = json_object_new_array();
+	} else {
+		vty_out(vty, "\nEIGRP DUAL events for AS(%d)/ID(%s), %" PRIu64
+			" recorded\n\n",
+			eigrp->AS, eigrp_print_routerid(eigrp->router_id),
+			trace->head);
+		vty_out(vty, "  %10s %-18s %-15s %-9s %-11s    %-11s %4s  %s\n",
+			"Age(s)", "Prefix", "Neighbor", "Packet", "State", "New",
+			"Rij", "Event");
+	}
+
+	for (seq = trace->head; seq > oldest; seq--) {
+		if (last && shown >= last)
+			break;
+
+		entry = &trace->entry[(seq - 1) & (EIGRP_FSM_TRACE_SIZE - 1)];
+		if (prefix
+		    && (entry->prefixlen != prefix->prefixlen
+			|| entry->dest.s_addr != prefix->prefix.s_addr))
+			continue;
+
+		eigrp_fsm_trace_entry_dump(vty, entry, now, json_list);
+		shown++;
+	}
+
+	if (json) {
+		json_object_object_add(json_eigrp, "events", json_list);
+		snprintf(key, sizeof(key), "%u", eigrp->AS);
+		json_object_object_add(json, key, json_eigrp);
 	}
 }
 
@@ -225,41 +908,42 @@ void show_ip_eigrp_topology_header(struct vty *vty, eigrp_instance_t *eigrp)
 }
 
 void show_ip_eigrp_prefix_descriptor(struct vty *vty,
-				     eigrp_prefix_descriptor_t *tn)
+				     eigrp_snapshot_prefix_t *sp)
 {
-	struct list *successors = eigrp_topology_get_successor(tn);
 	char buffer[PREFIX_STRLEN];
 
-	vty_out(vty, "%-3c", (tn->state > 0) ? 'A' : 'P');
+	vty_out(vty, "%-3c", (sp->state > 0) ? 'A' : 'P');
 
 	vty_out(vty, "%s, ",
-		prefix2str(tn->destination, buffer, PREFIX_STRLEN));
-	vty_out(vty, "%u successors, ", (successors) ? successors->count : 0);
-	vty_out(vty, "FD is %u, serno: %" PRIu64 " \n", tn->fdistance,
-		tn->serno);
-
-	if (successors)
-		list_delete(&successors);
+		prefix2str((struct prefix *)&sp->dest, buffer,
+			   PREFIX_STRLEN));
+	vty_out(vty, "%u successors, ", sp->nsuccessor);
+	vty_out(vty, "FD is %u, serno: %" PRIu64 " \n", sp->fdistance,
+		sp->serno);
 }
 
 void show_ip_eigrp_route_descriptor(struct vty *vty, eigrp_instance_t *eigrp,
-				    eigrp_route_descriptor_t *te, bool *first)
+				    eigrp_snapshot_prefix_t *sp,
+				    eigrp_snapshot_route_t *sr, bool *first)
 {
-	if (te->reported_distance == EIGRP_MAX_METRIC)
+	const char *ifname;
+
+	if (sr->reported_distance == EIGRP_MAX_METRIC)
 		return;
 
 	if (*first) {
-		show_ip_eigrp_prefix_descriptor(vty, te->prefix);
+		show_ip_eigrp_prefix_descriptor(vty, sp);
 		*first = false;
 	}
 
-	if (te->adv_router == eigrp->neighbor_self)
-		vty_out(vty, "%-7s%s, %s\n", " ", "via Connected",
-			EIGRP_INTF_NAME(te->ei));
+	ifname = sr->ifindex ? ifindex2ifname(sr->ifindex, eigrp->vrf_id)
+			     : "inactive";
+	if (sr->connected)
+		vty_out(vty, "%-7s%s, %s\n", " ", "via Connected", ifname);
 	else {
 		vty_out(vty, "%-7s%s%s (%u/%u), %s\n", " ", "via ",
-			eigrp_print_addr(&te->adv_router->src), te->distance,
-			te->reported_distance, EIGRP_INTF_NAME(te->ei));
+			eigrp_print_addr(&sr->nexthop), sr->distance,
+			sr->reported_distance, ifname);
 	}
 }
 
@@ -139,10 +139,19 @@ extern void show_ip_eigrp_interface_detail(struct vty *, eigrp_instance_t *,
 extern void show_ip_eigrp_interface_sub(struct vty *, eigrp_instance_t *,
 					eigrp_interface_t *);
 extern void show_ip_eigrp_neighbor_sub(struct vty *, eigrp_neighbor_t *, int);
+extern void eigrp_neighbor_bringup_dump(struct vty *, eigrp_instance_t *);
+extern void eigrp_active_dump(struct vty *, eigrp_instance_t *);
+extern void eigrp_fsm_trace_dump(struct vty *, eigrp_instance_t *,
+				 const struct prefix_ipv4 *prefix,
+				 uint32_t last, struct json_object *json);
+extern void eigrp_memory_dump(struct vty *, eigrp_instance_t *, bool detail,
+			      struct json_object *json);
+extern void eigrp_topology_summary_dump(struct vty *, eigrp_instance_t *);
 extern void show_ip_eigrp_prefix_descriptor(struct vty *,
-					    eigrp_prefix_descriptor_t *);
+					    eigrp_snapshot_prefix_t *);
 extern void show_ip_eigrp_route_descriptor(struct vty *vty, eigrp_instance_t *,
-					   eigrp_route_descriptor_t *,
+					   eigrp_snapshot_prefix_t *,
+					   eigrp_snapshot_route_t *,
 					   bool *first);
 
 extern void eigrp_debug_init(void);
@@ -17,6 +17,7 @@
 #include "eigrpd/eigrp_structs.h"
 #include "eigrpd/eigrp_const.h"
 #include "eigrpd/eigrp_filter.h"
+#include "eigrpd/eigrp_filter_cache.h"
 #include "eigrpd/eigrp_packet.h"
 
 #include "plist.h"
@@ -36,6 +37,9 @@ void eigrp_distribute_update(struct distribute_ctx *ctx,
 	struct prefix_list *plist;
 	// struct route_map *routemap;
 
+	/* whichever lists change below, the cached verdicts are stale */
+	eigrp_filter_cache_flush(eigrp);
+
 	/* if no interface address is present, set list to eigrp process struct
 	 */
 
@@ -235,6 +239,9 @@ void eigrp_distribute_update_all(struct prefix_list *notused)
 	RB_FOREACH (vrf, vrf_name_head, &vrfs_by_name) {
 		eigrp = eigrp_lookup(vrf->vrf_id);
 		if (eigrp) {
+			/* the list may be bound to the instance, or unchanged
+			 * in name under an interface: retire all verdicts */
+			eigrp_filter_cache_flush(eigrp);
 			FOR_ALL_INTERFACES (vrf, ifp) {
 				eigrp_distribute_update_interface(eigrp, ifp);
 			}
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix distribute-list verdict cache.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Outbound filtering used to run the instance and the interface access
+ * and prefix lists for every prefix, on every interface, in every UPDATE
+ * build, full-table dump and GR chunk.  With long lists on many
+ * interfaces that was most of the cost of a dump, and the answers only
+ * change when the lists do.
+ *
+ * So each prefix keeps the verdicts it got: one entry for the instance
+ * lists, shared by every interface, and one per interface slot for the
+ * lists bound to that interface, both directions.  The verdicts hold for
+ * one filter generation.  A distribute-list change, or any edit of an
+ * access or prefix list, moves eigrp->filter_gen on, and a prefix whose
+ * cache is from an older generation starts over.  A list is evaluated at
+ * most once per prefix per generation.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_filter_cache.h"
+
+#include "plist.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_FILTER_CACHE, "EIGRP filter verdict cache");
+
+/* verdict bits, per direction */
+#define EIGRP_FILTER_CACHE_KNOWN(dir) (0x01 << ((dir) * 2))
+#define EIGRP_FILTER_CACHE_DENY(dir) (0x02 << ((dir) * 2))
+
+/* slot 0 is the instance lists */
+#define EIGRP_FILTER_CACHE_INSTANCE 0
+
+struct eigrp_filter_cache {
+	uint32_t gen;	  /* eigrp->filter_gen the verdicts are from */
+	uint32_t slots;	  /* entries in verdict[] */
+	uint8_t verdict[]; /* by slot */
+};
+
+static bool eigrp_filter_cache_deny(struct access_list *alist,
+				    struct prefix_list *plist,
+				    struct prefix *prefix)
+{
+	if (alist && access_list_apply(alist, prefix) == FILTER_DENY)
+		return true;
+
+	if (plist && prefix_list_apply(plist, prefix) == PREFIX_DENY)
+		return true;
+
+	return false;
+}
+
+/* pe's cache for this generation, with room for slot */
+static eigrp_filter_cache_t *eigrp_filter_cache_get(eigrp_instance_t *eigrp,
+						    eigrp_prefix_descriptor_t *pe,
+						    uint32_t slot)
+{
+	eigrp_filter_cache_t *cache = pe->filter_cache;
+	uint32_t slots = eigrp->filter_slots;
+
+	if (slots <= slot)
+		slots = slot + 1;
+
+	if (!cache) {
+		cache = XCALLOC(MTYPE_EIGRP_FILTER_CACHE, sizeof(*cache) + slots);
+		cache->gen = eigrp->filter_gen;
+		cache->slots = slots;
+		pe->filter_cache = cache;
+	} else if (cache->slots < slots) {
+		cache = XREALLOC(MTYPE_EIGRP_FILTER_CACHE, cache,
+				 sizeof(*cache) + slots);
+		memset(cache->verdict + cache->slots, 0, slots - cache->slots);
+		cache->slots = slots;
+		pe->filter_cache = cache;
+	}
+
+	if (cache->gen != eigrp->filter_gen) {
+		memset(cache->verdict, 0, cache->slots);
+		cache->gen = eigrp->filter_gen;
+	}
+
+	return cache;
+}
+
+static bool eigrp_filter_cache_verdict(eigrp_instance_t *eigrp,
+				       eigrp_filter_cache_t *cache,
+				       uint32_t slot, int dir,
+				       struct access_list *alist,
+				       struct prefix_list *plist,
+				       struct prefix *prefix)
+{
+	uint8_t *verdict = &cache->verdict[slot];
+	bool deny;
+
+	if (*verdict & EIGRP_FILTER_CACHE_KNOWN(dir)) {
+		eigrp->filter_cache_stats.hits++;
+		return *verdict & EIGRP_FILTER_CACHE_DENY(dir);
+	}
+
+	eigrp->filter_cache_stats.misses++;
+	deny = eigrp_filter_cache_deny(alist, plist, prefix);
+	*verdict |= EIGRP_FILTER_CACHE_KNOWN(dir);
+	if (deny)
+		*verdict |= EIGRP_FILTER_CACHE_DENY(dir);
+	return deny;
+}
+
+bool eigrp_filter_cache_apply(eigrp_instance_t *eigrp, eigrp_interface_t *ei,
+			      int dir, eigrp_prefix_descriptor_t *pe)
+{
+	bool instance = eigrp->list[dir] || eigrp->prefix[dir];
+	bool intf = ei->list[dir] || ei->prefix[dir];
+	eigrp_filter_cache_t *cache;
+	struct prefix *prefix;
+
+	/* nothing bound, nothing to remember */
+	if (!instance && !intf)
+		return false;
+
+	/* an interface without a slot would read the instance verdicts */
+	if (!ei->filter_slot)
+		return eigrp_filter_cache_deny(eigrp->list[dir],
+					       eigrp->prefix[dir],
+					       eigrp_topology_prefix_dest(pe))
+		       || eigrp_filter_cache_deny(ei->list[dir], ei->prefix[dir],
+						  eigrp_topology_prefix_dest(pe));
+
+	prefix = eigrp_topology_prefix_dest(pe);
+	cache = eigrp_filter_cache_get(eigrp, pe, ei->filter_slot);
+
+	if (instance
+	    && eigrp_filter_cache_verdict(eigrp, cache,
+					  EIGRP_FILTER_CACHE_INSTANCE, dir,
+					  eigrp->list[dir], eigrp->prefix[dir],
+					  prefix))
+		return true;
+
+	if (intf
+	    && eigrp_filter_cache_verdict(eigrp, cache, ei->filter_slot, dir,
+					  ei->list[dir], ei->prefix[dir],
+					  prefix))
+		return true;
+
+	return false;
+}
+
+void eigrp_filter_cache_flush(eigrp_instance_t *eigrp)
+{
+	eigrp->filter_gen++;
+	eigrp->filter_cache_stats.flushes++;
+}
+
+/*
+ * Interface slots.  Each interface holds the lowest slot no other
+ * interface of the instance holds, so the verdict arrays stay short.
+ * Interfaces come and go rarely; a walk of eiflist is enough.
+ */
+void eigrp_filter_cache_slot_alloc(eigrp_instance_t *eigrp,
+				   eigrp_interface_t *ei)
+{
+	eigrp_interface_t *other;
+	struct listnode *node;
+	uint32_t slot = EIGRP_FILTER_CACHE_INSTANCE + 1;
+	bool taken;
+
+	do {
+		taken = false;
+		for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, other)) {
+			if (other != ei && other->filter_slot == slot) {
+				taken = true;
+				slot++;
+				break;
+			}
+		}
+	} while (taken);
+
+	ei->filter_slot = slot;
+	if (slot >= eigrp->filter_slots)
+		eigrp->filter_slots = slot + 1;
+}
+
+/* The next holder of the slot must not see this interface's verdicts. */
+void eigrp_filter_cache_slot_release(eigrp_instance_t *eigrp,
+				     eigrp_interface_t *ei)
+{
+	if (!ei->filter_slot)
+		return;
+
+	ei->filter_slot = 0;
+	eigrp_filter_cache_flush(eigrp);
+}
+
+void eigrp_filter_cache_free(eigrp_prefix_descriptor_t *pe)
+{
+	if (pe->filter_cache)
+		XFREE(MTYPE_EIGRP_FILTER_CACHE, pe->filter_cache);
+}
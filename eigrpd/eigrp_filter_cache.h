@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix distribute-list verdict cache.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_FILTER_CACHE_H
+#define _ZEBRA_EIGRP_FILTER_CACHE_H
+
+#include "eigrpd/eigrp_types.h"
+
+/* true if a distribute-list of eigrp or ei denies pe in direction dir */
+extern bool eigrp_filter_cache_apply(eigrp_instance_t *eigrp,
+				     eigrp_interface_t *ei, int dir,
+				     eigrp_prefix_descriptor_t *pe);
+
+/* a list or its binding changed: retire every cached verdict */
+extern void eigrp_filter_cache_flush(eigrp_instance_t *eigrp);
+
+/* interface slots, taken when the interface is created */
+extern void eigrp_filter_cache_slot_alloc(eigrp_instance_t *eigrp,
+					  eigrp_interface_t *ei);
+extern void eigrp_filter_cache_slot_release(eigrp_instance_t *eigrp,
+					    eigrp_interface_t *ei);
+
+/* the prefix is going away */
+extern void eigrp_filter_cache_free(eigrp_prefix_descriptor_t *pe);
+
+#endif /* _ZEBRA_EIGRP_FILTER_CACHE_H */
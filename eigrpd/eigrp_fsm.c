@@ -57,7 +57,12 @@
 #include "eigrpd/eigrp_metric.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
 #include "eigrpd/eigrp_fsm.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_dump.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_FSM_TRACE, "EIGRP DUAL event trace");
 
 /*
  * Prototypes
@@ -140,7 +145,7 @@ const struct {
 	},
 };
 
-static const char *packet_type2str(uint8_t packet_type)
+const char *eigrp_fsm_packet_type2str(uint8_t packet_type)
 {
 	if (packet_type == EIGRP_OPC_UPDATE)
 		return "Update";
@@ -164,7 +169,7 @@ static const char *packet_type2str(uint8_t packet_type)
 	return "Unknown";
 }
 
-static const char *prefix_state2str(enum eigrp_fsm_states state)
+const char *eigrp_fsm_state2str(enum eigrp_fsm_states state)
 {
 	switch (state) {
 	case EIGRP_FSM_STATE_PASSIVE:
@@ -182,7 +187,7 @@ static const char *prefix_state2str(enum eigrp_fsm_states state)
 	return "Unknown";
 }
 
-static const char *fsm_state2str(enum eigrp_fsm_events event)
+const char *eigrp_fsm_event2str(enum eigrp_fsm_events event)
 {
 	switch (event) {
 	case EIGRP_FSM_KEEP_STATE:
@@ -206,7 +211,7 @@ static const char *fsm_state2str(enum eigrp_fsm_events event)
 	return "Unknown";
 }
 
-static const char *change2str(enum metric_change change)
+const char *eigrp_fsm_change2str(enum metric_change change)
 {
 	switch (change) {
 	case METRIC_DECREASE:
@@ -238,7 +243,8 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 	enum metric_change change;
 
 	if (route == NULL) {
-		route = eigrp_topology_route_create(msg->adv_router->ei);
+		route = eigrp_topology_route_create(msg->eigrp,
+						    msg->adv_router->ei);
 		route->adv_router = msg->adv_router;
 		route->prefix = prefix;
 		msg->route = route;
@@ -255,7 +261,7 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 
 	switch (actual_state) {
 	case EIGRP_FSM_STATE_PASSIVE: {
-		eigrp_route_descriptor_t *head = listnode_head(prefix->entries);
+		eigrp_route_descriptor_t *head = eigrp_route_vec_head(&prefix->routes);
 
 		if (head->reported_distance < prefix->fdistance) {
 			return EIGRP_FSM_KEEP_STATE;
@@ -276,13 +282,14 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 	case EIGRP_FSM_STATE_ACTIVE_0: {
 		if (msg->packet_type == EIGRP_OPC_REPLY) {
 			eigrp_route_descriptor_t *head =
-				listnode_head(prefix->entries);
+				eigrp_route_vec_head(&prefix->routes);
 
-			listnode_delete(prefix->rij, route->adv_router);
-			if (prefix->rij->count)
+			eigrp_topology_rij_remove(prefix, route->adv_router);
+			if (eigrp_topology_rij_count(prefix))
 				return EIGRP_FSM_KEEP_STATE;
 
-			zlog_info("All reply received");
+			if (IS_DEBUG_EIGRP_EVENT)
+				zlog_debug("All reply received");
 			if (head->reported_distance < prefix->fdistance) {
 				return EIGRP_FSM_EVENT_LR_FCS;
 			}
@@ -303,16 +310,17 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 		    && (route->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)) {
 			return EIGRP_FSM_EVENT_QACT;
 		} else if (msg->packet_type == EIGRP_OPC_REPLY) {
-			listnode_delete(prefix->rij, route->adv_router);
+			eigrp_topology_rij_remove(prefix, route->adv_router);
 
 			if (change == METRIC_INCREASE
 			    && (route->flags
 				& EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)) {
 				return EIGRP_FSM_EVENT_DINC;
-			} else if (prefix->rij->count) {
+			} else if (eigrp_topology_rij_count(prefix)) {
 				return EIGRP_FSM_KEEP_STATE;
 			} else {
-				zlog_info("All reply received");
+				if (IS_DEBUG_EIGRP_EVENT)
+				zlog_debug("All reply received");
 				return EIGRP_FSM_EVENT_LR;
 			}
 		} else if (msg->packet_type == EIGRP_OPC_UPDATE
@@ -328,13 +336,14 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 	case EIGRP_FSM_STATE_ACTIVE_2: {
 		if (msg->packet_type == EIGRP_OPC_REPLY) {
 			eigrp_route_descriptor_t *head =
-				listnode_head(prefix->entries);
+				eigrp_route_vec_head(&prefix->routes);
 
-			listnode_delete(prefix->rij, route->adv_router);
-			if (prefix->rij->count) {
+			eigrp_topology_rij_remove(prefix, route->adv_router);
+			if (eigrp_topology_rij_count(prefix)) {
 				return EIGRP_FSM_KEEP_STATE;
 			} else {
-				zlog_info("All reply received");
+				if (IS_DEBUG_EIGRP_EVENT)
+				zlog_debug("All reply received");
 				if (head->reported_distance
 				    < prefix->fdistance) {
 					return EIGRP_FSM_EVENT_LR_FCS;
@@ -349,16 +358,17 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 	}
 	case EIGRP_FSM_STATE_ACTIVE_3: {
 		if (msg->packet_type == EIGRP_OPC_REPLY) {
-			listnode_delete(prefix->rij, route->adv_router);
+			eigrp_topology_rij_remove(prefix, route->adv_router);
 
 			if (change == METRIC_INCREASE
 			    && (route->flags
 				& EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)) {
 				return EIGRP_FSM_EVENT_DINC;
-			} else if (prefix->rij->count) {
+			} else if (eigrp_topology_rij_count(prefix)) {
 				return EIGRP_FSM_KEEP_STATE;
 			} else {
-				zlog_info("All reply received");
+				if (IS_DEBUG_EIGRP_EVENT)
+				zlog_debug("All reply received");
 				return EIGRP_FSM_EVENT_LR;
 			}
 		} else if (msg->packet_type == EIGRP_OPC_UPDATE
@@ -376,21 +386,99 @@ eigrp_get_fsm_event(eigrp_fsm_action_message_t *msg)
 	return EIGRP_FSM_KEEP_STATE;
 }
 
+void eigrp_fsm_trace_init(eigrp_instance_t *eigrp)
+{
+	eigrp->fsm_trace = XCALLOC(MTYPE_EIGRP_FSM_TRACE,
+				   sizeof(*eigrp->fsm_trace));
+}
+
+void eigrp_fsm_trace_fini(eigrp_instance_t *eigrp)
+{
+	XFREE(MTYPE_EIGRP_FSM_TRACE, eigrp->fsm_trace);
+}
+
+/*
+ * Record a DUAL event in the instance ring.  The ring is only written
+ * from the protocol thread and never locked; the oldest entry is simply
+ * overwritten.
+ *
+ * The handler may delete the prefix (a lost route that DUAL retires
+ * frees its descriptor), so everything about the event is taken before
+ * the handler runs.  The prefix is left in trace->running, and
+ * eigrp_prefix_descriptor_delete() clears it there; a prefix that is gone
+ * is recorded as PASSIVE with no replies outstanding.  Handlers do not
+ * raise DUAL events themselves, so one slot is enough.
+ */
+static void eigrp_fsm_trace_begin(eigrp_fsm_action_message_t *msg,
+				  enum eigrp_fsm_events event,
+				  eigrp_fsm_trace_entry_t *entry)
+{
+	struct prefix *dest = eigrp_topology_prefix_dest(msg->prefix);
+	struct timeval now;
+
+	memset(entry, 0, sizeof(*entry));
+	monotime(&now);
+	entry->usec = (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+	entry->nbr = msg->adv_router->src;
+	entry->dest = dest->u.prefix4;
+	entry->prefixlen = dest->prefixlen;
+	entry->old_state = msg->prefix->state;
+	entry->event = event;
+	entry->packet_type = msg->packet_type;
+	entry->change = msg->change;
+
+	msg->eigrp->fsm_trace->running = msg->prefix;
+}
+
+static void eigrp_fsm_trace_end(eigrp_instance_t *eigrp,
+				eigrp_fsm_trace_entry_t *entry)
+{
+	eigrp_fsm_trace_t *trace = eigrp->fsm_trace;
+	eigrp_prefix_descriptor_t *prefix = trace->running;
+
+	if (prefix) {
+		entry->new_state = prefix->state;
+		entry->replies = eigrp_topology_rij_count(prefix);
+	} else {
+		entry->new_state = EIGRP_FSM_STATE_PASSIVE;
+		entry->replies = 0;
+	}
+	trace->running = NULL;
+
+	trace->entry[trace->head++ & (EIGRP_FSM_TRACE_SIZE - 1)] = *entry;
+}
+
 /*
  * Function made to execute in separate event.
  * Load argument from event and execute proper NSM function
  */
 int eigrp_fsm_event(eigrp_fsm_action_message_t *msg)
 {
+	eigrp_instance_t *eigrp = msg->eigrp;
 	enum eigrp_fsm_events event = eigrp_get_fsm_event(msg);
-
-	zlog_info(
-		"EIGRP AS: %d State: %s Event: %s Network: %s Packet Type: %s Reply RIJ Count: %d change: %s",
-		msg->eigrp->AS, prefix_state2str(msg->prefix->state),
-		fsm_state2str(event),
-		eigrp_print_prefix(msg->prefix->destination),
-		packet_type2str(msg->packet_type), msg->prefix->rij->count, change2str(msg->change));
-	(*(NSM[msg->prefix->state][event].func))(msg);
+	uint8_t old_state = msg->prefix->state;
+	eigrp_fsm_trace_entry_t entry;
+	bool trace = eigrp->fsm_trace != NULL;
+
+	if (IS_DEBUG_EIGRP_EVENT)
+		zlog_debug(
+			"EIGRP AS: %d State: %s Event: %s Network: %s Packet Type: %s Reply RIJ Count: %d change: %s",
+			eigrp->AS, eigrp_fsm_state2str(old_state),
+			eigrp_fsm_event2str(event),
+			eigrp_print_prefix(
+				eigrp_topology_prefix_dest(msg->prefix)),
+			eigrp_fsm_packet_type2str(msg->packet_type),
+			eigrp_topology_rij_count(msg->prefix),
+			eigrp_fsm_change2str(msg->change));
+
+	if (trace)
+		eigrp_fsm_trace_begin(msg, event, &entry);
+
+	/* msg->prefix may be freed by the handler; do not touch it after */
+	(*(NSM[old_state][event].func))(msg);
+
+	if (trace && eigrp->fsm_trace)
+		eigrp_fsm_trace_end(eigrp, &entry);
 
 	return 1;
 }
@@ -414,8 +502,8 @@ int eigrp_fsm_event_nq_fcn(eigrp_fsm_action_message_t *msg)
 	prefix->state = EIGRP_FSM_STATE_ACTIVE_1;
 
 	if (eigrp_nbr_count_get(eigrp)) {
-		prefix->req_action |= EIGRP_FSM_NEED_QUERY;
-		listnode_add(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_QUERY);
+		eigrp_active_start(eigrp, prefix);
 	} else {
 		eigrp_fsm_event_lr(msg); // in the case that there are no more
 					 // neighbors left
@@ -436,8 +524,8 @@ int eigrp_fsm_event_q_fcn(eigrp_fsm_action_message_t *msg)
 	 */
 	prefix->state = EIGRP_FSM_STATE_ACTIVE_3;
 	if (eigrp_nbr_count_get(eigrp)) {
-		prefix->req_action |= EIGRP_FSM_NEED_QUERY;
-		listnode_add(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_QUERY);
+		eigrp_active_start(eigrp, prefix);
 	} else {
 		eigrp_fsm_event_lr(msg); // in the case that there are no more
 					 // neighbors left
@@ -450,7 +538,7 @@ int eigrp_fsm_event_keep_state(eigrp_fsm_action_message_t *msg)
 {
 	eigrp_instance_t *eigrp = msg->eigrp;
 	eigrp_prefix_descriptor_t *prefix = msg->prefix;
-	eigrp_route_descriptor_t *route = listnode_head(prefix->entries);
+	eigrp_route_descriptor_t *route = eigrp_route_vec_head(&prefix->routes);
 
 	if (prefix->state == EIGRP_FSM_STATE_PASSIVE) {
 		if (!eigrp_metrics_is_same(prefix->reported_metric,
@@ -461,8 +549,7 @@ int eigrp_fsm_event_keep_state(eigrp_fsm_action_message_t *msg)
 			if (msg->packet_type == EIGRP_OPC_QUERY)
 				eigrp_reply_send(eigrp, msg->adv_router,
 						 prefix);
-			prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
-			listnode_add(eigrp->topology_changes, prefix);
+			eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 		}
 		eigrp_topology_update_node_flags(eigrp, prefix);
 		eigrp_update_routing_table(eigrp, prefix);
@@ -478,25 +565,23 @@ int eigrp_fsm_event_lr(eigrp_fsm_action_message_t *msg)
 {
 	eigrp_instance_t *eigrp = msg->eigrp;
 	eigrp_prefix_descriptor_t *prefix = msg->prefix;
-	eigrp_route_descriptor_t *route = listnode_head(prefix->entries);
+	eigrp_route_descriptor_t *route = eigrp_route_vec_head(&prefix->routes);
 
 	prefix->fdistance = prefix->distance = prefix->rdistance =
 		route->distance;
 	prefix->reported_metric = route->total_metric;
 
 	if (prefix->state == EIGRP_FSM_STATE_ACTIVE_3) {
-		struct list *successors = eigrp_topology_get_successor(prefix);
+		route = eigrp_topology_successor_head(prefix);
 
-		assert(successors); // It's like Napolean and Waterloo
+		assert(route); // It's like Napolean and Waterloo
 
-		route = listnode_head(successors);
 		eigrp_reply_send(eigrp, route->adv_router, prefix);
-		list_delete(&successors);
 	}
 
 	prefix->state = EIGRP_FSM_STATE_PASSIVE;
-	prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
-	listnode_add(eigrp->topology_changes, prefix);
+	eigrp_active_stop(eigrp, prefix);
+	eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 	eigrp_topology_update_node_flags(eigrp, prefix);
 	eigrp_update_routing_table(eigrp, prefix);
 	eigrp_update_topology_table_prefix(eigrp, eigrp->topology_table,
@@ -515,7 +600,7 @@ int eigrp_fsm_event_dinc(eigrp_fsm_action_message_t *msg)
 	msg->prefix->state = msg->prefix->state == EIGRP_FSM_STATE_ACTIVE_1
 				     ? EIGRP_FSM_STATE_ACTIVE_0
 				     : EIGRP_FSM_STATE_ACTIVE_2;
-	if (!msg->prefix->rij->count)
+	if (!eigrp_topology_rij_count(msg->prefix))
 		(*(NSM[msg->prefix->state][eigrp_get_fsm_event(msg)].func))(
 			msg);
 
@@ -526,26 +611,23 @@ int eigrp_fsm_event_lr_fcs(eigrp_fsm_action_message_t *msg)
 {
 	eigrp_instance_t *eigrp = msg->eigrp;
 	eigrp_prefix_descriptor_t *prefix = msg->prefix;
-	eigrp_route_descriptor_t *route = listnode_head(prefix->entries);
+	eigrp_route_descriptor_t *route = eigrp_route_vec_head(&prefix->routes);
 
 	prefix->state = EIGRP_FSM_STATE_PASSIVE;
+	eigrp_active_stop(eigrp, prefix);
 	prefix->distance = prefix->rdistance = route->distance;
 	prefix->reported_metric = route->total_metric;
 	prefix->fdistance = prefix->fdistance > prefix->distance
 				    ? prefix->distance
 				    : prefix->fdistance;
 	if (prefix->state == EIGRP_FSM_STATE_ACTIVE_2) {
-		struct list *successors = eigrp_topology_get_successor(prefix);
+		route = eigrp_topology_successor_head(prefix);
 
-		assert(successors); // Having a spoon and all you need is a
+		assert(route); // Having a spoon and all you need is a
 		// knife
-		route = listnode_head(successors);
 		eigrp_reply_send(eigrp, route->adv_router, prefix);
-
-		list_delete(&successors);
 	}
-	prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
-	listnode_add(eigrp->topology_changes, prefix);
+	eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 	eigrp_topology_update_node_flags(eigrp, prefix);
 	eigrp_update_routing_table(eigrp, prefix);
 	eigrp_update_topology_table_prefix(eigrp, eigrp->topology_table,
@@ -569,8 +651,8 @@ int eigrp_fsm_event_lr_fcn(eigrp_fsm_action_message_t *msg)
 				: EIGRP_FSM_STATE_ACTIVE_3;
 
 	if (eigrp_nbr_count_get(eigrp)) {
-		prefix->req_action |= EIGRP_FSM_NEED_QUERY;
-		listnode_add(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_QUERY);
+		eigrp_active_start(eigrp, prefix);
 	} else {
 		eigrp_fsm_event_lr(msg); // in the case that there are no more
 					 // neighbors left
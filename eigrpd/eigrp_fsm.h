@@ -19,6 +19,7 @@ typedef enum {
 	EIGRP_CONNECTED,
 	EIGRP_INT,
 	EIGRP_EXT,
+	EIGRP_RECOMPUTE, // distances already refreshed by bulk recompute
 } msg_data_t;
 
 typedef struct eigrp_fsm_action_message {
@@ -34,5 +35,13 @@ typedef struct eigrp_fsm_action_message {
 
 extern int eigrp_fsm_event(eigrp_fsm_action_message_t *msg);
 
+extern void eigrp_fsm_trace_init(eigrp_instance_t *eigrp);
+extern void eigrp_fsm_trace_fini(eigrp_instance_t *eigrp);
+
+extern const char *eigrp_fsm_state2str(enum eigrp_fsm_states state);
+extern const char *eigrp_fsm_event2str(enum eigrp_fsm_events event);
+extern const char *eigrp_fsm_change2str(enum metric_change change);
+extern const char *eigrp_fsm_packet_type2str(uint8_t packet_type);
+
 
 #endif /* _ZEBRA_EIGRP_DUAL_H */
@@ -33,6 +33,7 @@ static const struct message eigrp_general_tlv_type_str[] = {
 	{EIGRP_TLV_SEQ, "SEQ"},
 	{EIGRP_TLV_SW_VERSION, "SW_VERSION"},
 	{EIGRP_TLV_NEXT_MCAST_SEQ, "NEXT_MCAST_SEQ"},
+	{EIGRP_TLV_STUB, "STUB"},
 	{EIGRP_TLV_PEER_TERMINATION, "PEER_TERMINATION"},
 	{EIGRP_TLV_PEER_MTRLIST, "PEER_MTRLIST"},
 	{EIGRP_TLV_PEER_TIDLIST, "PEER_TIDLIST"},
@@ -139,8 +140,8 @@ eigrp_hello_parameter_decode(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 
 			//     if(ntohl(nbr->ei->address->u.prefix4.s_addr) >
 			//     ntohl(nbr->src.s_addr))
-			eigrp_update_send_init(eigrp, nbr);
 			eigrp_nbr_state_set(nbr, EIGRP_NEIGHBOR_PENDING);
+			eigrp_nbr_bringup_start(nbr);
 		}
 	} else {
 		if (eigrp_nbr_state_get(nbr) != EIGRP_NEIGHBOR_DOWN) {
@@ -202,6 +203,28 @@ static void eigrp_sw_version_decode(eigrp_neighbor_t *nbr,
 		eigrp_tlv1_neighbor_bind(nbr, &ei->eigrp->tlv1_codec);
 }
 
+/**
+ * @fn eigrp_stub_decode
+ *
+ * A neighbor announces its stub role in every hello; one without the
+ * TLV is not a stub.  A change takes effect for the next QUERY.
+ */
+static void eigrp_stub_decode(eigrp_neighbor_t *nbr,
+			      struct eigrp_tlv_hdr_type *tlv)
+{
+	struct TLV_Stub_Type *stub = (struct TLV_Stub_Type *)tlv;
+	uint16_t flags;
+
+	if (ntohs(stub->length) < EIGRP_TLV_STUB_LEN)
+		return;
+
+	flags = ntohs(stub->flags);
+	if (nbr->stub != flags && IS_DEBUG_EIGRP_PACKET(0, RECV))
+		zlog_debug("Neighbor %s stub flags 0x%04x", eigrp_print_addr(&nbr->src),
+			   flags);
+	nbr->stub = flags;
+}
+
 /**
  * @fn eigrp_peer_termination_decode
  *
@@ -284,6 +307,7 @@ void eigrp_hello_receive(eigrp_instance_t *eigrp, struct eigrp_header *eigrph,
 	uint16_t type;
 	uint16_t length;
 	bool new_nbr = FALSE;
+	bool stub;
 
 	if (IS_DEBUG_EIGRP_PACKET(eigrph->opcode - 1, RECV)) {
 		zlog_debug("Processing Hello size[%u] int(%s) src(%s)", size,
@@ -308,6 +332,7 @@ void eigrp_hello_receive(eigrp_instance_t *eigrp, struct eigrp_header *eigrph,
 		return;
 	}
 
+	stub = false;
 	tlv_header = (struct eigrp_tlv_hdr_type *)eigrph->tlv;
 	do {
 		type = ntohs(tlv_header->type);
@@ -342,6 +367,10 @@ void eigrp_hello_receive(eigrp_instance_t *eigrp, struct eigrp_header *eigrph,
 				break;
 			case EIGRP_TLV_NEXT_MCAST_SEQ:
 				break;
+			case EIGRP_TLV_STUB:
+				eigrp_stub_decode(nbr, tlv_header);
+				stub = true;
+				break;
 			case EIGRP_TLV_PEER_TERMINATION:
 				eigrp_peer_termination_decode(eigrp, nbr,
 							      tlv_header);
@@ -360,6 +389,10 @@ void eigrp_hello_receive(eigrp_instance_t *eigrp, struct eigrp_header *eigrph,
 		size -= length;
 	} while (size > 0);
 
+	/* a hello without the Stub TLV comes from a transit router */
+	if (!stub)
+		nbr->stub = 0;
+
 	/*If received packet is hello with Parameter TLV*/
 	if (ntohl(eigrph->ack) == 0) {
 		/* increment statistics. */
@@ -423,6 +456,32 @@ static uint16_t eigrp_sw_version_encode(struct stream *s)
 	return (length);
 }
 
+/**
+ * @fn eigrp_stub_encode
+ *
+ * @param[in]		eigrp	eigrp routing process
+ * @param[in,out]	s	packet stream TLV is stored to
+ *
+ * @return uint16_t	number of bytes added to packet stream
+ *
+ * @par
+ * A stub router announces what it advertises; a transit router sends
+ * no Stub TLV.
+ */
+static uint16_t eigrp_stub_encode(eigrp_instance_t *eigrp, struct stream *s)
+{
+	uint16_t length = EIGRP_TLV_STUB_LEN;
+
+	if (!eigrp->stub)
+		return 0;
+
+	stream_putw(s, EIGRP_TLV_STUB);
+	stream_putw(s, length);
+	stream_putw(s, eigrp->stub);
+
+	return (length);
+}
+
 /**
  * @fn eigrp_tidlist_encode
  *
@@ -621,6 +680,8 @@ static eigrp_packet_t *eigrp_hello_encode(eigrp_interface_t *ei, in_addr_t addr,
 		// add in the TID list if doing multi-topology
 		length += eigrp_tidlist_encode(packet->s);
 
+		length += eigrp_stub_encode(ei->eigrp, packet->s);
+
 		/* encode Peer Termination TLV if needed */
 		if (flags & EIGRP_HELLO_GRACEFUL_SHUTDOWN_NBR)
 			length += eigrp_peer_termination_encode(packet->s, nbr_addr);
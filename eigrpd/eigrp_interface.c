@@ -25,6 +25,9 @@
 #include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_dump.h"
 #include "eigrpd/eigrp_metric.h"
+#include "eigrpd/eigrp_summary.h"
+#include "eigrpd/eigrp_filter_cache.h"
+#include "eigrpd/eigrp_dual_queue.h"
 
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_INTF,      "EIGRP interface");
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_INTF_INFO, "EIGRP Interface Information");
@@ -38,6 +41,7 @@ void eigrp_interface_encoder_clear(eigrp_interface_t *ei)
 	ei->tlv1_peer_count = 0;
 	ei->tlv2_peer_count = 0;
 	ei->encoder = eigrp_packet_encoder_safe;
+	ei->sizer = eigrp_packet_sizer_safe;
 }
 
 static void eigrp_interface_encoder_select(eigrp_interface_t *ei)
@@ -47,6 +51,7 @@ static void eigrp_interface_encoder_select(eigrp_interface_t *ei)
 
 	if (ei->tlv1_peer_count && ei->tlv2_peer_count) {
 		ei->encoder = eigrp_packet_encoder_both;
+		ei->sizer = eigrp_packet_sizer_both;
 		return;
 	}
 
@@ -61,6 +66,7 @@ static void eigrp_interface_encoder_select(eigrp_interface_t *ei)
 	}
 
 	ei->encoder = eigrp_packet_encoder_safe;
+	ei->sizer = eigrp_packet_sizer_safe;
 }
 
 void eigrp_interface_encoder_bind(eigrp_interface_t *ei, uint8_t tlv_version)
@@ -161,6 +167,7 @@ eigrp_interface_t *eigrp_intf_new(eigrp_instance_t *eigrp, struct interface *ifp
 
 	ifp->info = ei;
 	listnode_add(eigrp->eiflist, ei);
+	eigrp_filter_cache_slot_alloc(eigrp, ei);
 
 	ei->type = EIGRP_IFTYPE_BROADCAST;
 
@@ -183,6 +190,7 @@ eigrp_interface_t *eigrp_intf_new(eigrp_instance_t *eigrp, struct interface *ifp
 	ei->params.delay = EIGRP_DELAY_DEFAULT;
 	ei->params.reliability = EIGRP_RELIABILITY_DEFAULT;
 	ei->params.load = EIGRP_LOAD_DEFAULT;
+	ei->params.bringup_max = EIGRP_INTF_BRINGUP_MAX_DEFAULT;
 	ei->params.auth_type = EIGRP_AUTH_TYPE_NONE;
 	ei->params.auth_keychain = NULL;
 
@@ -319,6 +327,21 @@ void eigrp_del_intf_params(eigrp_intf_params_t *eip)
 		free(eip->auth_keychain);
 }
 
+/* Metrics of a connected route over this interface */
+void eigrp_intf_metrics_get(eigrp_interface_t *ei, eigrp_metrics_t *metric)
+{
+	metric->bandwidth = eigrp_bandwidth_to_scaled(ei->params.bandwidth);
+	metric->delay = eigrp_delay_to_scaled(ei->params.delay);
+	metric->load = ei->params.load;
+	metric->reliability = ei->params.reliability;
+	metric->mtu[0] = 0xDC;
+	metric->mtu[1] = 0x05;
+	metric->mtu[2] = 0x00;
+	metric->hop_count = 0;
+	metric->flags = 0;
+	metric->tag = 0;
+}
+
 int eigrp_intf_up(eigrp_instance_t *eigrp, eigrp_interface_t *ei)
 {
 	eigrp_prefix_descriptor_t *prefix;
@@ -336,19 +359,10 @@ int eigrp_intf_up(eigrp_instance_t *eigrp, eigrp_interface_t *ei)
 	event_add_event(eigrpd_event, eigrp_hello_timer, ei, (1), &ei->t_hello);
 
 	/*Prepare metrics*/
-	metric.bandwidth = eigrp_bandwidth_to_scaled(ei->params.bandwidth);
-	metric.delay = eigrp_delay_to_scaled(ei->params.delay);
-	metric.load = ei->params.load;
-	metric.reliability = ei->params.reliability;
-	metric.mtu[0] = 0xDC;
-	metric.mtu[1] = 0x05;
-	metric.mtu[2] = 0x00;
-	metric.hop_count = 0;
-	metric.flags = 0;
-	metric.tag = 0;
+	eigrp_intf_metrics_get(ei, &metric);
 
 	/*Add connected route to topology table*/
-	route = eigrp_topology_route_create(ei);
+	route = eigrp_topology_route_create(eigrp, ei);
 	route->type = EIGRP_TLV_IPv4_INT;
 
 	route->reported_metric = metric;
@@ -365,19 +379,17 @@ int eigrp_intf_up(eigrp_instance_t *eigrp, eigrp_interface_t *ei)
 	prefix = eigrp_topology_table_lookup_ipv4(eigrp->topology_table, &dest_addr);
 
 	if (prefix == NULL) {
-		prefix = eigrp_topology_prefix_create();
+		prefix = eigrp_topology_prefix_create(eigrp);
 		prefix->serno = eigrp->serno;
-		prefix->destination = (struct prefix *)prefix_ipv4_new();
-		prefix_copy(prefix->destination, &dest_addr);
+		prefix_copy(eigrp_topology_prefix_dest(prefix), &dest_addr);
 		prefix->nt = EIGRP_TOPOLOGY_TYPE_CONNECTED;
 		prefix->reported_metric = metric;
 		prefix->state = EIGRP_FSM_STATE_PASSIVE;
 		prefix->fdistance = eigrp_calculate_metrics(eigrp, metric);
-		prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
 
 		eigrp_prefix_descriptor_add(eigrp->topology_table, prefix);
 
-		listnode_add(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 
 		route->prefix = prefix;
 		eigrp_route_descriptor_add(eigrp, prefix, route);
@@ -386,8 +398,7 @@ int eigrp_intf_up(eigrp_instance_t *eigrp, eigrp_interface_t *ei)
 			eigrp_update_send(eigrp, eigrp->neighbor_self, ei2);
 		}
 
-		prefix->req_action &= ~EIGRP_FSM_NEED_UPDATE;
-		listnode_delete(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_remove(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 
 	} else {
 		eigrp_fsm_action_message_t msg;
@@ -490,8 +501,15 @@ void eigrp_intf_free(eigrp_instance_t *eigrp, eigrp_interface_t *ei, int source)
 		eigrp_prefix_descriptor_delete(eigrp, eigrp->topology_table,
 					       pe);
 
+	eigrp_summary_intf_fini(ei);
 	eigrp_intf_down(ei);
 
+	/* neighbors deleted above still point at ei until their events run */
+	eigrp_dual_queue_drain(eigrp);
+
+	if (eigrp->flush_exception == ei)
+		eigrp->flush_exception = NULL;
+	eigrp_filter_cache_slot_release(eigrp, ei);
 	listnode_delete(ei->eigrp->eiflist, ei);
 }
 
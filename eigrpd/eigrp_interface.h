@@ -27,6 +27,7 @@ extern bool eigrp_intf_is_passive(eigrp_interface_t *ei);
 extern void eigrp_del_intf_params(eigrp_intf_params_t *);
 extern eigrp_interface_t *eigrp_intf_new(eigrp_instance_t *, struct interface *,
 					 struct prefix *);
+extern void eigrp_intf_metrics_get(eigrp_interface_t *, eigrp_metrics_t *);
 extern int eigrp_intf_up(eigrp_instance_t *, eigrp_interface_t *);
 extern void eigrp_intf_update(eigrp_instance_t *, struct interface *);
 extern void eigrp_intf_set_multicast(eigrp_interface_t *);
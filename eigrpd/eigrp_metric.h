@@ -35,6 +35,9 @@ extern eigrp_scaled_t eigrp_delay_to_scaled(eigrp_delay_t);
 extern eigrp_delay_t eigrp_scaled_to_delay(eigrp_scaled_t);
 
 extern eigrp_metric_t eigrp_calculate_metrics(eigrp_instance_t *, eigrp_metrics_t);
+extern void eigrp_calculate_metrics_batch(eigrp_instance_t *,
+					  eigrp_metric_batch_t *);
+extern void eigrp_total_metrics_update(eigrp_route_descriptor_t *);
 extern eigrp_metric_t eigrp_calculate_total_metrics(eigrp_instance_t *,
 						    eigrp_route_descriptor_t *);
 extern bool eigrp_metrics_is_same(eigrp_metrics_t, eigrp_metrics_t);
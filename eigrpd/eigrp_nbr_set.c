@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP neighbor bitsets, indexed by neighbor slot.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Every neighbor of an instance holds a dense slot number (see
+ * eigrp_nbr_slot_alloc()), so a set of neighbors is a bitset.  Reply
+ * tracking used to keep one listnode per outstanding neighbor per ACTIVE
+ * prefix and found each REPLY with a linear list walk.  A set is one
+ * inline word for the first 64 slots and a heap array beyond that; the
+ * heap pointer overlays the inline word.  Add and delete are a bit flip,
+ * and "last reply" is a popcount over a handful of words.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_nbr_set.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_NBR_SET, "EIGRP neighbor set");
+
+/* Make room for word index word, moving off the inline word if needed. */
+static uint64_t *eigrp_nbr_set_reserve(eigrp_nbr_set_t *set, uint32_t word)
+{
+	uint32_t nwords = eigrp_nbr_set_words(set);
+	uint32_t size = nwords;
+	uint64_t *heap;
+
+	if (word < nwords)
+		return eigrp_nbr_set_data(set);
+
+	while (size <= word)
+		size *= 2;
+
+	if (set->nwords) {
+		heap = XREALLOC(MTYPE_EIGRP_NBR_SET, set->heap,
+				size * sizeof(*heap));
+	} else {
+		heap = XCALLOC(MTYPE_EIGRP_NBR_SET, size * sizeof(*heap));
+		heap[0] = set->word;
+	}
+	memset(heap + nwords, 0, (size - nwords) * sizeof(*heap));
+
+	set->heap = heap;
+	set->nwords = size;
+	return heap;
+}
+
+/* Returns true if slot was not a member before. */
+bool eigrp_nbr_set_add(eigrp_nbr_set_t *set, uint32_t slot)
+{
+	uint64_t bit = 1ULL << (slot % 64);
+	uint64_t *data;
+
+	data = eigrp_nbr_set_reserve(set, slot / 64);
+	if (data[slot / 64] & bit)
+		return false;
+
+	data[slot / 64] |= bit;
+	return true;
+}
+
+/*
+ * Returns true if slot was a member.  A spilled set goes back to the
+ * inline word once it is empty.
+ */
+bool eigrp_nbr_set_del(eigrp_nbr_set_t *set, uint32_t slot)
+{
+	uint64_t bit = 1ULL << (slot % 64);
+	uint64_t *data;
+
+	if (!eigrp_nbr_set_test(set, slot))
+		return false;
+
+	data = eigrp_nbr_set_data(set);
+	data[slot / 64] &= ~bit;
+	if (set->nwords && eigrp_nbr_set_empty(set))
+		eigrp_nbr_set_fini(set);
+	return true;
+}
+
+/* First member at or after slot, EIGRP_NBR_SLOT_NONE if there is none. */
+uint32_t eigrp_nbr_set_next(eigrp_nbr_set_t *set, uint32_t slot)
+{
+	uint64_t *data = eigrp_nbr_set_data(set);
+	uint32_t nwords = eigrp_nbr_set_words(set);
+	uint32_t word = slot / 64;
+	uint64_t bits;
+
+	if (word >= nwords)
+		return EIGRP_NBR_SLOT_NONE;
+
+	bits = data[word] & (~0ULL << (slot % 64));
+	while (!bits) {
+		if (++word == nwords)
+			return EIGRP_NBR_SLOT_NONE;
+		bits = data[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+void eigrp_nbr_set_fini(eigrp_nbr_set_t *set)
+{
+	if (set->nwords)
+		XFREE(MTYPE_EIGRP_NBR_SET, set->heap);
+
+	memset(set, 0, sizeof(*set));
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP neighbor bitsets, indexed by neighbor slot.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_NBR_SET_H
+#define _ZEBRA_EIGRP_NBR_SET_H
+
+#include "eigrpd/eigrp_types.h"
+
+static inline uint64_t *eigrp_nbr_set_data(eigrp_nbr_set_t *set)
+{
+	return set->nwords ? set->heap : &set->word;
+}
+
+static inline uint32_t eigrp_nbr_set_words(const eigrp_nbr_set_t *set)
+{
+	return set->nwords ? set->nwords : 1;
+}
+
+static inline bool eigrp_nbr_set_test(eigrp_nbr_set_t *set, uint32_t slot)
+{
+	if (slot / 64 >= eigrp_nbr_set_words(set))
+		return false;
+
+	return eigrp_nbr_set_data(set)[slot / 64] & (1ULL << (slot % 64));
+}
+
+/* Members in the set; a popcount per word. */
+static inline uint32_t eigrp_nbr_set_count(eigrp_nbr_set_t *set)
+{
+	uint64_t *data = eigrp_nbr_set_data(set);
+	uint32_t i, count = 0;
+
+	for (i = 0; i < eigrp_nbr_set_words(set); i++)
+		count += __builtin_popcountll(data[i]);
+	return count;
+}
+
+static inline bool eigrp_nbr_set_empty(eigrp_nbr_set_t *set)
+{
+	uint64_t *data = eigrp_nbr_set_data(set);
+	uint32_t i;
+
+	for (i = 0; i < eigrp_nbr_set_words(set); i++)
+		if (data[i])
+			return false;
+	return true;
+}
+
+extern bool eigrp_nbr_set_add(eigrp_nbr_set_t *set, uint32_t slot);
+extern bool eigrp_nbr_set_del(eigrp_nbr_set_t *set, uint32_t slot);
+extern uint32_t eigrp_nbr_set_next(eigrp_nbr_set_t *set, uint32_t slot);
+extern void eigrp_nbr_set_fini(eigrp_nbr_set_t *set);
+
+/* Walk the member slots in increasing order; the body may delete them. */
+#define EIGRP_NBR_SET_FOREACH(set, slot)                                       \
+	for ((slot) = eigrp_nbr_set_next((set), 0);                            \
+	     (slot) != EIGRP_NBR_SLOT_NONE;                                    \
+	     (slot) = eigrp_nbr_set_next((set), (slot) + 1))
+
+#endif /* _ZEBRA_EIGRP_NBR_SET_H */
@@ -20,9 +20,12 @@
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_packetizer.h"
 #include "eigrpd/eigrp_zebra.h"
+#include "eigrpd/eigrp_dump.h"
 
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_NEIGHBOR, "EIGRP neighbor");
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_NBR_SLOTS, "EIGRP neighbor slots");
 
 
 void eigrp_neighbor_encoder_bind(eigrp_neighbor_t *nbr, eigrp_tlv_codec_t *codec)
@@ -31,6 +34,7 @@ void eigrp_neighbor_encoder_bind(eigrp_neighbor_t *nbr, eigrp_tlv_codec_t *codec
 		return;
 
 	nbr->encoder = codec->encoder;
+	nbr->sizer = codec->sizer;
 }
 
 void eigrp_neighbor_decoder_bind(eigrp_neighbor_t *nbr, eigrp_tlv_codec_t *codec)
@@ -61,12 +65,68 @@ static void eigrp_nbr_init(eigrp_neighbor_t *nbr, eigrp_addr_t *src)
 	nbr->tlv_version = 0;
 	nbr->decoder = eigrp_packet_decoder_safe;
 	nbr->encoder = eigrp_packet_encoder_safe;
+	nbr->sizer = eigrp_packet_sizer_safe;
 
 	//  if (IS_DEBUG_EIGRP_EVENT)
 	//    zlog_debug("NSM[%s:%s]: start", EIGRP_INTF_NAME (nbr->oi),
 	//               eigrp_print_routerid(nbr->router_id));
 }
 
+/*
+ * Neighbor slots.  Each neighbor of an instance holds the lowest free
+ * slot number, so slots stay dense and a set of neighbors can be kept as
+ * a bitset indexed by slot (eigrp_nbr_set_t).  The self neighbor has no
+ * instance when it is created and never gets a slot.
+ */
+static void eigrp_nbr_slot_alloc(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+{
+	uint32_t slot, size;
+
+	for (slot = eigrp->nbr_slot_low; slot < eigrp->nbr_slot_size; slot++)
+		if (!eigrp->nbr_slots[slot])
+			break;
+
+	if (slot == eigrp->nbr_slot_size) {
+		size = eigrp->nbr_slot_size ? eigrp->nbr_slot_size * 2
+					    : EIGRP_NBR_SLOT_INIT;
+		eigrp->nbr_slots = XREALLOC(MTYPE_EIGRP_NBR_SLOTS,
+					    eigrp->nbr_slots,
+					    size * sizeof(*eigrp->nbr_slots));
+		memset(eigrp->nbr_slots + eigrp->nbr_slot_size, 0,
+		       (size - eigrp->nbr_slot_size)
+			       * sizeof(*eigrp->nbr_slots));
+		eigrp->nbr_slot_size = size;
+	}
+
+	eigrp->nbr_slots[slot] = nbr;
+	eigrp->nbr_slot_low = slot + 1;
+	nbr->slot = slot;
+}
+
+static void eigrp_nbr_slot_release(eigrp_instance_t *eigrp,
+				   eigrp_neighbor_t *nbr)
+{
+	if (nbr->slot == EIGRP_NBR_SLOT_NONE)
+		return;
+
+	eigrp->nbr_slots[nbr->slot] = NULL;
+	if (nbr->slot < eigrp->nbr_slot_low)
+		eigrp->nbr_slot_low = nbr->slot;
+	nbr->slot = EIGRP_NBR_SLOT_NONE;
+}
+
+eigrp_neighbor_t *eigrp_nbr_slot_lookup(eigrp_instance_t *eigrp, uint32_t slot)
+{
+	return slot < eigrp->nbr_slot_size ? eigrp->nbr_slots[slot] : NULL;
+}
+
+void eigrp_nbr_slot_fini(eigrp_instance_t *eigrp)
+{
+	XFREE(MTYPE_EIGRP_NBR_SLOTS, eigrp->nbr_slots);
+	eigrp->nbr_slot_size = 0;
+	eigrp->nbr_slot_low = 0;
+}
+
 /**
  * Create a new neighbor structure and initalize it.
  */
@@ -79,6 +139,7 @@ eigrp_neighbor_t *eigrp_nbr_create(eigrp_interface_t *ei, eigrp_addr_t *src)
 
 	/* Relate neighbor to the interface. */
 	nbr->ei = ei;
+	nbr->slot = EIGRP_NBR_SLOT_NONE;
 
 	/* Set default values. */
 	eigrp_nbr_init(nbr, src);
@@ -87,6 +148,7 @@ eigrp_neighbor_t *eigrp_nbr_create(eigrp_interface_t *ei, eigrp_addr_t *src)
 	// If this is the 'self' neighbor, then you dont have an interface
 	if (ei) {
 		listnode_add(ei->nbrs, nbr);
+		eigrp_nbr_slot_alloc(ei->eigrp, nbr);
 	}
 	return nbr;
 }
@@ -171,8 +233,11 @@ eigrp_neighbor_t *eigrp_nbr_lookup_by_addr_process(eigrp_instance_t *eigrp,
 void eigrp_nbr_delete(eigrp_neighbor_t *nbr)
 {
 	eigrp_nbr_state_set(nbr, EIGRP_NEIGHBOR_DOWN);
-	if (nbr->ei)
+	if (nbr->ei) {
 		eigrp_topology_neighbor_down(nbr->ei->eigrp, nbr);
+		eigrp_nbr_slot_release(nbr->ei->eigrp, nbr);
+	}
+	eigrp_packetizer_neighbor_down(nbr);
 
 	/* Cancel all events. */ /* Event lookup cost would be negligible. */
 	event_cancel_event(eigrpd_event, nbr);
@@ -182,6 +247,17 @@ void eigrp_nbr_delete(eigrp_neighbor_t *nbr)
 
 	if (nbr->ei)
 		listnode_delete(nbr->ei->nbrs, nbr);
+
+	/* its withdraws are still queued; the last one to go frees it */
+	if (nbr->dual_pending) {
+		nbr->deleted = true;
+		return;
+	}
+	eigrp_nbr_release(nbr);
+}
+
+void eigrp_nbr_release(eigrp_neighbor_t *nbr)
+{
 	XFREE(MTYPE_EIGRP_NEIGHBOR, nbr);
 }
 
@@ -199,6 +275,189 @@ void holddown_timer_expired(struct event *event)
 	return;
 }
 
+/*
+ * Neighbor bring-up admission control.
+ *
+ * A new adjacency costs an INIT exchange followed by a full topology dump
+ * in eigrp_update_send_EOT(), all of it sitting on the neighbor's retransmit
+ * queue until acked.  A mass reconnect would otherwise start every one of
+ * those dumps at once.  Instead a neighbor entering PENDING asks for a sync
+ * slot; if the instance or its interface is at the cap the neighbor waits in
+ * eigrp->bringup_queue.  Waiting neighbors stay PENDING, their hellos keep
+ * refreshing the hold timer, and their INIT is only answered once admitted.
+ * The slot is returned when the EOT dump has been fully acked, or when the
+ * neighbor goes down.
+ */
+static bool eigrp_nbr_bringup_slot_free(eigrp_neighbor_t *nbr)
+{
+	eigrp_interface_t *ei = nbr->ei;
+	eigrp_instance_t *eigrp = ei->eigrp;
+
+	if (eigrp->bringup_max && eigrp->bringup_active >= eigrp->bringup_max)
+		return false;
+
+	if (ei->params.bringup_max
+	    && ei->bringup_active >= ei->params.bringup_max)
+		return false;
+
+	return true;
+}
+
+static void eigrp_nbr_bringup_admit(eigrp_neighbor_t *nbr)
+{
+	eigrp_interface_t *ei = nbr->ei;
+	eigrp_instance_t *eigrp = ei->eigrp;
+
+	nbr->bringup = EIGRP_BRINGUP_ACTIVE;
+	eigrp->bringup_active++;
+	ei->bringup_active++;
+	eigrp->bringup_stats.admitted++;
+
+	eigrp_update_send_init(eigrp, nbr);
+}
+
+/*
+ * Hand free slots to waiting neighbors in arrival order.  A neighbor whose
+ * interface is still full is skipped so one busy interface cannot hold up
+ * neighbors on the others.
+ */
+static void eigrp_nbr_bringup_admit_next(eigrp_instance_t *eigrp)
+{
+	struct listnode *node, *nnode;
+	eigrp_neighbor_t *nbr;
+
+	for (ALL_LIST_ELEMENTS(eigrp->bringup_queue, node, nnode, nbr)) {
+		if (eigrp->bringup_max
+		    && eigrp->bringup_active >= eigrp->bringup_max)
+			break;
+
+		if (!eigrp_nbr_bringup_slot_free(nbr))
+			continue;
+
+		list_delete_node(eigrp->bringup_queue, node);
+		nbr->ei->bringup_queued--;
+
+		if (IS_DEBUG_EIGRP_NEI(nei, NEI))
+			zlog_debug("Neighbor %s (%s) admitted to initial sync",
+				   eigrp_print_addr(&nbr->src),
+				   EIGRP_INTF_NAME(nbr->ei));
+
+		eigrp_nbr_bringup_admit(nbr);
+	}
+}
+
+/* A cap was raised or removed; admit whoever fits now. */
+void eigrp_nbr_bringup_resume(eigrp_instance_t *eigrp)
+{
+	eigrp_nbr_bringup_admit_next(eigrp);
+}
+
+/* Give up the slot or queue position without recording a completed sync. */
+static void eigrp_nbr_bringup_clear(eigrp_neighbor_t *nbr)
+{
+	eigrp_interface_t *ei = nbr->ei;
+	eigrp_instance_t *eigrp;
+
+	if (!ei || nbr->bringup == EIGRP_BRINGUP_NONE)
+		return;
+
+	eigrp = ei->eigrp;
+	if (nbr->bringup == EIGRP_BRINGUP_QUEUED) {
+		listnode_delete(eigrp->bringup_queue, nbr);
+		ei->bringup_queued--;
+		nbr->bringup = EIGRP_BRINGUP_NONE;
+		return;
+	}
+
+	nbr->bringup = EIGRP_BRINGUP_NONE;
+	eigrp->bringup_active--;
+	ei->bringup_active--;
+	eigrp->bringup_stats.aborted++;
+
+	eigrp_nbr_bringup_admit_next(eigrp);
+}
+
+/**
+ * @fn eigrp_nbr_bringup_start
+ *
+ * @param[in]		nbr	neighbor that just moved to PENDING
+ *
+ * @par
+ * Start the initial sync with a new neighbor if a slot is free, otherwise
+ * park it on the instance bring-up queue.
+ */
+void eigrp_nbr_bringup_start(eigrp_neighbor_t *nbr)
+{
+	eigrp_interface_t *ei = nbr->ei;
+	eigrp_instance_t *eigrp = ei->eigrp;
+
+	if (nbr->bringup != EIGRP_BRINGUP_NONE)
+		return;
+
+	monotime(&nbr->bringup_start);
+
+	if (!listcount(eigrp->bringup_queue)
+	    && eigrp_nbr_bringup_slot_free(nbr)) {
+		eigrp_nbr_bringup_admit(nbr);
+		return;
+	}
+
+	nbr->bringup = EIGRP_BRINGUP_QUEUED;
+	listnode_add(eigrp->bringup_queue, nbr);
+	ei->bringup_queued++;
+	eigrp->bringup_stats.deferred++;
+	if (listcount(eigrp->bringup_queue) > eigrp->bringup_stats.queue_peak)
+		eigrp->bringup_stats.queue_peak =
+			listcount(eigrp->bringup_queue);
+
+	if (IS_DEBUG_EIGRP_NEI(nei, NEI))
+		zlog_debug("Neighbor %s (%s) queued for initial sync, depth %u",
+			   eigrp_print_addr(&nbr->src), EIGRP_INTF_NAME(ei),
+			   listcount(eigrp->bringup_queue));
+
+	/* the slot check may have failed only because others are waiting */
+	eigrp_nbr_bringup_admit_next(eigrp);
+}
+
+/**
+ * @fn eigrp_nbr_bringup_finish
+ *
+ * @param[in]		nbr	neighbor whose EOT dump has been fully acked
+ *
+ * @par
+ * Record the time to full adjacency and pass the slot to the next
+ * waiting neighbor.
+ */
+void eigrp_nbr_bringup_finish(eigrp_neighbor_t *nbr)
+{
+	static const uint32_t bounds[] = EIGRP_BRINGUP_HIST_BOUNDS;
+	eigrp_interface_t *ei = nbr->ei;
+	eigrp_instance_t *eigrp = ei->eigrp;
+	struct timeval now;
+	uint32_t elapsed;
+	size_t bucket;
+
+	if (nbr->bringup != EIGRP_BRINGUP_ACTIVE)
+		return;
+
+	monotime(&now);
+	elapsed = now.tv_sec - nbr->bringup_start.tv_sec;
+	if (now.tv_usec < nbr->bringup_start.tv_usec && elapsed)
+		elapsed--;
+
+	for (bucket = 0; bucket < array_size(bounds); bucket++)
+		if (elapsed < bounds[bucket])
+			break;
+	eigrp->bringup_stats.adjacency_hist[bucket]++;
+	eigrp->bringup_stats.completed++;
+
+	nbr->bringup = EIGRP_BRINGUP_NONE;
+	eigrp->bringup_active--;
+	ei->bringup_active--;
+
+	eigrp_nbr_bringup_admit_next(eigrp);
+}
+
 uint8_t eigrp_nbr_state_get(eigrp_neighbor_t *nbr)
 {
 	return (nbr->state);
@@ -222,6 +481,8 @@ void eigrp_nbr_state_set(eigrp_neighbor_t *nbr, uint8_t state)
 		eigrp_interface_encoder_bind(nbr->ei, nbr->tlv_version);
 
 	if (eigrp_nbr_state_get(nbr) == EIGRP_NEIGHBOR_DOWN) {
+		eigrp_nbr_bringup_clear(nbr);
+
 		// reset all the seq/ack counters
 		nbr->recv_sequence_number = 0;
 		nbr->init_sequence_number = 0;
@@ -31,6 +31,7 @@ typedef struct eigrp_neighbor {
 
 	eigrp_packet_decoder_t decoder;
 	eigrp_packet_encoder_t encoder;
+	eigrp_packet_sizer_t sizer;
 
 	uint8_t K1;
 	uint8_t K2;
@@ -64,15 +65,43 @@ typedef struct eigrp_neighbor {
 	eigrp_packet_queue_t *retrans_queue;
 	eigrp_packet_queue_t *multicast_queue;
 
+	/* dense per-instance ID, EIGRP_NBR_SLOT_NONE for the self neighbor */
+	uint32_t slot;
+
+	/* EIGRP_STUB_* from the neighbor's hello, 0 if it is not a stub */
+	uint16_t stub;
+
+	/* ACTIVE prefixes still waiting on a REPLY from this neighbor */
+	uint32_t rij_pending;
+
+	/* DUAL input from this neighbor not yet run */
+	uint32_t dual_pending;
+
+	/* deleted, kept only until dual_pending drains */
+	bool deleted;
+
+	/* REPLY, SIA-REPLY and SIA-QUERY work still gathering in the packetizer */
+	eigrp_packetizer_work_t *reply_work;
+	eigrp_packetizer_work_t *siareply_work;
+	eigrp_packetizer_work_t *siaquery_work;
+
+	/* topology routes advertised by this neighbor, and the most at once */
+	uint32_t route_count;
+	uint32_t route_peak;
+
 	uint32_t crypt_seqnum; /* Cryptographic Sequence Number. */
 
 	/* prefixes not received from neighbor during Graceful restart */
 	struct list *nbr_gr_prefixes;
-	/* prefixes not yet send to neighbor during Graceful restart */
-	struct list *nbr_gr_prefixes_send;
+	/* last prefix sent during Graceful restart, the next chunk follows it */
+	struct prefix nbr_gr_resume;
 	/* if packet is first or last during Graceful restart */
 	enum Packet_part_type nbr_gr_packet_type;
 
+	/* bring-up admission: EIGRP_BRINGUP_* and when PENDING started */
+	uint8_t bringup;
+	struct timeval bringup_start;
+
 } eigrp_neighbor_t;
 
 
@@ -81,6 +110,10 @@ extern eigrp_neighbor_t *eigrp_nbr_lookup(eigrp_interface_t *, struct eigrp_head
 					  eigrp_addr_t *);
 extern eigrp_neighbor_t *eigrp_nbr_create(eigrp_interface_t *, eigrp_addr_t *);
 extern void eigrp_nbr_delete(eigrp_neighbor_t *neigh);
+extern void eigrp_nbr_release(eigrp_neighbor_t *nbr);
+extern eigrp_neighbor_t *eigrp_nbr_slot_lookup(eigrp_instance_t *,
+					       uint32_t slot);
+extern void eigrp_nbr_slot_fini(eigrp_instance_t *);
 
 extern void holddown_timer_expired(struct event *event);
 
@@ -100,6 +133,10 @@ extern eigrp_neighbor_t *eigrp_nbr_lookup_by_addr_process(eigrp_instance_t *,
 extern void eigrp_nbr_hard_restart(eigrp_instance_t *, eigrp_neighbor_t *,
 				   struct vty *);
 
+extern void eigrp_nbr_bringup_start(eigrp_neighbor_t *);
+extern void eigrp_nbr_bringup_finish(eigrp_neighbor_t *);
+extern void eigrp_nbr_bringup_resume(eigrp_instance_t *);
+
 extern int eigrp_nbr_split_horizon_check(eigrp_route_descriptor_t *,
 					 eigrp_interface_t *);
 
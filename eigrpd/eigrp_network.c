@@ -21,166 +21,6 @@ static int eigrp_network_match_iface(const struct prefix *connected_prefix,
 static void eigrp_network_run_interface(eigrp_instance_t *, struct prefix *,
 					struct interface *);
 
-int eigrp_sock_init(struct vrf *vrf)
-{
-	int eigrp_sock = -1;
-	int ret;
-#ifdef IP_HDRINCL
-	int hincl = 1;
-#endif
-
-	if (!vrf)
-		return eigrp_sock;
-
-	frr_with_privs (&eigrpd_privs) {
-		eigrp_sock = vrf_socket(
-			AF_INET, SOCK_RAW, IPPROTO_EIGRPIGP, vrf->vrf_id,
-			vrf->vrf_id != VRF_DEFAULT ? vrf->name : NULL);
-		if (eigrp_sock < 0) {
-			zlog_err("eigrp_read_sock_init: socket: %s",
-				 safe_strerror(errno));
-			exit(1);
-		}
-
-#ifdef IP_HDRINCL
-		/* we will include IP header with packet */
-		ret = setsockopt(eigrp_sock, IPPROTO_IP, IP_HDRINCL, &hincl,
-				 sizeof(hincl));
-		if (ret < 0) {
-			zlog_warn("Can't set IP_HDRINCL option for fd %d: %s",
-				  eigrp_sock, safe_strerror(errno));
-		}
-#elif defined(IPTOS_PREC_INTERNETCONTROL)
-#warning "IP_HDRINCL not available on this system"
-#warning "using IPTOS_PREC_INTERNETCONTROL"
-		ret = setsockopt_ipv4_tos(eigrp_sock,
-					  IPTOS_PREC_INTERNETCONTROL);
-		if (ret < 0) {
-			zlog_warn(
-				"can't set sockopt IP_TOS %d to socket %d: %s",
-				tos, eigrp_sock, safe_strerror(errno));
-			close(eigrp_sock); /* Prevent sd leak. */
-			return ret;
-		}
-#else /* !IPTOS_PREC_INTERNETCONTROL */
-#warning "IP_HDRINCL not available, nor is IPTOS_PREC_INTERNETCONTROL"
-		zlog_warn("IP_HDRINCL option not available");
-#endif /* IP_HDRINCL */
-
-		ret = setsockopt_ifindex(AF_INET, eigrp_sock, 1);
-		if (ret < 0)
-			zlog_warn("Can't set pktinfo option for fd %d",
-				  eigrp_sock);
-	}
-
-	return eigrp_sock;
-}
-
-void eigrp_adjust_sndbuflen(eigrp_instance_t *eigrp, unsigned int buflen)
-{
-	int newbuflen;
-	/* Check if any work has to be done at all. */
-	if (eigrp->maxsndbuflen >= buflen)
-		return;
-
-	/* Now we try to set SO_SNDBUF to what our caller has requested
-	 * (the MTU of a newly added interface). However, if the OS has
-	 * truncated the actual buffer size to somewhat less size, try
-	 * to detect it and update our records appropriately. The OS
-	 * may allocate more buffer space, than requested, this isn't
-	 * a error.
-	 */
-	setsockopt_so_sendbuf(eigrp->fd, buflen);
-	newbuflen = getsockopt_so_sendbuf(eigrp->fd);
-	if (newbuflen < 0 || newbuflen < (int)buflen)
-		zlog_warn("%s: tried to set SO_SNDBUF to %u, but got %d",
-			  __func__, buflen, newbuflen);
-	if (newbuflen >= 0)
-		eigrp->maxsndbuflen = (unsigned int)newbuflen;
-	else
-		zlog_warn("%s: failed to get SO_SNDBUF", __func__);
-}
-
-int eigrp_intf_ipmulticast(eigrp_instance_t *top, struct prefix *p,
-			   unsigned int ifindex)
-{
-	uint8_t val;
-	int ret, len;
-
-	val = 0;
-	len = sizeof(val);
-
-	/* Prevent receiving self-origined multicast packets. */
-	ret = setsockopt(top->fd, IPPROTO_IP, IP_MULTICAST_LOOP, (void *)&val,
-			 len);
-	if (ret < 0)
-		zlog_warn(
-			"can't setsockopt IP_MULTICAST_LOOP (0) for fd %d: %s",
-			top->fd, safe_strerror(errno));
-
-	/* Explicitly set multicast ttl to 1 -- endo. */
-	val = 1;
-	ret = setsockopt(top->fd, IPPROTO_IP, IP_MULTICAST_TTL, (void *)&val,
-			 len);
-	if (ret < 0)
-		zlog_warn("can't setsockopt IP_MULTICAST_TTL (1) for fd %d: %s",
-			  top->fd, safe_strerror(errno));
-
-	ret = setsockopt_ipv4_multicast_if(top->fd, p->u.prefix4, ifindex);
-	if (ret < 0)
-		zlog_warn(
-			"can't setsockopt IP_MULTICAST_IF (fd %d, addr %s, "
-			"ifindex %u): %s",
-			top->fd, eigrp_print_prefix(p), ifindex,
-			safe_strerror(errno));
-
-	return ret;
-}
-
-/* Join to the EIGRP multicast group. */
-int eigrp_intf_add_allspfrouters(eigrp_instance_t *top, struct prefix *p,
-				 unsigned int ifindex)
-{
-	int ret;
-
-	ret = setsockopt_ipv4_multicast(
-		top->fd, IP_ADD_MEMBERSHIP, p->u.prefix4,
-		htonl(EIGRP_MULTICAST_ADDRESS), ifindex);
-	if (ret < 0)
-		zlog_warn(
-			"can't setsockopt IP_ADD_MEMBERSHIP (fd %d, addr %s, "
-			"ifindex %u, AllSPFRouters): %s; perhaps a kernel limit "
-			"on # of multicast group memberships has been exceeded?",
-			top->fd, eigrp_print_prefix(p), ifindex,
-			safe_strerror(errno));
-	else
-		zlog_debug("interface %s [%u] join EIGRP Multicast group.",
-			   eigrp_print_prefix(p), ifindex);
-
-	return ret;
-}
-
-int eigrp_intf_drop_allspfrouters(eigrp_instance_t *top, struct prefix *p,
-				  unsigned int ifindex)
-{
-	int ret;
-
-	ret = setsockopt_ipv4_multicast(
-		top->fd, IP_DROP_MEMBERSHIP, p->u.prefix4,
-		htonl(EIGRP_MULTICAST_ADDRESS), ifindex);
-	if (ret < 0)
-		zlog_warn(
-			"can't setsockopt IP_DROP_MEMBERSHIP (fd %d, addr %s, "
-			"ifindex %u, AllSPFRouters): %s",
-			top->fd, eigrp_print_prefix(p), ifindex,
-			safe_strerror(errno));
-	else
-		zlog_debug("interface %s [%u] leave EIGRP Multicast group.",
-			   eigrp_print_prefix(p), ifindex);
-
-	return ret;
-}
-
 int eigrp_network_set(eigrp_instance_t *eigrp, struct prefix *p)
 {
 	struct vrf *vrf = vrf_lookup_by_id(eigrp->vrf_id);
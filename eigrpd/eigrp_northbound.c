@@ -10,8 +10,11 @@
 #include "eigrp_structs.h"
 #include "eigrp_interface.h"
 #include "eigrp_network.h"
+#include "eigrp_topology.h"
 #include "eigrp_zebra.h"
 #include "eigrp_cli.h"
+#include "eigrp_active.h"
+#include "eigrp_summary.h"
 
 #include "lib/keychain.h"
 #include "lib/northbound.h"
@@ -228,17 +231,38 @@ eigrpd_instance_passive_interface_destroy(struct nb_cb_destroy_args *args)
  */
 static int eigrpd_instance_active_time_modify(struct nb_cb_modify_args *args)
 {
+	eigrp_instance_t *eigrp;
+
 	switch (args->event) {
 	case NB_EV_VALIDATE:
-		/* TODO: Not implemented. */
 	case NB_EV_PREPARE:
 	case NB_EV_ABORT:
-		return NB_OK;
+		/* NOTHING */
+		break;
 	case NB_EV_APPLY:
-		snprintf(args->errmsg, args->errmsg_len,
-			 "active time not implemented yet");
+		eigrp = nb_running_get_entry(args->dnode, NULL, true);
+		eigrp_active_time_set(eigrp,
+				      yang_dnode_get_uint16(args->dnode, NULL));
+		break;
+	}
+
+	return NB_OK;
+}
+
+static int eigrpd_instance_active_time_destroy(struct nb_cb_destroy_args *args)
+{
+	eigrp_instance_t *eigrp;
+
+	switch (args->event) {
+	case NB_EV_VALIDATE:
+	case NB_EV_PREPARE:
+	case NB_EV_ABORT:
 		/* NOTHING */
 		break;
+	case NB_EV_APPLY:
+		eigrp = nb_running_get_entry(args->dnode, NULL, true);
+		eigrp_active_time_set(eigrp, EIGRP_ACTIVE_TIME_DEFAULT);
+		break;
 	}
 
 	return NB_OK;
@@ -344,6 +368,7 @@ eigrpd_instance_metric_weights_K1_modify(struct nb_cb_modify_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[0] = yang_dnode_get_uint8(args->dnode, NULL);
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -364,6 +389,7 @@ eigrpd_instance_metric_weights_K1_destroy(struct nb_cb_destroy_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[0] = EIGRP_K1_DEFAULT;
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -387,6 +413,7 @@ eigrpd_instance_metric_weights_K2_modify(struct nb_cb_modify_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[1] = yang_dnode_get_uint8(args->dnode, NULL);
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -407,6 +434,7 @@ eigrpd_instance_metric_weights_K2_destroy(struct nb_cb_destroy_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[1] = EIGRP_K2_DEFAULT;
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -430,6 +458,7 @@ eigrpd_instance_metric_weights_K3_modify(struct nb_cb_modify_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[2] = yang_dnode_get_uint8(args->dnode, NULL);
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -450,6 +479,7 @@ eigrpd_instance_metric_weights_K3_destroy(struct nb_cb_destroy_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[2] = EIGRP_K3_DEFAULT;
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -473,6 +503,7 @@ eigrpd_instance_metric_weights_K4_modify(struct nb_cb_modify_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[3] = yang_dnode_get_uint8(args->dnode, NULL);
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -493,6 +524,7 @@ eigrpd_instance_metric_weights_K4_destroy(struct nb_cb_destroy_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[3] = EIGRP_K4_DEFAULT;
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -516,6 +548,7 @@ eigrpd_instance_metric_weights_K5_modify(struct nb_cb_modify_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[4] = yang_dnode_get_uint8(args->dnode, NULL);
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -536,6 +569,7 @@ eigrpd_instance_metric_weights_K5_destroy(struct nb_cb_destroy_args *args)
 	case NB_EV_APPLY:
 		eigrp = nb_running_get_entry(args->dnode, NULL, true);
 		eigrp->k_values[4] = EIGRP_K5_DEFAULT;
+		eigrp_topology_recompute(eigrp, NULL);
 		break;
 	}
 
@@ -944,7 +978,7 @@ static int lib_interface_eigrp_delay_modify(struct nb_cb_modify_args *args)
 			return NB_ERR_INCONSISTENCY;
 
 		ei->params.delay = yang_dnode_get_uint32(args->dnode, NULL);
-		eigrp_intf_reset(ifp);
+		eigrp_topology_recompute(ei->eigrp, ei);
 		break;
 	}
 
@@ -985,7 +1019,7 @@ static int lib_interface_eigrp_bandwidth_modify(struct nb_cb_modify_args *args)
 			return NB_ERR_INCONSISTENCY;
 
 		ei->params.bandwidth = yang_dnode_get_uint32(args->dnode, NULL);
-		eigrp_intf_reset(ifp);
+		eigrp_topology_recompute(ei->eigrp, ei);
 		break;
 	}
 
@@ -1163,15 +1197,18 @@ static int lib_interface_eigrp_instance_destroy(struct nb_cb_destroy_args *args)
 static int lib_interface_eigrp_instance_summarize_addresses_create(
 	struct nb_cb_create_args *args)
 {
+	eigrp_interface_t *intf;
+	struct prefix prefix;
+
 	switch (args->event) {
 	case NB_EV_VALIDATE:
-		/* TODO: Not implemented. */
 	case NB_EV_PREPARE:
 	case NB_EV_ABORT:
 		return NB_OK;
 	case NB_EV_APPLY:
-		snprintf(args->errmsg, args->errmsg_len,
-			 "summary command not implemented yet");
+		intf = nb_running_get_entry(args->dnode, NULL, true);
+		yang_dnode_get_ipv4p(&prefix, args->dnode, NULL);
+		eigrp_summary_add(intf, &prefix);
 		break;
 	}
 
@@ -1181,16 +1218,18 @@ static int lib_interface_eigrp_instance_summarize_addresses_create(
 static int lib_interface_eigrp_instance_summarize_addresses_destroy(
 	struct nb_cb_destroy_args *args)
 {
+	eigrp_interface_t *intf;
+	struct prefix prefix;
+
 	switch (args->event) {
 	case NB_EV_VALIDATE:
-		/* TODO: Not implemented. */
 	case NB_EV_PREPARE:
 	case NB_EV_ABORT:
 		return NB_OK;
 	case NB_EV_APPLY:
-		snprintf(args->errmsg, args->errmsg_len,
-			 "no summary command not implemented yet");
-		/* NOTHING */
+		intf = nb_running_get_entry(args->dnode, NULL, true);
+		yang_dnode_get_ipv4p(&prefix, args->dnode, NULL);
+		eigrp_summary_del(intf, &prefix);
 		break;
 	}
 
@@ -1314,6 +1353,7 @@ const struct frr_yang_module_info frr_eigrpd_info = {
 			.xpath = "/frr-eigrpd:eigrpd/instance/active-time",
 			.cbs = {
 				.modify = eigrpd_instance_active_time_modify,
+				.destroy = eigrpd_instance_active_time_destroy,
 				.cli_show = eigrp_cli_show_active_time,
 			}
 		},
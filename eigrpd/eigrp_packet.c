@@ -20,6 +20,7 @@
 #include "eigrpd/eigrp_topology.h"
 #include "eigrpd/eigrp_dump.h"
 #include "eigrpd/eigrp_errors.h"
+#include "eigrpd/eigrp_southbound.h"
 
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_PACKET,          "EIGRP Packet");
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_PACKET_QUEUE,    "EIGRP Packet Queue");
@@ -109,6 +110,33 @@ uint16_t eigrp_packet_encoder_both(eigrp_instance_t *eigrp,
 	return len1 + len2;
 }
 
+uint16_t eigrp_packet_sizer_safe(eigrp_instance_t *eigrp,
+				 eigrp_route_descriptor_t *route)
+{
+	(void)eigrp;
+	(void)route;
+	return 0;
+}
+
+uint16_t eigrp_packet_sizer_both(eigrp_instance_t *eigrp,
+				 eigrp_route_descriptor_t *route)
+{
+	uint16_t len1;
+	uint16_t len2;
+
+	if (!eigrp || !route)
+		return 0;
+
+	len1 = eigrp->tlv1_codec.sizer(eigrp, route);
+	len2 = eigrp->tlv2_codec.sizer(eigrp, route);
+
+	/* eigrp_packet_encoder_both() writes both or neither */
+	if (!len1 || !len2)
+		return 0;
+
+	return len1 + len2;
+}
+
 static int eigrp_retrans_count_exceeded(eigrp_packet_t *packet,
 					eigrp_neighbor_t *nbr)
 {
@@ -138,6 +166,11 @@ static void eigrp_packet_ack(eigrp_instance_t *eigrp, struct eigrp_header *eigrp
 			eigrp_update_send_EOT(nbr);
 		} else
 			eigrp_packet_send_reliably(eigrp, nbr);
+
+		/* initial sync is done once the EOT dump is fully acked */
+		if ((nbr->state == EIGRP_NEIGHBOR_UP)
+		    && (nbr->retrans_queue->count == 0))
+			eigrp_nbr_bringup_finish(nbr);
 	}
 
 	packet = eigrp_packet_queue_next(nbr->multicast_queue);
@@ -158,31 +191,13 @@ void eigrp_packet_write(struct event *event)
 	struct eigrp_header *eigrph;
 	eigrp_interface_t *ei;
 	eigrp_packet_t *packet;
-	struct sockaddr_in sa_dst;
-	struct ip iph;
-	struct msghdr msg;
-	struct iovec iov[2];
-	uint32_t seqno, ack;
-
-	int ret;
-	int flags = 0;
 	struct listnode *node;
-#ifdef WANT_EIGRP_PACKET_WRITE_FRAGMENT
-	static uint16_t ipid = 0;
-#endif /* WANT_EIGRP_PACKET_WRITE_FRAGMENT */
-#define EIGRP_PACKET_WRITE_IPHL_SHIFT 2
 
 	node = listhead(eigrp->oi_write_q);
 	assert(node);
 	ei = listgetdata(node);
 	assert(ei);
 
-#ifdef WANT_EIGRP_PACKET_WRITE_FRAGMENT
-	/* seed ipid static with low order bits of time */
-	if (ipid == 0)
-		ipid = (time(NULL) & 0xffff);
-#endif /* WANT_EIGRP_PACKET_WRITE_FRAGMENT */
-
 	/* Get one packet from queue. */
 	packet = eigrp_packet_queue_next(ei->obuf);
 	if (!packet) {
@@ -198,12 +213,6 @@ void eigrp_packet_write(struct event *event)
 		eigrp_packet_delete(ei);
 		goto out;
 	}
-	// DVS: ipv6 issue
-	if (packet->dst.ip.v4.s_addr == htonl(EIGRP_MULTICAST_ADDRESS))
-		eigrp_intf_ipmulticast(eigrp, &ei->address, ei->ifp->ifindex);
-
-	memset(&iph, 0, sizeof(struct ip));
-	memset(&sa_dst, 0, sizeof(sa_dst));
 
 	/*
 	 * We build and schedule packets to go out
@@ -214,85 +223,14 @@ void eigrp_packet_write(struct event *event)
 	 * this outgoing packet.
 	 */
 	eigrph = (struct eigrp_header *)STREAM_DATA(packet->s);
-	seqno = ntohl(eigrph->sequence);
-	ack = ntohl(eigrph->ack);
-	if (packet->nbr && (ack != packet->nbr->recv_sequence_number)) {
+	if (packet->nbr
+	    && (ntohl(eigrph->ack) != packet->nbr->recv_sequence_number)) {
 		eigrph->ack = htonl(packet->nbr->recv_sequence_number);
-		ack = packet->nbr->recv_sequence_number;
 		eigrph->checksum = 0;
 		eigrp_packet_checksum(ei, packet->s, packet->length);
 	}
 
-	sa_dst.sin_family = AF_INET;
-#ifdef HAVE_STRUCT_SOCKADDR_IN_SIN_LEN
-	sa_dst.sin_len = sizeof(sa_dst);
-#endif /* HAVE_STRUCT_SOCKADDR_IN_SIN_LEN */
-
-	// DVS: ipv6 issue
-	sa_dst.sin_addr = packet->dst.ip.v4;
-	sa_dst.sin_port = htons(0);
-
-	/* Set DONTROUTE flag if dst is unicast. */
-	if (!IN_MULTICAST(htonl(packet->dst.ip.v4.s_addr)))
-		flags = MSG_DONTROUTE;
-
-	iph.ip_hl = sizeof(struct ip) >> EIGRP_PACKET_WRITE_IPHL_SHIFT;
-	/* it'd be very strange for header to not be 4byte-word aligned but.. */
-	if (sizeof(struct ip)
-	    > (unsigned int)(iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT))
-		iph.ip_hl++; /* we presume sizeof struct ip cant overflow
-				ip_hl.. */
-
-	iph.ip_v = IPVERSION;
-	iph.ip_tos = IPTOS_PREC_INTERNETCONTROL;
-	iph.ip_len = (iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT) + packet->length;
-
-#if defined(__DragonFly__)
-	/*
-	 * DragonFly's raw socket expects ip_len/ip_off in network byte order.
-	 */
-	iph.ip_len = htons(iph.ip_len);
-#endif
-
-	iph.ip_off = 0;
-	iph.ip_ttl = EIGRP_IP_TTL;
-	iph.ip_p = IPPROTO_EIGRPIGP;
-	iph.ip_sum = 0;
-	// DVS: ipv6 issue
-	iph.ip_src.s_addr = ei->address.u.prefix4.s_addr;
-	iph.ip_dst.s_addr = packet->dst.ip.v4.s_addr;
-
-	memset(&msg, 0, sizeof(msg));
-	msg.msg_name = (caddr_t)&sa_dst;
-	msg.msg_namelen = sizeof(sa_dst);
-	msg.msg_iov = iov;
-	msg.msg_iovlen = 2;
-
-	iov[0].iov_base = (char *)&iph;
-	iov[0].iov_len = iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT;
-	iov[1].iov_base = stream_pnt(packet->s);
-	iov[1].iov_len = packet->length;
-
-	/* send final fragment (could be first) */
-	sockopt_iphdrincl_swab_htosys(&iph);
-	ret = sendmsg(eigrp->fd, &msg, flags);
-	sockopt_iphdrincl_swab_systoh(&iph);
-
-	if (IS_DEBUG_EIGRP_TRANSMIT(0, SEND)) {
-		eigrph = (struct eigrp_header *)STREAM_DATA(packet->s);
-		zlog_debug(
-			"Sending [%s][%d/%d] to [%s] via [%s] ret [%d].",
-			lookup_msg(eigrp_packet_type_str, eigrph->opcode, NULL),
-			seqno, ack, eigrp_print_addr(&packet->dst),
-			EIGRP_INTF_NAME(ei), ret);
-	}
-
-	if (ret < 0) //DVS: IPV6 issue
-		zlog_warn("*** sendmsg in eigrp_packet_write failed to %pI4, "
-			  "id %d, off %d, len %d, interface %s, mtu %u: %s",
-			  &iph.ip_dst, iph.ip_id, iph.ip_off,
-			  iph.ip_len, ei->ifp->name, ei->ifp->mtu,
-			  safe_strerror(errno));
+	eigrp_southbound_packet_send(eigrp, ei, packet);
 
 	/* Now delete packet from queue. */
 	eigrp_packet_delete(ei);
@@ -314,19 +252,9 @@ out:
 /* Starting point of packet process function. */
 void eigrp_packet_read(struct event *event)
 {
-	int ret;
 	struct stream *ibuf;
 	eigrp_instance_t *eigrp;
-	eigrp_interface_t *ei;
-	struct ip *iph;
-	struct eigrp_header *eigrph;
 	struct interface *ifp;
-	eigrp_addr_t src;
-	eigrp_neighbor_t *nbr;
-	struct in_addr srcaddr;
-	uint16_t opcode = 0;
-	uint16_t length = 0;
-	uint16_t ip_header_len = 0;
 
 	/* first of all get interface pointer. */
 	eigrp = EVENT_ARG(event);
@@ -341,6 +269,29 @@ void eigrp_packet_read(struct event *event)
 		return;
 	}
 
+	eigrp_packet_input(eigrp, ibuf, ifp);
+}
+
+/*
+ * Process one received datagram.  ibuf starts with the IPv4 header, ip_len
+ * in host order; ifp is the receiving interface, or NULL if the host could
+ * not tell.  Whatever delivered the datagram, the socket or a simulator,
+ * everything from here on is the same.
+ */
+void eigrp_packet_input(eigrp_instance_t *eigrp, struct stream *ibuf,
+			struct interface *ifp)
+{
+	int ret;
+	eigrp_interface_t *ei;
+	struct ip *iph;
+	struct eigrp_header *eigrph;
+	eigrp_addr_t src;
+	eigrp_neighbor_t *nbr;
+	struct in_addr srcaddr;
+	uint16_t opcode = 0;
+	uint16_t length = 0;
+	uint16_t ip_header_len = 0;
+
 	/* Note that there should not be alignment problems with this assignment
 	   because this is at the beginning of the stream data buffer. */
 	iph = (struct ip *)STREAM_DATA(ibuf);
@@ -647,6 +598,7 @@ void eigrp_packet_queue_free(eigrp_packet_queue_t *queue)
 	}
 	queue->head = queue->tail = NULL;
 	queue->count = 0;
+	queue->bytes = 0;
 
 	XFREE(MTYPE_EIGRP_PACKET_QUEUE, queue);
 }
@@ -663,6 +615,7 @@ void eigrp_packet_queue_reset(eigrp_packet_queue_t *queue)
 	}
 	queue->head = queue->tail = NULL;
 	queue->count = 0;
+	queue->bytes = 0;
 }
 
 eigrp_packet_t *eigrp_packet_new(size_t size, eigrp_neighbor_t *nbr)
@@ -786,6 +739,17 @@ void eigrp_packet_header_init(int type, eigrp_instance_t *eigrp, struct stream *
 	stream_forward_endp(s, EIGRP_HEADER_LEN);
 }
 
+/* Heap held by a queued packet: the packet, its stream and the buffer. */
+static size_t eigrp_packet_bytes(eigrp_packet_t *packet)
+{
+	size_t bytes = sizeof(*packet);
+
+	if (packet->s)
+		bytes += sizeof(*packet->s) + STREAM_SIZE(packet->s);
+
+	return bytes;
+}
+
 /* Add new packet to head of queue. */
 void eigrp_packet_enqueue(eigrp_packet_queue_t *queue, eigrp_packet_t *packet)
 {
@@ -801,6 +765,11 @@ void eigrp_packet_enqueue(eigrp_packet_queue_t *queue, eigrp_packet_t *packet)
 	queue->head = packet;
 
 	queue->count++;
+	queue->bytes += eigrp_packet_bytes(packet);
+	if (queue->count > queue->count_peak)
+		queue->count_peak = queue->count;
+	if (queue->bytes > queue->bytes_peak)
+		queue->bytes_peak = queue->bytes;
 }
 
 /* Return last queue entry. */
@@ -1168,6 +1137,7 @@ eigrp_packet_t *eigrp_packet_dequeue(eigrp_packet_queue_t *queue)
 			queue->tail->next = NULL;
 
 		queue->count--;
+		queue->bytes -= eigrp_packet_bytes(packet);
 	}
 
 	return packet;
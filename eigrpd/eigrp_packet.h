@@ -37,6 +37,8 @@ typedef struct eigrp_tlv_header {
 
 /*Prototypes*/
 extern void eigrp_packet_read(struct event *);
+extern void eigrp_packet_input(eigrp_instance_t *, struct stream *,
+			       struct interface *);
 extern void eigrp_packet_write(struct event *);
 
 extern eigrp_packet_t *eigrp_packet_new(size_t, eigrp_neighbor_t *);
@@ -75,6 +77,10 @@ extern uint16_t eigrp_packet_encoder_both(eigrp_instance_t *,
 					 eigrp_interface_t *, eigrp_neighbor_t *,
 					 eigrp_stream_t *,
 					 eigrp_route_descriptor_t *);
+extern uint16_t eigrp_packet_sizer_safe(eigrp_instance_t *,
+				       eigrp_route_descriptor_t *);
+extern uint16_t eigrp_packet_sizer_both(eigrp_instance_t *,
+				       eigrp_route_descriptor_t *);
 
 /*
  * untill there is reason to have their own header, these externs are found in
@@ -10,11 +10,12 @@
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_auth.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_dump.h"
-
-DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_PACKETIZER_WORK,
-		    "EIGRP packetizer work");
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_stub.h"
+#include "eigrpd/eigrp_summary.h"
 
 static bool eigrp_packetizer_opcode_valid(uint8_t opcode)
 {
@@ -30,21 +31,21 @@ static bool eigrp_packetizer_opcode_valid(uint8_t opcode)
 	}
 }
 
-
 static eigrp_route_descriptor_t *
-eigrp_packetizer_poison_route_create(eigrp_prefix_descriptor_t *prefix)
+eigrp_packetizer_poison_route_create(eigrp_instance_t *eigrp,
+				     eigrp_prefix_descriptor_t *prefix)
 {
 	eigrp_route_descriptor_t *route;
 
-	if (!prefix || !prefix->destination)
+	if (!prefix)
 		return NULL;
 
-	route = eigrp_topology_route_create(NULL);
+	route = eigrp_topology_route_create(eigrp, NULL);
 	if (!route)
 		return NULL;
 
 	route->prefix = prefix;
-	route->dest = *prefix->destination;
+	prefix_copy(&route->dest, eigrp_topology_prefix_dest(prefix));
 	route->type = (prefix->nt == EIGRP_TOPOLOGY_TYPE_REMOTE_EXTERNAL)
 			      ? EIGRP_TLV_IPv4_EXT
 			      : EIGRP_TLV_IPv4_INT;
@@ -79,64 +80,35 @@ static void eigrp_packetizer_neighbor_stat(eigrp_neighbor_t *nbr,
 	}
 }
 
-static void eigrp_packetizer_neighbor_route_send(eigrp_instance_t *eigrp,
-						 eigrp_packetizer_work_t *work)
+static eigrp_packet_t *eigrp_packetizer_packet_new(eigrp_instance_t *eigrp,
+						  eigrp_interface_t *ei,
+						  eigrp_neighbor_t *nbr,
+						  uint8_t opcode,
+						  uint16_t *length)
 {
-	eigrp_neighbor_t *nbr = work->nbr;
-	eigrp_prefix_descriptor_t *prefix = work->prefix;
-	eigrp_interface_t *ei;
 	eigrp_packet_t *packet;
-	eigrp_route_descriptor_t *route;
-	struct list *successors = NULL;
-	bool free_route = false;
-	uint32_t sequence;
-	uint16_t tlv_length;
-	uint16_t length = EIGRP_HEADER_LEN;
-
-	if (!eigrp || !nbr || !nbr->ei || !prefix)
-		return;
-
-	if (nbr->state != EIGRP_NEIGHBOR_UP)
-		return;
 
-	ei = nbr->ei;
-	sequence = eigrp_packet_sequence_reserve(eigrp);
 	packet = eigrp_packet_new(EIGRP_PACKET_MTU(ei->ifp->mtu), nbr);
-	eigrp_packet_header_init(work->opcode, eigrp, packet->s, 0, sequence, 0);
+	packet->sequence_number = eigrp_packet_sequence_reserve(eigrp);
+	packet->sequence_reserved = true;
+	eigrp_packet_header_init(opcode, eigrp, packet->s, 0,
+				 packet->sequence_number, 0);
 
+	*length = EIGRP_HEADER_LEN;
 	if (ei->params.auth_type == EIGRP_AUTH_TYPE_MD5
 	    && ei->params.auth_keychain != NULL)
-		length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
+		*length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
 
-	route = work->route;
-	if (!route) {
-		successors = eigrp_topology_get_successor(prefix);
-		if (successors)
-			route = listnode_head(successors);
-
-		if (!route) {
-			route = eigrp_packetizer_poison_route_create(prefix);
-			free_route = true;
-		}
-
-		if (!route) {
-			if (successors)
-				list_delete(&successors);
-			eigrp_packet_free(packet);
-			return;
-		}
-	}
+	return packet;
+}
 
-	tlv_length = nbr->encoder(eigrp, ei, nbr, packet->s, route);
-	if (successors)
-		list_delete(&successors);
-	if (free_route)
-		eigrp_topology_route_free(route);
-	if (!tlv_length) {
-		eigrp_packet_free(packet);
-		return;
-	}
-	length += tlv_length;
+static void eigrp_packetizer_neighbor_packet_send(eigrp_instance_t *eigrp,
+						  eigrp_neighbor_t *nbr,
+						  eigrp_packet_t *packet,
+						  uint16_t length,
+						  uint8_t opcode, uint32_t tlvs)
+{
+	eigrp_interface_t *ei = nbr->ei;
 
 	if (ei->params.auth_type == EIGRP_AUTH_TYPE_MD5
 	    && ei->params.auth_keychain != NULL)
@@ -145,88 +117,167 @@ static void eigrp_packetizer_neighbor_route_send(eigrp_instance_t *eigrp,
 	eigrp_packet_checksum(ei, packet->s, length);
 	packet->length = length;
 	eigrp_addr_copy(&packet->dst, &nbr->src);
-	packet->sequence_number = sequence;
-	packet->sequence_reserved = true;
 
 	eigrp_packet_enqueue(nbr->retrans_queue, packet);
-	eigrp_packetizer_neighbor_stat(nbr, work->opcode);
+	eigrp_packetizer_neighbor_stat(nbr, opcode);
+	eigrp_packetizer_packet_stat(eigrp, opcode, tlvs, length,
+				     EIGRP_PACKET_MTU(ei->ifp->mtu));
 
 	if (nbr->retrans_queue->count == 1)
 		eigrp_packet_send_reliably(eigrp, nbr);
 }
 
+/* Packets go out for the opcodes of a neighbor chain in this order */
+static const uint8_t eigrp_packetizer_neighbor_opcodes[] = {
+	EIGRP_OPC_REPLY,
+	EIGRP_OPC_SIAREPLY,
+	EIGRP_OPC_SIAQUERY,
+};
 
-static eigrp_neighbor_t *eigrp_packetizer_query_encoder_neighbor(
-	eigrp_interface_t *ei)
-{
-	eigrp_neighbor_t *nbr;
-	struct listnode *node;
-
-	for (ALL_LIST_ELEMENTS_RO(ei->nbrs, node, nbr)) {
-		if (nbr->state == EIGRP_NEIGHBOR_UP)
-			return nbr;
-	}
-
-	return NULL;
-}
-
-static void eigrp_packetizer_query_interface_send(eigrp_instance_t *eigrp,
-						  eigrp_interface_t *ei,
-						  eigrp_packetizer_work_t *work)
+/*
+ * Send the routes of a work item, and of the work chained behind it, to
+ * its neighbor.  The chain holds every REPLY (or SIA-REPLY, SIA-QUERY)
+ * queued for the neighbor since the packetizer last ran, so a burst of
+ * QUERYs is answered with a few full packets rather than one packet and
+ * one ACK per prefix.  A merge may have turned an SIA-REPLY in the chain
+ * into a REPLY; REPLYs go first.  Each prefix is still answered from its
+ * own state when it is encoded.
+ */
+static void eigrp_packetizer_neighbor_route_send(eigrp_instance_t *eigrp,
+						 eigrp_packetizer_work_t *work)
 {
-	eigrp_neighbor_t *nbr;
-	eigrp_prefix_descriptor_t *prefix = work->prefix;
-	eigrp_route_descriptor_t *route;
+	eigrp_neighbor_t *nbr = work->nbr;
+	eigrp_packetizer_work_t *item;
+	eigrp_prefix_descriptor_t *prefix;
+	eigrp_interface_t *ei;
 	eigrp_packet_t *packet;
-	struct listnode *node, *nnode;
-	struct list *successors;
-	uint32_t sequence;
+	eigrp_route_descriptor_t *route;
+	bool free_route;
+	uint32_t tlvs = 0;
+	uint32_t i;
 	uint16_t tlv_length;
-	uint16_t length = EIGRP_HEADER_LEN;
+	uint16_t length = 0;
 	uint16_t eigrp_mtu;
+	uint8_t opcode;
 
-	if (!eigrp || !ei || !prefix)
+	if (!eigrp || !nbr || !nbr->ei)
 		return;
 
-	if (work->exception == ei)
+	if (nbr->state != EIGRP_NEIGHBOR_UP)
 		return;
 
-	nbr = eigrp_packetizer_query_encoder_neighbor(ei);
-	if (!nbr)
-		return;
+	ei = nbr->ei;
+	eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
 
-	successors = eigrp_topology_get_successor(prefix);
-	if (!successors)
-		return;
+	for (i = 0; i < array_size(eigrp_packetizer_neighbor_opcodes); i++) {
+		opcode = eigrp_packetizer_neighbor_opcodes[i];
+		packet = NULL;
 
-	route = listnode_head(successors);
-	if (!route) {
-		list_delete(&successors);
-		return;
-	}
+		for (item = work; item; item = item->next) {
+			prefix = item->prefix;
+			if (!prefix || item->opcode != opcode)
+				continue;
 
-	eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
-	sequence = eigrp_packet_sequence_reserve(eigrp);
-	packet = eigrp_packet_new(eigrp_mtu, NULL);
-	eigrp_packet_header_init(work->opcode, eigrp, packet->s, 0, sequence, 0);
+			free_route = false;
+			route = item->route;
+			if (!route) {
+				route = eigrp_topology_successor_head(prefix);
 
-	if (ei->params.auth_type == EIGRP_AUTH_TYPE_MD5
-	    && ei->params.auth_keychain != NULL)
-		length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
+				/* a stub answers for what it does not advertise as unreachable */
+				if (route && !eigrp_stub_advertise(eigrp, route))
+					route = NULL;
 
-	tlv_length = ei->encoder(eigrp, ei, NULL, packet->s, route);
-	list_delete(&successors);
-	if (!tlv_length) {
-		eigrp_packet_free(packet);
-		return;
+				if (!route) {
+					route = eigrp_packetizer_poison_route_create(
+						eigrp, prefix);
+					free_route = true;
+				}
+
+				if (!route)
+					continue;
+			}
+
+			tlv_length = nbr->sizer(eigrp, route);
+			if (!tlv_length) {
+				if (free_route)
+					eigrp_topology_route_free(route);
+				continue;
+			}
+
+			if (packet && length + tlv_length > eigrp_mtu) {
+				eigrp_packetizer_neighbor_packet_send(
+					eigrp, nbr, packet, length, opcode, tlvs);
+				packet = NULL;
+			}
+			if (!packet) {
+				packet = eigrp_packetizer_packet_new(eigrp, ei, nbr,
+								     opcode,
+								     &length);
+				tlvs = 0;
+			}
+
+			tlv_length = nbr->encoder(eigrp, ei, nbr, packet->s,
+						  route);
+			if (free_route)
+				eigrp_topology_route_free(route);
+			if (!tlv_length)
+				continue;
+			length += tlv_length;
+			tlvs++;
+		}
+
+		if (!packet)
+			continue;
+
+		if (tlvs)
+			eigrp_packetizer_neighbor_packet_send(eigrp, nbr, packet,
+							      length, opcode,
+							      tlvs);
+		else
+			eigrp_packet_free(packet);
 	}
-	length += tlv_length;
+}
 
-	for (ALL_LIST_ELEMENTS(ei->nbrs, node, nnode, nbr)) {
-		if (nbr->state == EIGRP_NEIGHBOR_UP)
-			listnode_add(prefix->rij, nbr);
+/*
+ * Neighbors on the interface a QUERY goes to.  Stub neighbors are left
+ * out: a stub is never a transit path, so it has nothing to tell us and
+ * waiting for its REPLY only slows convergence.
+ */
+static uint32_t eigrp_packetizer_query_neighbors(eigrp_interface_t *ei,
+						 uint32_t *stubs)
+{
+	eigrp_neighbor_t *nbr;
+	struct listnode *node;
+	uint32_t count = 0;
+
+	*stubs = 0;
+	for (ALL_LIST_ELEMENTS_RO(ei->nbrs, node, nbr)) {
+		if (nbr->state != EIGRP_NEIGHBOR_UP)
+			continue;
+		if (nbr->stub)
+			(*stubs)++;
+		else
+			count++;
 	}
 
+	return count;
+}
+
+/*
+ * Seal a QUERY and queue a copy on every queried neighbor.  The packet
+ * itself is multicast once if it is the first thing some neighbor is
+ * waiting to have acknowledged.
+ */
+static void eigrp_packetizer_query_packet_send(eigrp_instance_t *eigrp,
+					       eigrp_interface_t *ei,
+					       eigrp_packet_t *packet,
+					       uint16_t length, uint8_t opcode,
+					       uint32_t stubs, uint32_t tlvs)
+{
+	eigrp_neighbor_t *nbr;
+	struct listnode *node, *nnode;
+	bool initial_multicast_send = false;
+
 	if (ei->params.auth_type == EIGRP_AUTH_TYPE_MD5
 	    && ei->params.auth_keychain != NULL)
 		eigrp_make_md5_digest(ei, packet->s, EIGRP_AUTH_UPDATE_FLAG);
@@ -234,47 +285,151 @@ static void eigrp_packetizer_query_interface_send(eigrp_instance_t *eigrp,
 	eigrp_packet_checksum(ei, packet->s, length);
 	packet->length = length;
 	packet->dst.ip.v4.s_addr = htonl(EIGRP_MULTICAST_ADDRESS);
-	packet->sequence_number = sequence;
-	packet->sequence_reserved = true;
 
-	{
-		bool initial_multicast_send = false;
+	for (ALL_LIST_ELEMENTS(ei->nbrs, node, nnode, nbr)) {
+		eigrp_packet_t *dup;
+		bool queue_was_empty;
+
+		if (nbr->state != EIGRP_NEIGHBOR_UP || nbr->stub)
+			continue;
+
+		queue_was_empty = (nbr->retrans_queue->count == 0);
+		dup = eigrp_packet_duplicate(packet, nbr);
+
+		/*
+		 * Stubs on the segment would hear a multicast, so
+		 * with any present the QUERY goes unicast.
+		 */
+		if (stubs)
+			eigrp_addr_copy(&dup->dst, &nbr->src);
+		eigrp_packet_enqueue(nbr->retrans_queue, dup);
+
+		if (!queue_was_empty)
+			continue;
+
+		if (stubs) {
+			eigrp_packet_send_reliably(eigrp, nbr);
+		} else {
+			eigrp_packet_retransmit_timer_start(nbr);
+			initial_multicast_send = true;
+		}
+	}
 
-		for (ALL_LIST_ELEMENTS(ei->nbrs, node, nnode, nbr)) {
-			eigrp_packet_t *dup;
-			bool queue_was_empty;
+	if (initial_multicast_send)
+		eigrp_packet_output_enqueue(eigrp, ei, packet);
+	else
+		eigrp_packet_free(packet);
 
-			if (nbr->state != EIGRP_NEIGHBOR_UP)
-				continue;
+	if (opcode == EIGRP_OPC_SIAQUERY)
+		ei->stats.sent.siaQuery++;
+	else
+		ei->stats.sent.query++;
+	eigrp_packetizer_packet_stat(eigrp, opcode, tlvs, length,
+				     EIGRP_PACKET_MTU(ei->ifp->mtu));
+}
 
-			queue_was_empty = (nbr->retrans_queue->count == 0);
-			dup = eigrp_packet_duplicate(packet, nbr);
-			eigrp_packet_enqueue(nbr->retrans_queue, dup);
+/*
+ * Query the neighbors on one interface for every prefix of the work chain.
+ * The TLVs are packed into as few packets as the MTU allows, so a
+ * neighbor loss that takes thousands of prefixes active costs each peer a
+ * few dozen packets and ACKs, not one per prefix.  Reply tracking and the
+ * query scope statistics are still kept per prefix.
+ */
+static void eigrp_packetizer_query_interface_send(eigrp_instance_t *eigrp,
+						  eigrp_interface_t *ei,
+						  eigrp_packetizer_work_t *work)
+{
+	eigrp_neighbor_t *nbr;
+	eigrp_packetizer_work_t *item;
+	eigrp_prefix_descriptor_t *prefix;
+	eigrp_route_descriptor_t *route;
+	eigrp_packet_t *packet = NULL;
+	struct listnode *node, *nnode;
+	uint32_t queried, stubs;
+	uint16_t tlv_length;
+	uint16_t length = 0;
+	uint16_t eigrp_mtu;
+	uint32_t tlvs = 0;
 
-			if (queue_was_empty) {
-				eigrp_packet_retransmit_timer_start(nbr);
-				initial_multicast_send = true;
-			}
+	if (!eigrp || !ei)
+		return;
+
+	if (work->exception == ei)
+		return;
+
+	queried = eigrp_packetizer_query_neighbors(ei, &stubs);
+	eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
+
+	for (item = work; item; item = item->next) {
+		prefix = item->prefix;
+		if (!prefix)
+			continue;
+
+		/* neighbors behind a summary never heard of its components */
+		if (eigrp_summary_suppress(ei, prefix))
+			continue;
+
+		if (work->opcode == EIGRP_OPC_QUERY)
+			eigrp->query_stats.stub_skipped += stubs;
+		if (!queried)
+			continue;
+
+		route = eigrp_topology_successor_head(prefix);
+		if (!route)
+			continue;
+
+		tlv_length = ei->sizer(eigrp, route);
+		if (!tlv_length)
+			continue;
+
+		if (packet && length + tlv_length > eigrp_mtu) {
+			eigrp_packetizer_query_packet_send(eigrp, ei, packet,
+							   length, work->opcode,
+							   stubs, tlvs);
+			packet = NULL;
+		}
+		if (!packet) {
+			packet = eigrp_packetizer_packet_new(eigrp, ei, NULL,
+							     work->opcode,
+							     &length);
+			tlvs = 0;
 		}
 
-		if (initial_multicast_send)
-			eigrp_packet_output_enqueue(eigrp, ei, packet);
-		else
-			eigrp_packet_free(packet);
+		tlv_length = ei->encoder(eigrp, ei, NULL, packet->s, route);
+		if (!tlv_length)
+			continue;
+		length += tlv_length;
+		tlvs++;
+
+		for (ALL_LIST_ELEMENTS(ei->nbrs, node, nnode, nbr)) {
+			if (nbr->state == EIGRP_NEIGHBOR_UP && !nbr->stub)
+				eigrp_topology_rij_add(prefix, nbr);
+		}
+		if (work->opcode == EIGRP_OPC_QUERY) {
+			eigrp->query_stats.neighbors += queried;
+			if (!item->next)
+				eigrp->query_stats.last_neighbors += queried;
+		}
 	}
-	if (work->opcode == EIGRP_OPC_SIAQUERY)
-		ei->stats.sent.siaQuery++;
+
+	if (!packet)
+		return;
+
+	if (tlvs)
+		eigrp_packetizer_query_packet_send(eigrp, ei, packet, length,
+						   work->opcode, stubs, tlvs);
 	else
-		ei->stats.sent.query++;
+		eigrp_packet_free(packet);
 }
 
 static void eigrp_packetizer_query_send(eigrp_instance_t *eigrp,
 					 eigrp_packetizer_work_t *work)
 {
+	eigrp_packetizer_work_t *item;
 	eigrp_interface_t *ei;
 	struct listnode *node;
 
-	if (!eigrp || !work || !work->prefix)
+	if (!eigrp || !work)
 		return;
 
 	if (work->nbr) {
@@ -282,16 +437,100 @@ static void eigrp_packetizer_query_send(eigrp_instance_t *eigrp,
 		return;
 	}
 
+	/* only a QUERY goes out on every interface */
+	if (work->opcode != EIGRP_OPC_QUERY)
+		return;
+
+	for (item = work; item; item = item->next)
+		if (item->prefix)
+			eigrp->query_stats.prefixes++;
+	eigrp->query_stats.last_neighbors = 0;
+
 	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei))
 		eigrp_packetizer_query_interface_send(eigrp, ei, work);
 }
 
+/*
+ * Where the work waiting for the same destination is kept: the instance
+ * for UPDATE and QUERY, the neighbor for what goes to one neighbor.  New
+ * work for a destination with work waiting joins that work instead of
+ * being queued on its own.  A merge may change the opcode of the work
+ * later, so the head remembers the slot it was registered in.
+ */
+static eigrp_packetizer_work_t **
+eigrp_packetizer_chain_slot(eigrp_instance_t *eigrp,
+			    eigrp_packetizer_work_t *work)
+{
+	eigrp_neighbor_t *nbr = work->nbr;
+
+	switch (work->opcode) {
+	case EIGRP_OPC_UPDATE:
+		return &eigrp->update_work;
+	case EIGRP_OPC_QUERY:
+		return nbr ? NULL : &eigrp->query_work;
+	case EIGRP_OPC_REPLY:
+		return nbr ? &nbr->reply_work : NULL;
+	case EIGRP_OPC_SIAREPLY:
+		return nbr ? &nbr->siareply_work : NULL;
+	case EIGRP_OPC_SIAQUERY:
+		return nbr ? &nbr->siaquery_work : NULL;
+	default:
+		return NULL;
+	}
+}
+
+static void eigrp_packetizer_prefix_unlink(eigrp_packetizer_work_t *work)
+{
+	eigrp_packetizer_work_t **pp;
+
+	if (!(work->flags & EIGRP_PACKETIZER_WORK_F_LINKED))
+		return;
+
+	for (pp = &work->prefix->work; *pp; pp = &(*pp)->pe_next)
+		if (*pp == work) {
+			*pp = work->pe_next;
+			break;
+		}
+	work->pe_next = NULL;
+	work->flags &= ~EIGRP_PACKETIZER_WORK_F_LINKED;
+}
+
+/*
+ * The work is running or going away.  Work for its destination or its
+ * prefixes from now on starts over; the state it reads is already the
+ * latest.
+ */
+static void eigrp_packetizer_detach(eigrp_packetizer_work_t *work)
+{
+	eigrp_packetizer_work_t *item;
+
+	if (work->slot && *work->slot == work)
+		*work->slot = NULL;
+	work->slot = NULL;
+
+	for (item = work; item; item = item->next)
+		eigrp_packetizer_prefix_unlink(item);
+}
+
 static void eigrp_packetizer_work_process(eigrp_instance_t *eigrp,
 					  eigrp_packetizer_work_t *work)
 {
 	if (!eigrp || !work)
 		return;
 
+	eigrp_packetizer_detach(work);
+
+	/*
+	 * Work addressed to one neighbor lost its address when the neighbor
+	 * went down.  It must not fall through to the interface path, which
+	 * would put it to every neighbor.
+	 */
+	if (!work->nbr && work->opcode != EIGRP_OPC_UPDATE
+	    && work->opcode != EIGRP_OPC_QUERY) {
+		eigrp->packetizer_queue_stats.dropped++;
+		return;
+	}
+
 	switch (work->opcode) {
 	case EIGRP_OPC_UPDATE:
 		eigrp_update_packetize_all(eigrp, work->exception);
@@ -323,6 +562,7 @@ static void eigrp_packetizer_work_queue_delete(eigrp_work_queue_t *queue,
 					       void *data)
 {
 	(void)queue;
+	eigrp_packetizer_detach(data);
 	eigrp_packetizer_work_free(data);
 }
 
@@ -341,46 +581,255 @@ void eigrp_packetizer_finish(eigrp_instance_t *eigrp)
 	if (!eigrp)
 		return;
 
+	event_cancel(&eigrp->t_dual_flush);
+	eigrp->flush_exception = NULL;
+
 	eigrp_work_queue_free(eigrp->packetizer_queue);
 	eigrp->packetizer_queue = NULL;
 }
 
-eigrp_packetizer_work_t *eigrp_packetizer_work_new(uint8_t opcode)
+eigrp_packetizer_work_t *eigrp_packetizer_work_new(eigrp_instance_t *eigrp,
+						   uint8_t opcode)
 {
 	eigrp_packetizer_work_t *work;
 
-	work = XCALLOC(MTYPE_EIGRP_PACKETIZER_WORK, sizeof(*work));
+	work = eigrp_slab_obj_create(&eigrp->work_slab);
 	work->opcode = opcode;
 	return work;
 }
 
 void eigrp_packetizer_work_free(eigrp_packetizer_work_t *work)
 {
-	if (!work)
-		return;
+	eigrp_packetizer_work_t *next;
+
+	for (; work; work = next) {
+		next = work->next;
+
+		if ((work->flags & EIGRP_PACKETIZER_WORK_F_OWN_ROUTE)
+		    && work->route)
+			eigrp_topology_route_free(work->route);
 
-	if ((work->flags & EIGRP_PACKETIZER_WORK_F_OWN_ROUTE) && work->route)
-		eigrp_topology_route_free(work->route);
+		if ((work->flags & EIGRP_PACKETIZER_WORK_F_OWN_PREFIX)
+		    && work->prefix)
+			eigrp_topology_prefix_free(work->prefix);
 
-	if ((work->flags & EIGRP_PACKETIZER_WORK_F_OWN_PREFIX) && work->prefix)
-		eigrp_topology_prefix_free(work->prefix);
+		eigrp_slab_obj_free(work);
+	}
+}
+
+/*
+ * Fold work into old, which waits for the same prefix and neighbor.  The
+ * prefix is read when the work runs, so only the opcode and a route
+ * handed in with the work can differ.  A REPLY ends everything an
+ * SIA-REPLY would, so it upgrades a waiting SIA-REPLY, and an SIA-REPLY
+ * behind a waiting REPLY has nothing left to say.
+ */
+static bool eigrp_packetizer_merge(eigrp_instance_t *eigrp,
+				   eigrp_packetizer_work_t *old,
+				   eigrp_packetizer_work_t *work)
+{
+	uint32_t own = EIGRP_PACKETIZER_WORK_F_OWN_ROUTE;
+
+	if (old->opcode != work->opcode) {
+		if (old->opcode == EIGRP_OPC_REPLY
+		    && work->opcode == EIGRP_OPC_SIAREPLY)
+			return true;
+		if (old->opcode != EIGRP_OPC_SIAREPLY
+		    || work->opcode != EIGRP_OPC_REPLY)
+			return false;
+
+		old->opcode = EIGRP_OPC_REPLY;
+		eigrp->packetizer_queue_stats.upgraded++;
+	}
+
+	if (work->route) {
+		if ((old->flags & own) && old->route)
+			eigrp_topology_route_free(old->route);
+		old->route = work->route;
+		old->flags = (old->flags & ~own) | (work->flags & own);
+		work->route = NULL;
+		work->flags &= ~own;
+	}
 
-	XFREE(MTYPE_EIGRP_PACKETIZER_WORK, work);
+	return true;
 }
 
 void eigrp_packetizer_enqueue(eigrp_instance_t *eigrp,
 			      eigrp_packetizer_work_t *work)
 {
+	eigrp_packetizer_queue_stats_t *stats;
+	eigrp_packetizer_work_t **slot;
+	eigrp_packetizer_work_t *old;
+	eigrp_prefix_descriptor_t *prefix;
+
 	if (!eigrp || !work)
 		return;
 
+	stats = &eigrp->packetizer_queue_stats;
+	prefix = work->prefix;
+
 	if (!eigrp_packetizer_opcode_valid(work->opcode)) {
 		eigrp_packetizer_work_free(work);
 		return;
 	}
 
+	/* DUAL still runs for a deleted neighbor's routes; it gets nothing */
+	if (work->nbr && work->nbr->deleted) {
+		stats->dropped++;
+		eigrp_packetizer_work_free(work);
+		return;
+	}
+
+	/* work still waiting for the prefix and neighbor takes this in */
+	if (prefix && !(work->flags & EIGRP_PACKETIZER_WORK_F_OWN_PREFIX)) {
+		for (old = prefix->work; old; old = old->pe_next) {
+			if (old->nbr != work->nbr
+			    || !eigrp_packetizer_merge(eigrp, old, work))
+				continue;
+
+			stats->coalesced++;
+			eigrp_packetizer_work_free(work);
+			return;
+		}
+
+		work->pe_next = prefix->work;
+		prefix->work = work;
+		work->flags |= EIGRP_PACKETIZER_WORK_F_LINKED;
+	}
+
+	slot = eigrp_packetizer_chain_slot(eigrp, work);
+	if (slot && *slot) {
+		/* one UPDATE run covers every interface it was asked for */
+		if (work->opcode == EIGRP_OPC_UPDATE) {
+			if ((*slot)->exception != work->exception)
+				(*slot)->exception = NULL;
+			stats->coalesced++;
+			eigrp_packetizer_work_free(work);
+			return;
+		}
+
+		(*slot)->tail->next = work;
+		(*slot)->tail = work;
+		stats->chained++;
+		return;
+	}
+	if (slot) {
+		work->tail = work;
+		work->slot = slot;
+		*slot = work;
+	}
+
 	if (!eigrp->packetizer_queue)
 		eigrp_packetizer_init(eigrp);
 
 	eigrp_work_queue_enqueue(eigrp->packetizer_queue, work);
+	stats->enqueued++;
+}
+
+/*
+ * The neighbor is going away.  Its gathered work is still on the work
+ * queue; with no neighbor left it is dropped when it comes up.
+ */
+void eigrp_packetizer_neighbor_down(eigrp_neighbor_t *nbr)
+{
+	eigrp_packetizer_work_t **slots[] = {
+		&nbr->reply_work,
+		&nbr->siareply_work,
+		&nbr->siaquery_work,
+	};
+	eigrp_packetizer_work_t *item;
+	uint32_t i;
+
+	for (i = 0; i < array_size(slots); i++) {
+		if (*slots[i])
+			(*slots[i])->slot = NULL;
+		for (item = *slots[i]; item; item = item->next) {
+			eigrp_packetizer_prefix_unlink(item);
+			item->nbr = NULL;
+		}
+		*slots[i] = NULL;
+	}
+}
+
+/* The prefix is being deleted; its waiting work skips it. */
+void eigrp_packetizer_prefix_purge(eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_packetizer_work_t *work;
+
+	while ((work = pe->work)) {
+		eigrp_packetizer_prefix_unlink(work);
+		work->prefix = NULL;
+	}
+}
+
+void eigrp_packetizer_packet_stat(eigrp_instance_t *eigrp, uint8_t opcode,
+				  uint32_t tlvs, uint16_t length, uint16_t mtu)
+{
+	eigrp_packetizer_stats_t *stats;
+
+	if (opcode >= array_size(eigrp->packetizer_stats))
+		return;
+
+	stats = &eigrp->packetizer_stats[opcode];
+	stats->packets++;
+	stats->tlvs += tlvs;
+	stats->bytes += length;
+	stats->room += mtu;
+	if (tlvs > stats->max_tlvs)
+		stats->max_tlvs = tlvs;
+}
+
+static void eigrp_packetizer_flush_event(struct event *event)
+{
+	eigrp_instance_t *eigrp = EVENT_ARG(event);
+	eigrp_dual_flush_stats_t *stats = &eigrp->flush_stats;
+	uint32_t queries, updates;
+
+	queries = eigrp_query_send_all(eigrp);
+	updates = eigrp->dirty[EIGRP_DIRTY_UPDATE].count;
+	if (updates)
+		eigrp_update_send_all(eigrp, eigrp->flush_exception);
+	eigrp->flush_exception = NULL;
+
+	stats->flushes++;
+	stats->queries += queries;
+	stats->updates += updates;
+	stats->last_queries = queries;
+	stats->last_updates = updates;
+	if (queries > stats->max_queries)
+		stats->max_queries = queries;
+	if (updates > stats->max_updates)
+		stats->max_updates = updates;
+}
+
+/*
+ * Ask for the DUAL output of the current burst.  Receive paths and
+ * topology events used to packetize the dirty queues at the end of every
+ * packet; now they only schedule one flush per instance, which runs at the
+ * end of the current task, or eigrp->dual_flush_delay msec later when a
+ * coalescing delay is configured.  A prefix changed again before the flush
+ * is still queued once and is sent in its final state.
+ *
+ * exception is the interface the UPDATE should skip.  Requests that
+ * disagree on it widen the flush to every interface.
+ */
+void eigrp_packetizer_flush(eigrp_instance_t *eigrp,
+			    eigrp_interface_t *exception)
+{
+	eigrp->flush_stats.requests++;
+
+	if (eigrp->t_dual_flush) {
+		if (eigrp->flush_exception != exception)
+			eigrp->flush_exception = NULL;
+		return;
+	}
+
+	eigrp->flush_exception = exception;
+	if (eigrp->dual_flush_delay)
+		event_add_timer_msec(eigrpd_event, eigrp_packetizer_flush_event,
+				     eigrp, eigrp->dual_flush_delay,
+				     &eigrp->t_dual_flush);
+	else
+		event_add_event(eigrpd_event, eigrp_packetizer_flush_event,
+				eigrp, 0, &eigrp->t_dual_flush);
 }
@@ -10,8 +10,9 @@
 
 #define EIGRP_PACKETIZER_WORK_F_OWN_PREFIX 0x00000001U
 #define EIGRP_PACKETIZER_WORK_F_OWN_ROUTE  0x00000002U
+#define EIGRP_PACKETIZER_WORK_F_LINKED     0x00000004U /* on prefix->work */
 
-typedef struct eigrp_packetizer_work {
+struct eigrp_packetizer_work {
 	uint8_t opcode;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
@@ -19,14 +20,33 @@ typedef struct eigrp_packetizer_work {
 	eigrp_neighbor_t *nbr;
 	void *owner;
 	uint32_t flags;
-} eigrp_packetizer_work_t;
+
+	/* other work waiting for the same prefix, newest first */
+	eigrp_packetizer_work_t *pe_next;
+
+	/*
+	 * Later work for the same destination, packed with this: QUERYs for
+	 * the instance, REPLYs, SIA-REPLYs or SIA-QUERYs for one neighbor.
+	 * Only the head is on the work queue.
+	 */
+	eigrp_packetizer_work_t *next;
+	eigrp_packetizer_work_t *tail;
+	eigrp_packetizer_work_t **slot;
+};
 
 void eigrp_packetizer_init(eigrp_instance_t *eigrp);
 void eigrp_packetizer_finish(eigrp_instance_t *eigrp);
 
-eigrp_packetizer_work_t *eigrp_packetizer_work_new(uint8_t opcode);
+eigrp_packetizer_work_t *eigrp_packetizer_work_new(eigrp_instance_t *eigrp,
+						   uint8_t opcode);
 void eigrp_packetizer_work_free(eigrp_packetizer_work_t *work);
 void eigrp_packetizer_enqueue(eigrp_instance_t *eigrp,
 			      eigrp_packetizer_work_t *work);
+void eigrp_packetizer_flush(eigrp_instance_t *eigrp,
+			    eigrp_interface_t *exception);
+void eigrp_packetizer_neighbor_down(eigrp_neighbor_t *nbr);
+void eigrp_packetizer_prefix_purge(eigrp_prefix_descriptor_t *pe);
+void eigrp_packetizer_packet_stat(eigrp_instance_t *eigrp, uint8_t opcode,
+				  uint32_t tlvs, uint16_t length, uint16_t mtu);
 
 #endif /* _ZEBRA_EIGRP_PACKETIZER_H_ */
@@ -19,6 +19,8 @@
 #include "eigrpd/eigrp_auth.h"
 #include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_summary.h"
+#include "eigrpd/eigrp_dual_queue.h"
 
 
 static void eigrp_query_unknown_reply_send(eigrp_instance_t *eigrp,
@@ -31,18 +33,13 @@ static void eigrp_query_unknown_reply_send(eigrp_instance_t *eigrp,
 	if (!eigrp || !nbr || !query_route)
 		return;
 
-	prefix = eigrp_topology_prefix_create();
+	prefix = eigrp_topology_prefix_create(eigrp);
 	if (!prefix)
 		return;
 
-	prefix->destination = (struct prefix *)prefix_ipv4_new();
-	if (!prefix->destination) {
-		eigrp_topology_prefix_free(prefix);
-		return;
-	}
-	prefix_copy(prefix->destination, &query_route->dest);
+	prefix_copy(eigrp_topology_prefix_dest(prefix), &query_route->dest);
 
-	reply_route = eigrp_topology_route_create(nbr->ei);
+	reply_route = eigrp_topology_route_create(eigrp, nbr->ei);
 	if (!reply_route) {
 		eigrp_topology_prefix_free(prefix);
 		return;
@@ -61,28 +58,27 @@ static void eigrp_query_unknown_reply_send(eigrp_instance_t *eigrp,
 			      EIGRP_PACKETIZER_WORK_F_OWN_ROUTE);
 }
 
+/*
+ * Every prefix that went active since the last flush is handed to the
+ * packetizer, where the work chains into one QUERY run that packs them
+ * into shared packets.
+ */
 uint32_t eigrp_query_send_all(eigrp_instance_t *eigrp)
 {
 	eigrp_packetizer_work_t *work;
-	eigrp_prefix_descriptor_t *prefix;
-	struct listnode *node, *nnode;
+	eigrp_prefix_descriptor_t *prefix, *next;
 	uint32_t counter = 0;
 
 	if (!eigrp)
 		return 0;
 
-	for (ALL_LIST_ELEMENTS(eigrp->topology_changes, node, nnode, prefix)) {
-		if (!(prefix->req_action & EIGRP_FSM_NEED_QUERY))
-			continue;
-
-		work = eigrp_packetizer_work_new(EIGRP_OPC_QUERY);
+	EIGRP_TOPOLOGY_DIRTY_FOREACH (eigrp, EIGRP_DIRTY_QUERY, prefix, next) {
+		work = eigrp_packetizer_work_new(eigrp, EIGRP_OPC_QUERY);
 		work->prefix = prefix;
 		work->owner = prefix;
 		eigrp_packetizer_enqueue(eigrp, work);
 
-		prefix->req_action &= ~EIGRP_FSM_NEED_QUERY;
-		if (!prefix->req_action)
-			listnode_delete(eigrp->topology_changes, prefix);
+		eigrp_topology_dirty_remove(eigrp, prefix, EIGRP_FSM_NEED_QUERY);
 
 		counter++;
 	}
@@ -95,7 +91,6 @@ void eigrp_query_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			 struct eigrp_header *eigrph, struct stream *pkt,
 			 eigrp_interface_t *ei, int length)
 {
-	eigrp_fsm_action_message_t msg;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
 
@@ -123,38 +118,26 @@ void eigrp_query_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			eigrp_topology_route_free(route);
 			continue;
 		}
-		eigrp_route_descriptor_t *received_route = route;
-		eigrp_route_descriptor_t *topology_route =
-			eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
-		bool free_received_route = false;
-
-		if (topology_route) {
-			topology_route->type = received_route->type;
-			topology_route->nexthop = received_route->nexthop;
-			topology_route->extdata = received_route->extdata;
-			route = topology_route;
-			free_received_route = true;
-		} else {
-			received_route->adv_router = nbr;
-			received_route->prefix = prefix;
+
+		/* our summary never goes active; its answer is what we have */
+		if (prefix->nt == EIGRP_TOPOLOGY_TYPE_SUMMARY) {
+			eigrp_reply_send(eigrp, nbr, prefix);
+			eigrp_topology_route_free(route);
+			continue;
+		}
+
+		/* a component asked across its summary: unreachable from here */
+		if (eigrp_summary_boundary(ei, prefix, nbr)) {
+			eigrp->summary_boundary_replies++;
+			eigrp_query_unknown_reply_send(eigrp, nbr, route);
+			eigrp_topology_route_free(route);
+			continue;
 		}
 
-		msg.packet_type = EIGRP_OPC_QUERY;
-		msg.eigrp = eigrp;
-		msg.data_type = (received_route->type == EIGRP_TLV_IPv4_EXT)
-					? EIGRP_EXT
-					: EIGRP_INT;
-		msg.adv_router = nbr;
-		msg.route = route;
-		msg.metrics = received_route->metric;
-		msg.prefix = prefix;
-		eigrp_fsm_event(&msg);
-
-		if (free_received_route)
-			eigrp_topology_route_free(received_route);
+		eigrp_dual_queue_enqueue(eigrp, nbr, prefix, route,
+					 EIGRP_OPC_QUERY);
 	}
 
 	eigrp_hello_send_ack(nbr);
-	eigrp_query_send_all(eigrp);
-	eigrp_update_send_all(eigrp, nbr->ei);
+	eigrp_packetizer_flush(eigrp, nbr->ei);
 }
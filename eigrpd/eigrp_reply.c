@@ -22,6 +22,7 @@
 #include "eigrpd/eigrp_topology.h"
 #include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_dual_queue.h"
 
 void eigrp_reply_send_route(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			   eigrp_prefix_descriptor_t *prefix,
@@ -32,7 +33,7 @@ void eigrp_reply_send_route(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 	if (!eigrp || !nbr || !prefix)
 		return;
 
-	work = eigrp_packetizer_work_new(EIGRP_OPC_REPLY);
+	work = eigrp_packetizer_work_new(eigrp, EIGRP_OPC_REPLY);
 	work->nbr = nbr;
 	work->prefix = prefix;
 	work->route = route;
@@ -52,7 +53,6 @@ void eigrp_reply_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			 struct eigrp_header *eigrph, struct stream *pkt,
 			 eigrp_interface_t *ei, int length)
 {
-	struct eigrp_fsm_action_message msg;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
 
@@ -76,36 +76,9 @@ void eigrp_reply_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			eigrp_topology_route_free(route);
 			continue;
 		}
-		eigrp_route_descriptor_t *received_route = route;
-		eigrp_route_descriptor_t *topology_route =
-			eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
-		bool free_received_route = false;
 
-		if (topology_route) {
-			topology_route->type = received_route->type;
-			topology_route->nexthop = received_route->nexthop;
-			topology_route->extdata = received_route->extdata;
-			route = topology_route;
-			free_received_route = true;
-		} else {
-			received_route->adv_router = nbr;
-			received_route->prefix = prefix;
-		}
-
-		// should have got route off the packet, but one never knows
-		msg.packet_type = EIGRP_OPC_REPLY;
-		msg.eigrp = eigrp;
-		msg.data_type = (received_route->type == EIGRP_TLV_IPv4_EXT)
-					? EIGRP_EXT
-					: EIGRP_INT;
-		msg.adv_router = nbr;
-		msg.route = route;
-		msg.metrics = received_route->metric;
-		msg.prefix = prefix;
-		eigrp_fsm_event(&msg);
-
-		if (free_received_route)
-			eigrp_topology_route_free(received_route);
+		eigrp_dual_queue_enqueue(eigrp, nbr, prefix, route,
+					 EIGRP_OPC_REPLY);
 	}
 	eigrp_hello_send_ack(nbr);
 }
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP routing table install queue.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Every successor change used to go to zebra as it happened: DUAL sent an
+ * add or a delete each time it touched a prefix, adding a route sent one
+ * more add for that route alone, and removing any route withdrew the
+ * whole prefix.  A convergence event over many prefixes sent zebra
+ * several messages per prefix, most of them overtaken by the next.
+ *
+ * Now a change only queues the prefix, once; further changes before the
+ * flush fold into the waiting entry.  The flush runs EIGRP_RIB_FLUSH_DELAY
+ * msec after the first change, or at the end of the current task once
+ * EIGRP_RIB_QUEUE_BATCH prefixes wait, and sends at most a batch before
+ * giving the event loop back.  What goes out is the prefix's state at the
+ * flush, not the history: an add with its successors, or a delete when it
+ * has none left or has been deleted.
+ *
+ * An entry holds its prefix by pointer.  A deleted prefix leaves its
+ * entry behind, with the destination, to carry the delete.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_zebra.h"
+#include "eigrpd/eigrp_rib_queue.h"
+
+static uint64_t eigrp_rib_queue_now(void)
+{
+	struct timeval now;
+
+	monotime(&now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+/* Bring zebra in line with the prefix as it is now. */
+static void eigrp_rib_entry_send(eigrp_instance_t *eigrp,
+				 eigrp_rib_entry_t *entry)
+{
+	eigrp_prefix_descriptor_t *pe = entry->prefix;
+	unsigned int paths = 0;
+
+	if (pe) {
+		paths = pe->nsuccessor;
+		if (paths > eigrp->max_paths)
+			paths = eigrp->max_paths;
+	}
+
+	if (paths) {
+		eigrp_zebra_route_add(eigrp, &entry->dest,
+				      eigrp_route_vec_data(&pe->feasible),
+				      paths, pe->fdistance);
+		eigrp->rib_stats.installs++;
+	} else {
+		eigrp_zebra_route_delete(eigrp, &entry->dest);
+		eigrp->rib_stats.withdraws++;
+	}
+}
+
+static void eigrp_rib_queue_flush(eigrp_instance_t *eigrp, uint32_t max)
+{
+	eigrp_rib_queue_stats_t *stats = &eigrp->rib_stats;
+	eigrp_rib_entry_t *entry;
+	uint64_t now = eigrp_rib_queue_now();
+	uint64_t latency;
+	uint32_t sent = 0;
+
+	while (sent < max && (entry = eigrp->rib_head)) {
+		eigrp->rib_head = entry->next;
+		if (!eigrp->rib_head)
+			eigrp->rib_tail = NULL;
+		eigrp->rib_count--;
+		if (entry->prefix)
+			entry->prefix->rib = NULL;
+
+		eigrp_rib_entry_send(eigrp, entry);
+		sent++;
+
+		latency = now > entry->queued ? now - entry->queued : 0;
+		stats->latency_usec += latency;
+		if (latency > stats->latency_max_usec)
+			stats->latency_max_usec = latency;
+		eigrp_slab_obj_free(entry);
+	}
+
+	stats->flushes++;
+	stats->last_batch = sent;
+}
+
+static void eigrp_rib_queue_flush_event(struct event *event)
+{
+	eigrp_instance_t *eigrp = EVENT_ARG(event);
+
+	eigrp_rib_queue_flush(eigrp, EIGRP_RIB_QUEUE_BATCH);
+
+	/* more than a batch was waiting: the rest goes next turn */
+	if (eigrp->rib_head)
+		event_add_event(eigrpd_event, eigrp_rib_queue_flush_event,
+				eigrp, 0, &eigrp->t_rib_flush);
+}
+
+static void eigrp_rib_queue_schedule(eigrp_instance_t *eigrp)
+{
+	if (eigrp->rib_count == EIGRP_RIB_QUEUE_BATCH) {
+		/* a full batch does not wait for the timer */
+		event_cancel(&eigrp->t_rib_flush);
+		event_add_event(eigrpd_event, eigrp_rib_queue_flush_event,
+				eigrp, 0, &eigrp->t_rib_flush);
+		return;
+	}
+
+	if (!eigrp->t_rib_flush)
+		event_add_timer_msec(eigrpd_event, eigrp_rib_queue_flush_event,
+				     eigrp, EIGRP_RIB_FLUSH_DELAY,
+				     &eigrp->t_rib_flush);
+}
+
+void eigrp_rib_queue_enqueue(eigrp_instance_t *eigrp,
+			     eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_rib_queue_stats_t *stats = &eigrp->rib_stats;
+	eigrp_rib_entry_t *entry;
+
+	stats->requests++;
+	if (pe->rib) {
+		stats->coalesced++;
+		return;
+	}
+
+	entry = eigrp_slab_obj_create(&eigrp->rib_slab);
+	entry->prefix = pe;
+	prefix_copy(&entry->dest, eigrp_topology_prefix_dest(pe));
+	entry->queued = eigrp_rib_queue_now();
+	pe->rib = entry;
+
+	if (eigrp->rib_tail)
+		eigrp->rib_tail->next = entry;
+	else
+		eigrp->rib_head = entry;
+	eigrp->rib_tail = entry;
+
+	if (++eigrp->rib_count > stats->peak)
+		stats->peak = eigrp->rib_count;
+
+	eigrp_rib_queue_schedule(eigrp);
+}
+
+void eigrp_rib_queue_prefix_delete(eigrp_instance_t *eigrp,
+				   eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_rib_queue_enqueue(eigrp, pe);
+	eigrp_rib_queue_prefix_detach(pe);
+}
+
+void eigrp_rib_queue_prefix_detach(eigrp_prefix_descriptor_t *pe)
+{
+	if (!pe->rib)
+		return;
+
+	pe->rib->prefix = NULL;
+	pe->rib = NULL;
+}
+
+void eigrp_rib_queue_fini(eigrp_instance_t *eigrp)
+{
+	event_cancel(&eigrp->t_rib_flush);
+	eigrp_rib_queue_flush(eigrp, UINT32_MAX);
+}
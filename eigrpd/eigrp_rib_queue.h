@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP routing table install queue.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_RIB_QUEUE_H
+#define _ZEBRA_EIGRP_RIB_QUEUE_H
+
+#include "eigrpd/eigrp_types.h"
+
+/* send whatever is still waiting; the instance is going away */
+extern void eigrp_rib_queue_fini(eigrp_instance_t *eigrp);
+
+/* pe's successors changed: bring its zebra route in line at the flush */
+extern void eigrp_rib_queue_enqueue(eigrp_instance_t *eigrp,
+				    eigrp_prefix_descriptor_t *pe);
+
+/* pe is being deleted: withdraw it at the flush */
+extern void eigrp_rib_queue_prefix_delete(eigrp_instance_t *eigrp,
+					  eigrp_prefix_descriptor_t *pe);
+
+/* pe is freed without being deleted; forget it */
+extern void eigrp_rib_queue_prefix_detach(eigrp_prefix_descriptor_t *pe);
+
+#endif /* _ZEBRA_EIGRP_RIB_QUEUE_H */
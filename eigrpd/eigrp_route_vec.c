@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix route descriptor vector.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Most prefixes are reachable over one to four paths.  Keeping those paths
+ * in a struct list cost a list header plus one listnode allocation per
+ * path, and every distance change was a delete and re-insert through the
+ * list.  The vector holds the first EIGRP_ROUTE_VEC_INLINE paths inside the
+ * prefix descriptor itself and only spills to a heap array beyond that;
+ * the heap pointer overlays the inline slots, which are unused by then.
+ * Ordering is maintained with insertion sort, which is cheap at these sizes.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_route_vec.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_ROUTE_VEC, "EIGRP route vector");
+
+void eigrp_route_vec_init(eigrp_route_vec_t *vec)
+{
+	memset(vec, 0, sizeof(*vec));
+	vec->size = EIGRP_ROUTE_VEC_INLINE;
+}
+
+void eigrp_route_vec_fini(eigrp_route_vec_t *vec)
+{
+	if (vec->size > EIGRP_ROUTE_VEC_INLINE)
+		XFREE(MTYPE_EIGRP_ROUTE_VEC, vec->heap);
+
+	eigrp_route_vec_init(vec);
+}
+
+int eigrp_route_vec_find(eigrp_route_vec_t *vec,
+			 eigrp_route_descriptor_t *route)
+{
+	eigrp_route_descriptor_t **data = eigrp_route_vec_data(vec);
+	int i;
+
+	for (i = 0; i < vec->count; i++)
+		if (data[i] == route)
+			return i;
+
+	return -1;
+}
+
+/* Make room for one more route, moving to (or growing) the heap array. */
+static void eigrp_route_vec_grow(eigrp_route_vec_t *vec)
+{
+	eigrp_route_descriptor_t **heap;
+	uint16_t size;
+
+	if (vec->count < vec->size)
+		return;
+
+	size = vec->size * 2;
+	heap = XCALLOC(MTYPE_EIGRP_ROUTE_VEC, size * sizeof(*heap));
+	/* heap shares storage with slot[], so copy before switching over */
+	memcpy(heap, eigrp_route_vec_data(vec), vec->count * sizeof(*heap));
+
+	if (vec->size > EIGRP_ROUTE_VEC_INLINE)
+		XFREE(MTYPE_EIGRP_ROUTE_VEC, vec->heap);
+
+	vec->heap = heap;
+	vec->size = size;
+}
+
+/*
+ * Slide the route at index pos to its sorted position.  A route moves
+ * past neighbors with strictly worse (or, going up, equal or worse)
+ * distance, so equal distances stay in insertion order.
+ */
+static void eigrp_route_vec_settle(eigrp_route_vec_t *vec, int pos)
+{
+	eigrp_route_descriptor_t **data = eigrp_route_vec_data(vec);
+	eigrp_route_descriptor_t *route = data[pos];
+
+	while (pos > 0 && data[pos - 1]->distance > route->distance) {
+		data[pos] = data[pos - 1];
+		pos--;
+	}
+
+	while (pos + 1 < vec->count
+	       && data[pos + 1]->distance <= route->distance) {
+		data[pos] = data[pos + 1];
+		pos++;
+	}
+
+	data[pos] = route;
+}
+
+bool eigrp_route_vec_insert(eigrp_route_vec_t *vec,
+			    eigrp_route_descriptor_t *route)
+{
+	if (eigrp_route_vec_find(vec, route) >= 0)
+		return false;
+
+	eigrp_route_vec_grow(vec);
+	eigrp_route_vec_data(vec)[vec->count] = route;
+	vec->count++;
+	eigrp_route_vec_settle(vec, vec->count - 1);
+
+	return true;
+}
+
+/* Add a route at the tail, for callers that build the vector in order. */
+void eigrp_route_vec_append(eigrp_route_vec_t *vec,
+			    eigrp_route_descriptor_t *route)
+{
+	eigrp_route_vec_grow(vec);
+	eigrp_route_vec_data(vec)[vec->count] = route;
+	vec->count++;
+}
+
+bool eigrp_route_vec_remove(eigrp_route_vec_t *vec,
+			    eigrp_route_descriptor_t *route)
+{
+	eigrp_route_descriptor_t **data = eigrp_route_vec_data(vec);
+	int pos = eigrp_route_vec_find(vec, route);
+
+	if (pos < 0)
+		return false;
+
+	vec->count--;
+	memmove(&data[pos], &data[pos + 1],
+		(vec->count - pos) * sizeof(*data));
+
+	return true;
+}
+
+/* Restore the order after the distances of many routes changed at once. */
+void eigrp_route_vec_sort(eigrp_route_vec_t *vec)
+{
+	eigrp_route_descriptor_t **data = eigrp_route_vec_data(vec);
+	eigrp_route_descriptor_t *route;
+	int i, j;
+
+	for (i = 1; i < vec->count; i++) {
+		route = data[i];
+		for (j = i; j > 0 && data[j - 1]->distance > route->distance; j--)
+			data[j] = data[j - 1];
+		data[j] = route;
+	}
+}
+
+/* Re-position a route after its distance changed. */
+void eigrp_route_vec_resort(eigrp_route_vec_t *vec,
+			    eigrp_route_descriptor_t *route)
+{
+	int pos = eigrp_route_vec_find(vec, route);
+
+	if (pos >= 0)
+		eigrp_route_vec_settle(vec, pos);
+}
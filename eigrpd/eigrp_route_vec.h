@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix route descriptor vector.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_ROUTE_VEC_H
+#define _ZEBRA_EIGRP_ROUTE_VEC_H
+
+#include "eigrpd/eigrp_types.h"
+
+/*
+ * The vector keeps the candidate paths of one prefix ordered by distance,
+ * best first, the same order listnode_add_sort() used to give the old
+ * entries list.  Routes of equal distance keep their insertion order.
+ */
+static inline eigrp_route_descriptor_t **
+eigrp_route_vec_data(eigrp_route_vec_t *vec)
+{
+	return vec->size > EIGRP_ROUTE_VEC_INLINE ? vec->heap : vec->slot;
+}
+
+/* Drop all routes but keep any heap array for reuse. */
+static inline void eigrp_route_vec_clear(eigrp_route_vec_t *vec)
+{
+	vec->count = 0;
+}
+
+static inline eigrp_route_descriptor_t *
+eigrp_route_vec_head(eigrp_route_vec_t *vec)
+{
+	return vec->count ? eigrp_route_vec_data(vec)[0] : NULL;
+}
+
+/* Walk best to worst.  The body must not add or remove routes. */
+#define EIGRP_ROUTE_VEC_FOREACH(vec, i, route)                                 \
+	for ((i) = 0; (i) < (vec)->count                                       \
+		      && ((route) = eigrp_route_vec_data(vec)[(i)], 1);        \
+	     (i)++)
+
+/*
+ * Walk worst to best.  The body may remove the current route, which only
+ * shifts routes that have already been visited.
+ */
+#define EIGRP_ROUTE_VEC_FOREACH_REVERSE(vec, i, route)                         \
+	for ((i) = (vec)->count;                                               \
+	     (i)-- > 0 && ((route) = eigrp_route_vec_data(vec)[(i)], 1);)
+
+extern void eigrp_route_vec_init(eigrp_route_vec_t *);
+extern void eigrp_route_vec_fini(eigrp_route_vec_t *);
+extern int eigrp_route_vec_find(eigrp_route_vec_t *, eigrp_route_descriptor_t *);
+extern bool eigrp_route_vec_insert(eigrp_route_vec_t *,
+				   eigrp_route_descriptor_t *);
+extern bool eigrp_route_vec_remove(eigrp_route_vec_t *,
+				   eigrp_route_descriptor_t *);
+extern void eigrp_route_vec_append(eigrp_route_vec_t *,
+				   eigrp_route_descriptor_t *);
+extern void eigrp_route_vec_resort(eigrp_route_vec_t *,
+				   eigrp_route_descriptor_t *);
+extern void eigrp_route_vec_sort(eigrp_route_vec_t *);
+
+#endif /* _ZEBRA_EIGRP_ROUTE_VEC_H */
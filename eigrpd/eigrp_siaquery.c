@@ -16,15 +16,21 @@
 #include "eigrpd/eigrp_auth.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_topology.h"
-#include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_packetizer.h"
 
-/* EIGRP SIA-QUERY read function */
+/*
+ * EIGRP SIA-QUERY read function
+ *
+ * An SIA-QUERY only asks whether we are still working on the prefix; it
+ * carries no new distance and is not a DUAL input.  Answer it with an
+ * SIA-REPLY.  If the prefix is already PASSIVE our REPLY is on the
+ * retransmit queue and the SIA-REPLY just keeps the asker from resetting
+ * us while it gets there.
+ */
 void eigrp_siaquery_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			    struct eigrp_header *eigrph, struct stream *pkt,
 			    eigrp_interface_t *ei, int length)
 {
-	eigrp_fsm_action_message_t msg;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
 
@@ -51,35 +57,11 @@ void eigrp_siaquery_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			eigrp_topology_route_free(route);
 			continue;
 		}
-		eigrp_route_descriptor_t *received_route = route;
-		eigrp_route_descriptor_t *topology_route =
-			eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
-		bool free_received_route = false;
-
-		if (topology_route) {
-			topology_route->type = received_route->type;
-			topology_route->nexthop = received_route->nexthop;
-			topology_route->extdata = received_route->extdata;
-			route = topology_route;
-			free_received_route = true;
-		} else {
-			received_route->adv_router = nbr;
-			received_route->prefix = prefix;
-		}
-
-		msg.packet_type = EIGRP_OPC_SIAQUERY;
-		msg.eigrp = eigrp;
-		msg.data_type = (received_route->type == EIGRP_TLV_IPv4_EXT)
-					? EIGRP_EXT
-					: EIGRP_INT;
-		msg.adv_router = nbr;
-		msg.route = route;
-		msg.metrics = received_route->metric;
-		msg.prefix = prefix;
-		eigrp_fsm_event(&msg);
+		eigrp_topology_route_free(route);
 
-		if (free_received_route)
-			eigrp_topology_route_free(received_route);
+		eigrp->active_stats.sia_queries_rcvd++;
+		eigrp->active_stats.sia_replies_sent++;
+		eigrp_siareply_send(eigrp, nbr, prefix);
 	}
 
 	eigrp_hello_send_ack(nbr);
@@ -90,7 +72,7 @@ void eigrp_siaquery_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 {
 	eigrp_packetizer_work_t *work;
 
-	work = eigrp_packetizer_work_new(EIGRP_OPC_SIAQUERY);
+	work = eigrp_packetizer_work_new(eigrp, EIGRP_OPC_SIAQUERY);
 	work->nbr = nbr;
 	work->prefix = prefix;
 	work->owner = prefix;
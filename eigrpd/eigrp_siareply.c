@@ -16,15 +16,20 @@
 #include "eigrpd/eigrp_auth.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_topology.h"
-#include "eigrpd/eigrp_fsm.h"
+#include "eigrpd/eigrp_active.h"
 #include "eigrpd/eigrp_packetizer.h"
 
-/* EIGRP SIA-REPLY read function */
+/*
+ * EIGRP SIA-REPLY read function
+ *
+ * The neighbor is alive and still owes us its REPLY; clear it from the
+ * active timer's SIA wait list so it is not reset as stuck.  The REPLY
+ * itself still has to arrive before DUAL sees anything.
+ */
 void eigrp_siareply_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			    struct eigrp_header *eigrph, struct stream *pkt,
 			    eigrp_interface_t *ei, int length)
 {
-	struct eigrp_fsm_action_message msg;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
 
@@ -46,36 +51,9 @@ void eigrp_siareply_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			eigrp_topology_route_free(route);
 			continue;
 		}
-		eigrp_route_descriptor_t *received_route = route;
-		eigrp_route_descriptor_t *topology_route =
-			eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
-		bool free_received_route = false;
-
-		if (topology_route) {
-			topology_route->type = received_route->type;
-			topology_route->nexthop = received_route->nexthop;
-			topology_route->extdata = received_route->extdata;
-			route = topology_route;
-			free_received_route = true;
-		} else {
-			received_route->adv_router = nbr;
-			received_route->prefix = prefix;
-		}
-
-		/* If the destination exists, pass it to DUAL. */
-		msg.packet_type = EIGRP_OPC_SIAREPLY;
-		msg.eigrp = eigrp;
-		msg.data_type = (received_route->type == EIGRP_TLV_IPv4_EXT)
-					? EIGRP_EXT
-					: EIGRP_INT;
-		msg.adv_router = nbr;
-		msg.route = route;
-		msg.metrics = received_route->metric;
-		msg.prefix = prefix;
-		eigrp_fsm_event(&msg);
+		eigrp_topology_route_free(route);
 
-		if (free_received_route)
-			eigrp_topology_route_free(received_route);
+		eigrp_active_sia_reply(eigrp, prefix, nbr);
 	}
 	eigrp_hello_send_ack(nbr);
 }
@@ -85,7 +63,7 @@ void eigrp_siareply_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 {
 	eigrp_packetizer_work_t *work;
 
-	work = eigrp_packetizer_work_new(EIGRP_OPC_SIAREPLY);
+	work = eigrp_packetizer_work_new(eigrp, EIGRP_OPC_SIAREPLY);
 	work->nbr = nbr;
 	work->prefix = prefix;
 	work->owner = prefix;
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP fixed-size object allocator.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Prefix descriptors, route descriptors and packetizer work items are
+ * created and freed at route-churn rates.  Allocating each one from the
+ * heap costs malloc metadata per object and scatters a large table over
+ * the whole heap.  A slab carves objects of one type out of
+ * EIGRP_SLAB_CHUNK_SIZE chunks instead.
+ *
+ * Every object is preceded by a pointer to its chunk, so an object can be
+ * freed without knowing which instance it came from.  A chunk whose last
+ * object is freed is given back to the heap as soon as the slab holds
+ * another chunk's worth of free objects, so memory follows the table down
+ * when it shrinks without thrashing at a chunk boundary.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_slab.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_SLAB, "EIGRP slab chunk");
+
+struct eigrp_slab_chunk {
+	eigrp_slab_t *slab;
+	struct eigrp_slab_chunk *prev;
+	struct eigrp_slab_chunk *next;
+	void *free;    /* free objects, linked through their first word */
+	uint32_t used; /* objects handed out from this chunk */
+};
+
+/* Objects keep pointer alignment; none of the slab types need more. */
+#define EIGRP_SLAB_ALIGN(x)                                                    \
+	(((x) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+#define EIGRP_SLAB_HDR_SIZE EIGRP_SLAB_ALIGN(sizeof(struct eigrp_slab_chunk))
+
+static void eigrp_slab_chunk_link(struct eigrp_slab_chunk **head,
+				  struct eigrp_slab_chunk *chunk)
+{
+	chunk->prev = NULL;
+	chunk->next = *head;
+	if (*head)
+		(*head)->prev = chunk;
+	*head = chunk;
+}
+
+static void eigrp_slab_chunk_unlink(struct eigrp_slab_chunk **head,
+				    struct eigrp_slab_chunk *chunk)
+{
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		*head = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	chunk->prev = chunk->next = NULL;
+}
+
+static void eigrp_slab_chunk_free_all(struct eigrp_slab_chunk **head)
+{
+	struct eigrp_slab_chunk *chunk;
+
+	while ((chunk = *head) != NULL) {
+		*head = chunk->next;
+		XFREE(MTYPE_EIGRP_SLAB, chunk);
+	}
+}
+
+void eigrp_slab_init(eigrp_slab_t *slab, const char *name, size_t size)
+{
+	memset(slab, 0, sizeof(*slab));
+	slab->name = name;
+	slab->size = size;
+
+	if (size < sizeof(void *))
+		size = sizeof(void *);
+	slab->stride = EIGRP_SLAB_ALIGN(sizeof(struct eigrp_slab_chunk *) + size);
+
+	slab->per_chunk = (EIGRP_SLAB_CHUNK_SIZE - EIGRP_SLAB_HDR_SIZE)
+			  / slab->stride;
+	if (slab->per_chunk == 0)
+		slab->per_chunk = 1;
+}
+
+/*
+ * Release every chunk.  Objects still handed out would be left dangling,
+ * so a slab with live objects is leaked instead and the leak is logged.
+ */
+void eigrp_slab_fini(eigrp_slab_t *slab)
+{
+	if (slab->live) {
+		zlog_warn("EIGRP slab %s: %u objects still live at shutdown",
+			  slab->name, slab->live);
+		return;
+	}
+
+	eigrp_slab_chunk_free_all(&slab->avail);
+	eigrp_slab_chunk_free_all(&slab->full);
+	slab->chunks = 0;
+	slab->free = 0;
+}
+
+static struct eigrp_slab_chunk *eigrp_slab_chunk_create(eigrp_slab_t *slab)
+{
+	struct eigrp_slab_chunk *chunk;
+	char *obj;
+	uint32_t i;
+
+	chunk = XCALLOC(MTYPE_EIGRP_SLAB,
+			EIGRP_SLAB_HDR_SIZE + slab->per_chunk * slab->stride);
+	chunk->slab = slab;
+
+	obj = (char *)chunk + EIGRP_SLAB_HDR_SIZE;
+	for (i = 0; i < slab->per_chunk; i++, obj += slab->stride) {
+		*(struct eigrp_slab_chunk **)obj = chunk;
+		*(void **)(obj + sizeof(chunk)) = chunk->free;
+		chunk->free = obj + sizeof(chunk);
+	}
+
+	eigrp_slab_chunk_link(&slab->avail, chunk);
+	slab->chunks++;
+	slab->free += slab->per_chunk;
+
+	return chunk;
+}
+
+/* Returns a zeroed object, as XCALLOC would. */
+void *eigrp_slab_obj_create(eigrp_slab_t *slab)
+{
+	struct eigrp_slab_chunk *chunk;
+	void *obj;
+
+	chunk = slab->avail;
+	if (!chunk)
+		chunk = eigrp_slab_chunk_create(slab);
+
+	obj = chunk->free;
+	chunk->free = *(void **)obj;
+	chunk->used++;
+
+	if (!chunk->free) {
+		eigrp_slab_chunk_unlink(&slab->avail, chunk);
+		eigrp_slab_chunk_link(&slab->full, chunk);
+	}
+
+	slab->free--;
+	slab->live++;
+	if (slab->live > slab->live_peak)
+		slab->live_peak = slab->live;
+
+	memset(obj, 0, slab->size);
+	return obj;
+}
+
+void eigrp_slab_obj_free(void *obj)
+{
+	struct eigrp_slab_chunk *chunk;
+	eigrp_slab_t *slab;
+
+	if (!obj)
+		return;
+
+	chunk = *(struct eigrp_slab_chunk **)((char *)obj - sizeof(chunk));
+	slab = chunk->slab;
+
+	if (!chunk->free) {
+		eigrp_slab_chunk_unlink(&slab->full, chunk);
+		eigrp_slab_chunk_link(&slab->avail, chunk);
+	}
+
+	*(void **)obj = chunk->free;
+	chunk->free = obj;
+	chunk->used--;
+	slab->live--;
+	slab->free++;
+
+	if (chunk->used == 0 && slab->free >= 2 * slab->per_chunk) {
+		eigrp_slab_chunk_unlink(&slab->avail, chunk);
+		XFREE(MTYPE_EIGRP_SLAB, chunk);
+		slab->chunks--;
+		slab->free -= slab->per_chunk;
+		slab->released++;
+	}
+}
+
+/* Heap bytes held by the slab, live and free objects included. */
+size_t eigrp_slab_bytes(eigrp_slab_t *slab)
+{
+	return (size_t)slab->chunks
+	       * (EIGRP_SLAB_HDR_SIZE + slab->per_chunk * slab->stride);
+}
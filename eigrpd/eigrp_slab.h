@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP fixed-size object allocator.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_SLAB_H
+#define _ZEBRA_EIGRP_SLAB_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern void eigrp_slab_init(eigrp_slab_t *, const char *name, size_t size);
+extern void eigrp_slab_fini(eigrp_slab_t *);
+extern void *eigrp_slab_obj_create(eigrp_slab_t *);
+extern void eigrp_slab_obj_free(void *);
+extern size_t eigrp_slab_bytes(eigrp_slab_t *);
+
+#endif /* _ZEBRA_EIGRP_SLAB_H */
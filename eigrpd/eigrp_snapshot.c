@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP read-only topology snapshots.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Show commands used to walk the live topology table and format every
+ * route while doing it, so a large table held the protocol thread for as
+ * long as the output took to build, once per operator.  Readers now work
+ * from a snapshot instead: a flat copy of the table taken at one topology
+ * epoch.  Copying is a tight loop with no formatting in it, and once taken
+ * the snapshot is shared by every reader until the table changes.
+ *
+ * eigrp->topology_epoch is bumped by every topology change.  While a
+ * reader has asked for a snapshot in the last EIGRP_SNAPSHOT_HOLD seconds,
+ * a change schedules a background refresh: after EIGRP_SNAPSHOT_DELAY
+ * seconds the table is copied EIGRP_SNAPSHOT_CHUNK prefixes at a time,
+ * yielding to the event loop between chunks.  A change in the middle of
+ * a chunked copy restarts it, so a published snapshot is always an exact
+ * copy of one epoch.  A reader that finds no current snapshot takes one
+ * itself in a single pass.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_snapshot.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_SNAPSHOT, "EIGRP topology snapshot");
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_SNAPSHOT_DATA, "EIGRP topology snapshot data");
+
+static void eigrp_snapshot_refresh_event(struct event *event);
+
+static eigrp_snapshot_t *eigrp_snapshot_new(eigrp_instance_t *eigrp,
+					    uint32_t prefixes, uint32_t routes)
+{
+	eigrp_snapshot_t *snap;
+
+	snap = XCALLOC(MTYPE_EIGRP_SNAPSHOT, sizeof(*snap));
+	snap->epoch = eigrp->topology_epoch;
+	snap->refcnt = 1;
+
+	snap->prefix_size = prefixes ? prefixes : 1;
+	snap->route_size = routes ? routes : 1;
+	snap->prefixes = XCALLOC(MTYPE_EIGRP_SNAPSHOT_DATA,
+				 snap->prefix_size * sizeof(*snap->prefixes));
+	snap->routes = XCALLOC(MTYPE_EIGRP_SNAPSHOT_DATA,
+			       snap->route_size * sizeof(*snap->routes));
+	return snap;
+}
+
+/* A copy of the whole table; the slabs know how big it is. */
+static eigrp_snapshot_t *eigrp_snapshot_table_new(eigrp_instance_t *eigrp)
+{
+	eigrp_snapshot_t *snap;
+
+	snap = eigrp_snapshot_new(eigrp, eigrp->prefix_slab.live,
+				  eigrp->route_slab.live);
+	snap->resume = route_top(eigrp->topology_table);
+	return snap;
+}
+
+static void eigrp_snapshot_free(eigrp_snapshot_t *snap)
+{
+	if (snap->resume)
+		route_unlock_node(snap->resume);
+
+	XFREE(MTYPE_EIGRP_SNAPSHOT_DATA, snap->prefixes);
+	XFREE(MTYPE_EIGRP_SNAPSHOT_DATA, snap->routes);
+	XFREE(MTYPE_EIGRP_SNAPSHOT, snap);
+}
+
+void eigrp_snapshot_release(eigrp_snapshot_t **snap)
+{
+	if (!*snap)
+		return;
+
+	if (--(*snap)->refcnt == 0)
+		eigrp_snapshot_free(*snap);
+	*snap = NULL;
+}
+
+static void eigrp_snapshot_reserve(eigrp_snapshot_t *snap, uint32_t routes)
+{
+	if (snap->nprefixes == snap->prefix_size) {
+		snap->prefix_size *= 2;
+		snap->prefixes = XREALLOC(MTYPE_EIGRP_SNAPSHOT_DATA,
+					  snap->prefixes,
+					  snap->prefix_size
+						  * sizeof(*snap->prefixes));
+	}
+
+	if (snap->nroutes + routes > snap->route_size) {
+		while (snap->nroutes + routes > snap->route_size)
+			snap->route_size *= 2;
+		snap->routes = XREALLOC(MTYPE_EIGRP_SNAPSHOT_DATA, snap->routes,
+					snap->route_size
+						* sizeof(*snap->routes));
+	}
+}
+
+static void eigrp_snapshot_copy_prefix(eigrp_instance_t *eigrp,
+				       eigrp_snapshot_t *snap,
+				       eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_snapshot_prefix_t *sp;
+	eigrp_snapshot_route_t *sr;
+	eigrp_route_descriptor_t *route;
+	int i;
+
+	eigrp_snapshot_reserve(snap, pe->routes.count);
+
+	sp = &snap->prefixes[snap->nprefixes++];
+	prefix_copy((struct prefix *)&sp->dest,
+		    eigrp_topology_prefix_dest(pe));
+	sp->fdistance = pe->fdistance;
+	sp->route = snap->nroutes;
+	sp->nroutes = pe->routes.count;
+	sp->nsuccessor = pe->nsuccessor;
+	sp->state = pe->state;
+	sp->serno = pe->serno;
+
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route) {
+		sr = &snap->routes[snap->nroutes++];
+		memset(sr, 0, sizeof(*sr));
+		if (route->adv_router)
+			sr->nexthop = route->adv_router->src;
+		sr->distance = route->distance;
+		sr->reported_distance = route->reported_distance;
+		sr->ifindex = route->ei ? route->ei->ifp->ifindex : 0;
+		sr->flags = route->flags;
+		sr->connected = (route->adv_router == eigrp->neighbor_self);
+	}
+}
+
+/*
+ * Copy up to limit prefixes, continuing from where the last call stopped.
+ * Returns true once the whole table has been copied.
+ */
+static bool eigrp_snapshot_copy(eigrp_instance_t *eigrp,
+				eigrp_snapshot_t *snap, uint32_t limit)
+{
+	struct route_node *rn = snap->resume;
+	struct timeval start, now;
+	uint32_t copied = 0;
+
+	monotime(&start);
+	while (rn && copied < limit) {
+		if (rn->info) {
+			eigrp_snapshot_copy_prefix(eigrp, snap, rn->info);
+			copied++;
+		}
+		rn = route_next(rn);
+	}
+	/* route_next() leaves the node we stopped at locked for us */
+	snap->resume = rn;
+
+	monotime(&now);
+	snap->usec += (now.tv_sec - start.tv_sec) * 1000000
+		      + (now.tv_usec - start.tv_usec);
+
+	return rn == NULL;
+}
+
+/* Make a finished copy the instance snapshot. */
+static void eigrp_snapshot_publish(eigrp_instance_t *eigrp,
+				   eigrp_snapshot_t *snap)
+{
+	eigrp->snapshot_stats.copies++;
+	eigrp->snapshot_stats.last_prefixes = snap->nprefixes;
+	eigrp->snapshot_stats.last_routes = snap->nroutes;
+	eigrp->snapshot_stats.last_usec = snap->usec;
+
+	eigrp_snapshot_release(&eigrp->snapshot);
+	eigrp->snapshot = snap;
+}
+
+static void eigrp_snapshot_refresh_event(struct event *event)
+{
+	eigrp_instance_t *eigrp = EVENT_ARG(event);
+	eigrp_snapshot_t *snap = eigrp->snapshot_build;
+
+	if (snap && !eigrp_snapshot_current(eigrp, snap)) {
+		/* the table moved under the copy, start over once it settles */
+		eigrp->snapshot_stats.abandoned++;
+		eigrp_snapshot_release(&eigrp->snapshot_build);
+		eigrp_snapshot_refresh(eigrp);
+		return;
+	}
+
+	if (!snap)
+		snap = eigrp->snapshot_build = eigrp_snapshot_table_new(eigrp);
+
+	eigrp->snapshot_stats.chunks++;
+	if (!eigrp_snapshot_copy(eigrp, snap, EIGRP_SNAPSHOT_CHUNK)) {
+		event_add_event(eigrpd_event, eigrp_snapshot_refresh_event,
+				eigrp, 0, &eigrp->t_snapshot);
+		return;
+	}
+
+	eigrp->snapshot_build = NULL;
+	eigrp->snapshot_stats.background++;
+	eigrp_snapshot_publish(eigrp, snap);
+}
+
+/*
+ * The topology changed.  Keep a current copy warm for readers that have
+ * been around lately; otherwise let the snapshot go.
+ */
+void eigrp_snapshot_refresh(eigrp_instance_t *eigrp)
+{
+	struct timeval now;
+
+	if (eigrp->t_snapshot)
+		return;
+
+	if (eigrp->snapshot && !eigrp_snapshot_current(eigrp, eigrp->snapshot))
+		eigrp_snapshot_release(&eigrp->snapshot);
+
+	monotime(&now);
+	if (!eigrp->snapshot_read
+	    || now.tv_sec - eigrp->snapshot_read > EIGRP_SNAPSHOT_HOLD) {
+		eigrp->snapshot_read = 0;
+		return;
+	}
+
+	event_add_timer(eigrpd_event, eigrp_snapshot_refresh_event, eigrp,
+			EIGRP_SNAPSHOT_DELAY, &eigrp->t_snapshot);
+}
+
+/*
+ * Returns a snapshot of the topology as it is now.  The caller owns a
+ * reference and drops it with eigrp_snapshot_release().
+ */
+eigrp_snapshot_t *eigrp_snapshot_get(eigrp_instance_t *eigrp)
+{
+	eigrp_snapshot_t *snap;
+	struct timeval now;
+
+	monotime(&now);
+	eigrp->snapshot_read = now.tv_sec;
+
+	if (eigrp_snapshot_current(eigrp, eigrp->snapshot)) {
+		eigrp->snapshot_stats.reused++;
+	} else {
+		/* finish a chunked copy of this epoch rather than start over */
+		snap = eigrp->snapshot_build;
+		eigrp->snapshot_build = NULL;
+		event_cancel(&eigrp->t_snapshot);
+		if (snap && !eigrp_snapshot_current(eigrp, snap))
+			eigrp_snapshot_release(&snap);
+		if (!snap)
+			snap = eigrp_snapshot_table_new(eigrp);
+
+		eigrp_snapshot_copy(eigrp, snap, UINT32_MAX);
+		eigrp_snapshot_publish(eigrp, snap);
+	}
+
+	eigrp->snapshot->refcnt++;
+	return eigrp->snapshot;
+}
+
+/*
+ * Returns a private snapshot of a single prefix, for readers that only
+ * want one entry and should not pay for a copy of the table.
+ */
+eigrp_snapshot_t *eigrp_snapshot_prefix(eigrp_instance_t *eigrp,
+					eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_snapshot_t *snap;
+
+	snap = eigrp_snapshot_new(eigrp, 1, pe->routes.count);
+	eigrp_snapshot_copy_prefix(eigrp, snap, pe);
+	return snap;
+}
+
+void eigrp_snapshot_fini(eigrp_instance_t *eigrp)
+{
+	event_cancel(&eigrp->t_snapshot);
+	eigrp_snapshot_release(&eigrp->snapshot_build);
+	eigrp_snapshot_release(&eigrp->snapshot);
+	eigrp->snapshot_read = 0;
+}
+
+/* Heap held by a snapshot, for show memory. */
+size_t eigrp_snapshot_bytes(eigrp_snapshot_t *snap)
+{
+	if (!snap)
+		return 0;
+
+	return sizeof(*snap) + snap->prefix_size * sizeof(*snap->prefixes)
+	       + snap->route_size * sizeof(*snap->routes);
+}
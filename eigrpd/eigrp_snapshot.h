@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP read-only topology snapshots.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_SNAPSHOT_H
+#define _ZEBRA_EIGRP_SNAPSHOT_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern eigrp_snapshot_t *eigrp_snapshot_get(eigrp_instance_t *eigrp);
+extern eigrp_snapshot_t *eigrp_snapshot_prefix(eigrp_instance_t *eigrp,
+					       eigrp_prefix_descriptor_t *pe);
+extern void eigrp_snapshot_release(eigrp_snapshot_t **snap);
+extern void eigrp_snapshot_refresh(eigrp_instance_t *eigrp);
+extern void eigrp_snapshot_fini(eigrp_instance_t *eigrp);
+extern size_t eigrp_snapshot_bytes(eigrp_snapshot_t *snap);
+
+/* Does the snapshot still match the live table? */
+static inline bool eigrp_snapshot_current(eigrp_instance_t *eigrp,
+					  eigrp_snapshot_t *snap)
+{
+	return snap && snap->epoch == eigrp->topology_epoch;
+}
+
+static inline eigrp_snapshot_route_t *
+eigrp_snapshot_routes(eigrp_snapshot_t *snap, eigrp_snapshot_prefix_t *sp)
+{
+	return &snap->routes[sp->route];
+}
+
+/*
+ * Walk the prefixes of a snapshot in table order.  The snapshot never
+ * changes once eigrp_snapshot_get() has returned it, so the body may
+ * yield or run protocol work between prefixes.
+ */
+#define EIGRP_SNAPSHOT_FOREACH(snap, sp)                                       \
+	for ((sp) = (snap)->prefixes;                                          \
+	     (sp) < (snap)->prefixes + (snap)->nprefixes; (sp)++)
+
+#endif /* _ZEBRA_EIGRP_SNAPSHOT_H */
@@ -2,11 +2,24 @@
 /*
  * EIGRP host southbound abstraction.
  * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Everything that touches the host goes through this file: the work
+ * queues, the raw socket and its multicast memberships, and the sendmsg()
+ * of each packet.  The rest of the daemon never calls into the socket
+ * layer itself, so a test program can link every other translation unit
+ * unchanged and supply its own southbound instead.
  */
 #include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_interface.h"
+#include "eigrpd/eigrp_network.h"
+#include "eigrpd/eigrp_packet.h"
+#include "eigrpd/eigrp_dump.h"
 #include "eigrpd/eigrp_southbound.h"
 
 #include "workqueue.h"
+#include "sockopt.h"
+#include "privs.h"
 
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_WORK_QUEUE, "EIGRP work queue");
 DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_WORK_QUEUE_NAME, "EIGRP work queue name");
@@ -107,3 +120,259 @@ eigrp_instance_t *eigrp_work_queue_eigrp(eigrp_work_queue_t *queue)
 {
 	return queue ? queue->eigrp : NULL;
 }
+
+int eigrp_sock_init(struct vrf *vrf)
+{
+	int eigrp_sock = -1;
+	int ret;
+#ifdef IP_HDRINCL
+	int hincl = 1;
+#endif
+
+	if (!vrf)
+		return eigrp_sock;
+
+	frr_with_privs (&eigrpd_privs) {
+		eigrp_sock = vrf_socket(
+			AF_INET, SOCK_RAW, IPPROTO_EIGRPIGP, vrf->vrf_id,
+			vrf->vrf_id != VRF_DEFAULT ? vrf->name : NULL);
+		if (eigrp_sock < 0) {
+			zlog_err("eigrp_read_sock_init: socket: %s",
+				 safe_strerror(errno));
+			exit(1);
+		}
+
+#ifdef IP_HDRINCL
+		/* we will include IP header with packet */
+		ret = setsockopt(eigrp_sock, IPPROTO_IP, IP_HDRINCL, &hincl,
+				 sizeof(hincl));
+		if (ret < 0) {
+			zlog_warn("Can't set IP_HDRINCL option for fd %d: %s",
+				  eigrp_sock, safe_strerror(errno));
+		}
+#elif defined(IPTOS_PREC_INTERNETCONTROL)
+#warning "IP_HDRINCL not available on this system"
+#warning "using IPTOS_PREC_INTERNETCONTROL"
+		ret = setsockopt_ipv4_tos(eigrp_sock,
+					  IPTOS_PREC_INTERNETCONTROL);
+		if (ret < 0) {
+			zlog_warn(
+				"can't set sockopt IP_TOS %d to socket %d: %s",
+				tos, eigrp_sock, safe_strerror(errno));
+			close(eigrp_sock); /* Prevent sd leak. */
+			return ret;
+		}
+#else /* !IPTOS_PREC_INTERNETCONTROL */
+#warning "IP_HDRINCL not available, nor is IPTOS_PREC_INTERNETCONTROL"
+		zlog_warn("IP_HDRINCL option not available");
+#endif /* IP_HDRINCL */
+
+		ret = setsockopt_ifindex(AF_INET, eigrp_sock, 1);
+		if (ret < 0)
+			zlog_warn("Can't set pktinfo option for fd %d",
+				  eigrp_sock);
+	}
+
+	return eigrp_sock;
+}
+
+void eigrp_adjust_sndbuflen(eigrp_instance_t *eigrp, unsigned int buflen)
+{
+	int newbuflen;
+	/* Check if any work has to be done at all. */
+	if (eigrp->maxsndbuflen >= buflen)
+		return;
+
+	/* Now we try to set SO_SNDBUF to what our caller has requested
+	 * (the MTU of a newly added interface). However, if the OS has
+	 * truncated the actual buffer size to somewhat less size, try
+	 * to detect it and update our records appropriately. The OS
+	 * may allocate more buffer space, than requested, this isn't
+	 * a error.
+	 */
+	setsockopt_so_sendbuf(eigrp->fd, buflen);
+	newbuflen = getsockopt_so_sendbuf(eigrp->fd);
+	if (newbuflen < 0 || newbuflen < (int)buflen)
+		zlog_warn("%s: tried to set SO_SNDBUF to %u, but got %d",
+			  __func__, buflen, newbuflen);
+	if (newbuflen >= 0)
+		eigrp->maxsndbuflen = (unsigned int)newbuflen;
+	else
+		zlog_warn("%s: failed to get SO_SNDBUF", __func__);
+}
+
+int eigrp_intf_ipmulticast(eigrp_instance_t *top, struct prefix *p,
+			   unsigned int ifindex)
+{
+	uint8_t val;
+	int ret, len;
+
+	val = 0;
+	len = sizeof(val);
+
+	/* Prevent receiving self-origined multicast packets. */
+	ret = setsockopt(top->fd, IPPROTO_IP, IP_MULTICAST_LOOP, (void *)&val,
+			 len);
+	if (ret < 0)
+		zlog_warn(
+			"can't setsockopt IP_MULTICAST_LOOP (0) for fd %d: %s",
+			top->fd, safe_strerror(errno));
+
+	/* Explicitly set multicast ttl to 1 -- endo. */
+	val = 1;
+	ret = setsockopt(top->fd, IPPROTO_IP, IP_MULTICAST_TTL, (void *)&val,
+			 len);
+	if (ret < 0)
+		zlog_warn("can't setsockopt IP_MULTICAST_TTL (1) for fd %d: %s",
+			  top->fd, safe_strerror(errno));
+
+	ret = setsockopt_ipv4_multicast_if(top->fd, p->u.prefix4, ifindex);
+	if (ret < 0)
+		zlog_warn(
+			"can't setsockopt IP_MULTICAST_IF (fd %d, addr %s, "
+			"ifindex %u): %s",
+			top->fd, eigrp_print_prefix(p), ifindex,
+			safe_strerror(errno));
+
+	return ret;
+}
+
+/* Join to the EIGRP multicast group. */
+int eigrp_intf_add_allspfrouters(eigrp_instance_t *top, struct prefix *p,
+				 unsigned int ifindex)
+{
+	int ret;
+
+	ret = setsockopt_ipv4_multicast(
+		top->fd, IP_ADD_MEMBERSHIP, p->u.prefix4,
+		htonl(EIGRP_MULTICAST_ADDRESS), ifindex);
+	if (ret < 0)
+		zlog_warn(
+			"can't setsockopt IP_ADD_MEMBERSHIP (fd %d, addr %s, "
+			"ifindex %u, AllSPFRouters): %s; perhaps a kernel limit "
+			"on # of multicast group memberships has been exceeded?",
+			top->fd, eigrp_print_prefix(p), ifindex,
+			safe_strerror(errno));
+	else
+		zlog_debug("interface %s [%u] join EIGRP Multicast group.",
+			   eigrp_print_prefix(p), ifindex);
+
+	return ret;
+}
+
+int eigrp_intf_drop_allspfrouters(eigrp_instance_t *top, struct prefix *p,
+				  unsigned int ifindex)
+{
+	int ret;
+
+	ret = setsockopt_ipv4_multicast(
+		top->fd, IP_DROP_MEMBERSHIP, p->u.prefix4,
+		htonl(EIGRP_MULTICAST_ADDRESS), ifindex);
+	if (ret < 0)
+		zlog_warn(
+			"can't setsockopt IP_DROP_MEMBERSHIP (fd %d, addr %s, "
+			"ifindex %u, AllSPFRouters): %s",
+			top->fd, eigrp_print_prefix(p), ifindex,
+			safe_strerror(errno));
+	else
+		zlog_debug("interface %s [%u] leave EIGRP Multicast group.",
+			   eigrp_print_prefix(p), ifindex);
+
+	return ret;
+}
+
+/*
+ * Put one packet on the wire.  eigrp_packet_write() has already brought
+ * the header's ack up to date; this builds the IPv4 header and sends.
+ */
+void eigrp_southbound_packet_send(eigrp_instance_t *eigrp,
+				  eigrp_interface_t *ei, eigrp_packet_t *packet)
+{
+	struct eigrp_header *eigrph;
+	struct sockaddr_in sa_dst;
+	struct ip iph;
+	struct msghdr msg;
+	struct iovec iov[2];
+	int ret;
+	int flags = 0;
+#define EIGRP_PACKET_WRITE_IPHL_SHIFT 2
+
+	// DVS: ipv6 issue
+	if (packet->dst.ip.v4.s_addr == htonl(EIGRP_MULTICAST_ADDRESS))
+		eigrp_intf_ipmulticast(eigrp, &ei->address, ei->ifp->ifindex);
+
+	memset(&iph, 0, sizeof(struct ip));
+	memset(&sa_dst, 0, sizeof(sa_dst));
+
+	sa_dst.sin_family = AF_INET;
+#ifdef HAVE_STRUCT_SOCKADDR_IN_SIN_LEN
+	sa_dst.sin_len = sizeof(sa_dst);
+#endif /* HAVE_STRUCT_SOCKADDR_IN_SIN_LEN */
+
+	// DVS: ipv6 issue
+	sa_dst.sin_addr = packet->dst.ip.v4;
+	sa_dst.sin_port = htons(0);
+
+	/* Set DONTROUTE flag if dst is unicast. */
+	if (!IN_MULTICAST(htonl(packet->dst.ip.v4.s_addr)))
+		flags = MSG_DONTROUTE;
+
+	iph.ip_hl = sizeof(struct ip) >> EIGRP_PACKET_WRITE_IPHL_SHIFT;
+	/* it'd be very strange for header to not be 4byte-word aligned but.. */
+	if (sizeof(struct ip)
+	    > (unsigned int)(iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT))
+		iph.ip_hl++; /* we presume sizeof struct ip cant overflow
+				ip_hl.. */
+
+	iph.ip_v = IPVERSION;
+	iph.ip_tos = IPTOS_PREC_INTERNETCONTROL;
+	iph.ip_len = (iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT) + packet->length;
+
+#if defined(__DragonFly__)
+	/*
+	 * DragonFly's raw socket expects ip_len/ip_off in network byte order.
+	 */
+	iph.ip_len = htons(iph.ip_len);
+#endif
+
+	iph.ip_off = 0;
+	iph.ip_ttl = EIGRP_IP_TTL;
+	iph.ip_p = IPPROTO_EIGRPIGP;
+	iph.ip_sum = 0;
+	// DVS: ipv6 issue
+	iph.ip_src.s_addr = ei->address.u.prefix4.s_addr;
+	iph.ip_dst.s_addr = packet->dst.ip.v4.s_addr;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = (caddr_t)&sa_dst;
+	msg.msg_namelen = sizeof(sa_dst);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+
+	iov[0].iov_base = (char *)&iph;
+	iov[0].iov_len = iph.ip_hl << EIGRP_PACKET_WRITE_IPHL_SHIFT;
+	iov[1].iov_base = stream_pnt(packet->s);
+	iov[1].iov_len = packet->length;
+
+	/* send final fragment (could be first) */
+	sockopt_iphdrincl_swab_htosys(&iph);
+	ret = sendmsg(eigrp->fd, &msg, flags);
+	sockopt_iphdrincl_swab_systoh(&iph);
+
+	if (IS_DEBUG_EIGRP_TRANSMIT(0, SEND)) {
+		eigrph = (struct eigrp_header *)STREAM_DATA(packet->s);
+		zlog_debug(
+			"Sending [%s][%d/%d] to [%s] via [%s] ret [%d].",
+			lookup_msg(eigrp_packet_type_str, eigrph->opcode, NULL),
+			ntohl(eigrph->sequence), ntohl(eigrph->ack),
+			eigrp_print_addr(&packet->dst),
+			EIGRP_INTF_NAME(ei), ret);
+	}
+
+	if (ret < 0) //DVS: IPV6 issue
+		zlog_warn("*** sendmsg in eigrp_packet_write failed to %pI4, "
+			  "id %d, off %d, len %d, interface %s, mtu %u: %s",
+			  &iph.ip_dst, iph.ip_id, iph.ip_off,
+			  iph.ip_len, ei->ifp->name, ei->ifp->mtu,
+			  safe_strerror(errno));
+}
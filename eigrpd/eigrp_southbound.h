@@ -28,4 +28,13 @@ void eigrp_work_queue_reset(eigrp_work_queue_t *queue);
 void eigrp_work_queue_enqueue(eigrp_work_queue_t *queue, void *data);
 eigrp_instance_t *eigrp_work_queue_eigrp(eigrp_work_queue_t *queue);
 
+/*
+ * The socket half of eigrp_network.h and eigrp_interface.h
+ * (eigrp_sock_init() and the multicast memberships) lives in
+ * eigrp_southbound.c as well.
+ */
+void eigrp_southbound_packet_send(eigrp_instance_t *eigrp,
+				  eigrp_interface_t *ei,
+				  eigrp_packet_t *packet);
+
 #endif /* _ZEBRA_EIGRP_SOUTHBOUND_H_ */
@@ -41,6 +41,316 @@ typedef struct eigrp_metrics {
 	uint8_t flags;
 } eigrp_metrics_t;
 
+typedef struct eigrp_bringup_stats {
+	uint32_t queue_peak; /* deepest bring-up queue seen */
+	uint64_t admitted;   /* neighbors granted a sync slot */
+	uint64_t deferred;   /* neighbors that had to wait for a slot */
+	uint64_t completed;  /* initial syncs acked through EOT */
+	uint64_t aborted;    /* neighbors that went down while syncing */
+
+	/* time from PENDING to fully synced, EIGRP_BRINGUP_HIST_BOUNDS */
+	uint64_t adjacency_hist[EIGRP_BRINGUP_HIST_MAX];
+} eigrp_bringup_stats_t;
+
+/*
+ * FIFO of prefixes waiting for UPDATE or QUERY packetization.  Linked
+ * through the prefix descriptors; the req_action bit is the membership
+ * flag, so a prefix is queued at most once.
+ */
+typedef struct eigrp_dirty_queue {
+	eigrp_prefix_descriptor_t *head;
+	eigrp_prefix_descriptor_t *tail;
+	uint32_t count;
+	uint32_t peak;	     /* deepest queue seen */
+	uint64_t queued;     /* prefixes added */
+	uint64_t suppressed; /* adds for a prefix already queued */
+} eigrp_dirty_queue_t;
+
+/*
+ * Structure-of-arrays input for eigrp_calculate_metrics_batch(), one lane
+ * per metric.  The composite distance of each lane is returned in
+ * composite[].
+ */
+struct eigrp_metric_batch {
+	uint32_t count;
+	eigrp_delay_t delay[EIGRP_METRIC_BATCH_SIZE];
+	eigrp_bandwidth_t bandwidth[EIGRP_METRIC_BATCH_SIZE];
+	uint8_t load[EIGRP_METRIC_BATCH_SIZE];
+	uint8_t reliability[EIGRP_METRIC_BATCH_SIZE];
+	eigrp_metric_t composite[EIGRP_METRIC_BATCH_SIZE];
+};
+
+/* Bulk distance recompute after a K-value or interface metric change */
+typedef struct eigrp_recompute_stats {
+	uint64_t runs;		 /* recomputes performed */
+	uint64_t routes;	 /* route distances recomputed */
+	uint64_t prefixes;	 /* prefixes handed back to DUAL */
+	uint32_t last_routes;	 /* routes recomputed by the last run */
+	uint32_t last_prefixes;	 /* prefixes handed to DUAL by the last run */
+	uint32_t last_usec;	 /* duration of the last run */
+} eigrp_recompute_stats_t;
+
+/*
+ * Read-only copy of the topology table for show commands and other
+ * operational readers.  Prefixes are kept in table order; the paths of a
+ * prefix are routes[route] .. routes[route + nroutes - 1], best first.
+ */
+struct eigrp_snapshot_route {
+	eigrp_addr_t nexthop;	    /* advertising neighbor */
+	uint32_t distance;
+	uint32_t reported_distance;
+	ifindex_t ifindex;
+	uint8_t flags;		    /* EIGRP_ROUTE_DESCRIPTOR_* */
+	bool connected;
+};
+
+struct eigrp_snapshot_prefix {
+	struct prefix_ipv4 dest;
+	uint32_t fdistance;
+	uint32_t route;		    /* first path in routes[] */
+	uint16_t nroutes;
+	uint16_t nsuccessor;
+	uint8_t state;
+	uint64_t serno;
+};
+
+struct eigrp_snapshot {
+	uint64_t epoch;	 /* eigrp->topology_epoch the copy was taken at */
+	uint32_t refcnt; /* instance plus readers */
+	uint32_t usec;	 /* time spent copying */
+
+	eigrp_snapshot_prefix_t *prefixes;
+	uint32_t nprefixes;
+	uint32_t prefix_size;
+	eigrp_snapshot_route_t *routes;
+	uint32_t nroutes;
+	uint32_t route_size;
+
+	struct route_node *resume; /* next node of a chunked copy, locked */
+};
+
+typedef struct eigrp_snapshot_stats {
+	uint64_t copies;     /* snapshots taken */
+	uint64_t background; /* of those, taken in yielding chunks */
+	uint64_t chunks;     /* yielding steps run */
+	uint64_t abandoned;  /* chunked copies restarted by a table change */
+	uint64_t reused;     /* readers served an existing snapshot */
+	uint32_t last_prefixes;
+	uint32_t last_routes;
+	uint32_t last_usec;  /* copy time of the last snapshot */
+} eigrp_snapshot_stats_t;
+
+/*
+ * One DUAL event, as recorded by eigrp_fsm_event().  Kept binary so that
+ * recording costs a clock read and a few stores; formatting happens only
+ * when the ring is shown.
+ */
+struct eigrp_fsm_trace_entry {
+	uint64_t usec;	      /* monotonic time of the event */
+	eigrp_addr_t nbr;     /* advertising neighbor */
+	struct in_addr dest;  /* prefix */
+	uint16_t replies;     /* replies outstanding after the event */
+	uint8_t prefixlen;
+	uint8_t old_state;    /* enum eigrp_fsm_states */
+	uint8_t new_state;
+	uint8_t event;	      /* enum eigrp_fsm_events */
+	uint8_t packet_type;  /* EIGRP_OPC_* that caused it */
+	uint8_t change;	      /* enum metric_change */
+};
+
+struct eigrp_fsm_trace {
+	uint64_t head; /* events recorded; entry[head % size] is next */
+	eigrp_prefix_descriptor_t *running; /* prefix of the event in flight */
+	eigrp_fsm_trace_entry_t entry[EIGRP_FSM_TRACE_SIZE];
+};
+
+typedef struct eigrp_dual_flush_stats {
+	uint64_t requests; /* callers asking for DUAL output */
+	uint64_t flushes;  /* flushes run; requests - flushes were merged */
+	uint64_t queries;  /* prefixes handed to QUERY packetization */
+	uint64_t updates;  /* prefixes handed to UPDATE packetization */
+	uint32_t last_queries;
+	uint32_t last_updates;
+	uint32_t max_queries; /* largest QUERY batch of one flush */
+	uint32_t max_updates; /* largest UPDATE batch of one flush */
+} eigrp_dual_flush_stats_t;
+
+/* Packets the packetizer built for one opcode and the TLVs packed in them */
+typedef struct eigrp_packetizer_stats {
+	uint64_t packets;
+	uint64_t tlvs;
+	uint64_t bytes; /* packet lengths, headers and auth included */
+	uint64_t room;	/* MTUs of those packets; bytes / room is the fill */
+	uint32_t max_tlvs; /* most TLVs in one packet */
+} eigrp_packetizer_stats_t;
+
+/* What became of the work handed to the packetizer */
+typedef struct eigrp_packetizer_queue_stats {
+	uint64_t enqueued;  /* put on the work queue */
+	uint64_t chained;   /* packed behind work for the same destination */
+	uint64_t coalesced; /* merged into work waiting for the same object */
+	uint64_t upgraded;  /* waiting SIA-REPLYs a merge turned into REPLYs */
+	uint64_t dropped;   /* neighbor work whose neighbor went down first */
+} eigrp_packetizer_queue_stats_t;
+
+/* Route TLVs taken from the per-prefix image cache, see eigrp_tlv_cache.c */
+typedef struct eigrp_tlv_cache_stats {
+	uint64_t hits;	    /* TLVs copied from a cached image */
+	uint64_t misses;    /* TLVs encoded */
+	uint64_t uncached;  /* of those, not cached: unreachable or too long */
+	uint64_t dumps;	    /* full-table UPDATEs built for a new neighbor */
+	uint64_t dump_tlvs; /* route TLVs in them */
+	uint64_t dump_usec; /* time spent building them */
+	uint32_t last_dump_tlvs;
+	uint32_t last_dump_usec;
+	uint32_t max_dump_usec;
+} eigrp_tlv_cache_stats_t;
+
+/* Distribute-list verdicts, see eigrp_filter_cache.c */
+typedef struct eigrp_filter_cache_stats {
+	uint64_t hits;	  /* verdicts taken from the prefix's cache */
+	uint64_t misses;  /* filters evaluated, then cached */
+	uint64_t flushes; /* generations retired by a filter change */
+} eigrp_filter_cache_stats_t;
+
+/* Query scope: how many neighbors each lost prefix was put to */
+typedef struct eigrp_query_stats {
+	uint64_t prefixes;     /* prefixes QUERY packetization ran for */
+	uint64_t neighbors;    /* neighbors queried, one per prefix */
+	uint64_t stub_skipped; /* stub neighbors not queried */
+	uint32_t last_neighbors; /* neighbors queried for the latest prefix */
+} eigrp_query_stats_t;
+
+/*
+ * Neighbors of one instance, one bit per neighbor slot.  The first 64
+ * slots fit in the inline word; a higher slot spills the set to heap.
+ */
+struct eigrp_nbr_set {
+	uint32_t nwords; /* words on the heap, 0 while inline */
+	union {
+		uint64_t word;
+		uint64_t *heap;
+	};
+};
+
+/*
+ * Active timer of one ACTIVE prefix.  Every prefix runs on the instance
+ * active time, so appending keeps the queue in deadline order and one
+ * instance timer for the head serves them all.
+ */
+struct eigrp_active {
+	eigrp_prefix_descriptor_t *prefix;
+	eigrp_active_t *prev;
+	eigrp_active_t *next;
+
+	uint64_t start;	       /* msec, went ACTIVE */
+	uint64_t deadline;     /* msec, next SIA round */
+	uint8_t sia_rounds;    /* SIA-QUERY rounds sent */
+	eigrp_nbr_set_t sia_wait; /* asked last round, no SIA-REPLY yet */
+};
+
+/*
+ * Interface summary, shared by every interface configured with the same
+ * prefix.  The summary is a prefix descriptor of its own with one local
+ * route, metric of the best component, installed as a discard route.
+ */
+struct eigrp_summary {
+	struct prefix prefix;
+	eigrp_prefix_descriptor_t *pe; /* NULL while the prefix is taken */
+	eigrp_route_descriptor_t *route;
+	uint32_t refs;	     /* interfaces configured with it */
+	uint32_t components; /* reachable components, last refresh */
+	bool stale;	     /* a component changed since the last refresh */
+};
+
+/*
+ * DUAL input decoded from one UPDATE, QUERY or REPLY TLV, waiting for its
+ * turn.  It is on the instance FIFO and on its prefix's list; a later TLV
+ * from the same neighbor with the same opcode replaces the route and moves
+ * it to the tail.  queued stays the first TLV's time.
+ */
+struct eigrp_dual_event {
+	eigrp_dual_event_t *prev; /* instance FIFO */
+	eigrp_dual_event_t *next;
+	eigrp_dual_event_t *pe_next; /* prefix list, newest first */
+
+	eigrp_prefix_descriptor_t *prefix;
+	eigrp_neighbor_t *nbr;
+	eigrp_route_descriptor_t *route; /* as decoded, owned; NULL from neighbor down */
+	uint8_t opcode;
+	uint64_t queued; /* usec */
+};
+
+typedef struct eigrp_dual_queue_stats {
+	uint64_t queued;
+	uint64_t coalesced;  /* replaced a waiting event */
+	uint64_t processed;
+	uint64_t dropped;    /* prefix or neighbor gone first */
+	uint64_t runs;
+	uint64_t yields;     /* runs that left work behind */
+	uint64_t latency_usec; /* enqueue to DUAL, all processed */
+	uint32_t latency_max_usec;
+	uint32_t peak;
+	uint32_t last_processed;
+	uint32_t last_usec;
+} eigrp_dual_queue_stats_t;
+
+/*
+ * A prefix whose zebra route has to be brought in line with its
+ * successors, waiting for the next RIB flush.  One per prefix; further
+ * changes before the flush only fold into it.
+ */
+struct eigrp_rib_entry {
+	eigrp_rib_entry_t *next; /* instance FIFO */
+
+	eigrp_prefix_descriptor_t *prefix; /* NULL once the prefix is deleted */
+	struct prefix dest;
+	uint64_t queued; /* usec, first change */
+};
+
+typedef struct eigrp_rib_queue_stats {
+	uint64_t requests;     /* changes to the installed state */
+	uint64_t coalesced;    /* folded into a waiting entry */
+	uint64_t installs;     /* route adds sent to zebra */
+	uint64_t withdraws;    /* route deletes sent to zebra */
+	uint64_t flushes;      /* batches sent */
+	uint64_t latency_usec; /* change to zebra, all sent */
+	uint32_t latency_max_usec;
+	uint32_t peak;
+	uint32_t last_batch;
+} eigrp_rib_queue_stats_t;
+
+typedef struct eigrp_active_stats {
+	uint64_t entered;	   /* prefixes that went ACTIVE */
+	uint64_t sia_queries_sent;
+	uint64_t sia_queries_rcvd;
+	uint64_t sia_replies_sent;
+	uint64_t sia_replies_rcvd;
+	uint64_t stuck;		   /* neighbors reset as stuck in active */
+
+	/* time from ACTIVE back to PASSIVE, EIGRP_ACTIVE_HIST_BOUNDS */
+	uint64_t active_hist[EIGRP_ACTIVE_HIST_MAX];
+} eigrp_active_stats_t;
+
+/*
+ * Fixed-size object allocator, one per object type per instance.  Objects
+ * are carved from EIGRP_SLAB_CHUNK_SIZE chunks; see eigrp_slab.c.
+ */
+struct eigrp_slab {
+	const char *name;
+	uint32_t size;	     /* object size requested */
+	uint32_t stride;     /* object plus chunk back pointer */
+	uint32_t per_chunk;  /* objects carved from one chunk */
+	struct eigrp_slab_chunk *avail; /* chunks with at least one free object */
+	struct eigrp_slab_chunk *full;	/* chunks with no free object */
+
+	uint32_t chunks;    /* chunks currently allocated */
+	uint32_t live;	    /* objects handed out */
+	uint32_t free;	    /* unused objects in allocated chunks */
+	uint32_t live_peak; /* most objects handed out at once */
+	uint64_t released;  /* chunks given back as the table shrank */
+};
+
 typedef struct eigrp_extdata {
 	uint32_t orig;
 	uint32_t as;
@@ -97,10 +407,88 @@ struct eigrp_instance {
 			   changes*/
 	uint64_t serno_last_update; /* Highest serial number of information send
 				       by last update*/
-	struct list *topology_changes;
+	eigrp_dirty_queue_t dirty[EIGRP_DIRTY_MAX];
+	eigrp_recompute_stats_t recompute;
+	eigrp_fsm_trace_t *fsm_trace; /* last EIGRP_FSM_TRACE_SIZE DUAL events */
+
+	/* Read-only topology copies for operational readers */
+	uint64_t topology_epoch;	  /* bumped on every topology change */
+	eigrp_snapshot_t *snapshot;	  /* copy of topology_epoch, or stale */
+	eigrp_snapshot_t *snapshot_build; /* chunked copy under way */
+	struct event *t_snapshot;
+	time_t snapshot_read;		  /* last reader, 0 if none yet */
+	eigrp_snapshot_stats_t snapshot_stats;
 
 	eigrp_work_queue_t *packetizer_queue;
 
+	/* DUAL output waiting for the end of the burst */
+	struct event *t_dual_flush;
+	eigrp_interface_t *flush_exception; /* skipped by the UPDATE, or NULL */
+	uint16_t dual_flush_delay;	    /* msec, 0 = end of current task */
+	eigrp_dual_flush_stats_t flush_stats;
+	eigrp_query_stats_t query_stats;
+	eigrp_packetizer_stats_t packetizer_stats[EIGRP_OPC_SIAREPLY + 1];
+	eigrp_packetizer_queue_stats_t packetizer_queue_stats;
+	eigrp_tlv_cache_stats_t tlv_cache_stats;
+
+	/* Cached filter verdicts, valid for one filter generation */
+	uint32_t filter_gen;
+	uint32_t filter_slots; /* interface slots handed out, plus one */
+	eigrp_filter_cache_stats_t filter_cache_stats;
+	eigrp_packetizer_work_t *update_work; /* waiting UPDATE run */
+	eigrp_packetizer_work_t *query_work;  /* waiting QUERY chain */
+
+	/* EIGRP_STUB_* when this router is a stub, 0 when it is not */
+	uint16_t stub;
+
+	/* Active timers, oldest deadline first */
+	uint16_t active_time;	      /* seconds, 0 = disabled */
+	eigrp_active_t *active_head;
+	eigrp_active_t *active_tail;
+	uint32_t active_count;
+	struct event *t_active;
+	eigrp_active_stats_t active_stats;
+
+	/* DUAL input waiting to run, see eigrp_dual_queue.c */
+	eigrp_dual_event_t *dual_head;
+	eigrp_dual_event_t *dual_tail;
+	uint32_t dual_count;
+	eigrp_work_queue_t *dual_queue;
+	bool dual_scheduled;
+	eigrp_dual_queue_stats_t dual_stats;
+
+	/* Routing table changes waiting for zebra, see eigrp_rib_queue.c */
+	eigrp_rib_entry_t *rib_head;
+	eigrp_rib_entry_t *rib_tail;
+	uint32_t rib_count;
+	struct event *t_rib_flush;
+	eigrp_rib_queue_stats_t rib_stats;
+
+	/* Interface summaries by prefix, see eigrp_summary.c */
+	struct route_table *summaries;
+	uint32_t summary_count;
+	uint32_t summary_stale;		   /* summaries to refresh */
+	uint64_t summary_boundary_replies; /* queries answered at a summary */
+
+	/* Neighbor slots: nbr_slots[nbr->slot] == nbr */
+	eigrp_neighbor_t **nbr_slots;
+	uint32_t nbr_slot_size;
+	uint32_t nbr_slot_low; /* no free slot below this */
+
+	/* Object allocators for topology, packetizer work, DUAL input and
+	 * RIB changes */
+	eigrp_slab_t prefix_slab;
+	eigrp_slab_t route_slab;
+	eigrp_slab_t work_slab;
+	eigrp_slab_t dual_slab;
+	eigrp_slab_t rib_slab;
+
+	/* Neighbor bring-up admission control */
+	uint16_t bringup_max;	    /* concurrent initial syncs, 0 = no cap */
+	uint16_t bringup_active;    /* neighbors holding a sync slot */
+	struct list *bringup_queue; /* PENDING neighbors waiting for a slot */
+	eigrp_bringup_stats_t bringup_stats;
+
 	/* Local TLV codecs used for neighbor/interface bind and mixed encode. */
 	eigrp_tlv_codec_t tlv1_codec;
 	eigrp_tlv_codec_t tlv2_codec;
@@ -139,6 +527,9 @@ typedef struct eigrp_packet_queue {
 	eigrp_packet_t *tail;
 
 	unsigned long count;
+	size_t bytes;		  /* heap held by the queued packets */
+	unsigned long count_peak; /* high-water marks */
+	size_t bytes_peak;
 } eigrp_packet_queue_t;
 
 typedef struct eigrp_intf_params {
@@ -150,6 +541,7 @@ typedef struct eigrp_intf_params {
 	uint32_t delay;
 	uint8_t reliability;
 	uint8_t load;
+	uint16_t bringup_max; /* concurrent initial syncs, 0 = no cap */
 
 	char *auth_keychain; /* Associated keychain with interface*/
 	int auth_type;	     /* EIGRP authentication type */
@@ -203,9 +595,26 @@ typedef struct eigrp_interface {
 	uint16_t tlv1_peer_count;
 	uint16_t tlv2_peer_count;
 	eigrp_packet_encoder_t encoder;
+	eigrp_packet_sizer_t sizer;
+
+	/* Filter verdict slot in pe->filter_cache, never 0 */
+	uint32_t filter_slot;
+
+	/* Summaries advertised here instead of their components */
+	struct list *summaries;
 
 	/* Neighbor information. */
 	struct list *nbrs; /* EIGRP Neighbor List */
+	uint16_t bringup_active; /* neighbors holding a sync slot */
+	uint16_t bringup_queued; /* neighbors waiting for a sync slot */
+
+	/* Topology routes learned over this interface, linked by route->intf */
+	eigrp_route_descriptor_t *routes;
+	uint32_t route_count;
+	uint32_t route_peak;
+	uint64_t recompute_runs;   /* delay/bandwidth changes recomputed */
+	uint64_t recompute_routes; /* routes those changes recomputed */
+	uint32_t recompute_last;   /* routes the last change recomputed */
 
 	/* Events. */
 	struct event *t_hello;	     /* timer */
@@ -384,6 +793,13 @@ struct TLV_IPv4_External_type {
 	struct in_addr destination;
 } __attribute__((packed));
 
+/* EIGRP Stub TLV - stub routers announce what they advertise */
+struct TLV_Stub_Type {
+	uint16_t type;
+	uint16_t length;
+	uint16_t flags; /* EIGRP_STUB_* */
+} __attribute__((packed));
+
 /* EIGRP Peer Termination TLV - used for hard restart */
 struct TLV_Peer_Termination_type {
 	uint16_t type;
@@ -397,24 +813,54 @@ enum GR_type { EIGRP_GR_MANUAL, EIGRP_GR_FILTER };
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
 
-/* EIGRP Topology table node structure */
+/*
+ * Candidate paths of a prefix, best distance first.  The first
+ * EIGRP_ROUTE_VEC_INLINE live in the descriptor; more spill to heap.
+ */
+#define EIGRP_ROUTE_VEC_INLINE 4
+
+struct eigrp_route_vec {
+	uint16_t count;
+	uint16_t size; /* capacity, > EIGRP_ROUTE_VEC_INLINE once on the heap */
+	union {
+		eigrp_route_descriptor_t *slot[EIGRP_ROUTE_VEC_INLINE];
+		eigrp_route_descriptor_t **heap;
+	};
+};
+
+/*
+ * EIGRP Topology table node structure.  There is one of these for every
+ * prefix in the table, so the layout is kept tight: the first cache line
+ * holds what DUAL reads on every event, the IPv4 destination is stored
+ * inline and reply tracking is a bitset that only reaches the heap while
+ * the prefix is ACTIVE on a large instance.
+ */
 typedef struct eigrp_prefix_descriptor {
-	struct list *entries, *rij;
-	struct prefix *destination;
+	eigrp_route_vec_t routes;
+	uint32_t fdistance;	// FD
+	uint32_t rdistance;	// RD
+	uint32_t distance;	// D
+	uint8_t state;		// route FSM state
+	uint8_t req_action;	// required action
+	uint8_t nt;		// network type
+	uint16_t nsuccessor;	// leading successors in feasible
 
-	eigrp_metrics_t reported_metric; // RD for sending
-	uint32_t fdistance;		 // FD
-	uint32_t rdistance;		 // RD
-	uint32_t distance;		 // D
+	eigrp_route_vec_t feasible; // successors first, then FS
 
-	uint8_t nt;	    // network type
-	uint8_t state;	    // route FSM state
-	uint8_t req_action; // required action
+	struct {
+		struct eigrp_prefix_descriptor *prev;
+		struct eigrp_prefix_descriptor *next;
+	} dirty[EIGRP_DIRTY_MAX]; // links on eigrp->dirty[]
 
-	// If network type is REMOTE_EXTERNAL, pointer will have reference to
-	// its external TLV
-//	uint8_t af;	    // address family
-	struct TLV_IPv4_External_type *extTLV;
+	struct prefix_ipv4 destination;
+	eigrp_metrics_t reported_metric; // RD for sending
+	eigrp_nbr_set_t rij;		 // replies outstanding, by neighbor slot
+	eigrp_active_t *active;		 // active timer, NULL if PASSIVE
+	eigrp_dual_event_t *dual;	 // DUAL input waiting, newest first
+	eigrp_packetizer_work_t *work;	 // packetizer work waiting, newest first
+	eigrp_tlv_cache_t *tlv_cache;	 // encoded route TLVs, NULL until sent
+	eigrp_filter_cache_t *filter_cache; // filter verdicts, NULL until filtered
+	eigrp_rib_entry_t *rib;		 // zebra change waiting, or NULL
 
 	uint64_t serno; /*Serial number for this entry. Increased with each
 			  change of entry*/
@@ -441,6 +887,10 @@ typedef struct eigrp_route_descriptor {
 	uint8_t flags; // used for marking successor and FS
 
 	eigrp_interface_t *ei; // pointer for case of connected entry
+	struct {
+		struct eigrp_route_descriptor *prev;
+		struct eigrp_route_descriptor *next;
+	} intf; // links on ei->routes
 } eigrp_route_descriptor_t;
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP stub routing.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * A stub router is never a transit path.  It announces that in every
+ * hello with a Stub TLV, and it only advertises its own routes of the
+ * types configured: connected, static, summary and redistributed.  A
+ * receive-only stub advertises nothing at all.
+ *
+ * A hub that knows a neighbor is a stub has no reason to ask it about a
+ * lost prefix: the stub cannot have a path the hub does not.  The QUERY
+ * packetizer therefore leaves stub neighbors out, so a prefix lost at
+ * the hub is put only to its transit neighbors and the diffusing
+ * computation no longer waits on every spoke.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_packet.h"
+#include "eigrpd/eigrp_network.h"
+#include "eigrpd/eigrp_stub.h"
+
+static const struct {
+	uint16_t flag;
+	const char *name;
+} eigrp_stub_names[] = {
+	{EIGRP_STUB_CONNECTED, "connected"},
+	{EIGRP_STUB_STATIC, "static"},
+	{EIGRP_STUB_SUMMARY, "summary"},
+	{EIGRP_STUB_REDIST, "redistributed"},
+	{EIGRP_STUB_RECVONLY, "receive-only"},
+};
+
+const char *eigrp_stub_str(uint16_t flags, char *buf, size_t size)
+{
+	unsigned int i;
+	size_t len = 0;
+
+	buf[0] = '\0';
+	for (i = 0; i < array_size(eigrp_stub_names); i++) {
+		if (!(flags & eigrp_stub_names[i].flag) || len >= size)
+			continue;
+		len += snprintf(buf + len, size - len, "%s%s", len ? " " : "",
+				eigrp_stub_names[i].name);
+	}
+	return buf;
+}
+
+/*
+ * May this router advertise the route?  Always, unless it is a stub.  A
+ * stub only advertises routes it originates, and only the types it was
+ * configured with; anything learned from a neighbor stays put.
+ */
+bool eigrp_stub_advertise(eigrp_instance_t *eigrp,
+			  eigrp_route_descriptor_t *route)
+{
+	eigrp_prefix_descriptor_t *pe;
+	uint16_t type;
+
+	if (!eigrp->stub)
+		return true;
+
+	if ((eigrp->stub & EIGRP_STUB_RECVONLY) || !route)
+		return false;
+
+	/* withdrawals go out; the neighbor may hold the route from before */
+	if (route->distance == EIGRP_MAX_METRIC)
+		return true;
+
+	if (route->adv_router != eigrp->neighbor_self)
+		return false;
+
+	pe = route->prefix;
+	if (pe && pe->nt == EIGRP_TOPOLOGY_TYPE_CONNECTED)
+		type = EIGRP_STUB_CONNECTED;
+	else if (route->type == EIGRP_TLV_IPv4_EXT)
+		type = (route->extdata.protocol == ZEBRA_ROUTE_STATIC)
+			       ? EIGRP_STUB_STATIC
+			       : EIGRP_STUB_REDIST;
+	else
+		type = EIGRP_STUB_SUMMARY;
+
+	return (eigrp->stub & type) != 0;
+}
+
+/*
+ * The stub role changed.  Neighbors hold routes this router may no
+ * longer advertise, or lack ones it now may, so every adjacency starts
+ * over and the initial sync sends the new set.
+ */
+void eigrp_stub_set(eigrp_instance_t *eigrp, uint16_t flags)
+{
+	eigrp_interface_t *ei;
+	eigrp_neighbor_t *nbr;
+	struct listnode *node, *nnode, *node2;
+
+	if (eigrp->stub == flags)
+		return;
+
+	eigrp->stub = flags;
+
+	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node2, ei)) {
+		if (!ei->nbrs->count)
+			continue;
+
+		eigrp_hello_send(ei, EIGRP_HELLO_GRACEFUL_SHUTDOWN, NULL);
+		for (ALL_LIST_ELEMENTS(ei->nbrs, node, nnode, nbr)) {
+			zlog_info("Neighbor %s (%s) is down: stub configuration changed",
+				  eigrp_print_addr(&nbr->src),
+				  ifindex2ifname(ei->ifp->ifindex,
+						 eigrp->vrf_id));
+			eigrp_nbr_state_set(nbr, EIGRP_NEIGHBOR_DOWN);
+			eigrp_nbr_delete(nbr);
+		}
+	}
+}
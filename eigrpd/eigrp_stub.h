@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP stub routing.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_STUB_H
+#define _ZEBRA_EIGRP_STUB_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern void eigrp_stub_set(eigrp_instance_t *eigrp, uint16_t flags);
+extern bool eigrp_stub_advertise(eigrp_instance_t *eigrp,
+				 eigrp_route_descriptor_t *route);
+
+/* "connected summary", "receive-only", ... for show and config output */
+extern const char *eigrp_stub_str(uint16_t flags, char *buf, size_t size);
+
+#endif /* _ZEBRA_EIGRP_STUB_H */
@@ -0,0 +1,426 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP interface summarization.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * A summary configured on an interface replaces, on that interface only,
+ * every more specific prefix it covers.  The neighbors there learn one
+ * prefix instead of many, and, more to the point, never hear of the
+ * components at all: when a component is lost, the QUERY for it is not
+ * sent across the summary, and a QUERY for it that arrives there is
+ * answered unreachable on the spot.  The summary is a query boundary.
+ *
+ * Each summary is a prefix descriptor of its own, type SUMMARY, holding
+ * one locally originated route.  Its metric is that of the best
+ * component; it is reachable while any component is.  While it is
+ * reachable a discard route for it is installed, so traffic for a
+ * covered address with no component behind it is dropped here rather
+ * than looping back to the default route.
+ *
+ * Summaries are shared between interfaces that configure the same prefix
+ * and live in a table of their own.  A component that changes marks the
+ * summaries covering it stale; stale summaries are recomputed once, just
+ * before the UPDATE packetizer runs, so a burst of component changes
+ * costs one recompute per summary.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_interface.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_packet.h"
+#include "eigrpd/eigrp_network.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_summary.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_SUMMARY, "EIGRP interface summary");
+
+void eigrp_summary_init(eigrp_instance_t *eigrp)
+{
+	eigrp->summaries = route_table_init();
+}
+
+static void eigrp_summary_stale(eigrp_instance_t *eigrp,
+				eigrp_summary_t *sum)
+{
+	if (sum->stale)
+		return;
+	sum->stale = true;
+	eigrp->summary_stale++;
+}
+
+/*
+ * Give the summary its prefix descriptor.  A connected or learned prefix
+ * already holding the slot keeps it; the summary is tried again on every
+ * refresh until the slot is free.  Returns true if it was created.
+ */
+static bool eigrp_summary_attach(eigrp_instance_t *eigrp, eigrp_summary_t *sum)
+{
+	eigrp_prefix_descriptor_t *pe;
+	eigrp_route_descriptor_t *route;
+
+	if (eigrp_topology_table_lookup_ipv4(eigrp->topology_table,
+					     &sum->prefix))
+		return false;
+
+	pe = eigrp_topology_prefix_create(eigrp);
+	pe->serno = eigrp->serno;
+	prefix_copy(eigrp_topology_prefix_dest(pe), &sum->prefix);
+	pe->nt = EIGRP_TOPOLOGY_TYPE_SUMMARY;
+	pe->state = EIGRP_FSM_STATE_PASSIVE;
+	pe->distance = pe->fdistance = pe->rdistance = EIGRP_MAX_METRIC;
+	pe->reported_metric.delay = EIGRP_MAX_METRIC;
+
+	route = eigrp_topology_route_create(eigrp, NULL);
+	route->type = EIGRP_TLV_IPv4_INT;
+	route->adv_router = eigrp->neighbor_self;
+	route->reported_distance = 0;
+	route->reported_metric.delay = EIGRP_MAX_METRIC;
+	route->total_metric = route->reported_metric;
+	route->prefix = pe;
+
+	eigrp_prefix_descriptor_add(eigrp->topology_table, pe);
+	eigrp_route_descriptor_add(eigrp, pe, route);
+
+	sum->pe = pe;
+	sum->route = route;
+	return true;
+}
+
+static void eigrp_summary_detach(eigrp_instance_t *eigrp, eigrp_summary_t *sum)
+{
+	if (!sum->pe)
+		return;
+
+	eigrp_prefix_descriptor_delete(eigrp, eigrp->topology_table, sum->pe);
+	sum->pe = NULL;
+	sum->route = NULL;
+}
+
+/*
+ * Recompute one summary from its components.  Returns true if what it
+ * advertises changed; the summary is then queued for UPDATE.
+ */
+static bool eigrp_summary_update(eigrp_instance_t *eigrp, eigrp_summary_t *sum)
+{
+	eigrp_prefix_descriptor_t *pe, *best = NULL;
+	eigrp_route_descriptor_t *route, *successor;
+	struct route_node *top, *rn;
+	uint32_t components = 0;
+	eigrp_metric_t distance;
+	bool fresh = false;
+
+	sum->stale = false;
+	eigrp->summary_stale--;
+
+	if (!sum->pe)
+		fresh = eigrp_summary_attach(eigrp, sum);
+
+	top = route_node_get(eigrp->topology_table, &sum->prefix);
+	for (rn = top; rn; rn = route_next_until(rn, top)) {
+		pe = rn->info;
+		if (!pe || pe->nt == EIGRP_TOPOLOGY_TYPE_SUMMARY)
+			continue;
+		if (!eigrp_topology_successor_head(pe))
+			continue;
+
+		components++;
+		if (!best || pe->distance < best->distance)
+			best = pe;
+	}
+	sum->components = components;
+
+	pe = sum->pe;
+	route = sum->route;
+	if (!pe)
+		return false;
+
+	distance = best ? best->distance : EIGRP_MAX_METRIC;
+	/* a fresh one is settled either way; the add installed it as is */
+	if (!fresh && route->distance == distance)
+		return false;
+
+	if (best) {
+		successor = eigrp_topology_successor_head(best);
+		route->reported_metric = successor->total_metric;
+	} else {
+		route->reported_metric.delay = EIGRP_MAX_METRIC;
+	}
+	route->total_metric = route->reported_metric;
+	route->distance = distance;
+
+	pe->distance = pe->fdistance = pe->rdistance = distance;
+	pe->reported_metric = route->total_metric;
+	eigrp_topology_update_node_flags(eigrp, pe);
+
+	/* the discard route: installed while any component is reachable */
+	eigrp_update_routing_table(eigrp, pe);
+
+	eigrp_topology_dirty_insert(eigrp, pe, EIGRP_FSM_NEED_UPDATE);
+	return true;
+}
+
+/*
+ * A prefix in the topology changed.  Every summary covering it, from the
+ * longest up, is recomputed before the next UPDATE.
+ */
+void eigrp_summary_changed(eigrp_instance_t *eigrp, struct prefix *dest)
+{
+	struct route_node *rn, *node;
+	eigrp_summary_t *sum;
+
+	if (!eigrp->summary_count)
+		return;
+
+	rn = route_node_match(eigrp->summaries, dest);
+	if (!rn)
+		return;
+
+	for (node = rn; node; node = node->parent) {
+		sum = node->info;
+		/* one without a descriptor may get the slot dest held */
+		if (sum && (sum->prefix.prefixlen < dest->prefixlen || !sum->pe))
+			eigrp_summary_stale(eigrp, sum);
+	}
+	route_unlock_node(rn);
+}
+
+/* Distances moved under every summary at once, as with new K-values. */
+void eigrp_summary_invalidate(eigrp_instance_t *eigrp)
+{
+	struct route_node *rn;
+
+	if (!eigrp->summary_count)
+		return;
+
+	for (rn = route_top(eigrp->summaries); rn; rn = route_next(rn))
+		if (rn->info)
+			eigrp_summary_stale(eigrp, rn->info);
+}
+
+/*
+ * Bring the stale summaries up to date.  The prefixes waiting for UPDATE
+ * are the components that changed since the last run.  Returns the
+ * number of summaries whose advertisement changed.
+ */
+uint32_t eigrp_summary_refresh(eigrp_instance_t *eigrp)
+{
+	eigrp_prefix_descriptor_t *pe, *next;
+	struct route_node *rn;
+	uint32_t changed = 0;
+
+	if (!eigrp->summary_count)
+		return 0;
+
+	EIGRP_TOPOLOGY_DIRTY_FOREACH (eigrp, EIGRP_DIRTY_UPDATE, pe, next)
+		if (pe->nt != EIGRP_TOPOLOGY_TYPE_SUMMARY)
+			eigrp_summary_changed(eigrp,
+					      eigrp_topology_prefix_dest(pe));
+
+	if (!eigrp->summary_stale)
+		return 0;
+
+	for (rn = route_top(eigrp->summaries); rn; rn = route_next(rn)) {
+		if (!rn->info || !((eigrp_summary_t *)rn->info)->stale)
+			continue;
+		if (eigrp_summary_update(eigrp, rn->info))
+			changed++;
+	}
+
+	return changed;
+}
+
+static eigrp_summary_t *eigrp_summary_intf_lookup(eigrp_interface_t *ei,
+						  struct prefix *p)
+{
+	eigrp_summary_t *sum;
+	struct listnode *node;
+
+	if (!ei->summaries)
+		return NULL;
+
+	for (ALL_LIST_ELEMENTS_RO(ei->summaries, node, sum))
+		if (prefix_same(&sum->prefix, p))
+			return sum;
+
+	return NULL;
+}
+
+/* The summary on ei that covers dest, if dest is one of its components. */
+static eigrp_summary_t *eigrp_summary_intf_covering(eigrp_interface_t *ei,
+						    struct prefix *dest)
+{
+	eigrp_summary_t *sum;
+	struct listnode *node;
+
+	if (!ei->summaries)
+		return NULL;
+
+	for (ALL_LIST_ELEMENTS_RO(ei->summaries, node, sum))
+		if (sum->pe && sum->prefix.prefixlen < dest->prefixlen
+		    && prefix_match(&sum->prefix, dest))
+			return sum;
+
+	return NULL;
+}
+
+static void eigrp_summary_unref(eigrp_instance_t *eigrp, eigrp_summary_t *sum)
+{
+	struct route_node *rn;
+
+	if (--sum->refs)
+		return;
+
+	eigrp_summary_detach(eigrp, sum);
+
+	rn = route_node_lookup(eigrp->summaries, &sum->prefix);
+	if (rn) {
+		rn->info = NULL;
+		route_unlock_node(rn); // Lookup above
+		route_unlock_node(rn); // Initial creation
+	}
+
+	if (sum->stale)
+		eigrp->summary_stale--;
+	eigrp->summary_count--;
+	XFREE(MTYPE_EIGRP_SUMMARY, sum);
+}
+
+/*
+ * Configure a summary on ei.  What the neighbors there hold no longer
+ * matches what they would be sent, so they are resynchronized.
+ */
+void eigrp_summary_add(eigrp_interface_t *ei, struct prefix *p)
+{
+	eigrp_instance_t *eigrp = ei->eigrp;
+	eigrp_summary_t *sum;
+	struct route_node *rn;
+	struct prefix prefix;
+
+	prefix_copy(&prefix, p);
+	apply_mask(&prefix);
+	if (eigrp_summary_intf_lookup(ei, &prefix))
+		return;
+
+	rn = route_node_get(eigrp->summaries, &prefix);
+	sum = rn->info;
+	if (sum) {
+		route_unlock_node(rn);
+	} else {
+		sum = XCALLOC(MTYPE_EIGRP_SUMMARY, sizeof(*sum));
+		prefix_copy(&sum->prefix, &prefix);
+		rn->info = sum;
+		eigrp->summary_count++;
+		eigrp_summary_stale(eigrp, sum);
+	}
+	sum->refs++;
+
+	if (!ei->summaries)
+		ei->summaries = list_new();
+	listnode_add(ei->summaries, sum);
+
+	eigrp_summary_refresh(eigrp);
+	eigrp_update_send_interface_GR(ei, EIGRP_GR_FILTER, NULL);
+	eigrp_packetizer_flush(eigrp, NULL);
+}
+
+void eigrp_summary_del(eigrp_interface_t *ei, struct prefix *p)
+{
+	eigrp_instance_t *eigrp = ei->eigrp;
+	eigrp_summary_t *sum;
+	struct prefix prefix;
+
+	prefix_copy(&prefix, p);
+	apply_mask(&prefix);
+	sum = eigrp_summary_intf_lookup(ei, &prefix);
+	if (!sum)
+		return;
+
+	listnode_delete(ei->summaries, sum);
+	eigrp_summary_unref(eigrp, sum);
+
+	eigrp_update_send_interface_GR(ei, EIGRP_GR_FILTER, NULL);
+	eigrp_packetizer_flush(eigrp, NULL);
+}
+
+/* The interface is going away; drop its hold on its summaries. */
+void eigrp_summary_intf_fini(eigrp_interface_t *ei)
+{
+	eigrp_summary_t *sum;
+	struct listnode *node;
+
+	if (!ei->summaries)
+		return;
+
+	for (ALL_LIST_ELEMENTS_RO(ei->summaries, node, sum))
+		eigrp_summary_unref(ei->eigrp, sum);
+	list_delete(&ei->summaries);
+}
+
+void eigrp_summary_fini(eigrp_instance_t *eigrp)
+{
+	struct route_node *rn;
+	eigrp_summary_t *sum;
+
+	if (!eigrp->summaries)
+		return;
+
+	for (rn = route_top(eigrp->summaries); rn; rn = route_next(rn)) {
+		sum = rn->info;
+		if (!sum)
+			continue;
+
+		eigrp_summary_detach(eigrp, sum);
+		rn->info = NULL;
+		route_unlock_node(rn);
+		XFREE(MTYPE_EIGRP_SUMMARY, sum);
+	}
+	route_table_finish(eigrp->summaries);
+	eigrp->summaries = NULL;
+	eigrp->summary_count = eigrp->summary_stale = 0;
+}
+
+/*
+ * Should pe stay off the wire on ei?  A component of a summary configured
+ * on ei does; so does a summary that is not configured on ei.
+ */
+bool eigrp_summary_suppress(eigrp_interface_t *ei,
+			    eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_summary_t *sum;
+	struct listnode *node;
+
+	if (!ei->eigrp->summary_count)
+		return false;
+
+	if (pe->nt != EIGRP_TOPOLOGY_TYPE_SUMMARY)
+		return eigrp_summary_intf_covering(
+			       ei, eigrp_topology_prefix_dest(pe))
+		       != NULL;
+
+	if (ei->summaries)
+		for (ALL_LIST_ELEMENTS_RO(ei->summaries, node, sum))
+			if (sum->pe == pe)
+				return false;
+	return true;
+}
+
+/*
+ * A QUERY from nbr on ei for a component of a summary there.  The
+ * neighbor only ever heard of the summary from us, so unless it is the
+ * one that gave us the component, there is nothing to compute: the
+ * answer is unreachable.
+ */
+bool eigrp_summary_boundary(eigrp_interface_t *ei,
+			    eigrp_prefix_descriptor_t *pe,
+			    eigrp_neighbor_t *nbr)
+{
+	if (!ei->eigrp->summary_count || pe->nt == EIGRP_TOPOLOGY_TYPE_SUMMARY)
+		return false;
+
+	if (!eigrp_summary_intf_covering(ei, eigrp_topology_prefix_dest(pe)))
+		return false;
+
+	return eigrp_prefix_descriptor_lookup(&pe->routes, nbr) == NULL;
+}
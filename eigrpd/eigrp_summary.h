@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP interface summarization.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_SUMMARY_H
+#define _ZEBRA_EIGRP_SUMMARY_H
+
+#include "eigrpd/eigrp_types.h"
+
+extern void eigrp_summary_init(eigrp_instance_t *eigrp);
+extern void eigrp_summary_fini(eigrp_instance_t *eigrp);
+
+extern void eigrp_summary_add(eigrp_interface_t *ei, struct prefix *p);
+extern void eigrp_summary_del(eigrp_interface_t *ei, struct prefix *p);
+extern void eigrp_summary_intf_fini(eigrp_interface_t *ei);
+
+/* a covered prefix changed; its summaries are recomputed before the next update */
+extern void eigrp_summary_changed(eigrp_instance_t *eigrp, struct prefix *dest);
+extern void eigrp_summary_invalidate(eigrp_instance_t *eigrp);
+extern uint32_t eigrp_summary_refresh(eigrp_instance_t *eigrp);
+
+/* keep pe off the wire on ei: a component behind a summary, or a summary configured elsewhere */
+extern bool eigrp_summary_suppress(eigrp_interface_t *ei,
+				   eigrp_prefix_descriptor_t *pe);
+/* a QUERY from nbr for pe stops at the summary boundary on ei */
+extern bool eigrp_summary_boundary(eigrp_interface_t *ei,
+				   eigrp_prefix_descriptor_t *pe,
+				   eigrp_neighbor_t *nbr);
+
+#endif /* _ZEBRA_EIGRP_SUMMARY_H */
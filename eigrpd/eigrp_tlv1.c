@@ -22,6 +22,8 @@
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_tlv1.h"
+#include "eigrpd/eigrp_tlv_cache.h"
+#include "eigrpd/eigrp_filter_cache.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_topology.h"
 #include "eigrpd/eigrp_fsm.h"
@@ -249,7 +251,9 @@ static uint16_t eigrp_tlv1_addr_decode(eigrp_stream_t *pkt,
 static uint16_t eigrp_tlv1_addr_encode(eigrp_stream_t *pkt,
 				       eigrp_route_descriptor_t *route)
 {
-	struct prefix *dest = route->prefix->destination;
+	struct prefix *dest = route->prefix
+				      ? eigrp_topology_prefix_dest(route->prefix)
+				      : &route->dest;
 	uint8_t addr[4];
 	uint16_t addr_len;
 
@@ -372,7 +376,7 @@ static eigrp_route_descriptor_t *eigrp_tlv1_decoder(eigrp_instance_t *eigrp,
 	stream_set_endp(pkt, tlv_end);
 
 	/* allocate buffer */
-	route = eigrp_topology_route_create(nbr->ei);
+	route = eigrp_topology_route_create(eigrp, nbr->ei);
 	if (!route) {
 		stream_set_endp(pkt, packet_end);
 		eigrp_tlv1_decode_skip(pkt, tlv_end);
@@ -443,6 +447,36 @@ malformed:
 	return NULL;
 }
 
+/*
+ * What the TLV1 encoder will write for route, worked out without
+ * writing it, so a packet can be filled up to the MTU.
+ */
+static uint16_t eigrp_tlv1_sizer(eigrp_instance_t *eigrp,
+				 eigrp_route_descriptor_t *route)
+{
+	struct prefix *dest;
+	uint16_t length = EIGRP_TLV_HDR_SIZE + EIGRP_TLV1_IPV4_NEXTHOP_SIZE
+			  + EIGRP_TLV1_METRIC_SIZE + EIGRP_TLV1_DEST_PREFIX_SIZE;
+
+	(void)eigrp;
+	switch (eigrp_tlv1_route_tlv_type(route)) {
+	case EIGRP_TLV_IPv4_EXT:
+		length += EIGRP_TLV1_EXTDATA_SIZE;
+		break;
+	case EIGRP_TLV_IPv4_INT:
+		break;
+	default:
+		return 0;
+	}
+
+	dest = route->prefix ? eigrp_topology_prefix_dest(route->prefix)
+			     : &route->dest;
+	if (dest->family != AF_INET || dest->prefixlen > IPV4_MAX_BITLEN)
+		return 0;
+
+	return length + eigrp_tlv1_ipv4_prefix_bytes(dest->prefixlen);
+}
+
 static uint16_t eigrp_tlv1_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *ei,
 				   eigrp_neighbor_t *nbr, eigrp_stream_t *pkt,
 				   eigrp_route_descriptor_t *route)
@@ -452,6 +486,7 @@ static uint16_t eigrp_tlv1_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *e
 	uint16_t type;
 	uint16_t length;
 	uint16_t encoded;
+	bool filtered;
 
 	if (!ei && nbr)
 		ei = nbr->ei;
@@ -460,14 +495,23 @@ static uint16_t eigrp_tlv1_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *e
 	 * TODO: Work in progress
 	 */
 	if (ei) {
-		if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT,
-					      route->prefix->destination)) {
+		if (route->prefix)
+			filtered = eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT,
+							    route->prefix);
+		else
+			filtered = eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT,
+							     &route->dest);
+		if (filtered) {
 			zlog_info(
 				"Prefix Filtered:  Setting Metric to EIGRP_MAX_METRIC");
 			route->metric.delay = EIGRP_MAX_METRIC;
 		}
 	}
 
+	length = eigrp_tlv_cache_put(eigrp, pkt, route, EIGRP_TLV_CACHE_TLV1);
+	if (length)
+		return length;
+
 	type = eigrp_tlv1_route_tlv_type(route);
 	if (!type) {
 		if (IS_DEBUG_EIGRP_PACKET(0, RECV)) {
@@ -512,6 +556,8 @@ static uint16_t eigrp_tlv1_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *e
 	stream_putw(pkt, length);
 	stream_set_endp(pkt, tlv_end);
 
+	eigrp_tlv_cache_store(eigrp, pkt, tlv_start, length, route,
+			      EIGRP_TLV_CACHE_TLV1);
 	return length;
 }
 
@@ -522,6 +568,7 @@ void eigrp_tlv1_init(eigrp_tlv_codec_t *codec)
 
 	codec->decoder = eigrp_tlv1_decoder;
 	codec->encoder = eigrp_tlv1_encoder;
+	codec->sizer = eigrp_tlv1_sizer;
 }
 
 void eigrp_tlv1_neighbor_bind(eigrp_neighbor_t *nbr, eigrp_tlv_codec_t *codec)
@@ -540,4 +587,5 @@ void eigrp_tlv1_interface_bind(eigrp_interface_t *ei, eigrp_tlv_codec_t *codec)
 		return;
 
 	ei->encoder = codec->encoder;
+	ei->sizer = codec->sizer;
 }
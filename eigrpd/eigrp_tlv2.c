@@ -14,6 +14,8 @@
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_tlv2.h"
+#include "eigrpd/eigrp_tlv_cache.h"
+#include "eigrpd/eigrp_filter_cache.h"
 #include "eigrpd/eigrp_topology.h"
 #include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_metric.h"
@@ -218,12 +220,13 @@ static uint16_t eigrp_tlv2_addr_decode(eigrp_stream_t *pkt,
 static uint16_t eigrp_tlv2_addr_encode(eigrp_stream_t *pkt,
 				       eigrp_route_descriptor_t *route)
 {
-	struct prefix *dest = route->prefix ? route->prefix->destination
-					     : &route->dest;
+	struct prefix *dest = route->prefix
+				      ? eigrp_topology_prefix_dest(route->prefix)
+				      : &route->dest;
 	uint8_t addr[4];
 	uint16_t addr_len;
 
-	if (!dest || dest->family != AF_INET || dest->prefixlen > IPV4_MAX_BITLEN) {
+	if (dest->family != AF_INET || dest->prefixlen > IPV4_MAX_BITLEN) {
 		zlog_err("%s: Unexpected IPv4 prefix length", __func__);
 		return 0;
 	}
@@ -327,7 +330,7 @@ static eigrp_route_descriptor_t *eigrp_tlv2_decoder(eigrp_instance_t *eigrp,
 		return NULL;
 	}
 
-	route = eigrp_topology_route_create(nbr->ei);
+	route = eigrp_topology_route_create(eigrp, nbr->ei);
 	if (!route) {
 		stream_set_endp(pkt, packet_end);
 		eigrp_tlv2_decode_skip(pkt, tlv_end);
@@ -376,6 +379,37 @@ malformed:
 	return NULL;
 }
 
+/*
+ * What the TLV2 encoder will write for route, worked out without
+ * writing it, so a packet can be filled up to the MTU.
+ */
+static uint16_t eigrp_tlv2_sizer(eigrp_instance_t *eigrp,
+				 eigrp_route_descriptor_t *route)
+{
+	struct prefix *dest;
+	uint16_t length = EIGRP_TLV_HDR_SIZE + EIGRP_TLV2_HEADER_EXT_SIZE
+			  + EIGRP_TLV2_METRIC_SIZE
+			  + EIGRP_TLV2_DEST_PREFIX_SIZE;
+
+	(void)eigrp;
+	switch (eigrp_tlv2_route_tlv_type(route)) {
+	case EIGRP_TLV_MP_EXT:
+		length += EIGRP_TLV2_EXTDATA_SIZE;
+		break;
+	case EIGRP_TLV_MP_INT:
+		break;
+	default:
+		return 0;
+	}
+
+	dest = route->prefix ? eigrp_topology_prefix_dest(route->prefix)
+			     : &route->dest;
+	if (dest->family != AF_INET || dest->prefixlen > IPV4_MAX_BITLEN)
+		return 0;
+
+	return length + eigrp_tlv2_ipv4_prefix_bytes(dest->prefixlen);
+}
+
 static uint16_t eigrp_tlv2_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *ei,
 				   eigrp_neighbor_t *nbr, eigrp_stream_t *pkt,
 				   eigrp_route_descriptor_t *route)
@@ -385,19 +419,28 @@ static uint16_t eigrp_tlv2_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *e
 	uint16_t type;
 	uint16_t length;
 	uint16_t encoded;
+	bool filtered;
 
 	if (!ei && nbr)
 		ei = nbr->ei;
 	if (!eigrp || !ei || !pkt || !route)
 		return 0;
 
-	if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT,
-				       route->prefix ? route->prefix->destination
-						     : &route->dest)) {
+	if (route->prefix)
+		filtered = eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT,
+						    route->prefix);
+	else
+		filtered = eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT,
+						     &route->dest);
+	if (filtered) {
 		zlog_info("Prefix Filtered:  Setting Metric to EIGRP_MAX_METRIC");
 		route->metric.delay = EIGRP_MAX_METRIC;
 	}
 
+	length = eigrp_tlv_cache_put(eigrp, pkt, route, EIGRP_TLV_CACHE_TLV2);
+	if (length)
+		return length;
+
 	type = eigrp_tlv2_route_tlv_type(route);
 	if (!type)
 		return 0;
@@ -427,6 +470,8 @@ static uint16_t eigrp_tlv2_encoder(eigrp_instance_t *eigrp, eigrp_interface_t *e
 	stream_putw(pkt, length);
 	stream_set_endp(pkt, tlv_end);
 
+	eigrp_tlv_cache_store(eigrp, pkt, tlv_start, length, route,
+			      EIGRP_TLV_CACHE_TLV2);
 	return length;
 }
 
@@ -437,6 +482,7 @@ void eigrp_tlv2_init(eigrp_tlv_codec_t *codec)
 
 	codec->decoder = eigrp_tlv2_decoder;
 	codec->encoder = eigrp_tlv2_encoder;
+	codec->sizer = eigrp_tlv2_sizer;
 }
 
 void eigrp_tlv2_neighbor_bind(eigrp_neighbor_t *nbr, eigrp_tlv_codec_t *codec)
@@ -455,4 +501,5 @@ void eigrp_tlv2_interface_bind(eigrp_interface_t *ei, eigrp_tlv_codec_t *codec)
 		return;
 
 	ei->encoder = codec->encoder;
+	ei->sizer = codec->sizer;
 }
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix encoded route TLV cache.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * A route TLV used to be built field by field every time it went out:
+ * once per interface by the UPDATE packetizer, once per neighbor for each
+ * full-table UPDATE, once per QUERY interface and once per REPLY.  The
+ * bytes only differ when the route or the codec does.
+ *
+ * So each codec keeps the last TLV it built for a prefix, and the next
+ * packet that carries the prefix copies it.  An image is keyed by the
+ * prefix serial number, bumped each time DUAL queues the prefix for the
+ * wire, and by the route fields the codecs encode.  The serial number
+ * retires images as the prefix changes; the fields catch a route
+ * rewritten on the way out.  The cache goes with the prefix.
+ *
+ * Images cost memory on every prefix, so each is allocated to its TLV's
+ * length and a prefix only has one per codec actually in use.  An
+ * unreachable metric is never cached: that is the poisoned route of a
+ * REPLY, a metric an outbound filter set, or a prefix on its way out,
+ * none of which is sent the same way twice.
+ */
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_tlv_cache.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_TLV_CACHE, "EIGRP encoded TLV cache");
+
+/* one codec's image, on the prefix's list */
+struct eigrp_tlv_cache {
+	eigrp_tlv_cache_t *next;
+
+	/* everything a codec reads to build a route TLV */
+	uint64_t serno;
+	uint32_t router_id;
+	uint32_t nexthop;
+	eigrp_metrics_t metric;
+	eigrp_extdata_t extdata;
+	uint16_t type;
+
+	uint8_t codec;
+	uint8_t length;
+	uint8_t data[];
+};
+
+static bool eigrp_tlv_cache_metric_same(const eigrp_metrics_t *a,
+					const eigrp_metrics_t *b)
+{
+	return a->delay == b->delay && a->bandwidth == b->bandwidth
+	       && a->mtu[0] == b->mtu[0] && a->mtu[1] == b->mtu[1]
+	       && a->mtu[2] == b->mtu[2] && a->hop_count == b->hop_count
+	       && a->reliability == b->reliability && a->load == b->load
+	       && a->tag == b->tag && a->flags == b->flags;
+}
+
+static bool eigrp_tlv_cache_extdata_same(const eigrp_extdata_t *a,
+					 const eigrp_extdata_t *b)
+{
+	return a->orig == b->orig && a->as == b->as && a->tag == b->tag
+	       && a->metric == b->metric && a->reserved == b->reserved
+	       && a->protocol == b->protocol && a->flags == b->flags;
+}
+
+static bool eigrp_tlv_cache_match(eigrp_instance_t *eigrp,
+				  eigrp_tlv_cache_t *image,
+				  eigrp_route_descriptor_t *route)
+{
+	return image->serno == route->prefix->serno
+	       && image->router_id == eigrp->router_id.s_addr
+	       && image->nexthop == route->nexthop.ip.v4.s_addr
+	       && image->type == route->type
+	       && eigrp_tlv_cache_metric_same(&image->metric, &route->metric)
+	       && eigrp_tlv_cache_extdata_same(&image->extdata,
+					       &route->extdata);
+}
+
+static eigrp_tlv_cache_t **eigrp_tlv_cache_find(eigrp_prefix_descriptor_t *pe,
+						uint8_t codec)
+{
+	eigrp_tlv_cache_t **pp;
+
+	for (pp = &pe->tlv_cache; *pp; pp = &(*pp)->next)
+		if ((*pp)->codec == codec)
+			break;
+	return pp;
+}
+
+uint16_t eigrp_tlv_cache_put(eigrp_instance_t *eigrp, eigrp_stream_t *pkt,
+			     eigrp_route_descriptor_t *route, uint8_t codec)
+{
+	eigrp_tlv_cache_t *image;
+
+	if (!route->prefix || !route->prefix->tlv_cache
+	    || route->metric.delay == EIGRP_MAX_METRIC)
+		return 0;
+
+	image = *eigrp_tlv_cache_find(route->prefix, codec);
+	if (!image || STREAM_WRITEABLE(pkt) < image->length
+	    || !eigrp_tlv_cache_match(eigrp, image, route))
+		return 0;
+
+	stream_put(pkt, image->data, image->length);
+	eigrp->tlv_cache_stats.hits++;
+	return image->length;
+}
+
+void eigrp_tlv_cache_store(eigrp_instance_t *eigrp, eigrp_stream_t *pkt,
+			   size_t start, uint16_t length,
+			   eigrp_route_descriptor_t *route, uint8_t codec)
+{
+	eigrp_prefix_descriptor_t *pe = route->prefix;
+	eigrp_tlv_cache_t **pp;
+	eigrp_tlv_cache_t *image;
+
+	eigrp->tlv_cache_stats.misses++;
+	if (!pe || !length || length > EIGRP_TLV_CACHE_BYTES
+	    || route->metric.delay == EIGRP_MAX_METRIC) {
+		eigrp->tlv_cache_stats.uncached++;
+		return;
+	}
+
+	pp = eigrp_tlv_cache_find(pe, codec);
+	image = *pp;
+	if (!image || image->length != length) {
+		if (image) {
+			*pp = image->next;
+			XFREE(MTYPE_EIGRP_TLV_CACHE, image);
+		}
+		image = XMALLOC(MTYPE_EIGRP_TLV_CACHE, sizeof(*image) + length);
+		image->codec = codec;
+		image->length = length;
+		image->next = pe->tlv_cache;
+		pe->tlv_cache = image;
+	}
+
+	image->serno = pe->serno;
+	image->router_id = eigrp->router_id.s_addr;
+	image->nexthop = route->nexthop.ip.v4.s_addr;
+	image->metric = route->metric;
+	image->extdata = route->extdata;
+	image->type = route->type;
+	memcpy(image->data, STREAM_DATA(pkt) + start, length);
+}
+
+void eigrp_tlv_cache_free(eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_tlv_cache_t *image;
+
+	while ((image = pe->tlv_cache)) {
+		pe->tlv_cache = image->next;
+		XFREE(MTYPE_EIGRP_TLV_CACHE, image);
+	}
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix encoded route TLV cache.
+ * Copyright (C) 2026 Donnie V. Savage
+ */
+#ifndef _ZEBRA_EIGRP_TLV_CACHE_H
+#define _ZEBRA_EIGRP_TLV_CACHE_H
+
+#include "eigrpd/eigrp_types.h"
+
+/* at most one cached image per codec */
+enum eigrp_tlv_cache_codec {
+	EIGRP_TLV_CACHE_TLV1 = 0,
+	EIGRP_TLV_CACHE_TLV2,
+	EIGRP_TLV_CACHE_CODECS,
+};
+
+/* largest route TLV either codec builds */
+#define EIGRP_TLV_CACHE_BYTES 64
+
+/* copy route's cached TLV onto pkt; 0 if the codec has to encode it */
+extern uint16_t eigrp_tlv_cache_put(eigrp_instance_t *eigrp,
+				    eigrp_stream_t *pkt,
+				    eigrp_route_descriptor_t *route,
+				    uint8_t codec);
+/* keep the TLV the codec just encoded at start for the next packet */
+extern void eigrp_tlv_cache_store(eigrp_instance_t *eigrp,
+				  eigrp_stream_t *pkt, size_t start,
+				  uint16_t length,
+				  eigrp_route_descriptor_t *route,
+				  uint8_t codec);
+
+/* the prefix is going away */
+extern void eigrp_tlv_cache_free(eigrp_prefix_descriptor_t *pe);
+
+#endif /* _ZEBRA_EIGRP_TLV_CACHE_H */
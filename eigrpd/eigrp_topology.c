@@ -15,6 +15,7 @@
  */
 #include "eigrpd/eigrpd.h"
 #include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_interface.h"
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_dump.h"
@@ -23,27 +24,43 @@
 #include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_metric.h"
 #include "eigrpd/eigrp_errors.h"
-#include "eigrpd/eigrp_zebra.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_snapshot.h"
+#include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_summary.h"
+#include "eigrpd/eigrp_dual_queue.h"
+#include "eigrpd/eigrp_tlv_cache.h"
+#include "eigrpd/eigrp_filter_cache.h"
+#include "eigrpd/eigrp_rib_queue.h"
+
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_RECOMPUTE, "EIGRP bulk recompute");
+DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_PREFIX_SET, "EIGRP interface prefix set");
 
-DEFINE_MTYPE_STATIC(EIGRPD, EIGRP_ROUTE_DESCRIPTOR, "EIGRP Route Entry");
-DEFINE_MTYPE(EIGRPD, EIGRP_PREFIX_DESCRIPTOR,       "EIGRP Prefix Entry");
-
-static int eigrp_route_descriptor_cmp(eigrp_route_descriptor_t *,
-				      eigrp_route_descriptor_t *);
+/*
+ * Every change to what a snapshot would hold moves the topology epoch, so
+ * snapshot readers can tell whether their copy is still current.
+ */
+static void eigrp_topology_changed(eigrp_instance_t *eigrp)
+{
+	eigrp->topology_epoch++;
+	if (eigrp->snapshot_read && !eigrp->t_snapshot)
+		eigrp_snapshot_refresh(eigrp);
+}
 
 /**
  * Various fuctions for handling eigrp route descriptors
  */
 
 /*
- * Returns new topology route
+ * Returns new topology route, carved from the instance route slab
  */
-eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_interface_t *intf)
+eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_instance_t *eigrp, eigrp_interface_t *intf)
 {
 	eigrp_route_descriptor_t *new;
 
-	new = XCALLOC(MTYPE_EIGRP_ROUTE_DESCRIPTOR,
-		      sizeof(eigrp_route_descriptor_t));
+	new = eigrp_slab_obj_create(&eigrp->route_slab);
 	new->reported_distance = EIGRP_MAX_METRIC;
 	new->distance = EIGRP_MAX_METRIC;
 	new->ei = intf;
@@ -51,64 +68,113 @@ eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_interface_t *intf)
 	return new;
 }
 
+/*
+ * Rebuild the cached successor and feasible successor sets from the route
+ * flags.  Both keep the distance order of the routes vector.
+ */
+static void eigrp_topology_successor_update(eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_route_descriptor_t *route;
+	int i;
+
+	eigrp_route_vec_clear(&pe->feasible);
+
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route)
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
+			eigrp_route_vec_append(&pe->feasible, route);
+	pe->nsuccessor = pe->feasible.count;
+
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route)
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG)
+			eigrp_route_vec_append(&pe->feasible, route);
+}
+
 /*
  * Adding topology entry to topology node
  */
+/*
+ * Per-interface route index.  A route is on route->ei's list from the time
+ * it joins a prefix until it is freed, so work caused by one interface or
+ * one neighbor only has to look at the routes learned over that interface.
+ * The interface and advertising neighbor route counts move with the index.
+ */
+static void eigrp_topology_intf_link(eigrp_route_descriptor_t *route)
+{
+	eigrp_interface_t *ei = route->ei;
+	eigrp_neighbor_t *nbr;
+
+	if (!ei)
+		return;
+
+	route->intf.prev = NULL;
+	route->intf.next = ei->routes;
+	if (ei->routes)
+		ei->routes->intf.prev = route;
+	ei->routes = route;
+	if (++ei->route_count > ei->route_peak)
+		ei->route_peak = ei->route_count;
+
+	nbr = route->adv_router;
+	if (nbr && ++nbr->route_count > nbr->route_peak)
+		nbr->route_peak = nbr->route_count;
+}
+
+static void eigrp_topology_intf_unlink(eigrp_route_descriptor_t *route)
+{
+	eigrp_interface_t *ei = route->ei;
+
+	if (!ei || (!route->intf.prev && ei->routes != route))
+		return;
+
+	if (route->intf.prev)
+		route->intf.prev->intf.next = route->intf.next;
+	else
+		ei->routes = route->intf.next;
+	if (route->intf.next)
+		route->intf.next->intf.prev = route->intf.prev;
+
+	route->intf.prev = route->intf.next = NULL;
+	ei->route_count--;
+	if (route->adv_router)
+		route->adv_router->route_count--;
+}
+
 void eigrp_route_descriptor_add(eigrp_instance_t *eigrp,
 				eigrp_prefix_descriptor_t *node,
 				eigrp_route_descriptor_t *route)
 {
-	struct list *l = list_new();
-
-	listnode_add(l, route);
-
-	if (listnode_lookup(node->entries, route) == NULL) {
-		listnode_add_sort(node->entries, route);
+	if (eigrp_route_vec_insert(&node->routes, route)) {
 		route->prefix = node;
+		eigrp_topology_intf_link(route);
 
-		eigrp_zebra_route_add(eigrp, node->destination, l,
-				      node->fdistance);
-	}
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_FEASIBLE_FLAGS)
+			eigrp_topology_successor_update(node);
 
-	list_delete(&l);
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
+			eigrp_rib_queue_enqueue(eigrp, node);
+		eigrp_topology_changed(eigrp);
+	}
 }
 
-
 void eigrp_topology_prefix_free(eigrp_prefix_descriptor_t *pe)
 {
 	eigrp_route_descriptor_t *route;
-	struct listnode *node, *nnode;
+	int i;
 
 	if (!pe)
 		return;
 
-	if (pe->entries) {
-		for (ALL_LIST_ELEMENTS(pe->entries, node, nnode, route))
-			eigrp_topology_route_free(route);
-		list_delete(&pe->entries);
-	}
-
-	if (pe->rij)
-		list_delete(&pe->rij);
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route)
+		eigrp_topology_route_free(route);
+	eigrp_route_vec_fini(&pe->routes);
+	eigrp_route_vec_fini(&pe->feasible);
 
-	if (pe->destination)
-		prefix_free(&pe->destination);
+	eigrp_nbr_set_fini(&pe->rij);
+	eigrp_tlv_cache_free(pe);
+	eigrp_filter_cache_free(pe);
+	eigrp_rib_queue_prefix_detach(pe);
 
-	XFREE(MTYPE_EIGRP_PREFIX_DESCRIPTOR, pe);
-}
-
-/*
- * Topology entry comparison
- */
-static int eigrp_route_descriptor_cmp(eigrp_route_descriptor_t *route1,
-				      eigrp_route_descriptor_t *route2)
-{
-	if (route1->distance < route2->distance)
-		return -1;
-	if (route1->distance > route2->distance)
-		return 1;
-
-	return 0;
+	eigrp_slab_obj_free(pe);
 }
 
 /*
@@ -116,7 +182,8 @@ static int eigrp_route_descriptor_cmp(eigrp_route_descriptor_t *route1,
  */
 void eigrp_topology_route_free(eigrp_route_descriptor_t *route)
 {
-	XFREE(MTYPE_EIGRP_ROUTE_DESCRIPTOR, route);
+	eigrp_topology_intf_unlink(route);
+	eigrp_slab_obj_free(route);
 }
 
 /**
@@ -124,23 +191,163 @@ void eigrp_topology_route_free(eigrp_route_descriptor_t *route)
  */
 
 /*
- * Returns new created toplogy node
- * cmp - assigned function for comparing topology entry
+ * Returns new created toplogy node, carved from the instance prefix slab
  */
-eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(void)
+eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(eigrp_instance_t *eigrp)
 {
 	eigrp_prefix_descriptor_t *new;
-	new = XCALLOC(MTYPE_EIGRP_PREFIX_DESCRIPTOR,
-		      sizeof(eigrp_prefix_descriptor_t));
-	new->entries = list_new();
-	new->rij = list_new();
-	new->entries->cmp = (int (*)(void *, void *))eigrp_route_descriptor_cmp;
+
+	new = eigrp_slab_obj_create(&eigrp->prefix_slab);
+	eigrp_route_vec_init(&new->routes);
+	eigrp_route_vec_init(&new->feasible);
 	new->distance = new->fdistance = new->rdistance = EIGRP_MAX_METRIC;
-	new->destination = NULL;
 
 	return new;
 }
 
+/*
+ * Reply tracking.  The replies outstanding are a bitset over neighbor
+ * slots, so a QUERY or REPLY is a bit flip and the last reply is seen by
+ * popcount.  Each neighbor counts the prefixes still waiting on it, which
+ * lets neighbor-down cleanup skip prefixes entirely once it reaches zero.
+ */
+void eigrp_topology_rij_add(eigrp_prefix_descriptor_t *pe,
+			    eigrp_neighbor_t *nbr)
+{
+	if (nbr->slot == EIGRP_NBR_SLOT_NONE)
+		return;
+
+	if (eigrp_nbr_set_add(&pe->rij, nbr->slot))
+		nbr->rij_pending++;
+}
+
+void eigrp_topology_rij_remove(eigrp_prefix_descriptor_t *pe,
+			       eigrp_neighbor_t *nbr)
+{
+	if (eigrp_nbr_set_del(&pe->rij, nbr->slot))
+		nbr->rij_pending--;
+}
+
+bool eigrp_topology_rij_test(eigrp_prefix_descriptor_t *pe,
+			     eigrp_neighbor_t *nbr)
+{
+	return eigrp_nbr_set_test(&pe->rij, nbr->slot);
+}
+
+/* Forget every reply outstanding; the prefix is going away. */
+void eigrp_topology_rij_clear(eigrp_instance_t *eigrp,
+			      eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_neighbor_t *nbr;
+	uint32_t slot;
+
+	EIGRP_TOPOLOGY_RIJ_FOREACH (eigrp, pe, slot, nbr)
+		nbr->rij_pending--;
+	eigrp_nbr_set_fini(&pe->rij);
+}
+
+/* Next neighbor owing a REPLY at or after *slot, NULL when done. */
+eigrp_neighbor_t *eigrp_topology_rij_next(eigrp_instance_t *eigrp,
+					  eigrp_prefix_descriptor_t *pe,
+					  uint32_t *slot)
+{
+	eigrp_neighbor_t *nbr;
+
+	for (*slot = eigrp_nbr_set_next(&pe->rij, *slot);
+	     *slot != EIGRP_NBR_SLOT_NONE;
+	     *slot = eigrp_nbr_set_next(&pe->rij, *slot + 1)) {
+		nbr = eigrp_nbr_slot_lookup(eigrp, *slot);
+		if (nbr)
+			return nbr;
+	}
+
+	return NULL;
+}
+
+/*
+ * Drop the neighbor from every prefix still waiting on it, wherever that
+ * is.  Only needed when the ACTIVE prefix walk did not account for all of
+ * its pending replies; stops as soon as the count says it is done.
+ */
+void eigrp_topology_rij_purge(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+{
+	struct route_node *rn;
+
+	for (rn = route_top(eigrp->topology_table); rn && nbr->rij_pending;
+	     rn = route_next(rn)) {
+		if (rn->info)
+			eigrp_topology_rij_remove(rn->info, nbr);
+	}
+	if (rn)
+		route_unlock_node(rn);
+}
+
+/*
+ * Queue a prefix for the packetization named by the req_action bits in
+ * action.  A prefix already waiting for that work is not queued again.
+ * Either way it changed: the new serial number retires its cached TLVs.
+ */
+void eigrp_topology_dirty_insert(eigrp_instance_t *eigrp,
+				 eigrp_prefix_descriptor_t *pe, uint8_t action)
+{
+	eigrp_dirty_queue_t *queue;
+	int q;
+
+	pe->serno = ++eigrp->serno;
+	for (q = 0; q < EIGRP_DIRTY_MAX; q++) {
+		if (!(action & (1 << q)))
+			continue;
+
+		queue = &eigrp->dirty[q];
+		if (pe->req_action & (1 << q)) {
+			queue->suppressed++;
+			continue;
+		}
+
+		pe->req_action |= (1 << q);
+		pe->dirty[q].next = NULL;
+		pe->dirty[q].prev = queue->tail;
+		if (queue->tail)
+			queue->tail->dirty[q].next = pe;
+		else
+			queue->head = pe;
+		queue->tail = pe;
+
+		queue->queued++;
+		if (++queue->count > queue->peak)
+			queue->peak = queue->count;
+	}
+}
+
+/*
+ * Take a prefix off the queues named by the req_action bits in action.
+ */
+void eigrp_topology_dirty_remove(eigrp_instance_t *eigrp,
+				 eigrp_prefix_descriptor_t *pe, uint8_t action)
+{
+	eigrp_dirty_queue_t *queue;
+	int q;
+
+	for (q = 0; q < EIGRP_DIRTY_MAX; q++) {
+		if (!(action & pe->req_action & (1 << q)))
+			continue;
+
+		queue = &eigrp->dirty[q];
+		if (pe->dirty[q].prev)
+			pe->dirty[q].prev->dirty[q].next = pe->dirty[q].next;
+		else
+			queue->head = pe->dirty[q].next;
+		if (pe->dirty[q].next)
+			pe->dirty[q].next->dirty[q].prev = pe->dirty[q].prev;
+		else
+			queue->tail = pe->dirty[q].prev;
+
+		pe->dirty[q].prev = pe->dirty[q].next = NULL;
+		pe->req_action &= ~(1 << q);
+		queue->count--;
+	}
+}
+
 /*
  * Adding topology node to topology table
  */
@@ -149,12 +356,12 @@ void eigrp_prefix_descriptor_add(struct route_table *topology,
 {
 	struct route_node *rn;
 
-	rn = route_node_get(topology, pe->destination);
+	rn = route_node_get(topology, eigrp_topology_prefix_dest(pe));
 	if (rn->info) {
 		if (IS_DEBUG_EIGRP_EVENT) {
 			zlog_debug("%s: %s Should we have found this prefix in the topo table?",
 				   __func__,
-				   eigrp_print_prefix(pe->destination));
+				   eigrp_print_prefix(eigrp_topology_prefix_dest(pe)));
 		}
 		route_unlock_node(rn);
 	}
@@ -165,12 +372,13 @@ void eigrp_prefix_descriptor_add(struct route_table *topology,
 /*
  * Find topology node in topology table
  */
-eigrp_route_descriptor_t *eigrp_prefix_descriptor_lookup(struct list *entries,
+eigrp_route_descriptor_t *eigrp_prefix_descriptor_lookup(eigrp_route_vec_t *routes,
 							 eigrp_neighbor_t *nbr)
 {
 	eigrp_route_descriptor_t *data;
-	struct listnode *node, *nnode;
-	for (ALL_LIST_ELEMENTS(entries, node, nnode, data)) {
+	int i;
+
+	EIGRP_ROUTE_VEC_FOREACH (routes, i, data) {
 		if (data->adv_router == nbr) {
 			return data;
 		}
@@ -187,33 +395,44 @@ void eigrp_prefix_descriptor_delete(eigrp_instance_t *eigrp,
 				    eigrp_prefix_descriptor_t *pe)
 {
 	eigrp_route_descriptor_t *ne;
-	struct listnode *node, *nnode;
 	struct route_node *rn;
+	int i;
 
 	if (!eigrp)
 		return;
 
-	rn = route_node_lookup(table, pe->destination);
+	rn = route_node_lookup(table, eigrp_topology_prefix_dest(pe));
 	if (!rn)
 		return;
 
 	/*
-	 * Emergency removal of the node from this list.
+	 * Emergency removal of the node from the dirty queues.
 	 * Whatever it is.
 	 */
-	listnode_delete(eigrp->topology_changes, pe);
-
-	for (ALL_LIST_ELEMENTS(pe->entries, node, nnode, ne))
+	eigrp_topology_dirty_remove(eigrp, pe,
+				    EIGRP_FSM_NEED_UPDATE | EIGRP_FSM_NEED_QUERY);
+	eigrp_active_stop(eigrp, pe);
+	eigrp_dual_queue_prefix_purge(eigrp, pe);
+	if (eigrp->fsm_trace && eigrp->fsm_trace->running == pe)
+		eigrp->fsm_trace->running = NULL;
+	eigrp_packetizer_prefix_purge(pe);
+	eigrp_tlv_cache_free(pe);
+	eigrp_filter_cache_free(pe);
+
+	EIGRP_ROUTE_VEC_FOREACH_REVERSE (&pe->routes, i, ne)
 		eigrp_route_descriptor_delete(eigrp, pe, ne);
-	list_delete(&pe->entries);
-	list_delete(&pe->rij);
-	eigrp_zebra_route_delete(eigrp, pe->destination);
-	prefix_free(&pe->destination);
+	eigrp_route_vec_fini(&pe->routes);
+	eigrp_route_vec_fini(&pe->feasible);
+	eigrp_topology_rij_clear(eigrp, pe);
+	eigrp_rib_queue_prefix_delete(eigrp, pe);
+	if (pe->nt != EIGRP_TOPOLOGY_TYPE_SUMMARY)
+		eigrp_summary_changed(eigrp, eigrp_topology_prefix_dest(pe));
 
 	rn->info = NULL;
 	route_unlock_node(rn); // Lookup above
 	route_unlock_node(rn); // Initial creation
-	XFREE(MTYPE_EIGRP_PREFIX_DESCRIPTOR, pe);
+	eigrp_slab_obj_free(pe);
+	eigrp_topology_changed(eigrp);
 }
 
 /*
@@ -223,10 +442,13 @@ void eigrp_route_descriptor_delete(eigrp_instance_t *eigrp,
 				   eigrp_prefix_descriptor_t *node,
 				   eigrp_route_descriptor_t *route)
 {
-	if (listnode_lookup(node->entries, route) != NULL) {
-		listnode_delete(node->entries, route);
-		eigrp_zebra_route_delete(eigrp, node->destination);
-		XFREE(MTYPE_EIGRP_ROUTE_DESCRIPTOR, route);
+	if (eigrp_route_vec_remove(&node->routes, route)) {
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_FEASIBLE_FLAGS)
+			eigrp_topology_successor_update(node);
+		if (route->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
+			eigrp_rib_queue_enqueue(eigrp, node);
+		eigrp_topology_route_free(route);
+		eigrp_topology_changed(eigrp);
 	}
 }
 
@@ -287,60 +509,10 @@ eigrp_topology_table_lookup_ipv4(struct route_table *table,
 	return pe;
 }
 
-/*
- * For a future optimization, put the successor list into it's
- * own separate list from the full list?
- *
- * That way we can clean up all the list_new and list_delete's
- * that we are doing.  DBS
- */
-struct list *eigrp_topology_get_successor(eigrp_prefix_descriptor_t *table_node)
-{
-	struct list *successors = list_new();
-	eigrp_route_descriptor_t *data;
-	struct listnode *node1, *node2;
-
-	for (ALL_LIST_ELEMENTS(table_node->entries, node1, node2, data)) {
-		if (data->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG) {
-			listnode_add(successors, data);
-		}
-	}
-
-	/*
-	 * If we have no successors return NULL
-	 */
-	if (!successors->count) {
-		list_delete(&successors);
-		successors = NULL;
-	}
-
-	return successors;
-}
-
-struct list *
-eigrp_topology_get_successor_max(eigrp_prefix_descriptor_t *table_node,
-				 unsigned int maxpaths)
-{
-	struct list *successors = eigrp_topology_get_successor(table_node);
-
-	if (successors && successors->count > maxpaths) {
-		do {
-			struct listnode *node = listtail(successors);
-
-			list_delete_node(successors, node);
-
-		} while (successors->count > maxpaths);
-	}
-
-	return successors;
-}
-
 /* Lookup all prefixes from specified neighbor */
 struct list *eigrp_neighbor_prefixes_lookup(eigrp_instance_t *eigrp,
 					    eigrp_neighbor_t *nbr)
 {
-	struct listnode *node2, *node22;
-	eigrp_route_descriptor_t *route;
 	eigrp_prefix_descriptor_t *pe;
 	struct route_node *rn;
 
@@ -352,13 +524,9 @@ struct list *eigrp_neighbor_prefixes_lookup(eigrp_instance_t *eigrp,
 		if (!rn->info)
 			continue;
 		pe = rn->info;
-		/* iterate over all neighbor route in prefix */
-		for (ALL_LIST_ELEMENTS(pe->entries, node2, node22, route)) {
-			/* if route is from specified neighbor, add to list */
-			if (route->adv_router == nbr) {
-				listnode_add(prefixes, pe);
-			}
-		}
+		/* if prefix has a route from specified neighbor, add to list */
+		if (eigrp_prefix_descriptor_lookup(&pe->routes, nbr))
+			listnode_add(prefixes, pe);
 	}
 
 	/* return list of prefixes from specified neighbor */
@@ -375,13 +543,17 @@ eigrp_topology_update_distance(eigrp_fsm_action_message_t *msg)
 	uint32_t new_reported_distance;
 
 	assert(route);
+	eigrp_topology_changed(eigrp);
 
 	if (!route->adv_router)
 		route->adv_router = msg->adv_router;
 	if (!route->prefix)
 		route->prefix = prefix;
-	if (!route->ei && msg->adv_router)
+	if (!route->ei && msg->adv_router) {
 		route->ei = msg->adv_router->ei;
+		if (eigrp_route_vec_find(&prefix->routes, route) >= 0)
+			eigrp_topology_intf_link(route);
+	}
 
 	switch (msg->data_type) {
 	case EIGRP_CONNECTED:
@@ -428,6 +600,9 @@ eigrp_topology_update_distance(eigrp_fsm_action_message_t *msg)
 		route->reported_distance = new_reported_distance;
 		route->distance = eigrp_calculate_total_metrics(eigrp, route);
 		break;
+	case EIGRP_RECOMPUTE:
+		change = msg->change;
+		break;
 	default:
 		flog_err(EC_LIB_DEVELOPMENT, "%s: Please implement handler",
 			 __func__);
@@ -437,8 +612,9 @@ eigrp_topology_update_distance(eigrp_fsm_action_message_t *msg)
 	/*
 	 * Move to correct position in list according to new distance
 	 */
-	listnode_delete(prefix->entries, route);
-	listnode_add_sort(prefix->entries, route);
+	eigrp_route_vec_resort(&prefix->routes, route);
+	if (route->flags & EIGRP_ROUTE_DESCRIPTOR_FEASIBLE_FLAGS)
+		eigrp_topology_successor_update(prefix);
 
 	return change;
 }
@@ -464,10 +640,10 @@ void eigrp_topology_update_all_node_flags(eigrp_instance_t *eigrp)
 void eigrp_topology_update_node_flags(eigrp_instance_t *eigrp,
 				      eigrp_prefix_descriptor_t *dest)
 {
-	struct listnode *node;
 	eigrp_route_descriptor_t *route;
+	int i;
 
-	for (ALL_LIST_ELEMENTS_RO(dest->entries, node, route)) {
+	EIGRP_ROUTE_VEC_FOREACH (&dest->routes, i, route) {
 		if (route->reported_distance < dest->fdistance) {
 			// is feasible successor, can be successor
 			if (((uint64_t)route->distance
@@ -491,79 +667,376 @@ void eigrp_topology_update_node_flags(eigrp_instance_t *eigrp,
 			route->flags &= ~EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG;
 		}
 	}
+
+	eigrp_topology_successor_update(dest);
+	eigrp_topology_changed(eigrp);
 }
 
 void eigrp_update_routing_table(eigrp_instance_t *eigrp,
 				eigrp_prefix_descriptor_t *prefix)
 {
-	struct list *successors;
-	struct listnode *node;
 	eigrp_route_descriptor_t *route;
+	unsigned int paths;
+	int i;
 
-	successors = eigrp_topology_get_successor_max(prefix, eigrp->max_paths);
+	eigrp_topology_changed(eigrp);
+	paths = prefix->nsuccessor;
+	if (paths > eigrp->max_paths)
+		paths = eigrp->max_paths;
 
-	if (successors) {
-		eigrp_zebra_route_add(eigrp, prefix->destination, successors,
-				      prefix->fdistance);
-		for (ALL_LIST_ELEMENTS_RO(successors, node, route))
-			route->flags |= EIGRP_ROUTE_DESCRIPTOR_INTABLE_FLAG;
+	/* zebra hears the outcome at the next RIB flush */
+	eigrp_rib_queue_enqueue(eigrp, prefix);
 
-		list_delete(&successors);
+	if (paths) {
+		EIGRP_TOPOLOGY_SUCCESSOR_FOREACH (prefix, i, route) {
+			if ((unsigned int)i >= paths)
+				break;
+			route->flags |= EIGRP_ROUTE_DESCRIPTOR_INTABLE_FLAG;
+		}
 	} else {
-		eigrp_zebra_route_delete(eigrp, prefix->destination);
-		for (ALL_LIST_ELEMENTS_RO(prefix->entries, node, route))
+		EIGRP_ROUTE_VEC_FOREACH (&prefix->routes, i, route)
 			route->flags &= ~EIGRP_ROUTE_DESCRIPTOR_INTABLE_FLAG;
 	}
 }
 
-void eigrp_topology_neighbor_down(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+/*
+ * Bulk distance recompute.  Route metrics are gathered into a
+ * structure-of-arrays batch, composite distances are computed for the whole
+ * batch at once and written back, and only then is each prefix looked at.
+ * A prefix goes back to DUAL only if its successor set, a feasibility
+ * verdict or its successor distance changed; otherwise its routes are just
+ * put back in order.
+ */
+struct eigrp_recompute {
+	eigrp_instance_t *eigrp;
+	eigrp_interface_t *ei; // only routes over ei, NULL for all
+	bool rebase;	       // K-values changed, RD and FD move too
+
+	eigrp_metric_batch_t batch;
+	eigrp_route_descriptor_t *lane[EIGRP_METRIC_BATCH_SIZE];
+	bool lane_rd[EIGRP_METRIC_BATCH_SIZE]; // lane is the route's RD
+
+	eigrp_prefix_descriptor_t *pending[EIGRP_METRIC_BATCH_SIZE];
+	uint32_t npending;
+
+	uint32_t routes;
+	uint32_t prefixes;
+};
+
+static bool eigrp_topology_recompute_changed(eigrp_instance_t *eigrp,
+					     eigrp_prefix_descriptor_t *pe,
+					     eigrp_route_descriptor_t *successor)
 {
-	eigrp_prefix_descriptor_t *pe;
+	eigrp_route_descriptor_t *head = eigrp_route_vec_head(&pe->routes);
 	eigrp_route_descriptor_t *route;
-	struct listnode *node2, *node22;
-	struct route_node *rn;
+	uint8_t flags;
+	int i;
+
+	if (!head)
+		return false;
+	if (successor != head || successor->distance != pe->distance)
+		return true;
+
+	/* the verdicts eigrp_topology_update_node_flags() would reach */
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route) {
+		flags = 0;
+		if (route->reported_distance < pe->fdistance) {
+			if ((uint64_t)route->distance
+				    <= (uint64_t)head->distance * eigrp->variance
+			    && route->distance != EIGRP_MAX_METRIC)
+				flags = EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG;
+			else
+				flags = EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG;
+		}
 
-	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
-		pe = rn->info;
+		if (flags != (route->flags & EIGRP_ROUTE_DESCRIPTOR_FEASIBLE_FLAGS))
+			return true;
+	}
 
-		if (!pe)
+	return false;
+}
+
+static void eigrp_topology_recompute_prefix(struct eigrp_recompute *rc,
+					    eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_route_descriptor_t *successor = eigrp_topology_successor_head(pe);
+	eigrp_fsm_action_message_t msg;
+
+	eigrp_route_vec_sort(&pe->routes);
+
+	/* FD is in the old K-value units; restart it from the successor */
+	if (rc->rebase && successor && pe->state == EIGRP_FSM_STATE_PASSIVE)
+		pe->fdistance = pe->rdistance = pe->distance =
+			successor->distance;
+
+	if (!eigrp_topology_recompute_changed(rc->eigrp, pe, successor)) {
+		eigrp_topology_successor_update(pe);
+		return;
+	}
+
+	msg.packet_type = EIGRP_OPC_UPDATE;
+	msg.eigrp = rc->eigrp;
+	msg.data_type = EIGRP_RECOMPUTE;
+	msg.prefix = pe;
+	msg.route = successor ? successor : eigrp_route_vec_head(&pe->routes);
+	msg.adv_router = msg.route->adv_router;
+	msg.metrics = msg.route->reported_metric;
+	msg.change = (successor && successor->distance > pe->distance)
+			     ? METRIC_INCREASE
+			     : METRIC_DECREASE;
+	eigrp_fsm_event(&msg);
+	rc->prefixes++;
+}
+
+static void eigrp_topology_recompute_flush(struct eigrp_recompute *rc)
+{
+	eigrp_metric_batch_t *batch = &rc->batch;
+	uint32_t i;
+
+	eigrp_calculate_metrics_batch(rc->eigrp, batch);
+	for (i = 0; i < batch->count; i++) {
+		if (rc->lane_rd[i])
+			rc->lane[i]->reported_distance = batch->composite[i];
+		else
+			rc->lane[i]->distance = batch->composite[i];
+	}
+	batch->count = 0;
+
+	for (i = 0; i < rc->npending; i++)
+		eigrp_topology_recompute_prefix(rc, rc->pending[i]);
+	rc->npending = 0;
+}
+
+static void eigrp_topology_recompute_lane(struct eigrp_recompute *rc,
+					  eigrp_route_descriptor_t *route,
+					  eigrp_metrics_t *metric, bool rd)
+{
+	eigrp_metric_batch_t *batch = &rc->batch;
+	uint32_t i;
+
+	if (batch->count == EIGRP_METRIC_BATCH_SIZE)
+		eigrp_topology_recompute_flush(rc);
+
+	i = batch->count++;
+	batch->delay[i] = metric->delay;
+	batch->bandwidth[i] = metric->bandwidth;
+	batch->load[i] = metric->load;
+	batch->reliability[i] = metric->reliability;
+	rc->lane[i] = route;
+	rc->lane_rd[i] = rd;
+}
+
+static void eigrp_topology_recompute_gather(struct eigrp_recompute *rc,
+					    eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_route_descriptor_t *route;
+	bool gathered = false;
+	int i;
+
+	EIGRP_ROUTE_VEC_FOREACH (&pe->routes, i, route) {
+		if (rc->ei && route->ei != rc->ei)
 			continue;
 
-		for (ALL_LIST_ELEMENTS(pe->entries, node2, node22, route)) {
-			eigrp_fsm_action_message_t msg;
+		if (route->adv_router == rc->eigrp->neighbor_self) {
+			/* connected: the interface metric is the route metric */
+			if (route->ei) {
+				eigrp_intf_metrics_get(route->ei,
+						       &route->reported_metric);
+				route->total_metric = route->reported_metric;
+			}
+		} else {
+			if (route->ei)
+				eigrp_total_metrics_update(route);
+			if (rc->rebase)
+				eigrp_topology_recompute_lane(
+					rc, route, &route->reported_metric,
+					true);
+		}
+
+		eigrp_topology_recompute_lane(rc, route, &route->total_metric,
+					      false);
+		rc->routes++;
+		gathered = true;
+	}
+
+	if (!gathered)
+		return;
+
+	if (rc->npending == EIGRP_METRIC_BATCH_SIZE)
+		eigrp_topology_recompute_flush(rc);
+	rc->pending[rc->npending++] = pe;
+}
+
+static int eigrp_topology_prefix_ptr_cmp(const void *a, const void *b)
+{
+	uintptr_t pa = (uintptr_t)*(eigrp_prefix_descriptor_t *const *)a;
+	uintptr_t pb = (uintptr_t)*(eigrp_prefix_descriptor_t *const *)b;
+
+	return (pa > pb) - (pa < pb);
+}
+
+/*
+ * The distinct prefixes with a route on ei's index, only those advertised
+ * by nbr if it is given.  They are collected up front because DUAL frees
+ * routes, and so index links, while the prefixes are being processed; DUAL
+ * on one prefix never frees another.  Returns NULL when there are none.
+ */
+static eigrp_prefix_descriptor_t **
+eigrp_topology_intf_prefixes(eigrp_interface_t *ei, eigrp_neighbor_t *nbr,
+			     uint32_t *count)
+{
+	eigrp_prefix_descriptor_t **set;
+	eigrp_route_descriptor_t *route;
+	uint32_t n = 0, i, j;
+
+	*count = 0;
+	if (!ei->route_count)
+		return NULL;
+
+	set = XCALLOC(MTYPE_EIGRP_PREFIX_SET, ei->route_count * sizeof(*set));
+	EIGRP_TOPOLOGY_INTF_FOREACH (ei, route)
+		if (!nbr || route->adv_router == nbr)
+			set[n++] = route->prefix;
+
+	/* a neighbor has one route per prefix, an interface may have several */
+	if (!nbr && n > 1) {
+		qsort(set, n, sizeof(*set), eigrp_topology_prefix_ptr_cmp);
+		for (i = 1, j = 1; i < n; i++)
+			if (set[i] != set[j - 1])
+				set[j++] = set[i];
+		n = j;
+	}
+
+	*count = n;
+	return set;
+}
+
+/*
+ * Recompute route distances after the K-values (ei == NULL) or the delay or
+ * bandwidth of one interface changed.  An interface change only visits the
+ * prefixes on that interface's route index.
+ */
+void eigrp_topology_recompute(eigrp_instance_t *eigrp, eigrp_interface_t *ei)
+{
+	struct eigrp_recompute *rc;
+	eigrp_prefix_descriptor_t **set;
+	eigrp_prefix_descriptor_t *pe;
+	struct route_node *rn;
+	struct timeval start, now;
+	uint32_t i, count;
 
-			if (route->adv_router != nbr)
-				continue;
+	if (!eigrp || !eigrp->topology_table)
+		return;
 
-			msg.metrics.delay = EIGRP_MAX_METRIC;
-			msg.packet_type = EIGRP_OPC_UPDATE;
-			msg.eigrp = eigrp;
-			msg.data_type = EIGRP_INT;
-			msg.adv_router = nbr;
-			msg.route = route;
-			msg.prefix = pe;
-			eigrp_fsm_event(&msg);
+	monotime(&start);
+	rc = XCALLOC(MTYPE_EIGRP_RECOMPUTE, sizeof(*rc));
+	rc->eigrp = eigrp;
+	rc->ei = ei;
+	rc->rebase = (ei == NULL);
+
+	if (ei) {
+		set = eigrp_topology_intf_prefixes(ei, NULL, &count);
+		for (i = 0; i < count; i++)
+			eigrp_topology_recompute_gather(rc, set[i]);
+		eigrp_topology_recompute_flush(rc);
+		if (set)
+			XFREE(MTYPE_EIGRP_PREFIX_SET, set);
+
+		ei->recompute_runs++;
+		ei->recompute_routes += rc->routes;
+		ei->recompute_last = rc->routes;
+	} else {
+		/* summaries follow their components, not DUAL */
+		for (rn = route_top(eigrp->topology_table); rn;
+		     rn = route_next(rn)) {
+			pe = rn->info;
+			if (pe && pe->nt != EIGRP_TOPOLOGY_TYPE_SUMMARY)
+				eigrp_topology_recompute_gather(rc, pe);
 		}
+		eigrp_topology_recompute_flush(rc);
+		eigrp_summary_invalidate(eigrp);
+		rc->prefixes += eigrp_summary_refresh(eigrp);
 	}
 
-	eigrp_query_send_all(eigrp);
-	eigrp_update_send_all(eigrp, nbr->ei);
+	if (rc->routes)
+		eigrp_topology_changed(eigrp);
+
+	monotime(&now);
+	eigrp->recompute.runs++;
+	eigrp->recompute.routes += rc->routes;
+	eigrp->recompute.prefixes += rc->prefixes;
+	eigrp->recompute.last_routes = rc->routes;
+	eigrp->recompute.last_prefixes = rc->prefixes;
+	eigrp->recompute.last_usec = (now.tv_sec - start.tv_sec) * 1000000
+				     + (now.tv_usec - start.tv_usec);
+	XFREE(MTYPE_EIGRP_RECOMPUTE, rc);
+
+	if (eigrp->recompute.last_prefixes)
+		eigrp_packetizer_flush(eigrp, NULL);
+}
+
+/*
+ * The neighbor is down.  Its routes are withdrawn through the DUAL queue,
+ * one event per prefix; eigrp_nbr_delete() keeps it until they have run.
+ */
+void eigrp_topology_neighbor_down(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr)
+{
+	eigrp_prefix_descriptor_t **set;
+	uint32_t i, count;
+
+	/* input from it still waiting is moot */
+	eigrp_dual_queue_neighbor_down(eigrp, nbr);
+
+	/* the neighbor's routes are all on its interface's index */
+	set = eigrp_topology_intf_prefixes(nbr->ei, nbr, &count);
+	for (i = 0; i < count; i++)
+		eigrp_dual_queue_enqueue(eigrp, nbr, set[i], NULL,
+					 EIGRP_OPC_UPDATE);
+	if (set)
+		XFREE(MTYPE_EIGRP_PREFIX_SET, set);
+
+	/* ACTIVE prefixes still waiting on its reply */
+	eigrp_active_neighbor_down(eigrp, nbr);
+}
+
+/* Withdraw the route nbr had for pe, if it still has one. */
+void eigrp_topology_neighbor_withdraw(eigrp_instance_t *eigrp,
+				      eigrp_neighbor_t *nbr,
+				      eigrp_prefix_descriptor_t *pe)
+{
+	eigrp_fsm_action_message_t msg = {};
+	eigrp_route_descriptor_t *route;
+
+	/* a neighbor contributes at most one route per prefix */
+	route = eigrp_prefix_descriptor_lookup(&pe->routes, nbr);
+	if (!route)
+		return;
+
+	msg.metrics.delay = EIGRP_MAX_METRIC;
+	msg.packet_type = EIGRP_OPC_UPDATE;
+	msg.eigrp = eigrp;
+	msg.data_type = EIGRP_INT;
+	msg.adv_router = nbr;
+	msg.route = route;
+	msg.prefix = pe;
+	eigrp_fsm_event(&msg);
 }
 
 void eigrp_update_topology_table_prefix(eigrp_instance_t *eigrp,
 					struct route_table *table,
 					eigrp_prefix_descriptor_t *prefix)
 {
-	struct listnode *node1, *node2;
-
 	eigrp_route_descriptor_t *route;
-	for (ALL_LIST_ELEMENTS(prefix->entries, node1, node2, route)) {
+	int i;
+
+	EIGRP_ROUTE_VEC_FOREACH_REVERSE (&prefix->routes, i, route) {
 		if (route->distance == EIGRP_MAX_METRIC) {
 			eigrp_route_descriptor_delete(eigrp, prefix, route);
 		}
 	}
 	if (prefix->distance == EIGRP_MAX_METRIC
-	    && prefix->nt != EIGRP_TOPOLOGY_TYPE_CONNECTED) {
+	    && prefix->nt != EIGRP_TOPOLOGY_TYPE_CONNECTED
+	    && prefix->nt != EIGRP_TOPOLOGY_TYPE_SUMMARY) {
 		eigrp_prefix_descriptor_delete(eigrp, table, prefix);
 	}
 }
@@ -18,8 +18,11 @@
 #ifndef _ZEBRA_EIGRP_TOPOLOGY_H
 #define _ZEBRA_EIGRP_TOPOLOGY_H
 
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_nbr_set.h"
+
 /* EIGRP Route Descriptor related functions. */
-extern eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_interface_t *);
+extern eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_instance_t *, eigrp_interface_t *);
 extern void eigrp_route_descriptor_add(eigrp_instance_t *,
 				       eigrp_prefix_descriptor_t *,
 				       eigrp_route_descriptor_t *);
@@ -32,12 +35,41 @@ void eigrp_topology_route_free(eigrp_route_descriptor_t *);
 extern struct route_table *eigrp_topology_new(void);
 extern void eigrp_topology_init(struct route_table *table);
 
-extern eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(void);
+extern eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(eigrp_instance_t *);
 extern void eigrp_topology_prefix_free(eigrp_prefix_descriptor_t *);
 
+extern void eigrp_topology_rij_add(eigrp_prefix_descriptor_t *pe,
+				   eigrp_neighbor_t *nbr);
+extern void eigrp_topology_rij_remove(eigrp_prefix_descriptor_t *pe,
+				      eigrp_neighbor_t *nbr);
+extern bool eigrp_topology_rij_test(eigrp_prefix_descriptor_t *pe,
+				    eigrp_neighbor_t *nbr);
+extern void eigrp_topology_rij_clear(eigrp_instance_t *eigrp,
+				     eigrp_prefix_descriptor_t *pe);
+extern eigrp_neighbor_t *eigrp_topology_rij_next(eigrp_instance_t *eigrp,
+						 eigrp_prefix_descriptor_t *pe,
+						 uint32_t *slot);
+extern void eigrp_topology_rij_purge(eigrp_instance_t *eigrp,
+				     eigrp_neighbor_t *nbr);
+
+/*
+ * Walk the neighbors a prefix still expects a REPLY from, in slot order.
+ * The body may remove the current neighbor.
+ */
+#define EIGRP_TOPOLOGY_RIJ_FOREACH(eigrp, pe, slot, nbr)                       \
+	for ((slot) = 0;                                                       \
+	     ((nbr) = eigrp_topology_rij_next((eigrp), (pe), &(slot)));         \
+	     (slot)++)
+
 extern void eigrp_topology_free(eigrp_instance_t *eigrp, struct route_table *table);
 extern void eigrp_prefix_descriptor_add(struct route_table *table,
 					eigrp_prefix_descriptor_t *pe);
+extern void eigrp_topology_dirty_insert(eigrp_instance_t *eigrp,
+					eigrp_prefix_descriptor_t *pe,
+					uint8_t action);
+extern void eigrp_topology_dirty_remove(eigrp_instance_t *eigrp,
+					eigrp_prefix_descriptor_t *pe,
+					uint8_t action);
 extern void eigrp_prefix_descriptor_delete(eigrp_instance_t *eigrp,
 					   struct route_table *table,
 					   eigrp_prefix_descriptor_t *pe);
@@ -45,12 +77,8 @@ extern void eigrp_topology_delete_all(eigrp_instance_t *eigrp,
 				      struct route_table *table);
 extern eigrp_prefix_descriptor_t *
 eigrp_topology_table_lookup_ipv4(struct route_table *table, struct prefix *p);
-extern struct list *eigrp_topology_get_successor(eigrp_prefix_descriptor_t *pe);
-extern struct list *
-eigrp_topology_get_successor_max(eigrp_prefix_descriptor_t *pe,
-				 unsigned int maxpaths);
 extern eigrp_route_descriptor_t *eigrp_prefix_descriptor_lookup(
-    struct list *entries, eigrp_neighbor_t *neigh);
+    eigrp_route_vec_t *routes, eigrp_neighbor_t *neigh);
 extern struct list *eigrp_neighbor_prefixes_lookup(eigrp_instance_t *eigrp,
 						   eigrp_neighbor_t *n);
 extern void eigrp_topology_update_all_node_flags(eigrp_instance_t *eigrp);
@@ -59,12 +87,73 @@ extern void eigrp_topology_update_node_flags(eigrp_instance_t *eigrp,
 extern enum metric_change eigrp_topology_update_distance(eigrp_fsm_action_message_t *msg);
 extern void eigrp_update_routing_table(eigrp_instance_t *eigrp,
 				       eigrp_prefix_descriptor_t *pe);
+extern void eigrp_topology_recompute(eigrp_instance_t *eigrp,
+				     eigrp_interface_t *ei);
 extern void eigrp_topology_neighbor_down(eigrp_instance_t *eigrp,
 					 eigrp_neighbor_t *neigh);
+extern void eigrp_topology_neighbor_withdraw(eigrp_instance_t *eigrp,
+					     eigrp_neighbor_t *nbr,
+					     eigrp_prefix_descriptor_t *pe);
 extern void eigrp_update_topology_table_prefix(eigrp_instance_t *eigrp,
 					       struct route_table *table,
 					       eigrp_prefix_descriptor_t *pe);
 
+/*
+ * The IPv4 destination lives inline in the prefix descriptor; hand it out
+ * as the generic struct prefix the table and zebra code expect.
+ */
+static inline struct prefix *
+eigrp_topology_prefix_dest(eigrp_prefix_descriptor_t *pe)
+{
+	return (struct prefix *)&pe->destination;
+}
+
+/* Neighbors we still expect a REPLY from; only non-zero while ACTIVE. */
+static inline unsigned int
+eigrp_topology_rij_count(eigrp_prefix_descriptor_t *pe)
+{
+	return eigrp_nbr_set_count(&pe->rij);
+}
+
+/*
+ * Successor and feasible successor sets of a prefix, best distance first.
+ * They are kept on the prefix and rebuilt whenever route flags or the
+ * routes of the prefix change.  The walks are read-only: the body must not
+ * add or remove routes of the prefix.
+ */
+#define EIGRP_TOPOLOGY_SUCCESSOR_FOREACH(pe, i, route)                         \
+	for ((i) = 0; (i) < (pe)->nsuccessor                                   \
+		      && ((route) = eigrp_route_vec_data(&(pe)->feasible)[(i)], \
+			  1);                                                  \
+	     (i)++)
+
+#define EIGRP_TOPOLOGY_FSUCCESSOR_FOREACH(pe, i, route)                        \
+	for ((i) = (pe)->nsuccessor;                                           \
+	     (i) < (pe)->feasible.count                                        \
+	     && ((route) = eigrp_route_vec_data(&(pe)->feasible)[(i)], 1);     \
+	     (i)++)
+
+static inline eigrp_route_descriptor_t *
+eigrp_topology_successor_head(eigrp_prefix_descriptor_t *pe)
+{
+	return pe->nsuccessor ? eigrp_route_vec_data(&pe->feasible)[0] : NULL;
+}
+
+/*
+ * Walk the topology routes learned over an interface.  The body must not
+ * free routes.
+ */
+#define EIGRP_TOPOLOGY_INTF_FOREACH(ei, route)                                 \
+	for ((route) = (ei)->routes; (route); (route) = (route)->intf.next)
+
+/*
+ * Walk a dirty prefix queue (EIGRP_DIRTY_UPDATE or EIGRP_DIRTY_QUERY) in
+ * FIFO order.  The body may remove the current prefix from the queue.
+ */
+#define EIGRP_TOPOLOGY_DIRTY_FOREACH(eigrp, q, pe, next)                       \
+	for ((pe) = (eigrp)->dirty[(q)].head;                                  \
+	     (pe) && ((next) = (pe)->dirty[(q)].next, 1); (pe) = (next))
+
 /* Static inline functions */
 /* IPv4/IPv6 prefix and address management functions
  * might move to eigrp_addr.h if this grows
@@ -37,8 +37,24 @@ typedef struct eigrp_neighbor eigrp_neighbor_t;
 typedef struct eigrp_metrics eigrp_metrics_t;
 typedef struct eigrp_prefix_descriptor eigrp_prefix_descriptor_t;
 typedef struct eigrp_route_descriptor eigrp_route_descriptor_t;
+typedef struct eigrp_route_vec eigrp_route_vec_t;
+typedef struct eigrp_nbr_set eigrp_nbr_set_t;
+typedef struct eigrp_slab eigrp_slab_t;
+typedef struct eigrp_metric_batch eigrp_metric_batch_t;
+typedef struct eigrp_snapshot eigrp_snapshot_t;
+typedef struct eigrp_snapshot_prefix eigrp_snapshot_prefix_t;
+typedef struct eigrp_snapshot_route eigrp_snapshot_route_t;
+typedef struct eigrp_fsm_trace eigrp_fsm_trace_t;
+typedef struct eigrp_fsm_trace_entry eigrp_fsm_trace_entry_t;
+typedef struct eigrp_active eigrp_active_t;
+typedef struct eigrp_summary eigrp_summary_t;
+typedef struct eigrp_dual_event eigrp_dual_event_t;
 typedef struct eigrp_fsm_action_message eigrp_fsm_action_message_t;
 typedef struct eigrp_work_queue eigrp_work_queue_t;
+typedef struct eigrp_packetizer_work eigrp_packetizer_work_t;
+typedef struct eigrp_tlv_cache eigrp_tlv_cache_t;
+typedef struct eigrp_filter_cache eigrp_filter_cache_t;
+typedef struct eigrp_rib_entry eigrp_rib_entry_t;
 
 // basic packet processor definitions
 typedef struct eigrp_packet eigrp_packet_t;
@@ -52,9 +68,14 @@ typedef uint16_t (*eigrp_packet_encoder_t)(
 	eigrp_instance_t *eigrp, eigrp_interface_t *ei, eigrp_neighbor_t *nbr,
 	eigrp_stream_t *pkt, eigrp_route_descriptor_t *route);
 
+/* bytes the matching encoder will write for route, 0 if it writes none */
+typedef uint16_t (*eigrp_packet_sizer_t)(eigrp_instance_t *eigrp,
+					 eigrp_route_descriptor_t *route);
+
 typedef struct eigrp_tlv_codec {
 	eigrp_packet_encoder_t encoder;
 	eigrp_packet_decoder_t decoder;
+	eigrp_packet_sizer_t sizer;
 } eigrp_tlv_codec_t;
 
 #endif /* _ZEBRA_EIGRP_TYPES_H_ */
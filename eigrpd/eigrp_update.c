@@ -16,6 +16,7 @@
 #include "eigrpd/eigrpd.h"
 #include "eigrpd/eigrp_structs.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
 #include "eigrpd/eigrp_interface.h"
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_packet.h"
@@ -27,6 +28,10 @@
 #include "eigrpd/eigrp_dump.h"
 #include "eigrpd/eigrp_network.h"
 #include "eigrpd/eigrp_metric.h"
+#include "eigrpd/eigrp_stub.h"
+#include "eigrpd/eigrp_summary.h"
+#include "eigrpd/eigrp_dual_queue.h"
+#include "eigrpd/eigrp_filter_cache.h"
 
 #include "routemap.h"
 
@@ -109,14 +114,14 @@ static void eigrp_update_receive_GR_ask(eigrp_instance_t *eigrp,
 	/* iterate over all prefixes which weren't advertised by neighbor */
 	for (ALL_LIST_ELEMENTS_RO(nbr_prefixes, node1, prefix)) {
 		zlog_debug("GR receive: Neighbor not advertised %s",
-			   eigrp_print_prefix(prefix->destination));
+			   eigrp_print_prefix(eigrp_topology_prefix_dest(prefix)));
 
 		fsm_msg.metrics = prefix->reported_metric;
 		/* set delay to MAX */
 		fsm_msg.metrics.delay = EIGRP_MAX_METRIC;
 
 		eigrp_route_descriptor_t *route =
-			eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
+			eigrp_prefix_descriptor_lookup(&prefix->routes, nbr);
 
 		fsm_msg.packet_type = EIGRP_OPC_UPDATE;
 		fsm_msg.eigrp = eigrp;
@@ -220,10 +225,12 @@ void eigrp_update_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 	} else if ((flags & EIGRP_INIT_FLAG) && (!same)) {
 		/*
 		 * When in pending state, send INIT update only if it wasn't
-		 * already sent before (only if init_sequence is 0)
+		 * already sent before (only if init_sequence is 0).  A neighbor
+		 * still waiting for a bring-up slot gets its INIT when admitted.
 		 */
 		if ((nbr->state == EIGRP_NEIGHBOR_PENDING)
-		    && (nbr->init_sequence_number == 0))
+		    && (nbr->init_sequence_number == 0)
+		    && (nbr->bringup != EIGRP_BRINGUP_QUEUED))
 			eigrp_update_send_init(eigrp, nbr);
 
 		if (nbr->state == EIGRP_NEIGHBOR_UP) {
@@ -239,17 +246,24 @@ void eigrp_update_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 				  eigrp_print_addr(&nbr->src),
 				  ifindex2ifname(nbr->ei->ifp->ifindex,
 						 VRF_DEFAULT));
-			eigrp_update_send_init(eigrp, nbr);
+			eigrp_nbr_bringup_start(nbr);
 		}
 	}
 
-	/*If there is topology information*/
+	/* every route TLV in the packet, up to the end */
 	while (pkt->endp > pkt->getp) {
 		route = (nbr->decoder)(eigrp, nbr, pkt, length);
 
 		// should have got route off the packet, but one never knows
 		if (route) {
 			prefix = eigrp_topology_table_lookup_ipv4(eigrp->topology_table, &route->dest);
+			/* our own summary is not a destination to learn */
+			if (prefix && prefix->nt == EIGRP_TOPOLOGY_TYPE_SUMMARY) {
+				if (graceful_restart)
+					remove_received_prefix_gr(nbr_prefixes, prefix);
+				eigrp_topology_route_free(route);
+				continue;
+			}
 			/*if exists it comes to DUAL*/
 			if (prefix != NULL) {
 				/* remove received prefix from neighbor prefix
@@ -257,43 +271,14 @@ void eigrp_update_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 				if (graceful_restart)
 					remove_received_prefix_gr(nbr_prefixes, prefix);
 
-				struct eigrp_fsm_action_message msg;
-				eigrp_route_descriptor_t *received_route = route;
-				eigrp_route_descriptor_t *topology_route =
-					eigrp_prefix_descriptor_lookup(prefix->entries, nbr);
-				bool free_received_route = false;
-
-				if (topology_route) {
-					topology_route->type = received_route->type;
-					topology_route->nexthop = received_route->nexthop;
-					topology_route->extdata = received_route->extdata;
-					route = topology_route;
-					free_received_route = true;
-				} else {
-					received_route->adv_router = nbr;
-					received_route->prefix = prefix;
-				}
-
-				msg.packet_type = EIGRP_OPC_UPDATE;
-				msg.eigrp = eigrp;
-				msg.data_type = (received_route->type == EIGRP_TLV_IPv4_EXT)
-							? EIGRP_EXT
-							: EIGRP_INT;
-				msg.adv_router = nbr;
-				msg.metrics = received_route->metric;
-				msg.route = route;
-				msg.prefix = prefix;
-				eigrp_fsm_event(&msg);
-
-				if (free_received_route)
-					eigrp_topology_route_free(received_route);
-
+				eigrp_dual_queue_enqueue(eigrp, nbr, prefix, route,
+							 EIGRP_OPC_UPDATE);
 			} else {
 				/*Here comes topology information save*/
-				prefix = eigrp_topology_prefix_create();
+				prefix = eigrp_topology_prefix_create(eigrp);
 				prefix->serno = eigrp->serno;
-				prefix->destination = (struct prefix *)prefix_ipv4_new();
-				prefix_copy(prefix->destination, &route->dest);
+				prefix_copy(eigrp_topology_prefix_dest(prefix),
+					    &route->dest);
 				prefix->state = EIGRP_FSM_STATE_PASSIVE;
 				prefix->nt = (route->type == EIGRP_TLV_IPv4_EXT)
 						     ? EIGRP_TOPOLOGY_TYPE_REMOTE_EXTERNAL
@@ -330,10 +315,8 @@ void eigrp_update_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 				prefix->reported_metric = route->total_metric;
 				eigrp_topology_update_node_flags(eigrp, prefix);
 
-				prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
-				listnode_add(eigrp->topology_changes, prefix);
+				eigrp_topology_dirty_insert(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 			}
-			break;
 		}
 	}
 
@@ -351,8 +334,7 @@ void eigrp_update_receive(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 		eigrp_hello_send_ack(nbr);
 	}
 
-	eigrp_query_send_all(eigrp);
-	eigrp_update_send_all(eigrp, ei);
+	eigrp_packetizer_flush(eigrp, ei);
 
 	if (nbr_prefixes)
 		list_delete(&nbr_prefixes);
@@ -470,19 +452,41 @@ static void eigrp_update_send_to_all_nbrs(eigrp_instance_t *eigrp,
 		eigrp_packet_free(packet);
 }
 
+/*
+ * A full-table UPDATE is where encoding costs the most: every prefix, once
+ * per new neighbor.  Keep what it took, see eigrp_tlv_cache.c.
+ */
+static void eigrp_update_dump_stat(eigrp_instance_t *eigrp, uint32_t tlvs,
+				   uint32_t usec)
+{
+	eigrp_tlv_cache_stats_t *stats = &eigrp->tlv_cache_stats;
+
+	stats->dumps++;
+	stats->dump_tlvs += tlvs;
+	stats->dump_usec += usec;
+	stats->last_dump_tlvs = tlvs;
+	stats->last_dump_usec = usec;
+	if (usec > stats->max_dump_usec)
+		stats->max_dump_usec = usec;
+}
+
 void eigrp_update_send_EOT(eigrp_neighbor_t *nbr)
 {	eigrp_packet_t *packet;
 	uint16_t length = EIGRP_HEADER_LEN;
 	eigrp_route_descriptor_t *route;
 	eigrp_prefix_descriptor_t *prefix;
-	struct listnode *node2, *nnode2;
+	int i;
 	eigrp_interface_t *ei = nbr->ei;
 	eigrp_instance_t *eigrp = ei->eigrp;
-	struct prefix *dest_addr;
 	uint32_t seq_no = eigrp->sequence_number;
 	uint16_t eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
 	struct route_node *rn;
+	struct timeval start, now;
+	uint16_t tlv_length;
+	uint32_t packet_tlvs = 0;
+	uint32_t tlvs = 0;
 
+	monotime(&start);
 	packet = eigrp_packet_new(eigrp_mtu, nbr);
 
 	/* Prepare EIGRP EOT UPDATE header */
@@ -500,13 +504,31 @@ void eigrp_update_send_EOT(eigrp_neighbor_t *nbr)
 			continue;
 
 		prefix = rn->info;
-		for (ALL_LIST_ELEMENTS(prefix->entries, node2, nnode2, route)) {
+		if (eigrp_summary_suppress(ei, prefix))
+			continue;
+
+		EIGRP_ROUTE_VEC_FOREACH (&prefix->routes, i, route) {
 			if (eigrp_nbr_split_horizon_check(route, ei))
 				continue;
 
-			if ((length + EIGRP_TLV_MAX_IPV4_BYTE) > eigrp_mtu) {
+			if (!eigrp_stub_advertise(eigrp, route))
+				continue;
+
+			/* Check if any list fits */
+			if (eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT, prefix))
+				continue;
+
+			tlv_length = nbr->sizer(eigrp, route);
+			if (!tlv_length)
+				continue;
+
+			if (packet_tlvs && length + tlv_length > eigrp_mtu) {
+				eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE,
+							     packet_tlvs, length,
+							     eigrp_mtu);
 				eigrp_update_place_on_nbr_queue(eigrp, nbr, packet, seq_no, length);
 				seq_no++;
+				packet_tlvs = 0;
 
 				length = EIGRP_HEADER_LEN;
 				packet = eigrp_packet_new(eigrp_mtu, nbr);
@@ -520,20 +542,26 @@ void eigrp_update_send_EOT(eigrp_neighbor_t *nbr)
 					length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
 				}
 			}
-			/* Get destination address from prefix */
-			dest_addr = prefix->destination;
 
-			/* Check if any list fits */
-			if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT, dest_addr))
+			tlv_length = (nbr->encoder)(eigrp, ei, nbr, packet->s,
+						    route);
+			if (!tlv_length)
 				continue;
-			else {
-				length += (nbr->encoder)(eigrp, ei, nbr, packet->s, route);
-			}
+			length += tlv_length;
+			packet_tlvs++;
+			tlvs++;
 		}
 	}
 
+	eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE, packet_tlvs,
+				     length, eigrp_mtu);
 	eigrp_update_place_on_nbr_queue(eigrp, nbr, packet, seq_no, length);
 	eigrp->sequence_number = seq_no++;
+
+	monotime(&now);
+	eigrp_update_dump_stat(eigrp, tlvs,
+			       (now.tv_sec - start.tv_sec) * 1000000
+				       + (now.tv_usec - start.tv_usec));
 }
 
 void eigrp_update_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
@@ -541,16 +569,15 @@ void eigrp_update_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 {
 	eigrp_packet_t *packet;
 
-	eigrp_prefix_descriptor_t *prefix;
+	eigrp_prefix_descriptor_t *prefix, *next;
 	eigrp_route_descriptor_t *route;
 	uint8_t has_tlv;
+	uint32_t tlvs = 0;
 	uint32_t seq_no = eigrp->sequence_number;
 	uint16_t eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
 	uint16_t tlv_length;
 	uint16_t length = EIGRP_HEADER_LEN;
 
-	struct listnode *node, *nnode;
-	struct prefix *dest_addr;
 
 	/* if we dont have peers on this interface, then we're done. */
 	if (ei->nbrs->count == 0)
@@ -568,16 +595,27 @@ void eigrp_update_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 	}
 
 	has_tlv = 0;
-	for (ALL_LIST_ELEMENTS(ei->eigrp->topology_changes, node, nnode, prefix)) {
+	EIGRP_TOPOLOGY_DIRTY_FOREACH (eigrp, EIGRP_DIRTY_UPDATE, prefix, next) {
+		route = eigrp_route_vec_head(&prefix->routes);
+		if (eigrp_nbr_split_horizon_check(route, ei))
+			continue;
 
-		if (!(prefix->req_action & EIGRP_FSM_NEED_UPDATE))
+		if (!eigrp_stub_advertise(eigrp, route))
 			continue;
 
-		route = listnode_head(prefix->entries);
-		if (eigrp_nbr_split_horizon_check(route, ei))
+		if (eigrp_summary_suppress(ei, prefix))
+			continue;
+
+		if (eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT, prefix)) {
+			// prefix->reported_metric.delay = EIGRP_MAX_METRIC;
+			continue;
+		}
+
+		tlv_length = ei->sizer(eigrp, route);
+		if (!tlv_length)
 			continue;
 
-		if ((length + EIGRP_TLV_MAX_IPV4_BYTE) > eigrp_mtu) {
+		if (has_tlv && length + tlv_length > eigrp_mtu) {
 			if ((ei->params.auth_type == EIGRP_AUTH_TYPE_MD5)
 			    && (ei->params.auth_keychain != NULL)) {
 				eigrp_make_md5_digest(ei, packet->s, EIGRP_AUTH_UPDATE_FLAG);
@@ -592,26 +630,28 @@ void eigrp_update_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 			packet->sequence_number = seq_no;
 			seq_no++;
 			eigrp_update_send_to_all_nbrs(eigrp, ei, packet);
-
+			eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE, tlvs,
+						     length, eigrp_mtu);
+			tlvs = 0;
+
+			/* the rest go in a packet of their own */
+			length = EIGRP_HEADER_LEN;
+			packet = eigrp_packet_new(eigrp_mtu, NULL);
+			eigrp_packet_header_init(EIGRP_OPC_UPDATE, eigrp,
+						 packet->s, 0, seq_no, 0);
 			if ((ei->params.auth_type == EIGRP_AUTH_TYPE_MD5)
 			    && (ei->params.auth_keychain != NULL)) {
 				length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
 			}
 			has_tlv = 0;
 		}
-		/* Get destination address from prefix */
-		dest_addr = prefix->destination;
 
-		if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT, dest_addr)) {
-			// prefix->reported_metric.delay = EIGRP_MAX_METRIC;
+		tlv_length = ei->encoder(eigrp, ei, NULL, packet->s, route);
+		if (!tlv_length)
 			continue;
-		} else {
-			tlv_length = ei->encoder(eigrp, ei, NULL, packet->s, route);
-			if (!tlv_length)
-				continue;
-			length += tlv_length;
-			has_tlv = 1;
-		}
+		length += tlv_length;
+		has_tlv = 1;
+		tlvs++;
 	}
 
 	if (!has_tlv) {
@@ -631,13 +671,15 @@ void eigrp_update_send(eigrp_instance_t *eigrp, eigrp_neighbor_t *nbr,
 	packet->dst.ip.v4.s_addr = htonl(EIGRP_MULTICAST_ADDRESS);
 
 	/*This ack number we await from neighbor*/
-	packet->sequence_number = eigrp->sequence_number;
+	packet->sequence_number = seq_no;
 
 	if (IS_DEBUG_EIGRP_PACKET(0, RECV))
 		zlog_debug("Enqueuing Update length[%u] Seq [%u]", length,
 			   packet->sequence_number);
 
 	eigrp_update_send_to_all_nbrs(eigrp, ei, packet);
+	eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE, tlvs, length,
+				     eigrp_mtu);
 	ei->eigrp->sequence_number = seq_no++;
 }
 
@@ -659,8 +701,11 @@ void eigrp_update_packetize_all(eigrp_instance_t *eigrp, eigrp_interface_t *exce
 {
 	eigrp_interface_t *iface;
 	eigrp_neighbor_t *nbr;
-	struct listnode *node, *node2, *nnode2;
-	eigrp_prefix_descriptor_t *prefix;
+	struct listnode *node;
+	eigrp_prefix_descriptor_t *prefix, *next;
+
+	/* summaries over what changed go out in this same update */
+	eigrp_summary_refresh(eigrp);
 
 	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, iface)) {
 		if (iface == exception)
@@ -671,20 +716,15 @@ void eigrp_update_packetize_all(eigrp_instance_t *eigrp, eigrp_interface_t *exce
 			eigrp_update_send(eigrp, nbr, iface);
 	}
 
-	for (ALL_LIST_ELEMENTS(eigrp->topology_changes, node2, nnode2, prefix)) {
-		if (prefix->req_action & EIGRP_FSM_NEED_UPDATE) {
-			prefix->req_action &= ~EIGRP_FSM_NEED_UPDATE;
-			if (!prefix->req_action)
-				listnode_delete(eigrp->topology_changes, prefix);
-		}
-	}
+	EIGRP_TOPOLOGY_DIRTY_FOREACH (eigrp, EIGRP_DIRTY_UPDATE, prefix, next)
+		eigrp_topology_dirty_remove(eigrp, prefix, EIGRP_FSM_NEED_UPDATE);
 }
 
 void eigrp_update_send_all(eigrp_instance_t *eigrp, eigrp_interface_t *exception)
 {
 	eigrp_packetizer_work_t *work;
 
-	work = eigrp_packetizer_work_new(EIGRP_OPC_UPDATE);
+	work = eigrp_packetizer_work_new(eigrp, EIGRP_OPC_UPDATE);
 	work->exception = exception;
 	eigrp_packetizer_enqueue(eigrp, work);
 }
@@ -712,18 +752,16 @@ static void eigrp_update_send_GR_part(eigrp_neighbor_t *nbr)
 	eigrp_packet_t *packet;
 	eigrp_prefix_descriptor_t *prefix;
 	eigrp_route_descriptor_t *route;
+	struct eigrp_header *eigrph;
 
-	struct list *successors;
 	struct prefix *dest_addr;
-	struct list *prefixes;
 	struct route_node *rn;
 
 	uint32_t flags;
 	unsigned int send_prefixes;
+	uint16_t eigrp_mtu = EIGRP_PACKET_MTU(ei->ifp->mtu);
 	uint16_t length = EIGRP_HEADER_LEN;
-
-	/* get prefixes to send to neighbor */
-	prefixes = nbr->nbr_gr_prefixes_send;
+	uint16_t tlv_length;
 
 	send_prefixes = 0;
 
@@ -731,34 +769,21 @@ static void eigrp_update_send_GR_part(eigrp_neighbor_t *nbr)
 	if (nbr->nbr_gr_packet_type == EIGRP_PACKET_PART_LAST)
 		return;
 
-	/* if this is first packet chunk, we need to decide,
-	 * if there will be one or more chunks */
+	/*
+	 * The first chunk starts the walk of the topology, the others pick
+	 * it up after the last prefix sent.  Each chunk is filled to the
+	 * MTU; the one the walk ends in carries EOT.
+	 */
 	if (nbr->nbr_gr_packet_type == EIGRP_PACKET_PART_FIRST) {
-		if (prefixes->count <= EIGRP_TLV_MAX_IPv4) {
-			/* there will be only one chunk */
-			flags = EIGRP_INIT_FLAG + EIGRP_RS_FLAG
-				+ EIGRP_EOT_FLAG;
-			nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_LAST;
-		} else {
-			/* there will be more chunks */
-			flags = EIGRP_INIT_FLAG + EIGRP_RS_FLAG;
-			nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_NA;
-		}
+		flags = EIGRP_INIT_FLAG + EIGRP_RS_FLAG;
+		rn = route_top(eigrp->topology_table);
 	} else {
-		/* this is not first chunk, and we need to decide,
-		 * if there will be more chunks */
-		if (prefixes->count <= EIGRP_TLV_MAX_IPv4) {
-			/* this is last chunk */
-			flags = EIGRP_EOT_FLAG;
-			nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_LAST;
-		} else {
-			/* there will be more chunks */
-			flags = 0;
-			nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_NA;
-		}
+		flags = 0;
+		rn = route_table_get_next(eigrp->topology_table,
+					  &nbr->nbr_gr_resume);
 	}
 
-	packet = eigrp_packet_new(EIGRP_PACKET_MTU(ei->ifp->mtu), nbr);
+	packet = eigrp_packet_new(eigrp_mtu, nbr);
 
 	/* Prepare EIGRP Graceful restart UPDATE header */
 	eigrp_packet_header_init(EIGRP_OPC_UPDATE, eigrp, packet->s, flags,
@@ -771,37 +796,57 @@ static void eigrp_update_send_GR_part(eigrp_neighbor_t *nbr)
 		length += eigrp_add_authTLV_MD5_encode(packet->s, ei);
 	}
 
-	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
+	for (; rn; rn = route_next(rn)) {
 		if (!rn->info)
 			continue;
 
 		prefix = rn->info;
+		if (eigrp_summary_suppress(ei, prefix))
+			continue;
+
+		/* a summary with no component left has nothing to send */
+		if (prefix->nt == EIGRP_TOPOLOGY_TYPE_SUMMARY
+		    && !eigrp_topology_successor_head(prefix))
+			continue;
+
 		/*
 		 * Filtering
 		 */
-		dest_addr = prefix->destination;
+		dest_addr = eigrp_topology_prefix_dest(prefix);
 
-		if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT, dest_addr)) {
+		if (eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT, prefix)) {
 			/* do not send filtered route */
 			zlog_info("Filtered prefix %s won't be sent out.",
 				  eigrp_print_prefix(dest_addr));
 		} else {
 			// grab the route from the prefix so we can get the metrics we need
-			successors = eigrp_topology_get_successor(prefix);
-			assert(successors); // If this is NULL somebody poked us in the eye.
-			route = listnode_head(successors);
+			route = eigrp_topology_successor_head(prefix);
+			assert(route); // If this is NULL somebody poked us in the eye.
 
 			/* sending route which wasn't filtered */
-			length += (nbr->encoder)(eigrp, ei, nbr, packet->s, route);
-			send_prefixes++;
+			if (eigrp_stub_advertise(eigrp, route)) {
+				tlv_length = nbr->sizer(eigrp, route);
+
+				/* full: this prefix starts the next chunk */
+				if (send_prefixes
+				    && length + tlv_length > eigrp_mtu) {
+					route_unlock_node(rn);
+					break;
+				}
+
+				tlv_length = (nbr->encoder)(eigrp, ei, nbr,
+							    packet->s, route);
+				length += tlv_length;
+				if (tlv_length)
+					send_prefixes++;
+			}
 		}
 
 		/*
 		 * This makes no sense, Filter out then filter in???
 		 * Look into this more - DBS
 		 */
-		if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_IN,
-					      dest_addr)) {
+		if (eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_IN, prefix)) {
 			/* do not send filtered route */
 			zlog_info("Filtered prefix %s will be removed.",
 				  eigrp_print_prefix(dest_addr));
@@ -810,7 +855,7 @@ static void eigrp_update_send_GR_part(eigrp_neighbor_t *nbr)
 			eigrp_fsm_action_message_t fsm_msg;
 
 			eigrp_route_descriptor_t *fsm_route =
-				eigrp_prefix_descriptor_lookup(prefix->entries,
+				eigrp_prefix_descriptor_lookup(&prefix->routes,
 							       nbr);
 
 			fsm_msg.packet_type = EIGRP_OPC_UPDATE;
@@ -827,16 +872,21 @@ static void eigrp_update_send_GR_part(eigrp_neighbor_t *nbr)
 			eigrp_fsm_event(&fsm_msg);
 		}
 
-		/* NULL the pointer */
-		dest_addr = NULL;
-
-		/* delete processed prefix from list */
-		listnode_delete(prefixes, prefix);
+		/* the next chunk resumes after this prefix */
+		prefix_copy(&nbr->nbr_gr_resume, dest_addr);
+	}
 
-		/* if there are enough prefixes, send packet */
-		if (send_prefixes >= EIGRP_TLV_MAX_IPv4)
-			break;
+	if (rn) {
+		nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_NA;
+	} else {
+		/* the walk is done, this is the last chunk */
+		flags |= EIGRP_EOT_FLAG;
+		nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_LAST;
+		eigrph = (struct eigrp_header *)STREAM_DATA(packet->s);
+		eigrph->flags = htonl(flags);
 	}
+	eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE, send_prefixes,
+				     length, eigrp_mtu);
 
 	/* compute Auth digest */
 	if ((ei->params.auth_type == EIGRP_AUTH_TYPE_MD5)
@@ -926,9 +976,6 @@ void eigrp_update_send_GR_event(struct event *event)
 void eigrp_update_send_GR(eigrp_neighbor_t *nbr, enum GR_type gr_type,
 			  struct vty *vty)
 {
-	eigrp_prefix_descriptor_t *prefix2;
-	struct list *prefixes;
-	struct route_node *rn;
 	eigrp_interface_t *ei = nbr->ei;
 	eigrp_instance_t *eigrp = ei->eigrp;
 
@@ -954,19 +1001,6 @@ void eigrp_update_send_GR(eigrp_neighbor_t *nbr, enum GR_type gr_type,
 		}
 	}
 
-	prefixes = list_new();
-	/* add all prefixes from topology table to list */
-	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
-		if (!rn->info)
-			continue;
-
-		prefix2 = rn->info;
-		listnode_add(prefixes, prefix2);
-	}
-
-	/* save prefixes to neighbor */
-	nbr->nbr_gr_prefixes_send = prefixes;
-
 	/* indicate, that this is first GR Update packet chunk */
 	nbr->nbr_gr_packet_type = EIGRP_PACKET_PART_FIRST;
 
@@ -27,6 +27,7 @@
 #include "keychain.h"
 #include "linklist.h"
 #include "distribute.h"
+#include "json.h"
 
 #include "eigrpd/eigrpd.h"
 #include "eigrpd/eigrp_structs.h"
@@ -35,6 +36,8 @@
 #include "eigrpd/eigrp_neighbor.h"
 #include "eigrpd/eigrp_packet.h"
 #include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_route_vec.h"
+#include "eigrpd/eigrp_snapshot.h"
 #include "eigrpd/eigrp_zebra.h"
 #include "eigrpd/eigrp_vty.h"
 #include "eigrpd/eigrp_network.h"
@@ -64,6 +67,8 @@ struct eigrp_vty_walk_context {
 	const struct prefix *prefix;
 	bool soft;
 	int matched;
+	uint32_t last;
+	json_object *json;
 };
 
 typedef void (*eigrp_vty_walk_cb)(struct vty *vty, eigrp_instance_t *eigrp,
@@ -144,40 +149,47 @@ static int eigrp_vty_instance_walk(struct vty *vty, const char *afi,
 
 static void eigrp_vty_display_prefix_entry(struct vty *vty,
 					   eigrp_instance_t *eigrp,
-					   eigrp_prefix_descriptor_t *pe,
+					   eigrp_snapshot_t *snap,
+					   eigrp_snapshot_prefix_t *sp,
 					   bool all)
 {
 	bool first = true;
-	struct eigrp_route_descriptor *te;
-	struct listnode *node;
+	eigrp_snapshot_route_t *sr;
+	int i;
 
-	for (ALL_LIST_ELEMENTS_RO(pe->entries, node, te)) {
+	sr = eigrp_snapshot_routes(snap, sp);
+	for (i = 0; i < sp->nroutes; i++, sr++) {
 		if (all
-		    || (((te->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
+		    || (((sr->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
 			 == EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
-			|| ((te->flags & EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG)
+			|| ((sr->flags & EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG)
 			    == EIGRP_ROUTE_DESCRIPTOR_FSUCCESSOR_FLAG))) {
-			show_ip_eigrp_route_descriptor(vty, eigrp, te, &first);
+			show_ip_eigrp_route_descriptor(vty, eigrp, sp, sr,
+						       &first);
 			first = false;
 		}
 	}
 }
 
+/*
+ * Formatting works from a snapshot, never from the live table, so the
+ * time spent building the output does not hold up the topology and a
+ * second reader of an unchanged table reuses the same copy.
+ */
 static void eigrp_topology_helper(struct vty *vty, eigrp_instance_t *eigrp,
 				  const char *all)
 {
-	eigrp_prefix_descriptor_t *tn;
-	struct route_node *rn;
+	eigrp_snapshot_t *snap;
+	eigrp_snapshot_prefix_t *sp;
 
+	snap = eigrp_snapshot_get(eigrp);
 	show_ip_eigrp_topology_header(vty, eigrp);
 
-	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
-		if (!rn->info)
-			continue;
+	EIGRP_SNAPSHOT_FOREACH (snap, sp)
+		eigrp_vty_display_prefix_entry(vty, eigrp, snap, sp,
+					       all ? true : false);
 
-		tn = rn->info;
-		eigrp_vty_display_prefix_entry(vty, eigrp, tn, all ? true : false);
-	}
+	eigrp_snapshot_release(&snap);
 }
 
 static void eigrp_interface_helper(struct vty *vty, eigrp_instance_t *eigrp,
@@ -216,6 +228,9 @@ static void eigrp_neighbor_helper(struct vty *vty, eigrp_instance_t *eigrp,
 			}
 		}
 	}
+
+	if (detail)
+		eigrp_neighbor_bringup_dump(vty, eigrp);
 }
 
 static void show_eigrp_interface_cb(struct vty *vty, eigrp_instance_t *eigrp,
@@ -240,7 +255,7 @@ static void show_eigrp_topology_prefix_cb(struct vty *vty,
 					  eigrp_instance_t *eigrp,
 					  struct eigrp_vty_walk_context *ctx)
 {
-	eigrp_prefix_descriptor_t *tn;
+	eigrp_snapshot_t *snap;
 	struct route_node *rn;
 
 	show_ip_eigrp_topology_header(vty, eigrp);
@@ -253,9 +268,39 @@ static void show_eigrp_topology_prefix_cb(struct vty *vty,
 		return;
 	}
 
-	tn = rn->info;
-	eigrp_vty_display_prefix_entry(vty, eigrp, tn, ctx->all ? true : false);
+	snap = eigrp_snapshot_prefix(eigrp, rn->info);
 	route_unlock_node(rn);
+
+	eigrp_vty_display_prefix_entry(vty, eigrp, snap, snap->prefixes,
+				       ctx->all ? true : false);
+	eigrp_snapshot_release(&snap);
+}
+
+static void show_eigrp_topology_summary_cb(struct vty *vty,
+					   eigrp_instance_t *eigrp,
+					   struct eigrp_vty_walk_context *ctx)
+{
+	eigrp_topology_summary_dump(vty, eigrp);
+}
+
+static void show_eigrp_memory_cb(struct vty *vty, eigrp_instance_t *eigrp,
+				 struct eigrp_vty_walk_context *ctx)
+{
+	eigrp_memory_dump(vty, eigrp, ctx->detail ? true : false, ctx->json);
+}
+
+static void show_eigrp_event_cb(struct vty *vty, eigrp_instance_t *eigrp,
+				struct eigrp_vty_walk_context *ctx)
+{
+	eigrp_fsm_trace_dump(vty, eigrp,
+			     (const struct prefix_ipv4 *)ctx->prefix, ctx->last,
+			     ctx->json);
+}
+
+static void show_eigrp_timer_cb(struct vty *vty, eigrp_instance_t *eigrp,
+				struct eigrp_vty_walk_context *ctx)
+{
+	eigrp_active_dump(vty, eigrp);
 }
 
 #ifdef EIGRP_STANDALONE_BUILD
@@ -270,6 +315,7 @@ static int64_t as = 0;
 static const char *as_str = NULL;
 static const char *ifname = NULL;
 static const char *detail = NULL;
+static const char *json = NULL;
 static const char *all = NULL;
 static const char *target = NULL;
 static struct in_addr address;
@@ -280,6 +326,7 @@ static const char *prefix_str = NULL;
 static const char *soft = NULL;
 static struct in_addr nbr_addr;
 static const char *nbr_addr_str = NULL;
+static int64_t last = 0;
 #endif
 
 DEFPY(show_eigrp_interface,
@@ -400,6 +447,59 @@ DEFPY(show_eigrp_topology,
 					show_eigrp_topology_prefix_cb, &ctx);
 }
 
+DEFPY(show_eigrp_topology_summary,
+      show_eigrp_topology_summary_cmd,
+      "show eigrp address-family <ipv4|ipv6>$afi [vrf NAME$vrf] [(1-65535)$as] [multicast] topology summary",
+      SHOW_STR
+      EIGRP_STR
+      "Address-family information\n"
+      "IPv4 address-family\n"
+      "IPv6 address-family\n"
+      VRF_CMD_HELP_STR
+      AS_STR
+      "Display multicast instances\n"
+      "Display EIGRP topology table\n"
+      "Topology counts and pending work\n")
+{
+	struct eigrp_vty_walk_context ctx = {};
+
+	return eigrp_vty_instance_walk(vty, afi, as, vrf,
+					"show eigrp address-family topology summary",
+					show_eigrp_topology_summary_cb, &ctx);
+}
+
+DEFPY(show_eigrp_memory,
+      show_eigrp_memory_cmd,
+      "show eigrp address-family <ipv4|ipv6>$afi [vrf NAME$vrf] [(1-65535)$as] [multicast] memory [detail]$detail [json]$json",
+      SHOW_STR
+      EIGRP_STR
+      "Address-family information\n"
+      "IPv4 address-family\n"
+      "IPv6 address-family\n"
+      VRF_CMD_HELP_STR
+      AS_STR
+      "Display multicast instances\n"
+      "Display EIGRP object memory\n"
+      "Per interface and neighbor breakdown\n"
+      JSON_STR)
+{
+	struct eigrp_vty_walk_context ctx = {
+		.detail = detail,
+	};
+	int ret;
+
+	if (json)
+		ctx.json = json_object_new_object();
+
+	ret = eigrp_vty_instance_walk(vty, afi, as, vrf,
+				      "show eigrp address-family memory",
+				      show_eigrp_memory_cb, &ctx);
+
+	if (json)
+		vty_json(vty, ctx.json);
+	return ret;
+}
+
 static int show_eigrp_stub(struct vty *vty, const char *command)
 {
 	return eigrp_cli_not_configured(vty, command);
@@ -417,12 +517,38 @@ DEFPY(show_eigrp_accounting,
 
 DEFPY(show_eigrp_event,
       show_eigrp_event_cmd,
-      "show eigrp address-family <ipv4|ipv6>$afi [vrf NAME$vrf] [(1-65535)$as] [multicast] events",
-      SHOW_STR EIGRP_STR "Address-family information\n"
-      "IPv4 address-family\n" "IPv6 address-family\n" VRF_CMD_HELP_STR AS_STR
-      "Display multicast instances\n" "Display EIGRP events\n")
+      "show eigrp address-family <ipv4|ipv6>$afi [vrf NAME$vrf] [(1-65535)$as] [multicast] events [prefix A.B.C.D/M$prefix] [last (1-4096)$last] [json]$json",
+      SHOW_STR
+      EIGRP_STR
+      "Address-family information\n"
+      "IPv4 address-family\n"
+      "IPv6 address-family\n"
+      VRF_CMD_HELP_STR
+      AS_STR
+      "Display multicast instances\n"
+      "Display EIGRP DUAL events\n"
+      "Events of one prefix\n"
+      "Network prefix\n"
+      "Most recent events only\n"
+      "Number of events\n"
+      JSON_STR)
 {
-	return show_eigrp_stub(vty, "show eigrp address-family events");
+	struct eigrp_vty_walk_context ctx = {
+		.prefix = prefix_str ? (const struct prefix *)prefix : NULL,
+		.last = last,
+	};
+	int ret;
+
+	if (json)
+		ctx.json = json_object_new_object();
+
+	ret = eigrp_vty_instance_walk(vty, afi, as, vrf,
+				      "show eigrp address-family events",
+				      show_eigrp_event_cb, &ctx);
+
+	if (json)
+		vty_json(vty, ctx.json);
+	return ret;
 }
 
 DEFPY(show_eigrp_timer,
@@ -432,7 +558,11 @@ DEFPY(show_eigrp_timer,
       "IPv4 address-family\n" "IPv6 address-family\n" VRF_CMD_HELP_STR AS_STR
       "Display multicast instances\n" "Display EIGRP timers\n")
 {
-	return show_eigrp_stub(vty, "show eigrp address-family timers");
+	struct eigrp_vty_walk_context ctx = {};
+
+	return eigrp_vty_instance_walk(vty, afi, as, vrf,
+				       "show eigrp address-family timers",
+				       show_eigrp_timer_cb, &ctx);
 }
 
 DEFPY(show_eigrp_traffic,
@@ -658,6 +788,8 @@ void eigrp_vty_show_init(void)
 	install_element(VIEW_NODE, &show_eigrp_neighbor_cmd);
 	install_element(VIEW_NODE, &show_eigrp_topology_cmd);
 	install_element(VIEW_NODE, &show_eigrp_topology_all_cmd);
+	install_element(VIEW_NODE, &show_eigrp_topology_summary_cmd);
+	install_element(VIEW_NODE, &show_eigrp_memory_cmd);
 	install_element(VIEW_NODE, &show_eigrp_accounting_cmd);
 	install_element(VIEW_NODE, &show_eigrp_event_cmd);
 	install_element(VIEW_NODE, &show_eigrp_timer_cmd);
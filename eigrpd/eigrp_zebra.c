@@ -177,12 +177,13 @@ static int eigrp_zebra_interface_address_delete(ZAPI_CALLBACK_ARGS)
 }
 
 void eigrp_zebra_route_add(eigrp_instance_t *eigrp, struct prefix *p,
-			   struct list *successors, uint32_t distance)
+			   eigrp_route_descriptor_t **successors,
+			   unsigned int paths, uint32_t distance)
 {
 	struct zapi_route api;
 	struct zapi_nexthop *api_nh;
 	eigrp_route_descriptor_t *te;
-	struct listnode *node;
+	unsigned int i;
 	int count = 0;
 
 	if (!eigrp_zclient->redist[AFI_IP][ZEBRA_ROUTE_EIGRP])
@@ -193,18 +194,26 @@ void eigrp_zebra_route_add(eigrp_instance_t *eigrp, struct prefix *p,
 	api.type = ZEBRA_ROUTE_EIGRP;
 	api.safi = SAFI_UNICAST;
 	api.metric = distance;
-	memcpy(&api.prefix, p, sizeof(*p));
+	prefix_copy(&api.prefix, p);
 
 	SET_FLAG(api.message, ZAPI_MESSAGE_NEXTHOP);
 	SET_FLAG(api.message, ZAPI_MESSAGE_METRIC);
 
 	/* Nexthop, ifindex, distance and metric information. */
-	for (ALL_LIST_ELEMENTS_RO(successors, node, te)) {
+	for (i = 0; i < paths; i++) {
 		if (count >= MULTIPATH_NUM)
 			break;
+		te = successors[i];
 		api_nh = &api.nexthops[count];
 		zapi_nexthop_init(api_nh);
 		api_nh->vrf_id = eigrp->vrf_id;
+		if (!te->ei) {
+			/* interface summary: discard what no component covers */
+			api_nh->type = NEXTHOP_TYPE_BLACKHOLE;
+			api_nh->bh_type = BLACKHOLE_NULL;
+			count++;
+			continue;
+		}
 		if (te->adv_router->src.ip.v4.s_addr) {
 			api_nh->gate.ipv4 = te->adv_router->src.ip.v4;
 			api_nh->type = NEXTHOP_TYPE_IPV4_IFINDEX;
@@ -234,7 +243,7 @@ void eigrp_zebra_route_delete(eigrp_instance_t *eigrp, struct prefix *p)
 	api.vrf_id = eigrp->vrf_id;
 	api.type = ZEBRA_ROUTE_EIGRP;
 	api.safi = SAFI_UNICAST;
-	memcpy(&api.prefix, p, sizeof(*p));
+	prefix_copy(&api.prefix, p);
 	zclient_route_send(ZEBRA_ROUTE_DELETE, eigrp_zclient, &api);
 
 	if (IS_DEBUG_EIGRP(zebra, ZEBRA_REDISTRIBUTE)) {
@@ -22,7 +22,8 @@ extern void eigrp_zebra_init(void);
 extern void eigrp_zebra_stop(void);
 
 extern void eigrp_zebra_route_add(eigrp_instance_t *eigrp, struct prefix *p,
-				  struct list *successors, uint32_t distance);
+				  eigrp_route_descriptor_t **successors,
+				  unsigned int paths, uint32_t distance);
 extern void eigrp_zebra_route_delete(eigrp_instance_t *eigrp, struct prefix *);
 extern int eigrp_redistribute_set(eigrp_instance_t *, int, struct eigrp_metrics);
 extern int eigrp_redistribute_unset(eigrp_instance_t *, int);
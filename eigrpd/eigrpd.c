@@ -20,6 +20,13 @@
 #include "eigrpd/eigrp_errors.h"
 #include "eigrpd/eigrp_zebra.h"
 #include "eigrpd/eigrp_packetizer.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_snapshot.h"
+#include "eigrpd/eigrp_active.h"
+#include "eigrpd/eigrp_summary.h"
+#include "eigrpd/eigrp_dual_queue.h"
+#include "eigrpd/eigrp_rib_queue.h"
+#include "eigrpd/eigrp_fsm.h"
 #include "eigrpd/eigrp_tlv1.h"
 #include "eigrpd/eigrp_tlv2.h"
 
@@ -150,15 +157,33 @@ static eigrp_instance_t *eigrp_new(uint16_t as, vrf_id_t vrf_id)
 	src.afi = AF_INET;
 	src.ip.v4.s_addr = INADDR_ANY;
 
+	eigrp_slab_init(&eigrp->prefix_slab, "prefix",
+			sizeof(eigrp_prefix_descriptor_t));
+	eigrp_slab_init(&eigrp->route_slab, "route",
+			sizeof(eigrp_route_descriptor_t));
+	eigrp_slab_init(&eigrp->work_slab, "packetizer work",
+			sizeof(eigrp_packetizer_work_t));
+	eigrp_slab_init(&eigrp->dual_slab, "DUAL input",
+			sizeof(eigrp_dual_event_t));
+	eigrp_slab_init(&eigrp->rib_slab, "RIB change",
+			sizeof(eigrp_rib_entry_t));
+
 	eigrp->neighbor_self = eigrp_nbr_create(NULL, &src);
 	eigrp->topology_table = route_table_init();
+	eigrp_summary_init(eigrp);
+	eigrp_fsm_trace_init(eigrp);
 	eigrp->variance = EIGRP_VARIANCE_DEFAULT;
 	eigrp->max_paths = EIGRP_MAX_PATHS_DEFAULT;
 
 	eigrp->serno = 0;
 	eigrp->serno_last_update = 0;
-	eigrp->topology_changes = list_new();
 	eigrp_packetizer_init(eigrp);
+	eigrp_dual_queue_init(eigrp);
+
+	eigrp->bringup_max = EIGRP_BRINGUP_MAX_DEFAULT;
+	eigrp->dual_flush_delay = EIGRP_DUAL_FLUSH_DELAY_DEFAULT;
+	eigrp->active_time = EIGRP_ACTIVE_TIME_DEFAULT;
+	eigrp->bringup_queue = list_new();
 
 	eigrp->list[EIGRP_FILTER_IN] = NULL;
 	eigrp->list[EIGRP_FILTER_OUT] = NULL;
@@ -284,11 +309,13 @@ void eigrp_finish_final(eigrp_instance_t *eigrp)
 	eigrp_neighbor_t *nbr;
 	struct listnode *node, *nnode, *node2, *nnode2;
 
-	for (ALL_LIST_ELEMENTS(eigrp->eiflist, node, nnode, ei)) {
+	/* dropping the neighbors' queued withdraws frees the neighbors */
+	for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei))
 		for (ALL_LIST_ELEMENTS(ei->nbrs, node2, nnode2, nbr))
 			eigrp_nbr_delete(nbr);
+	eigrp_dual_queue_fini(eigrp);
+	for (ALL_LIST_ELEMENTS(eigrp->eiflist, node, nnode, ei))
 		eigrp_intf_free(eigrp, ei, INTERFACE_DOWN_BY_FINAL);
-	}
 
 	event_cancel(&eigrp->t_write);
 	event_cancel(&eigrp->t_read);
@@ -298,12 +325,24 @@ void eigrp_finish_final(eigrp_instance_t *eigrp)
 	list_delete(&eigrp->eiflist);
 	list_delete(&eigrp->oi_write_q);
 
+	eigrp_snapshot_fini(eigrp);
+	eigrp_summary_fini(eigrp);
+	eigrp_active_fini(eigrp);
 	eigrp_topology_free(eigrp, eigrp->topology_table);
+	eigrp_rib_queue_fini(eigrp);
+	eigrp_fsm_trace_fini(eigrp);
 	eigrp_nbr_delete(eigrp->neighbor_self);
 
-	list_delete(&eigrp->topology_changes);
+	eigrp_nbr_slot_fini(eigrp);
+	list_delete(&eigrp->bringup_queue);
 	listnode_delete(eigrp_om->eigrp, eigrp);
 
+	eigrp_slab_fini(&eigrp->dual_slab);
+	eigrp_slab_fini(&eigrp->rib_slab);
+	eigrp_slab_fini(&eigrp->work_slab);
+	eigrp_slab_fini(&eigrp->route_slab);
+	eigrp_slab_fini(&eigrp->prefix_slab);
+
 	if (eigrp->name)
 		XFREE(MTYPE_EIGRP_TOP, eigrp->name);
 
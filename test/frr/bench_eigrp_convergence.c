@@ -0,0 +1,1296 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP DUAL convergence simulator.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Runs N EIGRP routers in one process: the real hello, packet, TLV,
+ * packetizer, DUAL and topology code of each, one instance per VRF.  This
+ * file supplies the three things the daemon gets from its host:
+ *
+ *   - the southbound (eigrp_southbound.c is not linked): work queues are
+ *     run by the simulator, and eigrp_southbound_packet_send() puts each
+ *     packet on a simulated point-to-point link instead of a raw socket;
+ *   - the zebra client (eigrp_zebra.c is not linked): installs and
+ *     withdrawals land in a per-router table;
+ *   - the clock: the FRR event loop is never run.  Packets take their
+ *     link's delay in virtual time, and the simulator fires the daemon's
+ *     write, packetizer flush and RIB flush events itself.  When the network is quiet
+ *     the virtual clock jumps to the earliest retransmission or active
+ *     timer and fires that.  Hello and hold timers never fire; links fail
+ *     by interface down, as on loss of carrier.
+ *
+ * The topology file lists links and the failures to inject:
+ *
+ *   # comment
+ *   prefixes 8              stub prefixes each router originates
+ *   delay 1000              default one-way link delay, usec
+ *   link r1 r2 [usec]
+ *   fail r1 r2
+ *   restore r1 r2
+ *
+ * The network is brought up and left to converge, then each fail or
+ * restore is applied in turn.  Every step reports the virtual time to the
+ * last routing table change and to the last packet, the packets sent by
+ * type, the routing table writes and the prefixes that do not match the
+ * surviving topology.  Peak RSS and slab use are reported at the end.
+ *
+ * A step that leaves any prefix missing or stale fails the run: the
+ * simulator still runs the remaining steps, then exits nonzero.  So does
+ * a lost route: each receiver decodes every UPDATE it is handed with its
+ * own decoder, and at the end of the step every route a neighbor last
+ * sent as reachable must be in the receiver's topology, from that
+ * neighbor.  What the packetizer packs has to be what the receiver learns.
+ *
+ *   tests/eigrpd/bench_eigrp_convergence [-p prefixes] [-f flush-msec] topology
+ */
+#include <zebra.h>
+#include <sys/resource.h>
+
+#include "if.h"
+#include "vrf.h"
+#include "table.h"
+#include "linklist.h"
+#include "memory.h"
+#include "monotime.h"
+#include "frrevent.h"
+#include "stream.h"
+
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_interface.h"
+#include "eigrpd/eigrp_neighbor.h"
+#include "eigrpd/eigrp_network.h"
+#include "eigrpd/eigrp_packet.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_southbound.h"
+#include "eigrpd/eigrp_topology.h"
+#include "eigrpd/eigrp_zebra.h"
+
+/* normally defined by eigrp_main.c and eigrp_zebra.c */
+struct event_loop *eigrpd_event;
+struct in_addr router_id_zebra;
+
+#define SIM_AS 100
+#define SIM_NAME_LEN 32
+#define SIM_LINE_MAX 256
+#define SIM_STUB_MAX 262144
+#define SIM_TIMERS_MAX 256 /* quiet-network timer firings per step */
+#define SIM_OPC_MAX 16
+
+#define SIM_LINK_NET 0x0a000000 /* 10.0.0.0/8, one /30 per link */
+#define SIM_STUB_NET 0x14000000 /* 20.0.0.0/6, one /24 per stub prefix */
+#define SIM_ROUTER_ID 0x01000000
+
+struct sim_router;
+struct sim_link;
+
+struct sim_port {
+	struct sim_router *router;
+	struct sim_link *link; /* NULL for a stub prefix */
+	struct interface *ifp;
+	struct in_addr addr;
+	struct route_table *heard; /* reachable in the peer's UPDATEs, this step */
+};
+
+struct sim_link {
+	unsigned int router[2];
+	struct sim_port *end[2];
+	uint32_t delay; /* usec */
+	bool up;
+};
+
+struct sim_router {
+	char name[SIM_NAME_LEN];
+	vrf_id_t vrf_id;
+	eigrp_instance_t *eigrp;
+	struct route_table *rib; /* what the fake zebra was told */
+	uint32_t stub;		 /* index of the first stub prefix */
+	uint64_t flush_at;	 /* virtual time the pending flush runs */
+	uint64_t rib_at;	 /* virtual time the pending RIB flush runs */
+	int component;
+};
+
+/* A packet in flight */
+struct sim_msg {
+	uint64_t at;
+	uint64_t seq;
+	struct sim_port *to;
+	struct in_addr src;
+	struct in_addr dst;
+	uint16_t length;
+	uint8_t data[];
+};
+
+struct sim_step {
+	bool fail;
+	unsigned int link;
+};
+
+struct sim_counters {
+	uint64_t packets[SIM_OPC_MAX];
+	uint64_t acks;
+	uint64_t bytes;
+	uint64_t rib;
+	uint64_t last_rib;
+	uint64_t last_packet;
+	uint32_t timers;
+};
+
+static struct sim {
+	struct sim_router *routers;
+	unsigned int nrouters, routers_max;
+	struct sim_link *links;
+	unsigned int nlinks, links_max;
+	struct sim_port **ports; /* by ifindex - 1 */
+	unsigned int nports, ports_max;
+	struct sim_step *steps;
+	unsigned int nsteps, steps_max;
+
+	struct sim_msg **heap;
+	unsigned int heap_len, heap_max;
+
+	uint64_t now; /* usec */
+	uint64_t seq;
+	struct sim_counters c;
+
+	uint32_t prefixes;
+	uint32_t delay;
+	int flush_delay; /* msec, -1 = instance default */
+
+	uint32_t update_tlvs_max; /* most route TLVs in one UPDATE */
+	unsigned int failed;	  /* steps left with missing or stale prefixes */
+} sim = {
+	.prefixes = 4,
+	.delay = 1000,
+	.flush_delay = -1,
+};
+
+struct eigrp_work_queue {
+	eigrp_instance_t *eigrp;
+	char *name;
+	eigrp_work_queue_func_t workfunc;
+	eigrp_work_queue_delete_func_t deletefunc;
+	struct list *items;
+};
+
+static struct list *sim_work_queues;
+
+#define SIM_GROW(array, count, max)                                            \
+	do {                                                                   \
+		if ((count) == (max)) {                                        \
+			(max) = (max) ? (max) * 2 : 16;                        \
+			(array) = XREALLOC(MTYPE_TMP, (array),                 \
+					   (max) * sizeof(*(array)));          \
+		}                                                              \
+	} while (0)
+
+/*
+ * Run a pending daemon event now.  The event loop owns the event, so it is
+ * cancelled first and the callback gets a copy that only carries the arg.
+ */
+static void sim_event_fire(struct event **ref)
+{
+	void (*func)(struct event *);
+	struct event event = {};
+
+	if (!*ref)
+		return;
+
+	func = (*ref)->func;
+	event.arg = (*ref)->arg;
+	event_cancel(ref);
+	func(&event);
+}
+
+/* Packets in flight, earliest first */
+static bool sim_msg_before(struct sim_msg *a, struct sim_msg *b)
+{
+	return a->at < b->at || (a->at == b->at && a->seq < b->seq);
+}
+
+static void sim_heap_push(struct sim_msg *msg)
+{
+	unsigned int i, parent;
+
+	SIM_GROW(sim.heap, sim.heap_len, sim.heap_max);
+	for (i = sim.heap_len++; i; i = parent) {
+		parent = (i - 1) / 2;
+		if (!sim_msg_before(msg, sim.heap[parent]))
+			break;
+		sim.heap[i] = sim.heap[parent];
+	}
+	sim.heap[i] = msg;
+}
+
+static struct sim_msg *sim_heap_pop(void)
+{
+	struct sim_msg *top = sim.heap[0];
+	struct sim_msg *last = sim.heap[--sim.heap_len];
+	unsigned int i = 0, child;
+
+	while ((child = 2 * i + 1) < sim.heap_len) {
+		if (child + 1 < sim.heap_len
+		    && sim_msg_before(sim.heap[child + 1], sim.heap[child]))
+			child++;
+		if (!sim_msg_before(sim.heap[child], last))
+			break;
+		sim.heap[i] = sim.heap[child];
+		i = child;
+	}
+	if (sim.heap_len)
+		sim.heap[i] = last;
+
+	return top;
+}
+
+static struct sim_router *sim_router_of(eigrp_instance_t *eigrp)
+{
+	return &sim.routers[eigrp->vrf_id - 1];
+}
+
+static struct sim_port *sim_port_of(struct interface *ifp)
+{
+	if (ifp->ifindex <= 0 || (unsigned int)ifp->ifindex > sim.nports)
+		return NULL;
+
+	return sim.ports[ifp->ifindex - 1];
+}
+
+/*
+ * Southbound: work queues.  Each run of a router takes one item from each
+ * of its queues, so a queue that requeues shares the virtual instant with
+ * everything else that is due.
+ */
+eigrp_work_queue_t *eigrp_work_queue_new(eigrp_instance_t *eigrp,
+					 const char *name,
+					 eigrp_work_queue_func_t workfunc,
+					 eigrp_work_queue_delete_func_t deletefunc)
+{
+	eigrp_work_queue_t *queue;
+
+	queue = XCALLOC(MTYPE_TMP, sizeof(*queue));
+	queue->eigrp = eigrp;
+	queue->name = XSTRDUP(MTYPE_TMP, name);
+	queue->workfunc = workfunc;
+	queue->deletefunc = deletefunc;
+	queue->items = list_new();
+
+	if (!sim_work_queues)
+		sim_work_queues = list_new();
+	listnode_add(sim_work_queues, queue);
+	return queue;
+}
+
+void eigrp_work_queue_reset(eigrp_work_queue_t *queue)
+{
+	void *data;
+
+	if (!queue)
+		return;
+
+	while ((data = listnode_head(queue->items))) {
+		listnode_delete(queue->items, data);
+		if (queue->deletefunc)
+			queue->deletefunc(queue, data);
+	}
+}
+
+void eigrp_work_queue_free(eigrp_work_queue_t *queue)
+{
+	if (!queue)
+		return;
+
+	eigrp_work_queue_reset(queue);
+	list_delete(&queue->items);
+	listnode_delete(sim_work_queues, queue);
+	XFREE(MTYPE_TMP, queue->name);
+	XFREE(MTYPE_TMP, queue);
+}
+
+void eigrp_work_queue_enqueue(eigrp_work_queue_t *queue, void *data)
+{
+	if (!queue || !data)
+		return;
+
+	listnode_add(queue->items, data);
+}
+
+eigrp_instance_t *eigrp_work_queue_eigrp(eigrp_work_queue_t *queue)
+{
+	return queue ? queue->eigrp : NULL;
+}
+
+static bool sim_work_run(eigrp_instance_t *eigrp)
+{
+	eigrp_work_queue_t *queue;
+	struct listnode *node;
+	bool busy = false;
+	void *data;
+
+	for (ALL_LIST_ELEMENTS_RO(sim_work_queues, node, queue)) {
+		if (queue->eigrp != eigrp)
+			continue;
+
+		data = listnode_head(queue->items);
+		if (!data)
+			continue;
+
+		switch (queue->workfunc(queue, data)) {
+		case EIGRP_WORK_QUEUE_SUCCESS:
+			listnode_delete(queue->items, data);
+			if (queue->deletefunc)
+				queue->deletefunc(queue, data);
+			busy = true;
+			break;
+		case EIGRP_WORK_QUEUE_REQUEUE:
+			listnode_delete(queue->items, data);
+			listnode_add(queue->items, data);
+			busy = true;
+			break;
+		case EIGRP_WORK_QUEUE_BLOCKED:
+			break;
+		}
+	}
+
+	return busy;
+}
+
+/*
+ * Southbound: the socket.  A datagram socket stands in for the raw one so
+ * the read event eigrp_new() registers has a descriptor; nothing is ever
+ * read from or written to it.
+ */
+int eigrp_sock_init(struct vrf *vrf)
+{
+	return socket(AF_INET, SOCK_DGRAM, 0);
+}
+
+void eigrp_adjust_sndbuflen(eigrp_instance_t *eigrp, unsigned int buflen)
+{
+}
+
+int eigrp_intf_ipmulticast(eigrp_instance_t *top, struct prefix *p,
+			   unsigned int ifindex)
+{
+	return 0;
+}
+
+int eigrp_intf_add_allspfrouters(eigrp_instance_t *top, struct prefix *p,
+				 unsigned int ifindex)
+{
+	return 0;
+}
+
+int eigrp_intf_drop_allspfrouters(eigrp_instance_t *top, struct prefix *p,
+				  unsigned int ifindex)
+{
+	return 0;
+}
+
+/* Route TLVs in a packet, either encoding */
+static uint32_t sim_route_tlvs(const uint8_t *data, uint16_t length)
+{
+	uint16_t offset = EIGRP_HEADER_LEN;
+	uint16_t type, tlv_length;
+	uint32_t count = 0;
+
+	while (offset + EIGRP_TLV_HDR_LENGTH <= length) {
+		type = (data[offset] << 8) | data[offset + 1];
+		tlv_length = (data[offset + 2] << 8) | data[offset + 3];
+		if (tlv_length < EIGRP_TLV_HDR_LENGTH)
+			break;
+
+		if (type == EIGRP_TLV_IPv4_INT || type == EIGRP_TLV_IPv4_EXT
+		    || type == EIGRP_TLV_MP_INT || type == EIGRP_TLV_MP_EXT)
+			count++;
+		offset += tlv_length;
+	}
+
+	return count;
+}
+
+void eigrp_southbound_packet_send(eigrp_instance_t *eigrp,
+				  eigrp_interface_t *ei, eigrp_packet_t *packet)
+{
+	struct eigrp_header *eigrph;
+	struct sim_port *port, *peer;
+	struct sim_link *link;
+	struct sim_msg *msg;
+	uint32_t tlvs;
+
+	port = sim_port_of(ei->ifp);
+	if (!port || !port->link || !port->link->up)
+		return;
+
+	eigrph = (struct eigrp_header *)stream_pnt(packet->s);
+	if (eigrph->opcode == EIGRP_OPC_HELLO && eigrph->ack
+	    && packet->length == EIGRP_HEADER_LEN)
+		sim.c.acks++;
+	else if (eigrph->opcode < SIM_OPC_MAX)
+		sim.c.packets[eigrph->opcode]++;
+	sim.c.bytes += packet->length;
+
+	if (eigrph->opcode == EIGRP_OPC_UPDATE) {
+		tlvs = sim_route_tlvs((const uint8_t *)eigrph, packet->length);
+		if (tlvs > sim.update_tlvs_max)
+			sim.update_tlvs_max = tlvs;
+	}
+
+	link = port->link;
+	peer = link->end[0] == port ? link->end[1] : link->end[0];
+	if (packet->dst.ip.v4.s_addr != htonl(EIGRP_MULTICAST_ADDRESS)
+	    && packet->dst.ip.v4.s_addr != peer->addr.s_addr)
+		return;
+
+	msg = XMALLOC(MTYPE_TMP, sizeof(*msg) + packet->length);
+	msg->at = sim.now + link->delay;
+	msg->seq = sim.seq++;
+	msg->to = peer;
+	msg->src = port->addr;
+	msg->dst = packet->dst.ip.v4;
+	msg->length = packet->length;
+	memcpy(msg->data, eigrph, packet->length);
+	sim_heap_push(msg);
+}
+
+/* Zebra: one table per router, and the time of its last change */
+void eigrp_zebra_route_add(eigrp_instance_t *eigrp, struct prefix *p,
+			   eigrp_route_descriptor_t **successors,
+			   unsigned int paths, uint32_t distance)
+{
+	struct sim_router *r = sim_router_of(eigrp);
+	struct route_node *rn;
+
+	rn = route_node_get(r->rib, p);
+	if (rn->info)
+		route_unlock_node(rn);
+	rn->info = r;
+
+	sim.c.rib++;
+	sim.c.last_rib = sim.now;
+}
+
+void eigrp_zebra_route_delete(eigrp_instance_t *eigrp, struct prefix *p)
+{
+	struct sim_router *r = sim_router_of(eigrp);
+	struct route_node *rn;
+
+	rn = route_node_lookup(r->rib, p);
+	if (!rn)
+		return;
+
+	route_unlock_node(rn);
+	if (rn->info) {
+		rn->info = NULL;
+		route_unlock_node(rn);
+	}
+
+	sim.c.rib++;
+	sim.c.last_rib = sim.now;
+}
+
+void eigrp_zebra_stop(void)
+{
+}
+
+static void sim_heard_forget(struct sim_port *port, struct prefix *p)
+{
+	struct route_node *rn;
+
+	rn = route_node_lookup(port->heard, p);
+	if (!rn)
+		return;
+
+	route_unlock_node(rn);
+	if (rn->info) {
+		rn->info = NULL;
+		route_unlock_node(rn);
+	}
+}
+
+static void sim_heard_clear(struct sim_port *port)
+{
+	struct route_node *rn;
+
+	for (rn = route_top(port->heard); rn; rn = route_next(rn)) {
+		if (rn->info) {
+			rn->info = NULL;
+			route_unlock_node(rn);
+		}
+	}
+}
+
+/*
+ * Decode what a packet carries with the receiver's decoder.  A route an
+ * UPDATE sends as reachable is remembered until the step ends; one sent
+ * unreachable, or taken into a query or reply, is forgotten, as DUAL may
+ * drop it on its own account.
+ */
+static void sim_heard_record(struct sim_port *port, struct sim_msg *msg)
+{
+	struct eigrp_header *eigrph = (struct eigrp_header *)msg->data;
+	eigrp_instance_t *eigrp = port->router->eigrp;
+	eigrp_interface_t *ei = port->ifp->info;
+	eigrp_route_descriptor_t *route;
+	eigrp_neighbor_t *nbr;
+	struct route_node *rn;
+	struct stream *s;
+
+	switch (eigrph->opcode) {
+	case EIGRP_OPC_UPDATE:
+	case EIGRP_OPC_QUERY:
+	case EIGRP_OPC_REPLY:
+	case EIGRP_OPC_SIAQUERY:
+	case EIGRP_OPC_SIAREPLY:
+		break;
+	default:
+		return;
+	}
+
+	nbr = ei ? eigrp_nbr_lookup_by_addr(ei, &msg->src) : NULL;
+	if (!nbr || !nbr->decoder || msg->length <= EIGRP_HEADER_LEN)
+		return;
+
+	s = stream_new(msg->length);
+	stream_put(s, msg->data + EIGRP_HEADER_LEN,
+		   msg->length - EIGRP_HEADER_LEN);
+	while (s->endp > s->getp) {
+		route = (nbr->decoder)(eigrp, nbr, s, msg->length);
+		if (!route)
+			continue;
+
+		if (eigrph->opcode == EIGRP_OPC_UPDATE
+		    && route->metric.delay != EIGRP_MAX_METRIC) {
+			rn = route_node_get(port->heard, &route->dest);
+			if (rn->info)
+				route_unlock_node(rn);
+			rn->info = port;
+		} else {
+			sim_heard_forget(port, &route->dest);
+		}
+		eigrp_topology_route_free(route);
+	}
+	stream_free(s);
+}
+
+/* Routes a port heard that its router's topology does not hold */
+static uint32_t sim_heard_lost(struct sim_port *port)
+{
+	eigrp_instance_t *eigrp = port->router->eigrp;
+	eigrp_interface_t *ei = port->ifp->info;
+	eigrp_prefix_descriptor_t *pe;
+	eigrp_neighbor_t *nbr;
+	struct sim_port *peer;
+	struct route_node *rn;
+	uint32_t lost = 0;
+
+	if (!ei || !port->link->up)
+		return 0;
+
+	peer = port->link->end[0] == port ? port->link->end[1]
+					  : port->link->end[0];
+	nbr = eigrp_nbr_lookup_by_addr(ei, &peer->addr);
+
+	for (rn = route_top(port->heard); rn; rn = route_next(rn)) {
+		if (!rn->info)
+			continue;
+
+		pe = eigrp_topology_table_lookup_ipv4(eigrp->topology_table,
+						      &rn->p);
+		if (!nbr || !pe
+		    || !eigrp_prefix_descriptor_lookup(&pe->routes, nbr))
+			lost++;
+	}
+
+	return lost;
+}
+
+/* Hand a packet to the router at the far end, as eigrp_packet_read would */
+static void sim_deliver(struct sim_msg *msg)
+{
+	struct sim_port *port = msg->to;
+	eigrp_instance_t *eigrp = port->router->eigrp;
+	struct stream *s = eigrp->ibuf;
+	struct ip iph = {};
+
+	sim.c.last_packet = sim.now;
+	if (!port->link->up)
+		return;
+
+	iph.ip_hl = sizeof(iph) >> 2;
+	iph.ip_v = IPVERSION;
+	iph.ip_len = sizeof(iph) + msg->length;
+	iph.ip_ttl = EIGRP_IP_TTL;
+	iph.ip_p = IPPROTO_EIGRPIGP;
+	iph.ip_src = msg->src;
+	iph.ip_dst = msg->dst;
+
+	stream_reset(s);
+	stream_put(s, &iph, sizeof(iph));
+	stream_put(s, msg->data, msg->length);
+	eigrp_packet_input(eigrp, s, port->ifp);
+
+	sim_heard_record(port, msg);
+}
+
+/* Give one router its event loop turn; true if it had anything to do */
+static bool sim_router_run(struct sim_router *r)
+{
+	eigrp_instance_t *eigrp = r->eigrp;
+	bool busy;
+
+	busy = sim_work_run(eigrp);
+
+	if (!eigrp->t_dual_flush)
+		r->flush_at = 0;
+	else if (!r->flush_at)
+		r->flush_at = sim.now + eigrp->dual_flush_delay * 1000ULL;
+	if (eigrp->t_dual_flush && r->flush_at <= sim.now) {
+		r->flush_at = 0;
+		sim_event_fire(&eigrp->t_dual_flush);
+		busy = true;
+	}
+
+	while (eigrp->t_write) {
+		sim_event_fire(&eigrp->t_write);
+		busy = true;
+	}
+
+	if (!eigrp->t_rib_flush)
+		r->rib_at = 0;
+	else if (!r->rib_at)
+		r->rib_at = sim.now
+			    + event_timer_remain_msec(eigrp->t_rib_flush)
+				      * 1000ULL;
+	if (eigrp->t_rib_flush && r->rib_at <= sim.now) {
+		r->rib_at = 0;
+		sim_event_fire(&eigrp->t_rib_flush);
+		busy = true;
+	}
+
+	return busy;
+}
+
+/* Earliest pending flush across routers, or UINT64_MAX */
+static uint64_t sim_flush_next(void)
+{
+	uint64_t next = UINT64_MAX;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		if (sim.routers[i].flush_at && sim.routers[i].flush_at < next)
+			next = sim.routers[i].flush_at;
+		if (sim.routers[i].rib_at && sim.routers[i].rib_at < next)
+			next = sim.routers[i].rib_at;
+	}
+
+	return next;
+}
+
+static void sim_settle(void)
+{
+	bool busy;
+	unsigned int i;
+
+	do {
+		busy = false;
+		for (i = 0; i < sim.nrouters; i++)
+			busy |= sim_router_run(&sim.routers[i]);
+	} while (busy);
+}
+
+static void sim_timer_consider(struct event **ref, struct event ***next,
+			       unsigned long *remain)
+{
+	unsigned long msec;
+
+	if (!*ref)
+		return;
+
+	msec = event_timer_remain_msec(*ref);
+	if (!*next || msec < *remain) {
+		*next = ref;
+		*remain = msec;
+	}
+}
+
+/*
+ * The network is quiet: jump to the earliest retransmission or active
+ * timer still running and fire it.
+ */
+static bool sim_timers_fire(void)
+{
+	struct event **next = NULL;
+	unsigned long remain = 0;
+	eigrp_packet_t *packet;
+	eigrp_interface_t *ei;
+	eigrp_neighbor_t *nbr;
+	struct listnode *node, *node2;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		eigrp_instance_t *eigrp = sim.routers[i].eigrp;
+
+		sim_timer_consider(&eigrp->t_active, &next, &remain);
+		for (ALL_LIST_ELEMENTS_RO(eigrp->eiflist, node, ei)) {
+			for (ALL_LIST_ELEMENTS_RO(ei->nbrs, node2, nbr)) {
+				packet = eigrp_packet_queue_next(nbr->retrans_queue);
+				if (packet)
+					sim_timer_consider(&packet->t_retrans_timer,
+							   &next, &remain);
+				packet = eigrp_packet_queue_next(nbr->multicast_queue);
+				if (packet)
+					sim_timer_consider(&packet->t_retrans_timer,
+							   &next, &remain);
+			}
+		}
+	}
+
+	if (!next)
+		return false;
+
+	sim.now += remain * 1000ULL;
+	sim.c.timers++;
+	sim_event_fire(next);
+	return true;
+}
+
+/* Run until nothing is in flight, due or worth waiting for */
+static void sim_run(void)
+{
+	uint64_t at, flush;
+
+	for (;;) {
+		sim_settle();
+
+		flush = sim_flush_next();
+		if (sim.heap_len && sim.heap[0]->at <= flush) {
+			at = sim.heap[0]->at;
+			sim.now = at;
+			while (sim.heap_len && sim.heap[0]->at == at) {
+				struct sim_msg *msg = sim_heap_pop();
+
+				sim_deliver(msg);
+				XFREE(MTYPE_TMP, msg);
+			}
+			continue;
+		}
+		if (flush != UINT64_MAX) {
+			sim.now = flush;
+			continue;
+		}
+
+		if (sim.c.timers < SIM_TIMERS_MAX && sim_timers_fire())
+			continue;
+		break;
+	}
+}
+
+/* Label routers with the connected component they are in */
+static void sim_components(void)
+{
+	bool changed;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++)
+		sim.routers[i].component = i;
+
+	do {
+		changed = false;
+		for (i = 0; i < sim.nlinks; i++) {
+			struct sim_link *link = &sim.links[i];
+			struct sim_router *a = link->end[0]->router;
+			struct sim_router *b = link->end[1]->router;
+
+			if (!link->up || a->component == b->component)
+				continue;
+			if (a->component < b->component)
+				b->component = a->component;
+			else
+				a->component = b->component;
+			changed = true;
+		}
+	} while (changed);
+}
+
+static void sim_stub_prefix(uint32_t stub, struct prefix *p)
+{
+	memset(p, 0, sizeof(*p));
+	p->family = AF_INET;
+	p->prefixlen = 24;
+	p->u.prefix4.s_addr = htonl(SIM_STUB_NET + (stub << 8));
+}
+
+/*
+ * Every router should have a route to every stub prefix of the routers it
+ * can still reach, and none to those it cannot, and should hold every
+ * route its neighbors sent it.
+ */
+static void sim_check(uint32_t *missing, uint32_t *stale, uint32_t *lost)
+{
+	struct route_node *rn;
+	struct prefix p;
+	unsigned int i, j;
+	uint32_t k;
+
+	*missing = *stale = *lost = 0;
+	sim_components();
+
+	for (i = 0; i < sim.nlinks; i++)
+		for (j = 0; j < 2; j++)
+			*lost += sim_heard_lost(sim.links[i].end[j]);
+
+	for (i = 0; i < sim.nrouters; i++) {
+		struct sim_router *r = &sim.routers[i];
+
+		for (j = 0; j < sim.nrouters; j++) {
+			struct sim_router *s = &sim.routers[j];
+
+			if (r == s)
+				continue;
+
+			for (k = 0; k < sim.prefixes; k++) {
+				sim_stub_prefix(s->stub + k, &p);
+				rn = route_node_lookup(r->rib, &p);
+				if (rn)
+					route_unlock_node(rn);
+
+				if (r->component == s->component
+				    && (!rn || !rn->info))
+					(*missing)++;
+				else if (r->component != s->component && rn
+					 && rn->info)
+					(*stale)++;
+			}
+		}
+	}
+}
+
+static void sim_report_header(void)
+{
+	printf("%-22s %10s %10s %8s %7s %7s %7s %7s %5s %7s %7s %6s %6s %6s %9s\n",
+	       "step", "converge", "quiet", "packets", "update", "query",
+	       "reply", "ack", "sia", "rib", "missing", "stale", "lost",
+	       "active", "cpu");
+}
+
+static void sim_report(const char *label, uint64_t start,
+		       struct timeval *cpu_start)
+{
+	struct timeval now;
+	uint64_t packets = 0;
+	uint32_t missing, stale, lost, active = 0;
+	unsigned int i;
+
+	monotime(&now);
+	for (i = 0; i < SIM_OPC_MAX; i++)
+		packets += sim.c.packets[i];
+	packets += sim.c.acks;
+	for (i = 0; i < sim.nrouters; i++)
+		active += sim.routers[i].eigrp->active_count;
+	sim_check(&missing, &stale, &lost);
+
+	printf("%-22s %7.3f ms %7.3f ms %8" PRIu64 " %7" PRIu64 " %7" PRIu64
+	       " %7" PRIu64 " %7" PRIu64 " %5" PRIu64 " %7" PRIu64
+	       " %7u %6u %6u %6u %6.1f ms\n",
+	       label,
+	       sim.c.last_rib > start ? (sim.c.last_rib - start) / 1000.0 : 0.0,
+	       sim.c.last_packet > start ? (sim.c.last_packet - start) / 1000.0
+					 : 0.0,
+	       packets, sim.c.packets[EIGRP_OPC_UPDATE],
+	       sim.c.packets[EIGRP_OPC_QUERY], sim.c.packets[EIGRP_OPC_REPLY],
+	       sim.c.acks,
+	       sim.c.packets[EIGRP_OPC_SIAQUERY]
+		       + sim.c.packets[EIGRP_OPC_SIAREPLY],
+	       sim.c.rib, missing, stale, lost, active,
+	       timeval_elapsed(now, *cpu_start) / 1000.0);
+
+	if (missing || stale || lost)
+		sim.failed++;
+}
+
+/* Let the routers on both ends of a link hello each other */
+static void sim_link_hello(struct sim_link *link)
+{
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		eigrp_interface_t *ei = link->end[i]->ifp->info;
+
+		if (ei)
+			sim_event_fire(&ei->t_hello);
+	}
+}
+
+static void sim_step_run(const char *label, struct sim_link *link, bool fail)
+{
+	struct timeval cpu_start;
+	uint64_t start;
+	int i;
+
+	memset(&sim.c, 0, sizeof(sim.c));
+	start = sim.now;
+	monotime(&cpu_start);
+
+	for (i = 0; (unsigned int)i < sim.nlinks; i++) {
+		sim_heard_clear(sim.links[i].end[0]);
+		sim_heard_clear(sim.links[i].end[1]);
+	}
+
+	if (!link) {
+		for (i = 0; (unsigned int)i < sim.nlinks; i++)
+			sim_link_hello(&sim.links[i]);
+	} else if (fail && link->up) {
+		link->up = false;
+		for (i = 0; i < 2; i++) {
+			link->end[i]->ifp->flags &= ~(IFF_UP | IFF_RUNNING);
+			eigrp_intf_down(link->end[i]->ifp->info);
+		}
+	} else if (!fail && !link->up) {
+		link->up = true;
+		for (i = 0; i < 2; i++) {
+			link->end[i]->ifp->flags |= IFF_UP | IFF_RUNNING;
+			eigrp_intf_up(link->end[i]->router->eigrp,
+				      link->end[i]->ifp->info);
+		}
+		sim_link_hello(link);
+	}
+
+	sim_run();
+	sim_report(label, start, &cpu_start);
+}
+
+static struct sim_router *sim_router_get(const char *name)
+{
+	struct sim_router *r;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++)
+		if (strcmp(sim.routers[i].name, name) == 0)
+			return &sim.routers[i];
+
+	SIM_GROW(sim.routers, sim.nrouters, sim.routers_max);
+	r = &sim.routers[sim.nrouters++];
+	memset(r, 0, sizeof(*r));
+	strlcpy(r->name, name, sizeof(r->name));
+	r->vrf_id = sim.nrouters;
+	return r;
+}
+
+static int sim_link_find(const char *a, const char *b)
+{
+	unsigned int i;
+
+	for (i = 0; i < sim.nlinks; i++) {
+		const char *x = sim.routers[sim.links[i].router[0]].name;
+		const char *y = sim.routers[sim.links[i].router[1]].name;
+
+		if ((strcmp(x, a) == 0 && strcmp(y, b) == 0)
+		    || (strcmp(x, b) == 0 && strcmp(y, a) == 0))
+			return i;
+	}
+
+	return -1;
+}
+
+static int sim_load(const char *file)
+{
+	char line[SIM_LINE_MAX], word[16];
+	char a[SIM_NAME_LEN], b[SIM_NAME_LEN];
+	unsigned int lineno = 0, delay;
+	struct sim_link *link;
+	FILE *fp;
+	int n, index;
+
+	fp = fopen(file, "r");
+	if (!fp) {
+		fprintf(stderr, "%s: %s\n", file, strerror(errno));
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), fp)) {
+		char *hash = strchr(line, '#');
+
+		lineno++;
+		if (hash)
+			*hash = '\0';
+
+		n = sscanf(line, "%15s %31s %31s %u", word, a, b, &delay);
+		if (n <= 0)
+			continue;
+
+		if (strcmp(word, "prefixes") == 0 && n == 2) {
+			sim.prefixes = strtoul(a, NULL, 10);
+		} else if (strcmp(word, "delay") == 0 && n == 2) {
+			sim.delay = strtoul(a, NULL, 10);
+		} else if (strcmp(word, "link") == 0 && n >= 3) {
+			index = sim_router_get(a) - sim.routers;
+			SIM_GROW(sim.links, sim.nlinks, sim.links_max);
+			link = &sim.links[sim.nlinks++];
+			memset(link, 0, sizeof(*link));
+			link->router[0] = index;
+			link->router[1] = sim_router_get(b) - sim.routers;
+			link->delay = n == 4 ? delay : sim.delay;
+			link->up = true;
+		} else if ((strcmp(word, "fail") == 0
+			    || strcmp(word, "restore") == 0)
+			   && n == 3) {
+			index = sim_link_find(a, b);
+			if (index < 0) {
+				fprintf(stderr, "%s:%u: no link %s %s\n", file,
+					lineno, a, b);
+				fclose(fp);
+				return -1;
+			}
+			SIM_GROW(sim.steps, sim.nsteps, sim.steps_max);
+			sim.steps[sim.nsteps].fail = word[0] == 'f';
+			sim.steps[sim.nsteps++].link = index;
+		} else {
+			fprintf(stderr, "%s:%u: cannot parse: %s", file,
+				lineno, line);
+			fclose(fp);
+			return -1;
+		}
+	}
+	fclose(fp);
+
+	if (sim.nrouters * sim.prefixes > SIM_STUB_MAX) {
+		fprintf(stderr, "%u routers x %u prefixes is more than %u\n",
+			sim.nrouters, sim.prefixes, SIM_STUB_MAX);
+		return -1;
+	}
+
+	return 0;
+}
+
+static struct sim_port *sim_port_add(struct sim_router *r, const char *name,
+				     struct sim_link *link, uint32_t addr,
+				     int plen)
+{
+	struct vrf *vrf = vrf_lookup_by_id(r->vrf_id);
+	struct sim_port *port;
+	struct prefix p = {};
+
+	port = XCALLOC(MTYPE_TMP, sizeof(*port));
+	port->router = r;
+	port->link = link;
+	port->addr.s_addr = htonl(addr);
+	if (link)
+		port->heard = route_table_init();
+
+	port->ifp = if_get_by_name(name, r->vrf_id, vrf->name);
+	SIM_GROW(sim.ports, sim.nports, sim.ports_max);
+	sim.ports[sim.nports++] = port;
+	if_set_index(port->ifp, sim.nports);
+	port->ifp->mtu = 1500;
+	port->ifp->flags = IFF_UP | IFF_RUNNING | IFF_BROADCAST | IFF_MULTICAST;
+
+	p.family = AF_INET;
+	p.prefixlen = plen;
+	p.u.prefix4 = port->addr;
+	connected_add_by_prefix(port->ifp, &p, NULL);
+
+	return port;
+}
+
+/* Interfaces and addresses for every router, then an EIGRP instance each */
+static void sim_build(void)
+{
+	char name[INTERFACE_NAMSIZ];
+	struct prefix net = {};
+	unsigned int i;
+	uint32_t k;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		struct sim_router *r = &sim.routers[i];
+
+		vrf_get(r->vrf_id, r->name);
+		r->rib = route_table_init();
+		r->stub = i * sim.prefixes;
+		for (k = 0; k < sim.prefixes; k++) {
+			snprintf(name, sizeof(name), "stub%u", k);
+			sim_port_add(r, name, NULL,
+				     SIM_STUB_NET + ((r->stub + k) << 8) + 1,
+				     24);
+		}
+	}
+
+	for (i = 0; i < sim.nlinks; i++) {
+		struct sim_link *link = &sim.links[i];
+		uint32_t base = SIM_LINK_NET + (i << 2);
+
+		snprintf(name, sizeof(name), "eth%u", i);
+		link->end[0] = sim_port_add(&sim.routers[link->router[0]], name,
+					    link, base + 1, 30);
+		link->end[1] = sim_port_add(&sim.routers[link->router[1]], name,
+					    link, base + 2, 30);
+	}
+
+	net.family = AF_INET;
+	for (i = 0; i < sim.nrouters; i++) {
+		struct sim_router *r = &sim.routers[i];
+
+		r->eigrp = eigrp_get(SIM_AS, r->vrf_id);
+		eigrp_name_set(r->eigrp, r->name);
+		r->eigrp->router_id_static.s_addr = htonl(SIM_ROUTER_ID + i + 1);
+		if (sim.flush_delay >= 0)
+			r->eigrp->dual_flush_delay = sim.flush_delay;
+
+		net.prefixlen = 8;
+		net.u.prefix4.s_addr = htonl(SIM_LINK_NET);
+		eigrp_network_set(r->eigrp, &net);
+		net.prefixlen = 6;
+		net.u.prefix4.s_addr = htonl(SIM_STUB_NET);
+		eigrp_network_set(r->eigrp, &net);
+	}
+}
+
+static void sim_report_memory(void)
+{
+	struct rusage ru;
+	size_t slabs = 0;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		eigrp_instance_t *eigrp = sim.routers[i].eigrp;
+
+		slabs += eigrp_slab_bytes(&eigrp->prefix_slab)
+			 + eigrp_slab_bytes(&eigrp->route_slab)
+			 + eigrp_slab_bytes(&eigrp->work_slab)
+			 + eigrp_slab_bytes(&eigrp->dual_slab);
+	}
+
+	getrusage(RUSAGE_SELF, &ru);
+	printf("peak RSS %ld KiB, slabs %zu KiB (%zu bytes per router)\n",
+	       ru.ru_maxrss, slabs / 1024, slabs / sim.nrouters);
+}
+
+/*
+ * How much of the TLV building the per-prefix cache took over, and how
+ * full the UPDATE packets were
+ */
+static void sim_report_encode(void)
+{
+	uint64_t hits = 0, misses = 0, dumps = 0, dump_usec = 0;
+	uint64_t packets = 0, bytes = 0, room = 0;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		eigrp_instance_t *eigrp = sim.routers[i].eigrp;
+		eigrp_tlv_cache_stats_t *stats = &eigrp->tlv_cache_stats;
+		eigrp_packetizer_stats_t *update =
+			&eigrp->packetizer_stats[EIGRP_OPC_UPDATE];
+
+		hits += stats->hits;
+		misses += stats->misses;
+		dumps += stats->dumps;
+		dump_usec += stats->dump_usec;
+		packets += update->packets;
+		bytes += update->bytes;
+		room += update->room;
+	}
+
+	printf("route TLVs %" PRIu64 " copied, %" PRIu64
+	       " encoded; %" PRIu64 " full-table updates, %.1f usec each\n",
+	       hits, misses, dumps, dumps ? (double)dump_usec / dumps : 0.0);
+	printf("UPDATE packets %" PRIu64
+	       ", %.1f%% full, at most %u route TLVs in one\n",
+	       packets, room ? 100.0 * bytes / room : 0.0, sim.update_tlvs_max);
+}
+
+/* What reached the fake zebra against what DUAL asked for */
+static void sim_report_rib(void)
+{
+	uint64_t requests = 0, coalesced = 0, installs = 0, withdraws = 0;
+	uint64_t flushes = 0, latency = 0;
+	unsigned int i;
+
+	for (i = 0; i < sim.nrouters; i++) {
+		eigrp_rib_queue_stats_t *stats = &sim.routers[i].eigrp->rib_stats;
+
+		requests += stats->requests;
+		coalesced += stats->coalesced;
+		installs += stats->installs;
+		withdraws += stats->withdraws;
+		flushes += stats->flushes;
+		latency += stats->latency_usec;
+	}
+
+	printf("RIB changes %" PRIu64 " requested, %" PRIu64
+	       " coalesced; %" PRIu64 " installs, %" PRIu64
+	       " withdraws in %" PRIu64 " batches, %.1f usec latency\n",
+	       requests, coalesced, installs, withdraws, flushes,
+	       installs + withdraws
+		       ? (double)latency / (installs + withdraws)
+		       : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+	char label[64];
+	long prefixes = -1;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:f:")) != -1) {
+		switch (opt) {
+		case 'p':
+			prefixes = strtol(optarg, NULL, 10);
+			break;
+		case 'f':
+			sim.flush_delay = atoi(optarg);
+			break;
+		default:
+			optind = argc + 1;
+			break;
+		}
+	}
+	if (optind != argc - 1) {
+		fprintf(stderr,
+			"usage: %s [-p prefixes] [-f flush-msec] topology\n",
+			argv[0]);
+		return 1;
+	}
+
+	if (sim_load(argv[optind]) < 0)
+		return 1;
+	/* -p overrides the file */
+	if (prefixes >= 0)
+		sim.prefixes = prefixes;
+
+	eigrpd_event = event_master_create("eigrp convergence");
+	eigrp_init();
+	eigrp_om->event = eigrpd_event;
+	eigrp_om->master = eigrpd_event;
+	vrf_init(NULL, NULL, NULL, NULL);
+
+	sim_build();
+
+	printf("%u routers, %u links, %u prefixes per router\n", sim.nrouters,
+	       sim.nlinks, sim.prefixes);
+	sim_report_header();
+	sim_step_run("bring-up", NULL, false);
+
+	for (i = 0; i < sim.nsteps; i++) {
+		struct sim_step *step = &sim.steps[i];
+		struct sim_link *link = &sim.links[step->link];
+
+		snprintf(label, sizeof(label), "%s %s-%s",
+			 step->fail ? "fail" : "restore",
+			 sim.routers[link->router[0]].name,
+			 sim.routers[link->router[1]].name);
+		sim_step_run(label, link, step->fail);
+	}
+
+	sim_report_encode();
+	sim_report_rib();
+	sim_report_memory();
+
+	if (sim.failed) {
+		fprintf(stderr,
+			"%u of %u steps left prefixes missing, stale or lost\n",
+			sim.failed, sim.nsteps + 1);
+		return 1;
+	}
+	return 0;
+}
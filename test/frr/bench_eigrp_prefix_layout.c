@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP prefix descriptor footprint report.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Builds a table of passive, single-path prefixes twice: once with the
+ * prefix descriptor layout eigrpd used to have (heap destination, rij list
+ * per prefix, extTLV pointer) and once with eigrp_prefix_descriptor_t as
+ * it is now.  Descriptors come from an eigrp_slab_t like they do in the
+ * daemon, so the per-prefix figure includes slab overhead.  Side
+ * allocations are counted at their requested size; malloc overhead on top
+ * of that only widens the gap.
+ *
+ *   tests/eigrpd/bench_eigrp_prefix_layout [prefixes]
+ */
+#include <zebra.h>
+
+#include "linklist.h"
+#include "memory.h"
+#include "monotime.h"
+#include "prefix.h"
+
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_slab.h"
+#include "eigrpd/eigrp_topology.h"
+
+DEFINE_MGROUP(EIGRPD, "eigrpd");
+
+/* The route vector before the heap pointer shared the inline slots. */
+struct bench_legacy_vec {
+	uint16_t count;
+	uint16_t size;
+	eigrp_route_descriptor_t **heap;
+	eigrp_route_descriptor_t *slot[EIGRP_ROUTE_VEC_INLINE];
+};
+
+/* The prefix descriptor as it was laid out before the compaction. */
+struct bench_legacy_prefix {
+	struct bench_legacy_vec routes;
+	struct bench_legacy_vec feasible;
+	struct list *rij;
+	struct prefix *destination;
+
+	eigrp_metrics_t reported_metric;
+	uint32_t fdistance;
+	uint32_t rdistance;
+	uint32_t distance;
+
+	uint8_t nt;
+	uint8_t state;
+	uint8_t req_action;
+	uint16_t nsuccessor;
+
+	struct {
+		struct bench_legacy_prefix *prev;
+		struct bench_legacy_prefix *next;
+	} dirty[EIGRP_DIRTY_MAX];
+
+	struct TLV_IPv4_External_type *extTLV;
+
+	uint64_t serno;
+};
+
+struct bench_result {
+	size_t descriptor;
+	size_t side;
+	size_t slab;
+	double rate;
+};
+
+static double bench_rate(struct timeval *start, unsigned long count)
+{
+	struct timeval now;
+	int64_t usec;
+
+	monotime(&now);
+	usec = timeval_elapsed(now, *start);
+	if (usec <= 0)
+		usec = 1;
+
+	return (double)count * 1000000.0 / usec;
+}
+
+static void bench_dest(struct prefix *p, int n)
+{
+	p->family = AF_INET;
+	p->prefixlen = 24;
+	p->u.prefix4.s_addr = htonl(0x0a000000 | ((uint32_t)n << 8));
+}
+
+static void bench_legacy(int prefixes, struct bench_result *res)
+{
+	struct bench_legacy_prefix **table;
+	struct bench_legacy_prefix *pe;
+	eigrp_slab_t slab;
+	struct timeval start;
+	int n;
+
+	table = XCALLOC(MTYPE_TMP, prefixes * sizeof(*table));
+	eigrp_slab_init(&slab, "legacy prefix", sizeof(*pe));
+
+	monotime(&start);
+	for (n = 0; n < prefixes; n++) {
+		pe = eigrp_slab_obj_create(&slab);
+		pe->routes.size = pe->feasible.size = EIGRP_ROUTE_VEC_INLINE;
+		pe->rij = list_new();
+		pe->destination = (struct prefix *)prefix_ipv4_new();
+		bench_dest(pe->destination, n);
+		pe->distance = pe->fdistance = pe->rdistance = EIGRP_MAX_METRIC;
+		table[n] = pe;
+	}
+	res->rate = bench_rate(&start, prefixes);
+
+	/* prefix_ipv4_new() hands out a full struct prefix */
+	res->descriptor = sizeof(*pe);
+	res->side = sizeof(struct prefix) + sizeof(struct list);
+	res->slab = eigrp_slab_bytes(&slab) / prefixes;
+
+	for (n = 0; n < prefixes; n++) {
+		pe = table[n];
+		list_delete(&pe->rij);
+		prefix_free(&pe->destination);
+		eigrp_slab_obj_free(pe);
+	}
+	eigrp_slab_fini(&slab);
+	XFREE(MTYPE_TMP, table);
+}
+
+static void bench_compact(int prefixes, struct bench_result *res)
+{
+	eigrp_prefix_descriptor_t **table;
+	eigrp_prefix_descriptor_t *pe;
+	eigrp_slab_t slab;
+	struct timeval start;
+	int n;
+
+	table = XCALLOC(MTYPE_TMP, prefixes * sizeof(*table));
+	eigrp_slab_init(&slab, "prefix", sizeof(*pe));
+
+	monotime(&start);
+	for (n = 0; n < prefixes; n++) {
+		pe = eigrp_slab_obj_create(&slab);
+		eigrp_route_vec_init(&pe->routes);
+		eigrp_route_vec_init(&pe->feasible);
+		bench_dest(eigrp_topology_prefix_dest(pe), n);
+		pe->distance = pe->fdistance = pe->rdistance = EIGRP_MAX_METRIC;
+		table[n] = pe;
+	}
+	res->rate = bench_rate(&start, prefixes);
+
+	res->descriptor = sizeof(*pe);
+	res->side = 0;
+	res->slab = eigrp_slab_bytes(&slab) / prefixes;
+
+	for (n = 0; n < prefixes; n++)
+		eigrp_slab_obj_free(table[n]);
+	eigrp_slab_fini(&slab);
+	XFREE(MTYPE_TMP, table);
+}
+
+static void bench_print(const char *name, int prefixes,
+			struct bench_result *res)
+{
+	size_t total = res->slab + res->side;
+
+	printf("%-8s %10zu %10zu %10zu %10zu %10.1f %12.0f\n", name,
+	       res->descriptor, res->slab, res->side, total,
+	       (double)total * prefixes / (1024.0 * 1024.0), res->rate);
+}
+
+int main(int argc, char **argv)
+{
+	struct bench_result before, after;
+	int prefixes = 1000000;
+
+	if (argc > 1)
+		prefixes = atoi(argv[1]);
+	if (prefixes <= 0) {
+		fprintf(stderr, "usage: %s [prefixes]\n", argv[0]);
+		return 1;
+	}
+
+	bench_legacy(prefixes, &before);
+	bench_compact(prefixes, &after);
+
+	printf("%d passive single-path prefixes\n", prefixes);
+	printf("%-8s %10s %10s %10s %10s %10s %12s\n", "layout", "sizeof",
+	       "slab B", "side B", "B/pfx", "total MB", "create/s");
+	bench_print("before", prefixes, &before);
+	bench_print("after", prefixes, &after);
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * EIGRP per-prefix route storage benchmark.
+ * Copyright (C) 2026 Donnie V. Savage
+ *
+ * Compares the struct list the prefix descriptor used to keep its paths
+ * in against eigrp_route_vec_t.  For each path count it reports the extra
+ * bytes per prefix spent on the container and the rate of distance
+ * updates (change a distance, re-order the paths) per second.
+ *
+ *   tests/eigrpd/bench_eigrp_route_vec [prefixes] [updates]
+ */
+#include <zebra.h>
+
+#include "linklist.h"
+#include "memory.h"
+#include "monotime.h"
+
+#include "eigrpd/eigrpd.h"
+#include "eigrpd/eigrp_structs.h"
+#include "eigrpd/eigrp_route_vec.h"
+
+DEFINE_MGROUP(EIGRPD, "eigrpd");
+
+#define BENCH_PATHS_MAX 8
+
+struct bench_list_prefix {
+	struct list *entries;
+};
+
+static int bench_list_cmp(eigrp_route_descriptor_t *a,
+			  eigrp_route_descriptor_t *b)
+{
+	if (a->distance < b->distance)
+		return -1;
+	if (a->distance > b->distance)
+		return 1;
+
+	return 0;
+}
+
+static uint32_t bench_rand(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) & 0xffffff;
+}
+
+static double bench_rate(struct timeval *start, unsigned long count)
+{
+	struct timeval now;
+	int64_t usec;
+
+	monotime(&now);
+	usec = timeval_elapsed(now, *start);
+	if (usec <= 0)
+		usec = 1;
+
+	return (double)count * 1000000.0 / usec;
+}
+
+static size_t bench_list_bytes(int paths)
+{
+	return sizeof(struct list) + paths * sizeof(struct listnode);
+}
+
+static size_t bench_vec_bytes(int paths)
+{
+	size_t bytes = sizeof(eigrp_route_vec_t);
+	int size = EIGRP_ROUTE_VEC_INLINE;
+
+	if (paths <= EIGRP_ROUTE_VEC_INLINE)
+		return bytes;
+
+	while (size < paths)
+		size *= 2;
+
+	return bytes + size * sizeof(eigrp_route_descriptor_t *);
+}
+
+static void bench_run(eigrp_route_descriptor_t *routes, int prefixes,
+		      int paths, unsigned long updates)
+{
+	struct bench_list_prefix *lp;
+	eigrp_route_vec_t *vp;
+	eigrp_route_descriptor_t *route;
+	struct timeval start;
+	double list_rate, vec_rate;
+	uint32_t seed;
+	unsigned long n;
+	int p, i;
+
+	lp = XCALLOC(MTYPE_TMP, prefixes * sizeof(*lp));
+	vp = XCALLOC(MTYPE_TMP, prefixes * sizeof(*vp));
+
+	for (p = 0; p < prefixes; p++) {
+		lp[p].entries = list_new();
+		lp[p].entries->cmp = (int (*)(void *, void *))bench_list_cmp;
+		eigrp_route_vec_init(&vp[p]);
+
+		for (i = 0; i < paths; i++) {
+			route = &routes[p * paths + i];
+			route->distance = 1000 + i * 100;
+			listnode_add_sort(lp[p].entries, route);
+			eigrp_route_vec_insert(&vp[p], route);
+		}
+	}
+
+	seed = 1;
+	monotime(&start);
+	for (n = 0; n < updates; n++) {
+		p = bench_rand(&seed) % prefixes;
+		route = &routes[p * paths + bench_rand(&seed) % paths];
+		route->distance = 1000 + bench_rand(&seed) % 4096;
+		listnode_delete(lp[p].entries, route);
+		listnode_add_sort(lp[p].entries, route);
+	}
+	list_rate = bench_rate(&start, updates);
+
+	seed = 1;
+	monotime(&start);
+	for (n = 0; n < updates; n++) {
+		p = bench_rand(&seed) % prefixes;
+		route = &routes[p * paths + bench_rand(&seed) % paths];
+		route->distance = 1000 + bench_rand(&seed) % 4096;
+		eigrp_route_vec_resort(&vp[p], route);
+	}
+	vec_rate = bench_rate(&start, updates);
+
+	printf("%5d %12zu %12zu %14.0f %14.0f\n", paths,
+	       bench_list_bytes(paths), bench_vec_bytes(paths), list_rate,
+	       vec_rate);
+
+	for (p = 0; p < prefixes; p++) {
+		list_delete(&lp[p].entries);
+		eigrp_route_vec_fini(&vp[p]);
+	}
+	XFREE(MTYPE_TMP, lp);
+	XFREE(MTYPE_TMP, vp);
+}
+
+int main(int argc, char **argv)
+{
+	eigrp_route_descriptor_t *routes;
+	unsigned long updates = 1000000;
+	int prefixes = 10000;
+	int paths;
+
+	if (argc > 1)
+		prefixes = atoi(argv[1]);
+	if (argc > 2)
+		updates = strtoul(argv[2], NULL, 10);
+	if (prefixes <= 0 || updates == 0) {
+		fprintf(stderr, "usage: %s [prefixes] [updates]\n", argv[0]);
+		return 1;
+	}
+
+	routes = XCALLOC(MTYPE_TMP,
+			 prefixes * BENCH_PATHS_MAX * sizeof(*routes));
+
+	printf("%d prefixes, %lu updates per run\n", prefixes, updates);
+	printf("%5s %12s %12s %14s %14s\n", "paths", "list B/pfx",
+	       "vec B/pfx", "list upd/s", "vec upd/s");
+
+	for (paths = 1; paths <= BENCH_PATHS_MAX; paths++)
+		bench_run(routes, prefixes, paths, updates);
+
+	XFREE(MTYPE_TMP, routes);
+	return 0;
+}
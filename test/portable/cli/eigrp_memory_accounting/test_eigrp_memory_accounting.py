@@ -0,0 +1,69 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for show memory accounting.  Packet queues keep their
+# byte totals and high-water marks as packets move, route counts follow the
+# per-interface index, and the command takes detail and json.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_packet_queues_track_bytes_and_peaks():
+    packet = read("eigrp_packet.c")
+
+    enqueue = function_body(packet, "eigrp_packet_enqueue")
+    assert "->bytes += " in enqueue
+    assert "count_peak" in enqueue
+    assert "bytes_peak" in enqueue
+
+    assert "->bytes -= " in function_body(packet, "eigrp_packet_dequeue")
+
+
+def test_route_counts_follow_the_interface_index():
+    topology = read("eigrp_topology.c")
+
+    link = function_body(topology, "eigrp_topology_intf_link")
+    assert "route_peak" in link
+    assert "++nbr->route_count" in link
+
+    assert "->route_count--" in function_body(topology, "eigrp_topology_intf_unlink")
+
+
+def test_memory_command_takes_detail_and_json():
+    vty = read("eigrp_vty.c")
+
+    assert re.search(r'"show eigrp address-family [^"]* memory \[detail\]\$detail \[json\]\$json"', vty)
+    body = function_body(vty, "show_eigrp_memory_cb")
+    assert "ctx->json" in body
+
+
+def test_only_detail_walks_the_topology():
+    body = function_body(read("eigrp_dump.c"), "eigrp_memory_dump")
+
+    assert "route_top(" not in body
+    assert re.search(r"if \(detail\)\s*side = eigrp_topology_side_bytes\(eigrp\);", body)
@@ -0,0 +1,106 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the active timer.  ACTIVE prefixes sit on one
+# deadline-ordered queue served by a single instance timer, SIA packets
+# are answered without running DUAL, and only silent neighbors are reset.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_fsm_starts_and_stops_the_timer():
+    fsm = read("eigrp_fsm.c")
+
+    for name in ("eigrp_fsm_event_nq_fcn", "eigrp_fsm_event_q_fcn", "eigrp_fsm_event_lr_fcn"):
+        assert "eigrp_active_start(eigrp, prefix);" in function_body(fsm, name)
+    for name in ("eigrp_fsm_event_lr", "eigrp_fsm_event_lr_fcs"):
+        assert "eigrp_active_stop(eigrp, prefix);" in function_body(fsm, name)
+
+    delete = function_body(read("eigrp_topology.c"), "eigrp_prefix_descriptor_delete")
+    assert "eigrp_active_stop(eigrp, pe);" in delete
+
+
+def test_one_instance_timer_serves_the_queue():
+    active = read("eigrp_active.c")
+
+    assert "event_add_timer_msec(" in function_body(active, "eigrp_active_schedule")
+    assert active.count("event_add_timer") == 1
+
+    body = function_body(active, "eigrp_active_event")
+    assert "active->deadline <= now" in body
+    assert body.index("eigrp_active_schedule(eigrp);") < body.index(
+        "eigrp_active_reset(eigrp, nbr);"
+    )
+
+
+def test_sia_packets_are_not_dual_input():
+    for name, function in (
+        ("eigrp_siaquery.c", "eigrp_siaquery_receive"),
+        ("eigrp_siareply.c", "eigrp_siareply_receive"),
+    ):
+        assert "eigrp_fsm_event(" not in function_body(read(name), function)
+
+    query = function_body(read("eigrp_siaquery.c"), "eigrp_siaquery_receive")
+    assert "eigrp_siareply_send(eigrp, nbr, prefix);" in query
+
+    reply = function_body(read("eigrp_siareply.c"), "eigrp_siareply_receive")
+    assert "eigrp_active_sia_reply(eigrp, prefix, nbr);" in reply
+
+
+def test_only_silent_neighbors_are_reset():
+    body = function_body(read("eigrp_active.c"), "eigrp_active_expire")
+
+    assert "EIGRP_SIA_QUERY_MAX" in body
+    assert "eigrp_siaquery_send(eigrp, nbr, pe);" in body
+    assert "eigrp_nbr_delete(" not in body
+
+
+def test_neighbor_down_releases_active_prefixes():
+    down = function_body(read("eigrp_topology.c"), "eigrp_topology_neighbor_down")
+    assert down.index("eigrp_dual_queue_enqueue(") < down.index(
+        "eigrp_active_neighbor_down(eigrp, nbr);"
+    )
+
+    active = read("eigrp_active.c")
+    body = function_body(active, "eigrp_active_neighbor_down")
+    assert "eigrp_topology_rij_remove(pe, nbr);" in body
+    assert "eigrp_dual_queue_enqueue(eigrp, nbr, pe, NULL," in body
+    assert "msg.packet_type = EIGRP_OPC_REPLY;" in function_body(
+        active, "eigrp_active_replied"
+    )
+
+
+def test_active_time_is_configurable_and_shown():
+    northbound = read("eigrp_northbound.c")
+
+    assert "eigrp_active_time_set(" in function_body(northbound, "eigrpd_instance_active_time_modify")
+    assert "EIGRP_ACTIVE_TIME_DEFAULT" in function_body(northbound, "eigrpd_instance_active_time_destroy")
+
+    timer = function_body(read("eigrp_vty.c"), "show_eigrp_timer_cb")
+    assert "eigrp_active_dump(vty, eigrp);" in timer
+    assert "active_hist" in function_body(read("eigrp_dump.c"), "eigrp_active_dump")
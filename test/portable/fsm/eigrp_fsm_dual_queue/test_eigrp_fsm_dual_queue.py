@@ -0,0 +1,164 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the DUAL input queue.  The receive paths only
+# decode; DUAL runs from a work queue in time slices, and waiting input
+# goes away with its prefix or its neighbor.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_receive_paths_queue_dual_input():
+    for name, function, opcode in (
+        ("eigrp_update.c", "eigrp_update_receive", "EIGRP_OPC_UPDATE"),
+        ("eigrp_query.c", "eigrp_query_receive", "EIGRP_OPC_QUERY"),
+        ("eigrp_reply.c", "eigrp_reply_receive", "EIGRP_OPC_REPLY"),
+    ):
+        body = function_body(read(name), function)
+        assert "eigrp_dual_queue_enqueue(" in body
+        assert opcode in body
+        assert "eigrp_fsm_event(" not in body
+
+
+def test_every_tlv_of_an_update_is_queued():
+    body = function_body(read("eigrp_update.c"), "eigrp_update_receive")
+    loop = body[body.index("while (pkt->endp > pkt->getp) {") :]
+    loop = loop[: loop.index("if (graceful_restart_final)")]
+
+    # one event per decoded TLV: nothing leaves the loop before the end
+    assert loop.index("(nbr->decoder)(") < loop.index(
+        "eigrp_dual_queue_enqueue(eigrp, nbr, prefix, route,"
+    )
+    assert "break;" not in loop
+    assert "return" not in loop
+
+    # the other receive paths read to the end of the packet as well
+    for name, function in (
+        ("eigrp_query.c", "eigrp_query_receive"),
+        ("eigrp_reply.c", "eigrp_reply_receive"),
+        ("eigrp_siaquery.c", "eigrp_siaquery_receive"),
+    ):
+        body = function_body(read(name), function)
+        assert "while (pkt->endp > pkt->getp) {" in body
+
+
+def test_dual_input_runs_in_time_slices():
+    queue = read("eigrp_dual_queue.c")
+    run = function_body(queue, "eigrp_dual_queue_run")
+
+    assert "EIGRP_DUAL_QUEUE_SLICE_USEC" in run
+    assert "EIGRP_DUAL_QUEUE_CHECK" not in run
+    loop = run[run.index("while ((ev = eigrp->dual_head)) {") :]
+    assert loop.index("now = eigrp_dual_queue_now();") < loop.index(
+        "latency = now > ev->queued"
+    )
+    assert "return EIGRP_WORK_QUEUE_REQUEUE;" in run
+    assert "eigrp_packetizer_flush(eigrp, exception);" in run
+
+    enqueue = function_body(queue, "eigrp_dual_queue_enqueue")
+    assert "ev->opcode == opcode" in enqueue
+    assert "stats->coalesced++;" in enqueue
+
+
+def test_merged_input_keeps_arrival_order():
+    enqueue = function_body(read("eigrp_dual_queue.c"), "eigrp_dual_queue_enqueue")
+    merge = enqueue[enqueue.index("ev->route = route;") : enqueue.index("stats->coalesced++;")]
+    assert merge.index("eigrp_dual_queue_remove(eigrp, ev);") < merge.index(
+        "eigrp_dual_queue_append(eigrp, ev);"
+    )
+    assert "pe->dual = ev;" in merge
+
+
+def test_waiting_input_goes_with_its_prefix_and_neighbor():
+    topology = read("eigrp_topology.c")
+
+    delete = function_body(topology, "eigrp_prefix_descriptor_delete")
+    assert "eigrp_dual_queue_prefix_purge(eigrp, pe);" in delete
+
+    down = function_body(topology, "eigrp_topology_neighbor_down")
+    assert down.index("eigrp_dual_queue_neighbor_down(eigrp, nbr);") < down.index(
+        "eigrp_dual_queue_enqueue(eigrp, nbr, set[i], NULL,"
+    )
+
+    finish = function_body(read("eigrpd.c"), "eigrp_finish_final")
+    assert finish.index("eigrp_nbr_delete(nbr);") < finish.index(
+        "eigrp_dual_queue_fini(eigrp);"
+    )
+
+
+def test_neighbor_down_is_queued():
+    topology = read("eigrp_topology.c")
+    down = function_body(topology, "eigrp_topology_neighbor_down")
+    assert "eigrp_fsm_event(" not in down
+    assert "eigrp_fsm_event(&msg);" in function_body(
+        topology, "eigrp_topology_neighbor_withdraw"
+    )
+
+    active = read("eigrp_active.c")
+    assert "eigrp_fsm_event(" not in function_body(active, "eigrp_active_neighbor_down")
+    assert "EIGRP_OPC_REPLY);" in function_body(active, "eigrp_active_neighbor_down")
+    replied = function_body(active, "eigrp_active_replied")
+    assert replied.index("eigrp_topology_rij_count(pe)") < replied.index(
+        "eigrp_fsm_event(&msg);"
+    )
+
+    queue = read("eigrp_dual_queue.c")
+    run = function_body(queue, "eigrp_dual_event_run")
+    assert "eigrp_active_replied(eigrp, ev->prefix);" in run
+    assert "eigrp_topology_neighbor_withdraw(eigrp, ev->nbr," in run
+    assert "ev->route && route && ev->opcode == opcode" in function_body(
+        queue, "eigrp_dual_queue_enqueue"
+    )
+
+
+def test_deleted_neighbor_waits_for_its_events():
+    neighbor = read("eigrp_neighbor.c")
+    delete = function_body(neighbor, "eigrp_nbr_delete")
+    assert delete.index("if (nbr->dual_pending) {") < delete.index(
+        "eigrp_nbr_release(nbr);"
+    )
+    assert "nbr->deleted = true;" in delete
+
+    free = function_body(read("eigrp_dual_queue.c"), "eigrp_dual_event_free")
+    assert "nbr->deleted && !nbr->dual_pending" in free
+    assert free.index("eigrp_slab_obj_free(ev);") < free.index("eigrp_nbr_release(nbr);")
+
+    enqueue = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_enqueue")
+    assert "work->nbr->deleted" in enqueue
+
+    intf = function_body(read("eigrp_interface.c"), "eigrp_intf_free")
+    assert intf.index("eigrp_intf_down(ei);") < intf.index(
+        "eigrp_dual_queue_drain(eigrp);"
+    )
+
+
+def test_topology_summary_shows_queue_latency():
+    dump = read("eigrp_dump.c")
+    body = function_body(dump, "eigrp_dual_queue_dump")
+    assert "latency" in body
+    assert "eigrp_dual_queue_dump(vty, eigrp);" in dump
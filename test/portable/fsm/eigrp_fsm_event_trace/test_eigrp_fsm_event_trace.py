@@ -0,0 +1,83 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the DUAL event ring.  Every DUAL event is
+# recorded in binary form, text logging of events needs "debug eigrp
+# event", and the ring is shown by the events command.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_fsm_events_are_recorded_not_logged():
+    fsm = read("eigrp_fsm.c")
+    body = function_body(fsm, "eigrp_fsm_event")
+
+    assert "eigrp_fsm_trace_end(eigrp, &entry);" in body
+    assert "if (IS_DEBUG_EIGRP_EVENT)" in body
+    assert "zlog_info(" not in fsm
+
+
+def test_trace_does_not_read_the_prefix_after_the_handler():
+    body = function_body(read("eigrp_fsm.c"), "eigrp_fsm_event")
+    handler = body.index("(*(NSM[old_state][event].func))(msg);")
+
+    assert body.index("eigrp_fsm_trace_begin(msg, event, &entry);") < handler
+    assert "msg->" not in body[handler + len("(*(NSM[old_state][event].func))(msg);") :]
+
+    # a deleted prefix clears the in-flight slot; no table lookup per event
+    begin = function_body(read("eigrp_fsm.c"), "eigrp_fsm_trace_begin")
+    assert "fsm_trace->running = msg->prefix;" in begin
+    end = function_body(read("eigrp_fsm.c"), "eigrp_fsm_trace_end")
+    assert "prefix = trace->running;" in end
+    assert "trace->running = NULL;" in end
+    assert "lookup" not in end
+    assert "EIGRP_FSM_STATE_PASSIVE" in end
+
+    delete = function_body(read("eigrp_topology.c"), "eigrp_prefix_descriptor_delete")
+    assert "eigrp->fsm_trace->running == pe" in delete
+
+
+def test_ring_size_is_a_power_of_two():
+    const = read("eigrp_const.h")
+    size = int(re.search(r"#define EIGRP_FSM_TRACE_SIZE (\d+)", const).group(1))
+
+    assert size and size & (size - 1) == 0
+    body = function_body(read("eigrp_fsm.c"), "eigrp_fsm_trace_end")
+    assert "trace->head++ & (EIGRP_FSM_TRACE_SIZE - 1)" in body
+    assert "zlog" not in body
+
+
+def test_events_command_filters_and_limits():
+    vty = read("eigrp_vty.c")
+
+    assert re.search(
+        r'"show eigrp address-family [^"]* events \[prefix A\.B\.C\.D/M\$prefix\] '
+        r'\[last \(1-4096\)\$last\] \[json\]\$json"',
+        vty,
+    )
+    assert "show_eigrp_stub(vty, \"show eigrp address-family events\")" not in vty
@@ -0,0 +1,87 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for neighbor bring-up admission control.  A new
+# adjacency must go through the bring-up scheduler instead of sending its
+# INIT update directly from the hello path.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_hello_path_admits_new_neighbors_through_bringup_scheduler():
+    body = function_body(read("eigrp_hello.c"), "eigrp_hello_parameter_decode")
+
+    assert "eigrp_nbr_bringup_start(nbr);" in body
+    assert "eigrp_update_send_init" not in body
+
+
+def test_queued_neighbor_init_is_not_answered_before_admission():
+    body = function_body(read("eigrp_update.c"), "eigrp_update_receive")
+
+    assert "nbr->bringup != EIGRP_BRINGUP_QUEUED" in body
+
+
+def test_sync_slot_is_released_when_eot_dump_is_acked():
+    body = function_body(read("eigrp_packet.c"), "eigrp_packet_ack")
+
+    assert "eigrp_nbr_bringup_finish(nbr);" in body
+
+
+def test_neighbor_down_releases_bringup_slot():
+    body = function_body(read("eigrp_neighbor.c"), "eigrp_nbr_state_set")
+
+    assert "eigrp_nbr_bringup_clear(nbr);" in body
+
+
+def test_bringup_limits_have_instance_and_interface_defaults():
+    assert "eigrp->bringup_max = EIGRP_BRINGUP_MAX_DEFAULT;" in read("eigrpd.c")
+    assert (
+        "ei->params.bringup_max = EIGRP_INTF_BRINGUP_MAX_DEFAULT;"
+        in read("eigrp_interface.c")
+    )
+
+
+def test_bringup_limits_are_configurable():
+    cli = read("eigrp_cli.c")
+    assert '"bring-up max (0-65535)"' in cli
+    assert '"no bring-up max [(0-65535)]"' in cli
+    assert "install_element(EIGRP_NODE, &eigrp_bringup_max_cmd);" in cli
+    assert "install_element(EIGRP_NODE, &no_eigrp_bringup_max_cmd);" in cli
+
+    set_ = function_body(cli, "eigrp_cli_bringup_set")
+    assert "eigrp->bringup_max = max" in set_
+    assert "ei->params.bringup_max = max" in set_
+    assert "EIGRP_BRINGUP_MAX_DEFAULT" in set_
+    assert "EIGRP_INTF_BRINGUP_MAX_DEFAULT" in set_
+    assert "eigrp_nbr_bringup_resume(eigrp);" in set_
+
+    header = function_body(cli, "eigrp_cli_show_end_header")
+    assert '"  bring-up max %u\\n"' in header
+    intf = function_body(cli, "eigrp_cli_show_named_af_interfaces")
+    assert '"   bring-up max %u\\n"' in intf
+    assert "ei->params.bringup_max == EIGRP_INTF_BRINGUP_MAX_DEFAULT" in intf
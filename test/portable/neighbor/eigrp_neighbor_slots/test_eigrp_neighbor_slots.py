@@ -0,0 +1,72 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for neighbor slots.  Neighbors hold a dense slot for
+# their lifetime, replies outstanding are a bitset over those slots, and
+# each neighbor counts the prefixes still waiting on it.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_slot_follows_the_neighbor_lifetime():
+    neighbor = read("eigrp_neighbor.c")
+
+    assert "eigrp_nbr_slot_alloc(ei->eigrp, nbr);" in function_body(neighbor, "eigrp_nbr_create")
+
+    delete = function_body(neighbor, "eigrp_nbr_delete")
+    assert delete.index("eigrp_topology_neighbor_down(") < delete.index(
+        "eigrp_nbr_slot_release("
+    )
+
+
+def test_reply_tracking_is_a_bitset():
+    structs = read("eigrp_structs.h")
+    assert "eigrp_nbr_set_t rij;" in structs
+    assert "struct list *rij" not in structs
+
+    topology = read("eigrp_topology.c")
+    for name in ("eigrp_topology_rij_add", "eigrp_topology_rij_remove"):
+        body = function_body(topology, name)
+        assert "listnode" not in body
+        assert "nbr->rij_pending" in body
+
+
+def test_last_reply_is_a_popcount():
+    header = read("eigrp_nbr_set.h")
+
+    assert "__builtin_popcountll(" in function_body(header, "eigrp_nbr_set_count")
+    assert "eigrp_nbr_set_count(&pe->rij)" in function_body(
+        read("eigrp_topology.h"), "eigrp_topology_rij_count"
+    )
+
+
+def test_neighbor_down_stops_when_nothing_is_owed():
+    body = function_body(read("eigrp_active.c"), "eigrp_active_neighbor_down")
+
+    assert re.search(r"active && nbr->rij_pending;", body)
+    assert "eigrp_topology_rij_purge(eigrp, nbr);" in body
@@ -0,0 +1,75 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for stub routing.  A stub announces itself in the
+# hello Stub TLV and advertises only its own routes of the configured
+# types; a hub never puts a QUERY to a stub neighbor.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_stub_tlv_is_in_every_hello():
+    const = read("eigrp_const.h")
+    assert re.search(r"#define EIGRP_TLV_STUB\s+\(EIGRP_TLV_GENERAL \| 0x0006\)", const)
+
+    hello = read("eigrp_hello.c")
+    assert "eigrp_stub_encode(ei->eigrp, packet->s);" in function_body(hello, "eigrp_hello_encode")
+
+    receive = function_body(hello, "eigrp_hello_receive")
+    assert "case EIGRP_TLV_STUB:" in receive
+    assert "nbr->stub = 0;" in receive
+
+
+def test_hub_does_not_query_stubs():
+    packetizer = read("eigrp_packetizer.c")
+    body = function_body(packetizer, "eigrp_packetizer_query_interface_send")
+
+    assert "nbr->state == EIGRP_NEIGHBOR_UP && !nbr->stub" in body
+    assert "eigrp_topology_rij_add(prefix, nbr);" in body
+    assert "query_stats.neighbors += queried;" in body
+
+    send = function_body(packetizer, "eigrp_packetizer_query_packet_send")
+    assert "nbr->state != EIGRP_NEIGHBOR_UP || nbr->stub" in send
+
+
+def test_stub_filters_what_it_advertises():
+    update = read("eigrp_update.c")
+    for name in ("eigrp_update_send", "eigrp_update_send_EOT", "eigrp_update_send_GR_part"):
+        assert "eigrp_stub_advertise(eigrp, route)" in function_body(update, name)
+
+    reply = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_neighbor_route_send")
+    assert "!eigrp_stub_advertise(eigrp, route)" in reply
+
+    advertise = function_body(read("eigrp_stub.c"), "eigrp_stub_advertise")
+    assert "EIGRP_STUB_RECVONLY" in advertise
+    assert "route->adv_router != eigrp->neighbor_self" in advertise
+
+
+def test_query_scope_is_shown():
+    body = function_body(read("eigrp_dump.c"), "eigrp_topology_summary_dump")
+    assert "eigrp_query_scope_dump(vty, eigrp);" in body
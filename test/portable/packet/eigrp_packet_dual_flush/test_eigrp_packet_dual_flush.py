@@ -0,0 +1,69 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for DUAL output coalescing.  Receive paths and
+# topology events schedule one flush per instance instead of packetizing
+# the dirty queues themselves, and the flush records its batch sizes.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_dual_output_goes_through_the_flush():
+    for name, function in (
+        ("eigrp_update.c", "eigrp_update_receive"),
+        ("eigrp_query.c", "eigrp_query_receive"),
+        ("eigrp_topology.c", "eigrp_topology_recompute"),
+        ("eigrp_dual_queue.c", "eigrp_dual_queue_run"),
+        ("eigrp_dual_queue.c", "eigrp_dual_queue_drain"),
+    ):
+        body = function_body(read(name), function)
+        assert "eigrp_packetizer_flush(eigrp, " in body
+        assert "eigrp_query_send_all(" not in body
+        assert "eigrp_update_send_all(" not in body
+
+
+def test_flush_is_one_task_per_instance():
+    body = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_flush")
+
+    assert "if (eigrp->t_dual_flush) {" in body
+    assert "&eigrp->t_dual_flush" in body
+    assert "eigrp->dual_flush_delay" in body
+
+
+def test_flush_records_batch_sizes():
+    body = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_flush_event")
+
+    assert "queries = eigrp_query_send_all(eigrp);" in body
+    assert "stats->last_updates = updates;" in body
+    assert "stats->max_queries" in body
+
+
+def test_instance_teardown_cancels_the_flush():
+    body = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_finish")
+
+    assert "event_cancel(&eigrp->t_dual_flush);" in body
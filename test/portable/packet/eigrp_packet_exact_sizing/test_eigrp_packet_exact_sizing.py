@@ -0,0 +1,157 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for exact TLV sizing.  Every codec can say what it
+# will write before it writes it, and the packet builders use that to
+# fill each packet up to the MTU instead of stopping at a worst case.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+FRR_TESTS = ROOT / "test" / "frr"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_sizer_travels_with_the_encoder():
+    assert "eigrp_packet_sizer_t sizer;" in read("eigrp_types.h")
+    assert "eigrp_packet_sizer_t sizer;" in read("eigrp_structs.h")
+    assert "eigrp_packet_sizer_t sizer;" in read("eigrp_neighbor.h")
+
+    for codec in ("tlv1", "tlv2"):
+        source = read(f"eigrp_{codec}.c")
+        assert f"codec->sizer = eigrp_{codec}_sizer;" in function_body(
+            source, f"eigrp_{codec}_init"
+        )
+        assert "ei->sizer = codec->sizer;" in function_body(
+            source, f"eigrp_{codec}_interface_bind"
+        )
+
+    assert "nbr->sizer = codec->sizer;" in function_body(
+        read("eigrp_neighbor.c"), "eigrp_neighbor_encoder_bind"
+    )
+    select = function_body(read("eigrp_interface.c"), "eigrp_interface_encoder_select")
+    assert "ei->sizer = eigrp_packet_sizer_both;" in select
+
+    both = function_body(read("eigrp_packet.c"), "eigrp_packet_sizer_both")
+    assert "eigrp->tlv1_codec.sizer(eigrp, route)" in both
+    assert "eigrp->tlv2_codec.sizer(eigrp, route)" in both
+
+
+def test_sizers_count_what_the_encoders_write():
+    tlv1 = function_body(read("eigrp_tlv1.c"), "eigrp_tlv1_sizer")
+    for part in (
+        "EIGRP_TLV_HDR_SIZE",
+        "EIGRP_TLV1_IPV4_NEXTHOP_SIZE",
+        "EIGRP_TLV1_METRIC_SIZE",
+        "EIGRP_TLV1_EXTDATA_SIZE",
+        "eigrp_tlv1_ipv4_prefix_bytes(dest->prefixlen)",
+    ):
+        assert part in tlv1
+
+    tlv2 = function_body(read("eigrp_tlv2.c"), "eigrp_tlv2_sizer")
+    for part in (
+        "EIGRP_TLV_HDR_SIZE",
+        "EIGRP_TLV2_HEADER_EXT_SIZE",
+        "EIGRP_TLV2_METRIC_SIZE",
+        "EIGRP_TLV2_EXTDATA_SIZE",
+        "eigrp_tlv2_ipv4_prefix_bytes(dest->prefixlen)",
+    ):
+        assert part in tlv2
+
+
+def test_update_packets_are_filled_to_the_mtu():
+    update = read("eigrp_update.c")
+    assert "EIGRP_TLV_MAX_IPV4_BYTE" not in update
+
+    send = function_body(update, "eigrp_update_send")
+    size = send.index("tlv_length = ei->sizer(eigrp, route);")
+    full = send.index("has_tlv && length + tlv_length > eigrp_mtu")
+    assert size < full < send.index("ei->encoder(eigrp, ei, NULL, packet->s, route)")
+    # the packet that was sent is not written to again
+    assert full < send.index("packet = eigrp_packet_new(eigrp_mtu, NULL);", full)
+
+    eot = function_body(update, "eigrp_update_send_EOT")
+    size = eot.index("tlv_length = nbr->sizer(eigrp, route);")
+    full = eot.index("packet_tlvs && length + tlv_length > eigrp_mtu")
+    assert size < full < eot.index("(nbr->encoder)(eigrp, ei, nbr, packet->s,")
+
+
+def test_gr_chunks_are_filled_and_resume_after_the_last_prefix():
+    update = read("eigrp_update.c")
+    assert "EIGRP_TLV_MAX_IPv4" not in update
+    assert "nbr_gr_prefixes_send" not in update
+
+    part = function_body(update, "eigrp_update_send_GR_part")
+    assert "route_table_get_next(eigrp->topology_table," in part
+    assert "&nbr->nbr_gr_resume);" in part
+    assert "send_prefixes\n\t\t\t\t    && length + tlv_length > eigrp_mtu" in part
+    assert "prefix_copy(&nbr->nbr_gr_resume, dest_addr);" in part
+
+    # EOT goes on the chunk the walk ends in
+    done = part.index("flags |= EIGRP_EOT_FLAG;")
+    assert part.index("if (rn) {") < done
+    assert done < part.index("eigrph->flags = htonl(flags);")
+
+
+def test_fill_is_reported():
+    stat = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_packet_stat")
+    assert "stats->bytes += length;" in stat
+    assert "stats->room += mtu;" in stat
+
+    dump = function_body(read("eigrp_dump.c"), "eigrp_packetizer_dump")
+    assert "stats->bytes * 100 / stats->room" in dump
+
+
+def test_sizers_and_encoders_take_routes_without_a_prefix():
+    for codec in ("tlv1", "tlv2"):
+        source = read(f"eigrp_{codec}.c")
+        for name in (f"eigrp_{codec}_sizer", f"eigrp_{codec}_addr_encode"):
+            body = function_body(source, name)
+            assert "route->prefix" in body and "&route->dest" in body
+            # dest is never NULL, and the error log reads it
+            assert "dest->family != AF_INET" in body
+            assert "!dest" not in body
+
+        encoder = function_body(source, f"eigrp_{codec}_encoder")
+        assert "eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_OUT" in encoder
+
+
+def test_simulator_checks_that_packed_routes_are_learned():
+    sim = (FRR_TESTS / "bench_eigrp_convergence.c").read_text()
+
+    deliver = function_body(sim, "sim_deliver")
+    assert deliver.index("eigrp_packet_input(") < deliver.index(
+        "sim_heard_record(port, msg);"
+    )
+
+    record = function_body(sim, "sim_heard_record")
+    assert "(nbr->decoder)(eigrp, nbr, s, msg->length);" in record
+    assert "route->metric.delay != EIGRP_MAX_METRIC" in record
+
+    lost = function_body(sim, "sim_heard_lost")
+    assert "eigrp_prefix_descriptor_lookup(&pe->routes, nbr)" in lost
+
+    report = function_body(sim, "sim_report")
+    assert "if (missing || stale || lost)" in report
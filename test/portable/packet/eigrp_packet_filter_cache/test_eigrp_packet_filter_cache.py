@@ -0,0 +1,107 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the filter verdict cache.  Each prefix keeps the
+# instance and per-interface distribute-list verdicts for one filter
+# generation, and every list change moves the generation on.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_verdicts_are_kept_per_slot_and_generation():
+    cache = read("eigrp_filter_cache.c")
+
+    get = function_body(cache, "eigrp_filter_cache_get")
+    assert "cache->gen != eigrp->filter_gen" in get
+    assert "memset(cache->verdict, 0, cache->slots);" in get
+
+    verdict = function_body(cache, "eigrp_filter_cache_verdict")
+    known = verdict.index("EIGRP_FILTER_CACHE_KNOWN(dir)")
+    assert "filter_cache_stats.hits++" in verdict[known:]
+    assert verdict.index("filter_cache_stats.misses++") < verdict.index(
+        "eigrp_filter_cache_deny("
+    )
+
+    apply = function_body(cache, "eigrp_filter_cache_apply")
+    assert "EIGRP_FILTER_CACHE_INSTANCE" in apply
+    assert "ei->filter_slot" in apply
+    assert apply.index("if (!instance && !intf)") < apply.index(
+        "eigrp_filter_cache_get("
+    )
+
+
+def test_list_changes_retire_the_generation():
+    flush = function_body(read("eigrp_filter_cache.c"), "eigrp_filter_cache_flush")
+    assert "eigrp->filter_gen++;" in flush
+
+    filters = read("eigrp_filter.c")
+    assert "eigrp_filter_cache_flush(eigrp);" in function_body(
+        filters, "eigrp_distribute_update"
+    )
+    assert "eigrp_filter_cache_flush(eigrp);" in function_body(
+        filters, "eigrp_distribute_update_all"
+    )
+
+    release = function_body(
+        read("eigrp_filter_cache.c"), "eigrp_filter_cache_slot_release"
+    )
+    assert "eigrp_filter_cache_flush(eigrp);" in release
+
+
+def test_interfaces_hold_a_slot():
+    interface = read("eigrp_interface.c")
+    assert "eigrp_filter_cache_slot_alloc(eigrp, ei);" in function_body(
+        interface, "eigrp_intf_new"
+    )
+    assert "eigrp_filter_cache_slot_release(eigrp, ei);" in function_body(
+        interface, "eigrp_intf_free"
+    )
+
+
+def test_senders_use_the_cache():
+    update = read("eigrp_update.c")
+    for name in ("eigrp_update_send", "eigrp_update_send_EOT", "eigrp_update_send_GR_part"):
+        body = function_body(update, name)
+        assert "eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT, prefix)" in body
+        assert "eigrp_update_prefix_apply(" not in body
+
+    for codec in ("eigrp_tlv1.c", "eigrp_tlv2.c"):
+        assert "eigrp_filter_cache_apply(eigrp, ei, EIGRP_FILTER_OUT" in read(codec)
+
+
+def test_cache_goes_with_the_prefix_and_is_reported():
+    topology = read("eigrp_topology.c")
+    assert "eigrp_filter_cache_free(pe);" in function_body(
+        topology, "eigrp_prefix_descriptor_delete"
+    )
+    assert "eigrp_filter_cache_free(pe);" in function_body(
+        topology, "eigrp_topology_prefix_free"
+    )
+
+    summary = function_body(read("eigrp_dump.c"), "eigrp_topology_summary_dump")
+    assert "eigrp_filter_cache_dump(vty, eigrp);" in summary
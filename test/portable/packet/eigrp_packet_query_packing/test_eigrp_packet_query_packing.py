@@ -0,0 +1,70 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for QUERY packing.  The prefixes of one flush travel
+# in one work item and share MTU-sized packets per interface, while reply
+# tracking and the query scope statistics stay per prefix.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_flush_queries_chain_into_one_run():
+    body = function_body(read("eigrp_query.c"), "eigrp_query_send_all")
+    assert "eigrp_packetizer_work_new(eigrp, EIGRP_OPC_QUERY);" in body
+    assert "eigrp_packetizer_enqueue(eigrp, work);" in body
+
+    slot = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_chain_slot")
+    assert "return nbr ? NULL : &eigrp->query_work;" in slot
+
+
+def test_interface_send_packs_tlvs_up_to_the_mtu():
+    packetizer = read("eigrp_packetizer.c")
+    body = function_body(packetizer, "eigrp_packetizer_query_interface_send")
+
+    loop = body.index("for (item = work; item; item = item->next)")
+    size = body.index("tlv_length = ei->sizer(eigrp, route);")
+    full = body.index("length + tlv_length > eigrp_mtu")
+    assert loop < size < full < body.index("ei->encoder(")
+    assert "eigrp_packetizer_packet_new(eigrp, ei, NULL," in body
+
+    # reply tracking and statistics per prefix, inside the loop
+    assert loop < body.index("eigrp_topology_rij_add(prefix, nbr);")
+    assert loop < body.index("eigrp_summary_suppress(ei, prefix)")
+
+    new = function_body(packetizer, "eigrp_packetizer_packet_new")
+    assert "eigrp_packet_sequence_reserve(eigrp)" in new
+
+    send = function_body(packetizer, "eigrp_packetizer_query_packet_send")
+    assert "eigrp_packet_duplicate(packet, nbr)" in send
+    assert "eigrp_packetizer_packet_stat(eigrp, opcode, tlvs, length," in send
+
+
+def test_chain_is_freed_with_its_head():
+    body = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_work_free")
+    assert "next = work->next;" in body
+    assert "eigrp_slab_obj_free(work);" in body
@@ -0,0 +1,95 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for REPLY coalescing.  REPLY and SIA-REPLY work for a
+# neighbor gathers on the item already waiting for it and is sent in
+# MTU-sized packets, and every opcode reports its TLVs per packet.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_reply_work_gathers_per_neighbor():
+    packetizer = read("eigrp_packetizer.c")
+
+    slot = function_body(packetizer, "eigrp_packetizer_chain_slot")
+    assert "return nbr ? &nbr->reply_work : NULL;" in slot
+    assert "return nbr ? &nbr->siareply_work : NULL;" in slot
+
+    enqueue = function_body(packetizer, "eigrp_packetizer_enqueue")
+    chained = enqueue.index("(*slot)->tail->next = work;")
+    assert chained < enqueue.index("eigrp_work_queue_enqueue(")
+
+    process = function_body(packetizer, "eigrp_packetizer_work_process")
+    assert process.index("eigrp_packetizer_detach(work);") < process.index(
+        "eigrp_packetizer_neighbor_route_send(eigrp, work);"
+    )
+    assert "eigrp_packetizer_detach(data);" in function_body(
+        packetizer, "eigrp_packetizer_work_queue_delete"
+    )
+
+
+def test_chain_is_packed_up_to_the_mtu():
+    packetizer = read("eigrp_packetizer.c")
+    body = function_body(packetizer, "eigrp_packetizer_neighbor_route_send")
+
+    assert "eigrp_packetizer_neighbor_opcodes[i]" in body
+    loop = body.index("for (item = work; item; item = item->next)")
+    size = body.index("tlv_length = nbr->sizer(eigrp, route);")
+    assert loop < size < body.index("length + tlv_length > eigrp_mtu")
+    assert loop < body.index("eigrp_topology_successor_head(prefix)")
+    assert "eigrp_packetizer_packet_new(eigrp, ei, nbr," in body
+
+    send = function_body(packetizer, "eigrp_packetizer_neighbor_packet_send")
+    assert "eigrp_addr_copy(&packet->dst, &nbr->src);" in send
+    assert "eigrp_packetizer_packet_stat(eigrp, opcode, tlvs, length," in send
+
+    free = function_body(packetizer, "eigrp_packetizer_work_free")
+    assert "next = work->next;" in free
+
+
+def test_deleted_neighbor_drops_its_replies():
+    delete = function_body(read("eigrp_neighbor.c"), "eigrp_nbr_delete")
+    assert "eigrp_packetizer_neighbor_down(nbr);" in delete
+
+    down = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_neighbor_down")
+    assert "&nbr->reply_work," in down
+    assert "&nbr->siareply_work," in down
+    assert "item->nbr = NULL;" in down
+
+
+def test_tlvs_per_packet_are_reported_per_opcode():
+    update = function_body(read("eigrp_update.c"), "eigrp_update_send")
+    assert update.count("eigrp_packetizer_packet_stat(eigrp, EIGRP_OPC_UPDATE, tlvs") == 2
+
+    dump = read("eigrp_dump.c")
+    assert "eigrp_packetizer_dump(vty, eigrp);" in function_body(
+        dump, "eigrp_topology_summary_dump"
+    )
+    body = function_body(dump, "eigrp_packetizer_dump")
+    for opcode in ("UPDATE", "QUERY", "REPLY", "SIAQUERY", "SIAREPLY"):
+        assert f"EIGRP_OPC_{opcode}" in body
@@ -0,0 +1,104 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the southbound seam.  The host socket is only
+# touched from eigrp_southbound.c, and received packets are processed by a
+# function the convergence simulator can call without a socket.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+FRR_TESTS = ROOT / "test" / "frr"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_host_socket_is_only_used_by_the_southbound():
+    southbound = read("eigrp_southbound.c")
+    assert "sendmsg(" in function_body(southbound, "eigrp_southbound_packet_send")
+    for name in (
+        "eigrp_sock_init",
+        "eigrp_adjust_sndbuflen",
+        "eigrp_intf_ipmulticast",
+        "eigrp_intf_add_allspfrouters",
+        "eigrp_intf_drop_allspfrouters",
+    ):
+        function_body(southbound, name)
+
+    for name in ("eigrp_packet.c", "eigrp_network.c"):
+        source = read(name)
+        assert "sendmsg(" not in source
+        assert "socket(" not in source
+        assert "setsockopt" not in source
+
+
+def test_packet_write_and_read_go_through_the_seam():
+    packet = read("eigrp_packet.c")
+
+    write = function_body(packet, "eigrp_packet_write")
+    assert "eigrp_southbound_packet_send(eigrp, ei, packet);" in write
+
+    read_body = function_body(packet, "eigrp_packet_read")
+    assert "eigrp_packet_recv(" in read_body
+    assert "eigrp_packet_input(eigrp, ibuf, ifp);" in read_body
+    function_body(packet, "eigrp_packet_input")
+
+
+def test_convergence_simulator_is_built():
+    subdir = (FRR_TESTS / "subdir.am").read_text()
+    assert "noinst_PROGRAMS += tests/eigrpd/bench_eigrp_convergence" in subdir
+
+    sources = subdir.split("tests_eigrpd_bench_eigrp_convergence_SOURCES", 1)[1]
+    sources = sources.split("# end", 1)[0]
+    for name in ("eigrp_fsm.c", "eigrp_topology.c", "eigrp_packetizer.c", "eigrp_packet.c"):
+        assert f"eigrpd/{name}" in sources
+    for name in ("eigrp_southbound.c", "eigrp_zebra.c", "eigrp_main.c"):
+        assert f"eigrpd/{name}" not in sources
+
+    sim = (FRR_TESTS / "bench_eigrp_convergence.c").read_text()
+    function_body(sim, "eigrp_southbound_packet_send")
+    assert "eigrp_packet_input(" in sim
+
+    for topo in ("ring.topo", "hub.topo", "clos.topo", "dense.topo"):
+        assert (FRR_TESTS / "convergence" / topo).is_file()
+
+
+def test_convergence_simulator_fails_on_a_wrong_table():
+    sim = (FRR_TESTS / "bench_eigrp_convergence.c").read_text()
+
+    report = function_body(sim, "sim_report")
+    assert report.index("sim_check(&missing, &stale, &lost);") < report.index(
+        "sim.failed++;"
+    )
+    assert "if (missing || stale" in report
+
+    main = function_body(sim, "main")
+    failed = main[main.index("if (sim.failed) {") :]
+    assert "return 1;" in failed.split("}", 1)[0]
+
+    # the dense topology makes every full-table UPDATE carry many routes
+    send = function_body(sim, "eigrp_southbound_packet_send")
+    assert "sim_route_tlvs(" in send
+    dense = (FRR_TESTS / "convergence" / "dense.topo").read_text()
+    assert int(re.search(r"^prefixes (\d+)", dense, re.M).group(1)) >= 64
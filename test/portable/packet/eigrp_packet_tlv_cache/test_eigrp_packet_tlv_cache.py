@@ -0,0 +1,114 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the encoded TLV cache.  Each codec copies the
+# TLV it built last for a prefix while the prefix serial number and the
+# encoded route fields hold, and the cache goes with the prefix.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_each_codec_copies_before_it_encodes():
+    for codec, tag in (("tlv1", "TLV1"), ("tlv2", "TLV2")):
+        body = function_body(read(f"eigrp_{codec}.c"), f"eigrp_{codec}_encoder")
+        put = body.index(f"eigrp_tlv_cache_put(eigrp, pkt, route, EIGRP_TLV_CACHE_{tag});")
+
+        # the outbound filter still runs first and can change the metric
+        assert body.index("EIGRP_FILTER_OUT") < put
+        assert put < body.index("stream_putw(pkt, type);")
+        assert body.index("stream_putw(pkt, length);") < body.index(
+            "eigrp_tlv_cache_store("
+        )
+
+
+def test_image_is_keyed_by_serno_and_encoded_fields():
+    source = read("eigrp_tlv_cache.c")
+    match = function_body(source, "eigrp_tlv_cache_match")
+    for field in (
+        "route->prefix->serno",
+        "eigrp->router_id.s_addr",
+        "route->nexthop.ip.v4.s_addr",
+        "route->type",
+        "&route->metric",
+        "&route->extdata",
+    ):
+        assert field in match
+    assert "memcmp(" not in source
+
+    metric = function_body(source, "eigrp_tlv_cache_metric_same")
+    for field in ("delay", "bandwidth", "mtu[2]", "hop_count", "tag", "flags"):
+        assert f"a->{field} == b->{field}" in metric
+
+    put = function_body(source, "eigrp_tlv_cache_put")
+    assert "eigrp_tlv_cache_match(eigrp, image, route)" in put
+    assert "STREAM_WRITEABLE(pkt) < image->length" in put
+
+    store = function_body(source, "eigrp_tlv_cache_store")
+    assert "length > EIGRP_TLV_CACHE_BYTES" in store
+
+
+def test_images_are_sized_and_skip_unreachable_routes():
+    source = read("eigrp_tlv_cache.c")
+    assert "uint8_t data[];" in source
+    assert "EIGRP_TLV_CACHE_BYTES]" not in source
+
+    store = function_body(source, "eigrp_tlv_cache_store")
+    assert "sizeof(*image) + length" in store
+    assert store.index("route->metric.delay == EIGRP_MAX_METRIC") < store.index(
+        "XMALLOC("
+    )
+    assert "uncached++" in store
+
+    put = function_body(source, "eigrp_tlv_cache_put")
+    assert "route->metric.delay == EIGRP_MAX_METRIC" in put
+
+
+def test_prefix_change_bumps_serno():
+    body = function_body(read("eigrp_topology.c"), "eigrp_topology_dirty_insert")
+    assert "pe->serno = ++eigrp->serno;" in body
+
+
+def test_cache_goes_with_the_prefix():
+    topology = read("eigrp_topology.c")
+    assert "eigrp_tlv_cache_free(pe);" in function_body(
+        topology, "eigrp_prefix_descriptor_delete"
+    )
+    assert "eigrp_tlv_cache_free(pe);" in function_body(
+        topology, "eigrp_topology_prefix_free"
+    )
+    assert "eigrp_tlv_cache_t *tlv_cache;" in read("eigrp_structs.h")
+
+
+def test_full_table_update_time_is_recorded_and_shown():
+    update = function_body(read("eigrp_update.c"), "eigrp_update_send_EOT")
+    assert "eigrp_update_dump_stat(eigrp, tlvs," in update
+
+    dump = function_body(read("eigrp_dump.c"), "eigrp_topology_summary_dump")
+    assert "eigrp_tlv_cache_dump(vty, eigrp);" in dump
+
+    assert "eigrpd/eigrp_tlv_cache.c" in read("subdir.am")
@@ -0,0 +1,105 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for packetizer work coalescing.  Work waiting for a
+# prefix absorbs later work for it, work for a destination chains behind
+# the waiting head, and both stop once the head starts to run.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_prefix_points_at_its_waiting_work():
+    structs = read("eigrp_structs.h")
+    assert "eigrp_packetizer_work_t *work;" in structs
+    assert "eigrp_packetizer_work_t *pe_next;" in read("eigrp_packetizer.h")
+
+
+def test_enqueue_merges_before_it_chains_or_queues():
+    packetizer = read("eigrp_packetizer.c")
+    enqueue = function_body(packetizer, "eigrp_packetizer_enqueue")
+
+    merge = enqueue.index("eigrp_packetizer_merge(eigrp, old, work)")
+    chain = enqueue.index("(*slot)->tail->next = work;")
+    queue = enqueue.index("eigrp_work_queue_enqueue(")
+    assert merge < chain < queue
+    assert "stats->coalesced++;" in enqueue
+    assert "stats->enqueued++;" in enqueue
+
+    # one UPDATE run widens its exception instead of running twice
+    assert "(*slot)->exception = NULL;" in enqueue
+
+
+def test_reply_upgrades_a_waiting_sia_reply():
+    merge = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_merge")
+
+    assert "old->opcode = EIGRP_OPC_REPLY;" in merge
+    assert "packetizer_queue_stats.upgraded++" in merge
+    assert "old->route = work->route;" in merge
+
+
+def test_running_work_stops_taking_more():
+    packetizer = read("eigrp_packetizer.c")
+
+    detach = function_body(packetizer, "eigrp_packetizer_detach")
+    assert "*work->slot = NULL;" in detach
+    assert "eigrp_packetizer_prefix_unlink(item);" in detach
+
+    process = function_body(packetizer, "eigrp_packetizer_work_process")
+    assert process.index("eigrp_packetizer_detach(work);") < process.index("switch")
+
+
+def test_deleted_prefix_leaves_its_work():
+    delete = function_body(read("eigrp_topology.c"), "eigrp_prefix_descriptor_delete")
+    assert "eigrp_packetizer_prefix_purge(pe);" in delete
+
+    purge = function_body(read("eigrp_packetizer.c"), "eigrp_packetizer_prefix_purge")
+    assert "work->prefix = NULL;" in purge
+
+
+def test_orphaned_neighbor_work_is_dropped():
+    packetizer = read("eigrp_packetizer.c")
+
+    down = function_body(packetizer, "eigrp_packetizer_neighbor_down")
+    assert "item->nbr = NULL;" in down
+
+    process = function_body(packetizer, "eigrp_packetizer_work_process")
+    drop = process.index("packetizer_queue_stats.dropped++")
+    assert "!work->nbr && work->opcode != EIGRP_OPC_UPDATE" in process
+    assert "work->opcode != EIGRP_OPC_QUERY" in process
+    assert drop < process.index("switch")
+
+    query = function_body(packetizer, "eigrp_packetizer_query_send")
+    assert query.index("if (work->opcode != EIGRP_OPC_QUERY)") < query.index(
+        "eigrp_packetizer_query_interface_send("
+    )
+
+
+def test_counters_are_shown():
+    dump = function_body(read("eigrp_dump.c"), "eigrp_packetizer_dump")
+    for field in ("enqueued", "chained", "coalesced", "upgraded", "dropped"):
+        assert f"queue->{field}" in dump
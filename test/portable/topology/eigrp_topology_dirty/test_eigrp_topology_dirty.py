@@ -0,0 +1,36 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the dirty prefix queues.  Prefixes needing
+# UPDATE or QUERY work are queued through the deduplicating intrusive
+# queues, never through an FRR list with linear removal.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def test_topology_changes_list_is_gone():
+    for path in sorted(EIGRPD.glob("*.[ch]")):
+        assert "topology_changes" not in path.read_text(), path.name
+
+
+def test_req_action_is_only_set_by_the_dirty_queue():
+    for path in sorted(EIGRPD.glob("*.c")):
+        if path.name == "eigrp_topology.c":
+            continue
+        source = path.read_text()
+        assert not re.search(r"req_action\s*\|=", source), path.name
+        assert not re.search(r"req_action\s*&=", source), path.name
+
+
+def test_prefix_delete_leaves_both_queues():
+    topology = (EIGRPD / "eigrp_topology.c").read_text()
+    start = topology.index("void eigrp_prefix_descriptor_delete(")
+    end = topology.index("\n}\n", start)
+
+    assert "EIGRP_FSM_NEED_UPDATE | EIGRP_FSM_NEED_QUERY" in topology[start:end]
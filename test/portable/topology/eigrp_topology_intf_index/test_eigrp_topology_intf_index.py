@@ -0,0 +1,61 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the per-interface route index.  Routes join the
+# index when they join a prefix and leave it when freed, and interface or
+# neighbor driven work walks the index instead of the whole table.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_routes_join_and_leave_the_index_with_the_topology():
+    topology = read("eigrp_topology.c")
+
+    assert "eigrp_topology_intf_link(route);" in function_body(
+        topology, "eigrp_route_descriptor_add"
+    )
+    assert "eigrp_topology_intf_unlink(route);" in function_body(
+        topology, "eigrp_topology_route_free"
+    )
+    assert "eigrp_topology_intf_link(route);" in function_body(
+        topology, "eigrp_topology_update_distance"
+    )
+
+
+def test_neighbor_down_walks_the_interface_index():
+    body = function_body(read("eigrp_topology.c"), "eigrp_topology_neighbor_down")
+
+    assert "eigrp_topology_intf_prefixes(nbr->ei, nbr, &count);" in body
+    assert "route_top(" not in body
+
+
+def test_interface_recompute_walks_the_interface_index():
+    body = function_body(read("eigrp_topology.c"), "eigrp_topology_recompute")
+
+    assert "eigrp_topology_intf_prefixes(ei, NULL, &count);" in body
+    assert "ei->recompute_routes += rc->routes;" in body
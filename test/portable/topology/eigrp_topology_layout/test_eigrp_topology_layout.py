@@ -0,0 +1,66 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the compact prefix descriptor.  The destination
+# is stored inline, reply tracking only exists while replies are
+# outstanding, and the hot DUAL fields lead the structure.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def prefix_descriptor() -> str:
+    match = re.search(
+        r"typedef struct eigrp_prefix_descriptor \{(.*?)\} eigrp_prefix_descriptor_t;",
+        read("eigrp_structs.h"),
+        re.S,
+    )
+    assert match, "missing eigrp_prefix_descriptor_t"
+    return match.group(1)
+
+
+def test_destination_is_inline_and_extern_pointer_is_gone():
+    body = prefix_descriptor()
+
+    assert "struct prefix_ipv4 destination;" in body
+    assert "struct prefix *destination" not in body
+    assert "extTLV" not in body
+
+    for path in EIGRPD.glob("*.c"):
+        source = path.read_text()
+        assert "prefix_ipv4_new()" not in source, path.name
+        assert "->destination" not in source, path.name
+
+
+def test_hot_fields_lead_the_descriptor():
+    body = prefix_descriptor()
+    hot = ["routes", "fdistance", "rdistance", "distance", "state",
+           "req_action", "nt", "nsuccessor", "feasible"]
+
+    positions = [re.search(rf"\b{field};", body).start() for field in hot]
+    assert positions == sorted(positions)
+
+
+def test_rij_only_exists_while_replies_are_outstanding():
+    topology = read("eigrp_topology.c")
+    create = topology[topology.index("eigrp_topology_prefix_create(eigrp_instance_t"):]
+    create = create[: create.index("\n}\n")]
+
+    assert "list_new" not in create
+    for name in ("eigrp_fsm.c", "eigrp_packetizer.c"):
+        source = read(name)
+        assert "->rij" not in source, name
+    assert "eigrp_topology_rij_add(prefix, nbr);" in read("eigrp_packetizer.c")
+
+
+def test_zebra_copies_prefix_by_family():
+    assert "memcpy(&api.prefix" not in read("eigrp_zebra.c")
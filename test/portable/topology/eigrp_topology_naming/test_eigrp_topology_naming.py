@@ -61,15 +61,15 @@ def test_topology_module_owns_lifecycle_definitions():
     topology_header = topology_h.read_text()
 
     expected_definitions = {
-        "eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(void)",
+        "eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(eigrp_instance_t *eigrp)",
         "void eigrp_topology_prefix_free(eigrp_prefix_descriptor_t *pe)",
-        "eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_interface_t *intf)",
+        "eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_instance_t *eigrp, eigrp_interface_t *intf)",
         "void eigrp_topology_route_free(eigrp_route_descriptor_t *route)",
     }
     expected_declarations = {
-        "eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(void)",
+        "eigrp_prefix_descriptor_t *eigrp_topology_prefix_create(eigrp_instance_t *)",
         "void eigrp_topology_prefix_free(eigrp_prefix_descriptor_t *)",
-        "eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_interface_t *)",
+        "eigrp_route_descriptor_t *eigrp_topology_route_create(eigrp_instance_t *, eigrp_interface_t *)",
         "void eigrp_topology_route_free(eigrp_route_descriptor_t *)",
     }
 
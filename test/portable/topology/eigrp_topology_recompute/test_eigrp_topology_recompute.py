@@ -0,0 +1,77 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for bulk metric recompute.  K-value and interface
+# delay/bandwidth changes must recompute distances through the batch
+# engine rather than bouncing the interface or leaving stale distances.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_k_value_changes_recompute_all_routes():
+    northbound = read("eigrp_northbound.c")
+
+    for k in range(1, 6):
+        for cb in ("modify", "destroy"):
+            body = function_body(
+                northbound, f"eigrpd_instance_metric_weights_K{k}_{cb}"
+            )
+            assert "eigrp_topology_recompute(eigrp, NULL);" in body
+
+
+def test_interface_metric_changes_recompute_without_reset():
+    northbound = read("eigrp_northbound.c")
+
+    for param in ("delay", "bandwidth"):
+        body = function_body(northbound, f"lib_interface_eigrp_{param}_modify")
+        assert "eigrp_topology_recompute(ei->eigrp, ei);" in body
+        assert "eigrp_intf_reset" not in body
+
+
+def test_recompute_uses_batch_kernel_and_filters_dual_events():
+    topology = read("eigrp_topology.c")
+
+    flush = function_body(topology, "eigrp_topology_recompute_flush")
+    assert "eigrp_calculate_metrics_batch(rc->eigrp, batch);" in flush
+
+    prefix = function_body(topology, "eigrp_topology_recompute_prefix")
+    assert prefix.index("eigrp_topology_recompute_changed") < prefix.index(
+        "eigrp_fsm_event(&msg);"
+    )
+    assert "msg.data_type = EIGRP_RECOMPUTE;" in prefix
+
+
+def test_scalar_and_batch_composite_share_one_formula():
+    metric = read("eigrp_metric.c")
+
+    assert "return eigrp_composite(eigrp->k_values" in function_body(
+        metric, "eigrp_calculate_metrics"
+    )
+    assert "eigrp_composite(k, " in function_body(
+        metric, "eigrp_calculate_metrics_batch"
+    )
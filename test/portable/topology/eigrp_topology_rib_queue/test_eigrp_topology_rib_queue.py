@@ -0,0 +1,109 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the RIB install queue.  Topology and DUAL queue a
+# prefix once per flush, zebra hears the prefix's state at the flush, and
+# a deleted prefix still gets its withdrawal out.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_topology_queues_instead_of_calling_zebra():
+    topology = read("eigrp_topology.c")
+    assert "eigrp_zebra_route_" not in topology
+
+    for name in (
+        "eigrp_update_routing_table",
+        "eigrp_route_descriptor_add",
+        "eigrp_route_descriptor_delete",
+    ):
+        assert "eigrp_rib_queue_enqueue(eigrp," in function_body(topology, name)
+
+    assert "eigrp_rib_queue_prefix_delete(eigrp, pe);" in function_body(
+        topology, "eigrp_prefix_descriptor_delete"
+    )
+    assert "eigrp_rib_queue_prefix_detach(pe);" in function_body(
+        topology, "eigrp_topology_prefix_free"
+    )
+
+
+def test_a_prefix_is_queued_once():
+    enqueue = function_body(read("eigrp_rib_queue.c"), "eigrp_rib_queue_enqueue")
+    coalesce = enqueue.index("if (pe->rib) {")
+
+    assert "stats->coalesced++;" in enqueue[coalesce:]
+    assert coalesce < enqueue.index("eigrp_slab_obj_create(&eigrp->rib_slab)")
+    assert "eigrp_rib_queue_schedule(eigrp);" in enqueue
+
+
+def test_flush_sends_the_final_state_in_batches():
+    rib = read("eigrp_rib_queue.c")
+
+    send = function_body(rib, "eigrp_rib_entry_send")
+    assert "pe->nsuccessor" in send
+    assert "eigrp->max_paths" in send
+    assert "eigrp_zebra_route_add(" in send
+    assert "eigrp_zebra_route_delete(" in send
+
+    flush = function_body(rib, "eigrp_rib_queue_flush")
+    assert "sent < max" in flush
+    assert "entry->prefix->rib = NULL;" in flush
+    assert "stats->latency_max_usec = latency;" in flush
+
+    event = function_body(rib, "eigrp_rib_queue_flush_event")
+    assert "EIGRP_RIB_QUEUE_BATCH" in event
+    assert "event_add_event(" in event
+
+    schedule = function_body(rib, "eigrp_rib_queue_schedule")
+    assert "eigrp->rib_count == EIGRP_RIB_QUEUE_BATCH" in schedule
+    assert "EIGRP_RIB_FLUSH_DELAY" in schedule
+
+
+def test_deleted_prefix_keeps_its_withdrawal():
+    rib = read("eigrp_rib_queue.c")
+
+    delete = function_body(rib, "eigrp_rib_queue_prefix_delete")
+    assert delete.index("eigrp_rib_queue_enqueue(eigrp, pe);") < delete.index(
+        "eigrp_rib_queue_prefix_detach(pe);"
+    )
+    assert "pe->rib->prefix = NULL;" in function_body(
+        rib, "eigrp_rib_queue_prefix_detach"
+    )
+
+    final = function_body(read("eigrpd.c"), "eigrp_finish_final")
+    assert final.index("eigrp_topology_free(") < final.index(
+        "eigrp_rib_queue_fini(eigrp);"
+    )
+    assert final.index("eigrp_rib_queue_fini(eigrp);") < final.index(
+        "eigrp_slab_fini(&eigrp->rib_slab);"
+    )
+
+
+def test_queue_is_reported():
+    summary = function_body(read("eigrp_dump.c"), "eigrp_topology_summary_dump")
+    assert "eigrp_rib_queue_dump(vty, eigrp);" in summary
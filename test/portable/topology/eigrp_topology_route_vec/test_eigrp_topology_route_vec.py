@@ -0,0 +1,32 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for per-prefix route storage.  Candidate paths live
+# in the inline eigrp_route_vec_t, not in a struct list of listnodes.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def test_prefix_descriptor_has_no_entries_list():
+    structs = (EIGRPD / "eigrp_structs.h").read_text()
+
+    assert re.search(r"\beigrp_route_vec_t routes;", structs)
+    assert "struct list *entries;" not in structs
+
+
+def test_no_source_walks_the_old_entries_list():
+    for path in sorted(EIGRPD.glob("*.[ch]")):
+        assert "->entries" not in path.read_text(), path.name
+
+
+def test_distance_update_resorts_in_place():
+    topology = (EIGRPD / "eigrp_topology.c").read_text()
+
+    assert "eigrp_route_vec_resort(" in topology
+    assert "listnode_add_sort" not in topology
@@ -0,0 +1,41 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the per-instance object slabs.  Prefix and route
+# descriptors and packetizer work items must come from the instance slabs,
+# not from per-object heap allocations.
+
+from pathlib import Path
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def test_topology_objects_are_carved_from_instance_slabs():
+    topology = read("eigrp_topology.c")
+
+    assert "eigrp_slab_obj_create(&eigrp->prefix_slab)" in topology
+    assert "eigrp_slab_obj_create(&eigrp->route_slab)" in topology
+    assert "MTYPE_EIGRP_PREFIX_DESCRIPTOR" not in topology
+    assert "MTYPE_EIGRP_ROUTE_DESCRIPTOR" not in topology
+
+
+def test_packetizer_work_is_carved_from_instance_slab():
+    packetizer = read("eigrp_packetizer.c")
+
+    assert "eigrp_slab_obj_create(&eigrp->work_slab)" in packetizer
+    assert "MTYPE_EIGRP_PACKETIZER_WORK" not in packetizer
+
+
+def test_instance_owns_slab_lifetime():
+    instance = read("eigrpd.c")
+
+    for slab in ("prefix_slab", "route_slab", "work_slab"):
+        assert f"eigrp_slab_init(&eigrp->{slab}," in instance
+        assert f"eigrp_slab_fini(&eigrp->{slab});" in instance
@@ -0,0 +1,73 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for topology snapshots.  Show commands format from a
+# read-only copy of the table, every topology change moves the epoch that
+# tells a copy is stale, and background copies yield between chunks.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_topology_show_formats_from_a_snapshot():
+    body = function_body(read("eigrp_vty.c"), "eigrp_topology_helper")
+
+    assert "eigrp_snapshot_get(eigrp);" in body
+    assert "eigrp_snapshot_release(&snap);" in body
+    assert "route_top(" not in body
+    assert "route_next(" not in body
+
+
+def test_topology_changes_move_the_epoch():
+    topology = read("eigrp_topology.c")
+
+    for name in (
+        "eigrp_route_descriptor_add",
+        "eigrp_route_descriptor_delete",
+        "eigrp_prefix_descriptor_delete",
+        "eigrp_topology_update_distance",
+        "eigrp_topology_update_node_flags",
+        "eigrp_update_routing_table",
+        "eigrp_topology_recompute",
+    ):
+        assert "eigrp_topology_changed(eigrp);" in function_body(topology, name)
+
+
+def test_background_copy_yields_between_chunks():
+    body = function_body(read("eigrp_snapshot.c"), "eigrp_snapshot_refresh_event")
+
+    assert "EIGRP_SNAPSHOT_CHUNK" in body
+    assert "event_add_event(" in body
+    assert "eigrp_snapshot_current(eigrp, snap)" in body
+
+
+def test_instance_teardown_drops_snapshots_before_the_table():
+    body = function_body(read("eigrpd.c"), "eigrp_finish_final")
+
+    assert body.index("eigrp_snapshot_fini(eigrp);") < body.index(
+        "eigrp_topology_free("
+    )
@@ -0,0 +1,33 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for the cached successor sets.  Hot paths read the
+# successor set kept on the prefix instead of building a temporary list.
+
+from pathlib import Path
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def test_no_temporary_successor_lists():
+    for path in sorted(EIGRPD.glob("*.[ch]")):
+        assert "eigrp_topology_get_successor" not in path.read_text(), path.name
+
+
+def test_node_flags_rebuild_the_cached_sets():
+    topology = (EIGRPD / "eigrp_topology.c").read_text()
+    start = topology.index("void eigrp_topology_update_node_flags(")
+    end = topology.index("\n}\n", start)
+
+    assert "eigrp_topology_successor_update(dest);" in topology[start:end]
+
+
+def test_route_removal_drops_route_from_cached_sets():
+    topology = (EIGRPD / "eigrp_topology.c").read_text()
+    start = topology.index("void eigrp_route_descriptor_delete(")
+    end = topology.index("\n}\n", start)
+
+    assert "eigrp_topology_successor_update(node);" in topology[start:end]
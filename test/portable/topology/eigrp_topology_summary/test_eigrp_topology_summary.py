@@ -0,0 +1,89 @@
+# SPDX-License-Identifier: ISC
+#
+# Copyright (C) 2026 Donnie V. Savage
+#
+# Source-level guards for interface summarization.  A summary is a prefix
+# descriptor of its own with a discard route, its components stay off the
+# wire behind it, and it bounds the QUERY scope on its interface.
+
+from pathlib import Path
+import re
+
+
+ROOT = Path(__file__).resolve().parents[4]
+EIGRPD = ROOT / "eigrpd"
+
+
+def read(name: str) -> str:
+    return (EIGRPD / name).read_text()
+
+
+def function_body(source: str, name: str) -> str:
+    match = re.search(rf"\n[^\n]*\b{name}\([^;{{]*\)\s*\{{", source)
+    assert match, f"missing function {name}"
+
+    depth = 0
+    for index in range(match.end() - 1, len(source)):
+        if source[index] == "{":
+            depth += 1
+        elif source[index] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[match.start() : index + 1]
+    return source[match.start() :]
+
+
+def test_summary_is_a_local_descriptor_with_a_discard_route():
+    summary = read("eigrp_summary.c")
+
+    attach = function_body(summary, "eigrp_summary_attach")
+    assert "pe->nt = EIGRP_TOPOLOGY_TYPE_SUMMARY;" in attach
+    assert "eigrp_topology_route_create(eigrp, NULL);" in attach
+
+    update = function_body(summary, "eigrp_summary_update")
+    assert "eigrp_update_routing_table(eigrp, pe);" in update
+    assert "EIGRP_FSM_NEED_UPDATE" in update
+
+    zebra = function_body(read("eigrp_zebra.c"), "eigrp_zebra_route_add")
+    assert "NEXTHOP_TYPE_BLACKHOLE" in zebra
+
+
+def test_summaries_are_refreshed_before_updates_go_out():
+    body = function_body(read("eigrp_update.c"), "eigrp_update_packetize_all")
+    assert body.index("eigrp_summary_refresh(eigrp);") < body.index("eigrp_update_send(")
+
+    delete = function_body(read("eigrp_topology.c"), "eigrp_prefix_descriptor_delete")
+    assert "eigrp_summary_changed(" in delete
+
+
+def test_components_stay_behind_the_summary():
+    update = read("eigrp_update.c")
+    for name in ("eigrp_update_send", "eigrp_update_send_EOT", "eigrp_update_send_GR_part"):
+        assert "eigrp_summary_suppress(ei, prefix)" in function_body(update, name)
+
+    packetizer = function_body(
+        read("eigrp_packetizer.c"), "eigrp_packetizer_query_interface_send"
+    )
+    assert "eigrp_summary_suppress(ei, prefix)" in packetizer
+
+
+def test_summary_is_a_query_boundary():
+    query = function_body(read("eigrp_query.c"), "eigrp_query_receive")
+    boundary = query.index("eigrp_summary_boundary(ei, prefix, nbr)")
+
+    assert boundary < query.index("eigrp_dual_queue_enqueue(")
+    assert "summary_boundary_replies++" in query[boundary:]
+
+
+def test_summary_address_is_configured_and_written():
+    northbound = read("eigrp_northbound.c")
+    assert "eigrp_summary_add(intf, &prefix);" in function_body(
+        northbound, "lib_interface_eigrp_instance_summarize_addresses_create"
+    )
+    assert "eigrp_summary_del(intf, &prefix);" in function_body(
+        northbound, "lib_interface_eigrp_instance_summarize_addresses_destroy"
+    )
+
+    cli = read("eigrp_cli.c")
+    assert "summary-address %s" in function_body(cli, "eigrp_cli_show_named_af_interfaces")
+    assert "eigrp_cli_not_configured(vty, \"summary-address\")" not in cli